@@ -0,0 +1,48 @@
+/*
+ * 설명: Cornell smoke 장면의 턴테이블 애니메이션(볼륨 상자 자전, 카메라 좌우 흔들림)을 프레임 단위로 배치하고,
+ *       장면/BVH를 한 번만 만든 뒤 프레임마다 BVH 경계를 재맞춤해 프레임 파일들로 렌더링한다.
+ * 버전: v1.9.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.9.0-animation.md
+ * 테스트: tests/integration/animation_test.cpp
+ */
+#pragma once
+
+#include <string>
+
+#include "raytracer/bvh.hpp"
+#include "raytracer/camera.hpp"
+#include "raytracer/image_sink.hpp"
+#include "raytracer/render_options.hpp"
+#include "raytracer/scene.hpp"
+#include "raytracer/thread_pool.hpp"
+
+namespace raytracer {
+
+struct AnimationOptions {
+    int frame_count = 1;
+    // BvhNode::Refit에 넘기는 서브트리 재구성 임계값(빌드 당시 면적 비용 대비 배수).
+    double rebuild_threshold = 1.5;
+};
+
+// 출력 경로 패턴의 첫 '#' 연속 구간을 frame 번호(구간 길이만큼 0 채움)로 바꾼다.
+// '#'이 없으면 std::invalid_argument를 던진다.
+std::string FrameOutputPath(const std::string& pattern, int frame);
+
+// 프레임 f의 카메라. 계약 카메라를 방 중심 기준 Y축으로 sin 곡선을 따라 흔들며, 프레임 0은 MakeCamera와 같다.
+Camera MakeAnimationCamera(const RenderOptions& options, const AnimationOptions& animation, int frame);
+
+// 장면의 턴테이블 손잡이를 프레임 f 자세(한 바퀴를 frame_count 프레임에 나눔)로 바꾸고 BVH를 재맞춤해 다시 평탄화한다.
+// 프레임 0 자세는 정지 장면과 같다. 렌더 중인 장면에는 호출하면 안 된다.
+BvhRefitStats PoseAnimationFrame(Scene& scene, const RenderOptions& options, const AnimationOptions& animation, int frame);
+
+struct AnimationStats {
+    int frames = 0;
+    BvhRefitStats bvh;
+};
+
+// 장면/BVH와 풀을 한 번만 쓰고 프레임 0부터 순서대로 FrameOutputPath(output_pattern, f)에 기록한다.
+// 파일을 열거나 기록하지 못하면 std::runtime_error를 던지며 이미 기록한 프레임은 남는다.
+AnimationStats RenderAnimation(const RenderOptions& options, const AnimationOptions& animation,
+                               const std::string& output_pattern, PpmFormat format, ThreadPool& pool);
+
+}  // namespace raytracer
@@ -0,0 +1,27 @@
+/*
+ * 설명: 옵션 조합 목록(매니페스트)을 읽어 한 번 구성한 장면/BVH와 공유 스레드 풀로 모든 변형을 렌더링해 각자의 파일로 기록한다.
+ * 버전: v1.8.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.8.0-batch.md
+ * 테스트: tests/integration/batch_test.cpp
+ */
+#pragma once
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "raytracer/render_request.hpp"
+#include "raytracer/scene.hpp"
+#include "raytracer/thread_pool.hpp"
+
+namespace raytracer {
+
+// 한 줄에 렌더 요청 JSON 하나("output" 필수)를 둔다. 빈 줄과 '#'으로 시작하는 줄은 건너뛴다.
+// 문법 오류, output 누락, 중복 output 경로는 "<줄 번호>행: ..." 메시지의 std::runtime_error로 던진다.
+std::vector<RenderRequest> ParseBatchManifest(std::istream& input, const RenderOptions& defaults);
+
+// 변형들을 같은 풀에서 동시에 렌더링한다. 각 변형의 타일 작업도 같은 풀에 분배된다.
+// 반환값은 요청 순서대로의 오류 메시지이며 성공한 변형은 빈 문자열이다. 한 변형의 실패는 다른 변형을 멈추지 않는다.
+std::vector<std::string> RenderBatch(const std::vector<RenderRequest>& requests, const Scene& scene, ThreadPool& pool);
+
+}  // namespace raytracer
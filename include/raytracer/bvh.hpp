@@ -1,43 +1,210 @@
 /*
- * 설명: Hittable 트리로 구성된 BVH 노드를 정의하고 경계 상자 기반 가속 hit 함수를 제공한다.
- * 버전: v0.9.0
- * 관련 문서: design/renderer/v0.6.0-bvh.md, design/renderer/v0.9.0-volume.md
+ * 설명: Hittable 트리로 구성된 BVH 노드를 정의하고 경계 상자 기반 가속 hit 함수와 프레임 간 경계 재맞춤(refit)을 제공한다.
+ *       빌드는 구간 분할(binned) SAH가 기본이며 기존 중앙값 분할도 선택할 수 있다. 스레드 풀을 넘기면 큰 구간의
+ *       경계/구간 집계와 두 자식 서브트리 빌드를 병렬로 수행하되 직렬 빌드와 같은 트리를 만든다.
+ *       hit는 레이 방향에 따라 가까운 자식부터 방문하고 교차 기록 하나에 바로 쓴다.
+ *       공간 분할(SBVH) 모드는 큰 객체의 참조를 분할 평면에서 잘라 양쪽 자식에 나눠 넣는다.
+ *       순회 카운터를 켠 빌드에서는 방문 노드와 검사한 잎 도형 수를 센다. 가림 판정은 처음 찾은 교차에서 멈춘다.
+ *       지연 빌드 모드는 경계만 계산한 객체 구간으로 두었다가 레이가 처음 들어올 때 한 단계씩 나누고, 빌드한 양을 알려 준다.
+ * 버전: v1.24.0
+ * 관련 문서: design/renderer/v0.6.0-bvh.md, design/renderer/v0.9.0-volume.md, design/renderer/v1.9.0-animation.md,
+ *           design/renderer/v1.10.0-sah-build.md, design/renderer/v1.13.0-parallel-build.md,
+ *           design/renderer/v1.14.0-ordered-traversal.md, design/renderer/v1.15.0-sbvh.md,
+ *           design/renderer/v1.17.0-quantized-bvh.md, design/renderer/v1.19.0-bvh-stats.md,
+ *           design/renderer/v1.20.0-occlusion.md, design/renderer/v1.24.0-lazy-bvh.md
  * 테스트: tests/unit/bvh_test.cpp
  */
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "raytracer/aabb.hpp"
 #include "raytracer/hittable.hpp"
+#include "raytracer/vec3.hpp"
 
 namespace raytracer {
 
 class HittableList;
+class ThreadPool;
+
+enum class BvhSplitMethod {
+    // 가장 긴 축에서 경계 상자 최솟값 순으로 정렬해 개수 절반에서 나눈다(v0.6.0 빌더).
+    kMedian,
+    // 무게중심을 축마다 bin_count개 구간에 모아 표면적 휴리스틱 비용이 가장 작은 구간 경계에서 나눈다.
+    kBinnedSah,
+    // kBinnedSah 후보에 공간 분할 후보를 더한다. 객체 분할의 두 자식 상자가 크게 겹치면 노드 경계 상자를 구간으로 나눠
+    // 참조를 평면에서 잘라(Hittable::ClipBox) 양쪽에 넣는 비용도 계산해 더 싼 쪽을 고른다. 스레드 풀을 넘겨도 직렬로 빌드한다.
+    kSpatialSah,
+};
+
+struct BvhBuildOptions {
+    BvhSplitMethod split = BvhSplitMethod::kBinnedSah;
+    // 객체가 이 개수 이하인 구간은 더 나누지 않고 HittableList 잎으로 묶는다. 1이면 잎은 항상 객체 하나다.
+    int max_leaf_size = 1;
+    int bin_count = 16;
+    // kSpatialSah에서 참조 복제로 늘어날 수 있는 참조 수의 상한(객체 수 대비 비율). 0이면 공간 분할을 하지 않는다.
+    double max_reference_growth = 0.25;
+    // 노드를 경계 상자만 계산한 객체 구간으로 두고, 레이가 그 상자에 처음 들어올 때 한 단계만 나눈다(자식은 다시 미뤄 둔다).
+    // 다 나누면 즉시 빌드와 같은 트리가 된다. kSpatialSah와 함께 쓰면 std::invalid_argument를 던진다.
+    bool lazy = false;
+};
+
+// 지연 빌드 트리에서 지금까지 나눈 양. 즉시 빌드한 트리는 모두 0이다.
+struct BvhLazyBuildStats {
+    // 레이가 들어와 두 자식으로 나눈 노드 수.
+    std::size_t built_nodes = 0;
+    // 아직 나누지 않은 노드 수와 그 노드들이 담은 객체 수. 둘 다 0이면 트리 전체가 빌드된 것이다.
+    std::size_t pending_nodes = 0;
+    std::size_t pending_primitives = 0;
+    std::size_t primitive_count = 0;
+};
+
+struct BvhRefitStats {
+    int refitted_nodes = 0;
+    int rebuilt_subtrees = 0;
+};
 
 class BvhNode : public Hittable {
 public:
     BvhNode() = default;
-    BvhNode(std::vector<std::shared_ptr<Hittable>> objects, double time0, double time1);
-    BvhNode(const HittableList& list, double time0, double time1);
+    // max_leaf_size < 1, bin_count < 2, max_reference_growth < 0이면 std::invalid_argument를 던진다.
+    BvhNode(const std::vector<std::shared_ptr<Hittable>>& objects, double time0, double time1,
+            const BvhBuildOptions& options = BvhBuildOptions{});
+    BvhNode(const HittableList& list, double time0, double time1, const BvhBuildOptions& options = BvhBuildOptions{});
+    // pool의 스레드로 빌드한다. 분할 결정은 스레드 수와 무관하므로 같은 옵션의 직렬 빌드와 같은 트리가 나온다.
+    BvhNode(const std::vector<std::shared_ptr<Hittable>>& objects, double time0, double time1,
+            const BvhBuildOptions& options, ThreadPool& pool);
+    BvhNode(const HittableList& list, double time0, double time1, const BvhBuildOptions& options, ThreadPool& pool);
 
-    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const override;
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override;
+    bool Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const override;
     bool BoundingBox(double time0, double time1, Aabb& output_box) const override;
 
+    // 객체 위치/자세만 바뀌었을 때 트리 구조를 유지한 채 경계 상자를 잎에서 뿌리 방향으로 다시 계산한다.
+    // 서브트리의 면적 비용(내부 노드 표면적 합 / 서브트리 표면적)이 빌드 당시보다 rebuild_threshold배를 넘으면
+    // 그 서브트리만 같은 빌드 옵션으로 다시 빌드한다. 렌더 중에는 호출하면 안 된다. rebuild_threshold < 1이면 std::invalid_argument.
+    // kSpatialSah 트리는 잘린 상자가 움직인 객체를 감싼다는 보장이 없으므로 재맞춤 대신 전체를 다시 빌드한다.
+    // 지연 빌드 트리는 나눈 부분을 버리고 뿌리부터 다시 지연 빌드한다(rebuilt_subtrees = 1).
+    BvhRefitStats Refit(double time0, double time1, double rebuild_threshold);
+
+    // 지연 빌드 중인 노드를 모두 나눈다. 트리 전체를 읽는 평탄화/넓은 BVH/품질 지표가 먼저 부른다. 렌더 중에 불러도 된다.
+    void BuildAll() const;
+    BvhLazyBuildStats LazyBuildStats() const;
+
 private:
-    BvhNode(std::vector<std::shared_ptr<Hittable>>& objects, size_t start, size_t end, double time0, double time1);
+    // 빌드 동안 객체마다 한 번만 계산해 두는 경계 상자와 무게중심.
+    struct BuildPrimitive {
+        std::shared_ptr<Hittable> object;
+        Aabb box;
+        Point3 centroid;
+        // 공간 분할로 box가 객체 경계 상자보다 작아졌는지. 잎에서 잘린 상자를 유지하는 참조로 감싼다.
+        bool clipped = false;
+    };
+
+    // 공간 분할 빌드 동안 공유하는 셔터 구간, 뿌리 표면적, 남은 참조 복제 수.
+    struct SpatialBuildState {
+        double time0 = 0.0;
+        double time1 = 0.0;
+        double root_area = 0.0;
+        size_t remaining_references = 0;
+    };
+
+    // 지연 빌드 트리 전체가 공유하는 객체 배열과 진행 카운터. 노드마다 겹치지 않는 구간만 재배열하므로
+    // 서로 다른 노드를 동시에 나눠도 된다.
+    struct LazyBuild {
+        // 재맞춤 때 같은 입력 순서로 다시 빌드하려고 처음 받은 순서를 남긴다.
+        std::vector<std::shared_ptr<Hittable>> objects;
+        std::vector<BuildPrimitive> primitives;
+        std::atomic<std::size_t> built_nodes{0};
+        std::atomic<std::size_t> pending_nodes{0};
+        std::atomic<std::size_t> pending_primitives{0};
+    };
+
+    // 아직 나누지 않은 노드의 구간. once는 여러 스레드의 레이가 동시에 들어와도 한 번만 나누게 한다.
+    struct LazyRange {
+        std::shared_ptr<LazyBuild> build;
+        size_t start = 0;
+        size_t end = 0;
+        std::once_flag once;
+    };
 
-    void Build(std::vector<std::shared_ptr<Hittable>>& objects, size_t start, size_t end, double time0, double time1);
-    static std::vector<std::shared_ptr<Hittable>> CopyObjects(const std::vector<std::shared_ptr<Hittable>>& source);
-    static bool BoxComparator(const std::shared_ptr<Hittable>& a, const std::shared_ptr<Hittable>& b, int axis,
-                              double time0, double time1);
-    static int ChooseSplitAxis(const std::vector<std::shared_ptr<Hittable>>& objects, size_t start, size_t end,
-                               double time0, double time1);
+    enum class ChildKind {
+        kObject,
+        // 이 빌드가 만든 내부 노드.
+        kNode,
+        // 이 빌드가 max_leaf_size 이하 객체를 묶어 만든 HittableList.
+        kLeafList,
+    };
+
+    // pool이 nullptr이면 호출 스레드에서만 빌드한다.
+    BvhNode(const std::vector<std::shared_ptr<Hittable>>& objects, double time0, double time1,
+            const BvhBuildOptions& options, ThreadPool* pool);
+    BvhNode(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, const BvhBuildOptions& options,
+            ThreadPool* pool);
+    BvhNode(std::vector<BuildPrimitive> references, const BvhBuildOptions& options, SpatialBuildState& state);
+    // 지연 노드. 구간의 경계 상자만 계산한다.
+    BvhNode(std::shared_ptr<LazyBuild> build, size_t start, size_t end, const BvhBuildOptions& options);
+
+    static std::vector<BuildPrimitive> MakePrimitives(const std::vector<std::shared_ptr<Hittable>>& objects, double time0,
+                                                      double time1, ThreadPool* pool);
+    void Build(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, ThreadPool* pool);
+    // box_를 계산한 뒤 구간을 두 자식으로 나눈다. 지연 노드에서 부르면 큰 자식은 다시 지연 노드가 된다.
+    void Split(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, size_t chunk_count, ThreadPool* pool);
+    // 지연 노드면 처음 한 번만 나눈다. 다른 스레드가 나누는 중이면 끝날 때까지 기다린다.
+    void EnsureBuilt() const {
+        if (lazy_) {
+            std::call_once(lazy_->once, [this] { const_cast<BvhNode*>(this)->BuildLazy(); });
+        }
+    }
+    void BuildLazy();
+    static size_t SplitMedian(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, const Aabb& bounds);
+    static size_t SplitBinnedSah(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, int bin_count,
+                                 ThreadPool* pool);
+    std::shared_ptr<Hittable> MakeChild(std::vector<BuildPrimitive>& primitives, size_t start, size_t end,
+                                        ChildKind& kind, ThreadPool* pool) const;
+    void BuildSpatial(std::vector<BuildPrimitive> references, SpatialBuildState& state);
+    std::shared_ptr<Hittable> MakeSpatialChild(std::vector<BuildPrimitive> references, ChildKind& kind,
+                                               SpatialBuildState& state) const;
+
+    void UpdateBounds(double time0, double time1);
+    void UpdateVisitOrder(const Aabb& left_box, const Aabb& right_box);
+    void UpdateAreaSum();
+    void RefitBounds(double time0, double time1, BvhRefitStats& stats);
+    void RebuildDegraded(double time0, double time1, double rebuild_threshold, BvhRefitStats& stats);
+    void CollectObjects(std::vector<std::shared_ptr<Hittable>>& objects) const;
+    double AreaCost() const;
+    // 이 자식의 Hit가 직접 검사하는 기본 도형 수(내부 노드 0, 객체 1, 잎 목록은 목록 크기). 순회 카운터용이다.
+    static std::size_t LeafTestCount(const Hittable& child, ChildKind kind);
 
     std::shared_ptr<Hittable> left_;
     std::shared_ptr<Hittable> right_;
+    // 자식 종류. 잎 객체로 들어온 BvhNode/HittableList와 구분해 재맞춤·재구성 범위를 정한다.
+    ChildKind left_kind_ = ChildKind::kObject;
+    ChildKind right_kind_ = ChildKind::kObject;
     Aabb box_;
+    // 두 자식 중심이 가장 멀리 떨어진 축과 그 축에서 왼쪽 자식 중심이 더 작은지. 레이 방향 부호로 먼저 방문할 자식을 고른다.
+    int order_axis_ = 0;
+    bool left_is_lower_ = true;
+    // 서브트리 내부 노드들의 표면적 합과 마지막 빌드 시점의 면적 비용.
+    double area_sum_ = 0.0;
+    double build_cost_ = 1.0;
+    BvhBuildOptions options_;
+    // 지연 빌드 트리의 노드만 갖는다. 나눈 뒤에도 남겨 두어 읽는 스레드가 once로 동기화되게 한다.
+    std::unique_ptr<LazyRange> lazy_;
+
+    // 트리 구조를 그대로 읽어 평탄화하거나 넓은 노드로 접는다.
+    friend class LinearBvh;
+    friend class MotionBvh;
+    template <int Width>
+    friend class WideBvh;
+    template <int Bits>
+    friend class QuantizedBvh;
+    // 품질 지표를 계산하려고 자식 종류를 읽는다.
+    friend class BvhInspector;
 };
 
 }  // namespace raytracer
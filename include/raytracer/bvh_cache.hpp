@@ -0,0 +1,50 @@
+/*
+ * 설명: 빌드한 8칸 넓은 BVH의 노드 배열과 잎 객체 인덱스를 버전이 붙은 이진 파일로 기록하고, 장면 내용과 빌드 옵션의
+ *       해시가 맞으면 파일을 mmap해 다시 빌드하지 않고 순회 구조를 복원한다.
+ * 버전: v1.18.0
+ * 관련 문서: design/renderer/v1.18.0-bvh-cache.md
+ * 테스트: tests/unit/bvh_cache_test.cpp
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "raytracer/bvh.hpp"
+#include "raytracer/hittable.hpp"
+#include "raytracer/wide_bvh.hpp"
+
+namespace raytracer {
+
+// 트리는 객체 경계 상자 열과 빌드 옵션만으로 정해지므로, 객체 수와 [time0, time1] 경계 상자, 셔터 구간, 옵션,
+// 캐시 형식 버전을 64비트로 해시한 값을 캐시 키로 쓴다. 재질처럼 경계에 영향이 없는 변경은 키를 바꾸지 않는다.
+// 공간 분할(kSpatialSah) 트리는 잘린 참조를 담아 객체 인덱스로 표현할 수 없으므로 std::invalid_argument를 던진다.
+std::uint64_t BvhCacheKey(const std::vector<std::shared_ptr<Hittable>>& objects, double time0, double time1,
+                          const BvhBuildOptions& options = BvhBuildOptions{});
+
+// bvh의 노드 배열을 그대로, 잎 객체는 objects 안의 인덱스로 기록한다. 임시 파일에 쓴 뒤 이름을 바꾼다.
+// 잎 객체가 objects에 없으면 std::invalid_argument, 기록에 실패하면 std::runtime_error를 던진다.
+void SaveBvhCache(const std::string& path, const Bvh8& bvh, const std::vector<std::shared_ptr<Hittable>>& objects,
+                  std::uint64_t key);
+
+// 파일을 읽기 전용으로 mmap하고 노드 배열을 복사 없이 쓰는 Bvh8을 반환한다. 파일이 없거나, 형식 버전·바이트 순서·키가
+// 다르거나, 노드 참조/잎 범위/파일 크기가 맞지 않으면 nullptr을 반환한다(호출자가 다시 빌드한다).
+std::shared_ptr<Bvh8> LoadBvhCache(const std::string& path, const std::vector<std::shared_ptr<Hittable>>& objects,
+                                   std::uint64_t key);
+
+struct BvhCacheResult {
+    std::shared_ptr<Bvh8> bvh;
+    // 캐시에서 읽었으면 true, 새로 빌드했으면 false.
+    bool loaded = false;
+    // 새로 빌드한 트리를 캐시에 기록하지 못했을 때의 오류 메시지. 기록했거나 캐시에서 읽었으면 비어 있다.
+    std::string save_error;
+};
+
+// 캐시가 유효하면 읽고, 아니면 빌드한 뒤 캐시를 새로 기록한다. 캐시는 최적화일 뿐이므로 경로에 쓸 수 없거나 디스크가
+// 가득 차 기록에 실패해도 빌드한 트리를 돌려주고, 실패 이유는 save_error에 남긴다.
+BvhCacheResult LoadOrBuildBvh(const std::string& path, const std::vector<std::shared_ptr<Hittable>>& objects,
+                              double time0, double time1, const BvhBuildOptions& options = BvhBuildOptions{});
+
+}  // namespace raytracer
@@ -0,0 +1,103 @@
+/*
+ * 설명: BVH 트리 품질 지표(노드/잎 수, 깊이별 잎 분포, SAH 비용, 잎 크기 분포, 형제 상자 겹침 비율)를 계산해 텍스트로 정리하고,
+ *       빌드 옵션으로 켜는 순회 카운터(레이 수, 방문 노드 수, 검사한 기본 도형 수)를 스레드별로 모아 렌더 단위로 합산한다.
+ *       카운터를 끄면(기본) 계수 매크로는 빈 문장이 되어 순회 코드에 아무것도 남지 않는다.
+ *       레이 묶음 순회에서 단일 순회로 떨어져 나온 레이 수도 센다.
+ * 버전: v1.21.0
+ * 관련 문서: design/renderer/v1.19.0-bvh-stats.md, design/renderer/v1.21.0-ray-packets.md
+ * 테스트: tests/unit/bvh_stats_test.cpp
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "raytracer/bvh.hpp"
+#include "raytracer/wide_bvh.hpp"
+
+namespace raytracer {
+
+// 잎은 더 내려가지 않는 자식 하나다. 이진 트리는 객체 하나 또는 HittableList 잎 목록, 넓은 BVH는 잎 칸 하나가 잎이다.
+// 잎 객체가 다시 BVH(인스턴스의 BLAS 등)여도 그 안으로 내려가지 않고 기본 도형 하나로 센다.
+struct BvhStats {
+    std::size_t node_count = 0;
+    std::size_t leaf_count = 0;
+    // 잎들이 담은 기본 도형 참조 수의 합. 공간 분할 트리에서는 객체 수보다 클 수 있다.
+    std::size_t primitive_references = 0;
+    // leaves_per_depth[d]는 뿌리 노드에서 d단계 아래(뿌리의 자식이 1)에 있는 잎 수다.
+    std::vector<std::size_t> leaves_per_depth;
+    // leaf_sizes[n]은 기본 도형 n개를 담은 잎 수다.
+    std::vector<std::size_t> leaf_sizes;
+    // 노드 순회 비용 1, 도형 검사 비용 1로 둔 표면적 휴리스틱 비용:
+    // (내부 노드 표면적 합 + 잎마다 표면적 x 도형 수의 합) / 뿌리 표면적. 임의 방향 레이 하나의 기대 검사 횟수에 해당한다.
+    double sah_cost = 0.0;
+    // 내부 노드마다 자식 상자 쌍의 교집합 표면적을 더한 값을 내부 노드 표면적 합으로 나눈다. 0이면 형제 상자가 겹치지 않는다.
+    double sibling_overlap_ratio = 0.0;
+};
+
+// 이진 트리의 잎 객체 경계는 [time0, time1] 구간으로 계산한다(tree 빌드 구간과 같아야 한다).
+BvhStats InspectBvh(const BvhNode& tree, double time0, double time1);
+// 넓은 BVH는 노드에 저장된 float 경계로 계산한다.
+BvhStats InspectBvh(const Bvh4& bvh);
+BvhStats InspectBvh(const Bvh8& bvh);
+
+// 사람이 읽는 여러 줄 텍스트(각 줄은 두 칸 들여쓰기, 줄바꿈으로 끝남)로 정리한다.
+std::string FormatBvhStats(const BvhStats& stats);
+
+struct BvhTraversalCounters {
+    // 넓은 BVH 순회를 시작한 레이 수(묶음은 묶음 안 레이 수만큼).
+    std::uint64_t rays = 0;
+    // 상자 판정을 한 내부 노드 수(BvhNode::Hit 호출 또는 넓은 BVH 노드 하나).
+    std::uint64_t nodes_visited = 0;
+    // 잎에서 Hit를 호출한 기본 도형 수.
+    std::uint64_t primitives_tested = 0;
+    // 레이 묶음 순회에서 자식 순서가 묶음과 어긋나 단일 순회로 떨어져 나온 레이 수.
+    std::uint64_t packet_detached_rays = 0;
+};
+
+#if defined(RAYTRACER_BVH_COUNTERS)
+constexpr bool kBvhCountersEnabled = true;
+#else
+constexpr bool kBvhCountersEnabled = false;
+#endif
+
+// 프로세스 안 모든 스레드(종료한 스레드 포함)의 카운터 합. 카운터를 끈 빌드에서는 항상 0이다.
+BvhTraversalCounters ReadBvhCounters();
+// 렌더 단위로 합산하려면 렌더 전에 0으로 되돌린다. 렌더 중에 호출하면 진행 중인 계수와 섞인다.
+void ResetBvhCounters();
+
+#if defined(RAYTRACER_BVH_COUNTERS)
+namespace detail {
+
+// 주인 스레드만 쓰고 합산할 때만 다른 스레드가 읽으므로 relaxed 읽기·쓰기(잠금 없는 보통 덧셈)로 충분하다.
+struct BvhCounterSlot {
+    std::atomic<std::uint64_t> rays{0};
+    std::atomic<std::uint64_t> nodes_visited{0};
+    std::atomic<std::uint64_t> primitives_tested{0};
+    std::atomic<std::uint64_t> packet_detached_rays{0};
+};
+
+// 스레드마다 처음 부를 때 전역 목록에 칸을 등록한다. 칸은 스레드가 끝나도 합산을 위해 남긴다.
+BvhCounterSlot* RegisterBvhCounterSlot();
+
+inline BvhCounterSlot& ThreadBvhCounters() {
+    thread_local BvhCounterSlot* slot = RegisterBvhCounterSlot();
+    return *slot;
+}
+
+inline void AddBvhCount(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+}  // namespace detail
+
+#define RAYTRACER_BVH_COUNT(field, amount) \
+    ::raytracer::detail::AddBvhCount(::raytracer::detail::ThreadBvhCounters().field, (amount))
+#else
+#define RAYTRACER_BVH_COUNT(field, amount) ((void)0)
+#endif
+
+}  // namespace raytracer
@@ -1,14 +1,15 @@
 /*
- * 설명: defocus blur와 셔터 시간을 포함한 카메라에서 레이를 생성한다.
- * 버전: v0.5.0
- * 관련 문서: design/renderer/v0.5.0-blur.md
+ * 설명: defocus blur와 셔터 시간을 포함한 카메라에서 레이를 생성하고, 핀홀 카메라에서는 화면 영역의 레이 다발을 감싸는
+ *       절두체를 만든다.
+ * 버전: v1.23.0
+ * 관련 문서: design/renderer/v0.5.0-blur.md, design/renderer/v1.23.0-tile-culling.md
  * 테스트: tests/integration/ppm_integration_test.cpp
  */
 #pragma once
 
 #include <cmath>
-#include <random>
 
+#include "raytracer/frustum.hpp"
 #include "raytracer/random.hpp"
 #include "raytracer/ray.hpp"
 
@@ -38,13 +39,27 @@ public:
         lower_left_corner_ = origin_ - horizontal_ / 2.0 - vertical_ / 2.0 - focus_dist * w_;
     }
 
-    Ray GetRay(double s, double t, std::mt19937& generator) const {
+    Ray GetRay(double s, double t, Rng& generator) const {
         const Vec3 rd = lens_radius_ * RandomInUnitDisk(generator);
         const Vec3 offset = u_ * rd.x() + v_ * rd.y();
         const double time = RandomDouble(generator, time0_, time1_);
         return Ray(origin_ + offset, lower_left_corner_ + s * horizontal_ + t * vertical_ - origin_ - offset, time);
     }
 
+    // GetRay(s, t)에서 s ∈ [s0, s1], t ∈ [t0, t1]인 레이가 모두 지나는 절두체를 frustum에 쓴다. 렌즈 반경이 0이 아니면
+    // 레이가 렌즈 여러 점에서 나가 한 꼭짓점 절두체로 감쌀 수 없으므로 false를 반환한다.
+    bool RegionFrustum(double s0, double s1, double t0, double t1, Frustum& frustum) const {
+        if (lens_radius_ != 0.0) {
+            return false;
+        }
+        const auto direction = [this](double s, double t) {
+            return lower_left_corner_ + s * horizontal_ + t * vertical_ - origin_;
+        };
+        const Vec3 corners[4] = {direction(s0, t0), direction(s1, t0), direction(s1, t1), direction(s0, t1)};
+        frustum = Frustum::FromCorners(origin_, corners);
+        return true;
+    }
+
 private:
     Point3 origin_;
     Vec3 u_;
@@ -0,0 +1,35 @@
+/*
+ * 설명: 점진 렌더링의 누적 버퍼와 완료 패스 수를 텍스트 체크포인트로 저장하고 복원한다.
+ * 버전: v1.2.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.2.0-progressive.md
+ * 테스트: tests/integration/ppm_integration_test.cpp
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "raytracer/framebuffer.hpp"
+
+namespace raytracer {
+
+// 샘플 시드는 (seed, 픽셀, 샘플 인덱스)로만 결정되므로 seed와 completed_passes가 곧 RNG 상태다.
+struct Checkpoint {
+    int width = 0;
+    int height = 0;
+    std::uint32_t seed = 0;
+    int max_depth = 0;
+    // 같은 시드라도 카메라가 다르면 다른 이미지이므로, 재개 때 함께 비교한다.
+    double vertical_fov_degrees = 0.0;
+    double aperture = 0.0;
+    double shutter_open_time = 0.0;
+    double shutter_close_time = 0.0;
+    int completed_passes = 0;
+    Framebuffer accumulation;
+};
+
+// 임시 파일에 기록한 뒤 이름을 바꿔, 기록 도중 프로세스가 종료돼도 이전 체크포인트가 남도록 한다.
+void SaveCheckpoint(const std::string& path, const Checkpoint& checkpoint);
+Checkpoint LoadCheckpoint(const std::string& path);
+
+}  // namespace raytracer
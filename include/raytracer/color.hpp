@@ -0,0 +1,33 @@
+/*
+ * 설명: 선형 평균 색을 감마 보정·클램프·반올림해 8비트 채널로 바꾸는 색상 기록 정책을 한곳에 모은다.
+ * 버전: v1.3.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.3.0-shards.md
+ * 테스트: tests/integration/ppm_integration_test.cpp
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "raytracer/vec3.hpp"
+
+namespace raytracer {
+
+struct Rgb8 {
+    int r = 0;
+    int g = 0;
+    int b = 0;
+};
+
+inline int ToChannel(double value) {
+    const double clamped = std::clamp(value, 0.0, 0.999);
+    return std::clamp(static_cast<int>(std::lround(255.0 * clamped)), 0, 255);
+}
+
+// gamma=2.0 보정(sqrt) 후 [0, 0.999] 클램프, round(255 * c)로 채널 값을 만든다.
+inline Rgb8 QuantizeColor(const Color& averaged_color) {
+    return Rgb8{ToChannel(std::sqrt(averaged_color.x())), ToChannel(std::sqrt(averaged_color.y())),
+                ToChannel(std::sqrt(averaged_color.z()))};
+}
+
+}  // namespace raytracer
@@ -7,7 +7,6 @@
 #pragma once
 
 #include <memory>
-#include <random>
 
 #include "raytracer/hittable.hpp"
 #include "raytracer/material.hpp"
@@ -20,7 +19,7 @@ public:
     ConstantMedium(std::shared_ptr<Hittable> boundary, double density, std::shared_ptr<Texture> texture);
     ConstantMedium(std::shared_ptr<Hittable> boundary, double density, const Color& albedo);
 
-    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const override;
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override;
     bool BoundingBox(double time0, double time1, Aabb& output_box) const override;
 
 private:
@@ -0,0 +1,38 @@
+/*
+ * 설명: 픽셀별 샘플 색상 합을 보관하는 프레임버퍼를 정의한다.
+ * 버전: v1.1.0
+ * 관련 문서: design/renderer/v1.1.0-tile-threads.md
+ * 테스트: tests/integration/ppm_integration_test.cpp
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "raytracer/vec3.hpp"
+
+namespace raytracer {
+
+class Framebuffer {
+public:
+    Framebuffer() = default;
+    Framebuffer(int width, int height)
+        : width_(width), height_(height), pixels_(static_cast<std::size_t>(width) * static_cast<std::size_t>(height)) {}
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    Color& At(int x, int y) { return pixels_[Index(x, y)]; }
+    const Color& At(int x, int y) const { return pixels_[Index(x, y)]; }
+
+private:
+    std::size_t Index(int x, int y) const {
+        return static_cast<std::size_t>(y) * static_cast<std::size_t>(width_) + static_cast<std::size_t>(x);
+    }
+
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<Color> pixels_;
+};
+
+}  // namespace raytracer
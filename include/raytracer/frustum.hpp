@@ -0,0 +1,59 @@
+/*
+ * 설명: 한 점에서 나가는 레이 다발(예: 핀홀 카메라의 한 타일 화면 레이)을 감싸는 옆 평면 4개짜리 절두체와,
+ *       상자가 절두체 밖에 완전히 있는지 보수적으로 판정하는 검사를 정의한다.
+ * 버전: v1.23.0
+ * 관련 문서: design/renderer/v1.23.0-tile-culling.md
+ * 테스트: tests/unit/bvh_test.cpp
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "raytracer/vec3.hpp"
+
+namespace raytracer {
+
+// 꼭짓점 apex를 지나는 평면 4개의 안쪽(법선 방향) 교집합. 앞뒤를 자르는 평면은 없다.
+// 법선 길이가 0인 평면(폭이 0인 다발의 옆면)은 아무것도 잘라 내지 않는다.
+struct Frustum {
+    Point3 apex;
+    Vec3 normals[4];
+
+    // 네 모서리 방향을 반시계(또는 시계) 순서로 받아 이웃한 두 방향이 만드는 평면을 다발 중심 쪽을 향하게 세운다.
+    static Frustum FromCorners(const Point3& apex, const Vec3 (&corners)[4]) {
+        Frustum frustum;
+        frustum.apex = apex;
+        const Vec3 center = corners[0] + corners[1] + corners[2] + corners[3];
+        for (int i = 0; i < 4; ++i) {
+            Vec3 normal = Cross(corners[i], corners[(i + 1) % 4]);
+            const double length = normal.length();
+            normal = length > 0.0 ? normal / length : Vec3(0.0, 0.0, 0.0);
+            frustum.normals[i] = Dot(normal, center) < 0.0 ? -normal : normal;
+        }
+        return frustum;
+    }
+
+    // 상자 [minimum, maximum]가 어느 한 평면의 바깥쪽에 완전히 있으면 true다. 상자에 닿는 레이의 부동소수 판정이
+    // 경계에서 흔들려도 잘못 잘라 내지 않도록, 평면에서 apex까지 거리에 비례한 여유 안쪽은 밖으로 보지 않는다.
+    bool Excludes(const Point3& minimum, const Point3& maximum) const {
+        for (const Vec3& normal : normals) {
+            double distance = 0.0;
+            double scale = 1.0;
+            for (int axis = 0; axis < 3; ++axis) {
+                // 법선 방향으로 가장 멀리 나간 꼭짓점이 밖이면 상자 전체가 밖이다.
+                const double corner = normal[axis] >= 0.0 ? maximum[axis] : minimum[axis];
+                distance += normal[axis] * (corner - apex[axis]);
+                scale = std::max(scale, std::fabs(corner - apex[axis]));
+            }
+            if (distance < -kMargin * scale) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static constexpr double kMargin = 1e-7;
+};
+
+}  // namespace raytracer
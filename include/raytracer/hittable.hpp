@@ -1,20 +1,31 @@
 /*
  * 설명: 레이와 물체의 교차 정보를 표현하고 샘플링 PDF를 제공하는 추상 인터페이스를 정의한다.
- * 버전: v1.0.0
- * 관련 문서: design/renderer/v1.0.0-overview.md
- * 테스트: tests/unit/sphere_test.cpp, tests/unit/bvh_test.cpp, tests/unit/pdf_test.cpp
+ *       공간 분할 BVH를 위해 영역 안 표면만 감싸는 상자(ClipBox)를 선택적으로 제공한다.
+ *       그림자·가시성 레이용으로 교차 기록 없이 교차 여부만 답하는 Occluded와, 화면 레이 여러 개를 한 번에 순회하는
+ *       HitPacket을 제공한다. 가속 구조는 한 절두체 안 레이만 순회할 부분 구조(CullFrustum)를 선택적으로 제공한다.
+ *       모션 BVH를 위해 셔터 양 끝 경계 상자(MotionBounds)를 제공한다.
+ * 버전: v1.25.0
+ * 관련 문서: design/renderer/v1.0.0-overview.md, design/renderer/v1.15.0-sbvh.md, design/renderer/v1.20.0-occlusion.md,
+ *           design/renderer/v1.21.0-ray-packets.md, design/renderer/v1.23.0-tile-culling.md,
+ *           design/renderer/v1.25.0-motion-bvh.md
+ * 테스트: tests/unit/sphere_test.cpp, tests/unit/quad_test.cpp, tests/unit/bvh_test.cpp, tests/unit/pdf_test.cpp
  */
 #pragma once
 
+#include <cstdint>
 #include <memory>
-#include <random>
 
 #include "raytracer/aabb.hpp"
+#include "raytracer/random.hpp"
 #include "raytracer/ray.hpp"
 
 namespace raytracer {
 
 class Material;
+struct Frustum;
+
+// HitPacket 한 번에 넘길 수 있는 최대 레이 수. 결과 비트마스크 하나에 들어간다.
+constexpr int kMaxPacketSize = 16;
 
 struct HitRecord {
     Point3 p;
@@ -34,18 +45,64 @@ struct HitRecord {
 class Hittable {
 public:
     virtual ~Hittable() = default;
-    virtual bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const = 0;
+    virtual bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const = 0;
     virtual bool BoundingBox(double time0, double time1, Aabb& output_box) const = 0;
+    // 셔터 구간 [time0, time1] 안 시각 t의 객체를 box0과 box1을 (t - time0) / (time1 - time0)로 선형 보간한 상자가
+    // 감싸도록 두 끝 상자를 쓴다. 기본 구현은 구간 전체 경계를 양 끝에 똑같이 쓴다(항상 맞지만 움직이는 객체에는 느슨하다).
+    virtual bool MotionBounds(double time0, double time1, Aabb& box0, Aabb& box1) const {
+        if (!BoundingBox(time0, time1, box0)) {
+            return false;
+        }
+        box1 = box0;
+        return true;
+    }
+    // [t_min, t_max] 안에 교차가 하나라도 있으면 true다. 가장 가까운 교차를 찾지 않고 처음 찾은 교차에서 멈추며,
+    // 교차 기록(위치, 법선, UV, 재질)을 만들지 않는다. 기본 구현은 Hit로 판정하므로 볼륨처럼 난수를 쓰는 객체는 Hit와
+    // 같은 난수를 소비한다. 재정의하면 같은 레이·구간에서 Hit와 같은 참/거짓을 내야 한다.
+    virtual bool Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const {
+        HitRecord record;
+        return Hit(r, t_min, t_max, record, generator);
+    }
+    // rays[i]마다 Hit(rays[i], t_min, t_max, records[i], generators[i])를 부른 것과 같은 기록·난수 상태를 남기고,
+    // 교차한 레이를 비트 i로 돌려준다(1 <= count <= kMaxPacketSize). 기본 구현은 레이마다 Hit를 부른다.
+    virtual std::uint32_t HitPacket(const Ray* rays, int count, double t_min, double t_max, HitRecord* records,
+                                    Rng* generators) const {
+        std::uint32_t hits = 0;
+        for (int i = 0; i < count; ++i) {
+            if (Hit(rays[i], t_min, t_max, records[i], generators[i])) {
+                hits |= 1u << i;
+            }
+        }
+        return hits;
+    }
+    // frustum 꼭짓점에서 나가 frustum 안을 지나는 레이에게 이 객체와 같은 Hit/HitPacket/Occluded 결과·난수 소비를 주면서
+    // 더 싸게 순회하는 부분 구조를 돌려준다. 반환 객체는 this보다 오래 쓰면 안 된다. 기본 구현은 nullptr(이 객체를 그대로 쓴다)이다.
+    virtual std::unique_ptr<Hittable> CullFrustum(const Frustum& frustum) const {
+        (void)frustum;
+        return nullptr;
+    }
+
     virtual double PdfValue(const Point3& origin, const Vec3& direction) const {
         (void)origin;
         (void)direction;
         return 0.0;
     }
-    virtual Vec3 Random(const Point3& origin, std::mt19937& generator) const {
+    virtual Vec3 Random(const Point3& origin, Rng& generator) const {
         (void)origin;
         (void)generator;
         return Vec3(1.0, 0.0, 0.0);
     }
+    // 표면 중 region 안에 드는 부분을 감싸는 상자를 output_box에 쓴다. 그런 부분이 없으면 최솟값이 최댓값보다 큰
+    // 빈 상자를 쓴다. 결과는 보수적이어야 한다(잘린 표면을 빠짐없이 감싸야 한다). 기본 구현은 false를 반환해
+    // 공간 분할 BVH가 이 객체를 쪼개지 않게 한다. 교차 판정이 난수를 쓰는 볼륨처럼 같은 레이로 두 번 검사하면
+    // 결과가 달라지는 객체는 구현하면 안 된다.
+    virtual bool ClipBox(double time0, double time1, const Aabb& region, Aabb& output_box) const {
+        (void)time0;
+        (void)time1;
+        (void)region;
+        (void)output_box;
+        return false;
+    }
 };
 
 }  // namespace raytracer
@@ -1,7 +1,8 @@
 /*
  * 설명: 여러 개의 물체를 순회하며 RNG를 전달해 가장 가까운 교차를 찾고 PDF 샘플링에 필요한 정보를 제공한다.
- * 버전: v1.0.0
- * 관련 문서: design/renderer/v1.0.0-overview.md
+ *       가림 판정은 처음 가리는 물체에서 멈춘다.
+ * 버전: v1.20.0
+ * 관련 문서: design/renderer/v1.0.0-overview.md, design/renderer/v1.20.0-occlusion.md
  * 테스트: tests/unit/sphere_test.cpp, tests/unit/bvh_test.cpp, tests/unit/pdf_test.cpp
  */
 #pragma once
@@ -25,7 +26,7 @@ public:
 
     void Add(std::shared_ptr<Hittable> object) { objects_.push_back(std::move(object)); }
 
-    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const override {
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override {
         HitRecord temp_record;
         bool hit_anything = false;
         double closest_so_far = t_max;
@@ -41,6 +42,15 @@ public:
         return hit_anything;
     }
 
+    bool Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const override {
+        for (const auto& object : objects_) {
+            if (object->Occluded(r, t_min, t_max, generator)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     bool BoundingBox(double time0, double time1, Aabb& output_box) const override {
         if (objects_.empty()) {
             return false;
@@ -75,7 +85,7 @@ public:
         return sum / static_cast<double>(objects_.size());
     }
 
-    Vec3 Random(const Point3& origin, std::mt19937& generator) const override {
+    Vec3 Random(const Point3& origin, Rng& generator) const override {
         if (objects_.empty()) {
             return Vec3(1.0, 0.0, 0.0);
         }
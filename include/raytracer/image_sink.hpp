@@ -0,0 +1,49 @@
+/*
+ * 설명: 렌더러가 완성된 행을 위에서 아래로 넘겨주는 이미지 싱크와 PPM(P3/P6) 스트림 기록기를 정의한다.
+ * 버전: v1.4.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.4.0-streaming-output.md
+ * 테스트: tests/unit/image_sink_test.cpp, tests/integration/ppm_integration_test.cpp
+ */
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "raytracer/color.hpp"
+
+namespace raytracer {
+
+enum class PpmFormat {
+    kAscii,   // P3
+    kBinary,  // P6
+};
+
+// Begin → 행 y=0..height-1마다 WriteRow → End 순서로 호출된다. 행은 width개의 8비트 색을 담는다.
+class ImageSink {
+public:
+    virtual ~ImageSink() = default;
+    virtual void Begin(int width, int height) = 0;
+    virtual void WriteRow(int y, const std::vector<Rgb8>& row) = 0;
+    virtual void End() = 0;
+};
+
+// 행마다 재사용 버퍼에 std::to_chars로 서식화해 스트림에 바로 기록한다. 스트림 오류는 std::runtime_error로 던진다.
+class PpmStreamWriter : public ImageSink {
+public:
+    PpmStreamWriter(std::ostream& output, PpmFormat format);
+
+    void Begin(int width, int height) override;
+    void WriteRow(int y, const std::vector<Rgb8>& row) override;
+    void End() override;
+
+private:
+    void Flush();
+
+    std::ostream& output_;
+    PpmFormat format_;
+    int width_ = 0;
+    std::string buffer_;
+};
+
+}  // namespace raytracer
@@ -0,0 +1,64 @@
+/*
+ * 설명: 공유 하위 BVH(BLAS)를 아핀 변환으로 배치하는 인스턴스와 그 변환을 정의한다. 인스턴스들을 BvhNode/Bvh8로 묶으면
+ *       상위 구조(TLAS)가 되어, 같은 물체를 여러 번 배치해도 기하는 한 벌만 메모리에 둔다.
+ * 버전: v1.20.0
+ * 관련 문서: design/renderer/v1.16.0-instancing.md, design/renderer/v1.20.0-occlusion.md
+ * 테스트: tests/unit/instance_test.cpp
+ */
+#pragma once
+
+#include <memory>
+
+#include "raytracer/aabb.hpp"
+#include "raytracer/hittable.hpp"
+#include "raytracer/vec3.hpp"
+
+namespace raytracer {
+
+// 3x3 선형 부분과 이동 벡터로 이루어진 아핀 변환. 기본값은 항등 변환이다.
+class AffineTransform {
+public:
+    AffineTransform() = default;
+
+    static AffineTransform Translation(const Vec3& offset);
+    // RotateY와 같은 방향(+y에서 내려다볼 때 반시계)으로 돈다.
+    static AffineTransform RotationY(double angle_degrees);
+    static AffineTransform Scaling(const Vec3& factors);
+
+    // 이 변환을 먼저 적용한 뒤 next를 적용하는 변환을 반환한다.
+    AffineTransform Then(const AffineTransform& next) const;
+    // 선형 부분이 특이 행렬이면 std::invalid_argument를 던진다.
+    AffineTransform Inverse() const;
+
+    Point3 ApplyPoint(const Point3& p) const;
+    Vec3 ApplyVector(const Vec3& v) const;
+    // 선형 부분의 전치를 곱한다. 역변환에 쓰면 법선 변환(역전치)이 된다.
+    Vec3 ApplyTransposedVector(const Vec3& v) const;
+
+private:
+    double m_[3][4] = {{1.0, 0.0, 0.0, 0.0}, {0.0, 1.0, 0.0, 0.0}, {0.0, 0.0, 1.0, 0.0}};
+};
+
+// 물체 좌표의 blas를 object_to_world로 배치한다. 레이는 인스턴스에 들어올 때 한 번만 물체 좌표로 바꾸고,
+// 방향을 정규화하지 않으므로 교차 거리 t는 월드 레이 기준 그대로다. 여러 인스턴스가 같은 blas를 공유한다.
+// 광원 샘플링(PdfValue/Random)은 제공하지 않는다.
+class Instance : public Hittable {
+public:
+    // 변환이 특이 행렬이면 std::invalid_argument를 던진다.
+    Instance(std::shared_ptr<Hittable> blas, const AffineTransform& object_to_world);
+
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override;
+    bool Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const override;
+    // blas 상자의 여덟 꼭짓점을 변환해 감싼다.
+    bool BoundingBox(double time0, double time1, Aabb& output_box) const override;
+
+    const std::shared_ptr<Hittable>& Blas() const { return blas_; }
+    const AffineTransform& ObjectToWorld() const { return object_to_world_; }
+
+private:
+    std::shared_ptr<Hittable> blas_;
+    AffineTransform object_to_world_;
+    AffineTransform world_to_object_;
+};
+
+}  // namespace raytracer
@@ -0,0 +1,61 @@
+/*
+ * 설명: BvhNode 포인터 트리를 깊이 우선 순서의 32바이트 노드 배열로 평탄화하고, 명시적 스택과 인덱스 오프셋으로
+ *       재귀/노드별 가상 호출 없이 순회하는 선형 BVH를 제공한다.
+ * 버전: v1.11.0
+ * 관련 문서: design/renderer/v1.11.0-linear-bvh.md
+ * 테스트: tests/unit/bvh_test.cpp
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "raytracer/bvh.hpp"
+#include "raytracer/hittable.hpp"
+
+namespace raytracer {
+
+// 경계는 float로 저장하되 최솟값은 내림, 최댓값은 올림으로 바꿔 double 상자를 항상 감싼다.
+// 내부 노드의 왼쪽 자식은 바로 다음 인덱스이고 offset은 오른쪽 자식 인덱스다. 잎의 offset은 첫 객체 인덱스다.
+struct alignas(32) LinearBvhNode {
+    float bounds_min[3];
+    float bounds_max[3];
+    std::uint32_t offset;
+    // 0이면 내부 노드다.
+    std::uint16_t primitive_count;
+    std::uint8_t axis;
+    std::uint8_t padding;
+};
+
+static_assert(sizeof(LinearBvhNode) == 32, "LinearBvhNode는 32바이트여야 한다.");
+
+class LinearBvh : public Hittable {
+public:
+    // tree의 구조를 그대로 평탄화한다. 잎 객체 경계는 [time0, time1] 구간으로 계산한다(tree 빌드 구간과 같아야 한다).
+    // tree를 재맞춤하면 평탄화를 다시 해야 한다.
+    LinearBvh(const BvhNode& tree, double time0, double time1);
+    LinearBvh(std::vector<std::shared_ptr<Hittable>> objects, double time0, double time1,
+              const BvhBuildOptions& options = BvhBuildOptions{});
+
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override;
+    bool BoundingBox(double time0, double time1, Aabb& output_box) const override;
+
+    std::size_t NodeCount() const { return nodes_.size(); }
+    std::size_t PrimitiveCount() const { return primitives_.size(); }
+    int Depth() const { return depth_; }
+
+private:
+    // 노드를 깊이 우선으로 추가하고 그 인덱스를 반환한다.
+    std::uint32_t AppendNode(const Aabb& box, std::uint8_t axis);
+    std::uint32_t FlattenNode(const BvhNode& node, double time0, double time1, int depth);
+    std::uint32_t FlattenChild(const std::shared_ptr<Hittable>& child, BvhNode::ChildKind kind, const Aabb& box, double time0,
+                               double time1, int depth);
+
+    std::vector<LinearBvhNode> nodes_;
+    std::vector<std::shared_ptr<Hittable>> primitives_;
+    int depth_ = 0;
+};
+
+}  // namespace raytracer
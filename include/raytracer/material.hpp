@@ -8,7 +8,6 @@
 
 #include <cmath>
 #include <memory>
-#include <random>
 
 #include "raytracer/hittable.hpp"
 #include "raytracer/pdf.hpp"
@@ -30,7 +29,7 @@ class Material {
 public:
     virtual ~Material() = default;
     virtual bool Scatter(const Ray& r_in, const HitRecord& record, ScatterRecord& scatter_record,
-                         std::mt19937& generator) const = 0;
+                         Rng& generator) const = 0;
     virtual double ScatteringPdf(const Ray& r_in, const HitRecord& record, const Ray& scattered) const {
         (void)r_in;
         (void)record;
@@ -46,7 +45,7 @@ public:
     explicit Lambertian(std::shared_ptr<Texture> texture) : albedo_(std::move(texture)) {}
 
     bool Scatter(const Ray& /*r_in*/, const HitRecord& record, ScatterRecord& scatter_record,
-                 std::mt19937& /*generator*/) const override {
+                 Rng& /*generator*/) const override {
         scatter_record.is_specular = false;
         scatter_record.attenuation = albedo_->Value(record.u, record.v, record.p);
         scatter_record.pdf = std::make_shared<CosinePdf>(record.normal);
@@ -69,7 +68,7 @@ public:
     Metal(const Color& albedo, double fuzz) : albedo_(albedo), fuzz_(fuzz < 1.0 ? fuzz : 1.0) {}
 
     bool Scatter(const Ray& r_in, const HitRecord& record, ScatterRecord& scatter_record,
-                 std::mt19937& generator) const override {
+                 Rng& generator) const override {
         const Vec3 unit_direction = UnitVector(r_in.direction());
         const Vec3 reflected = Reflect(unit_direction, record.normal);
         const Vec3 scattered_direction = reflected + fuzz_ * RandomInUnitSphere(generator);
@@ -89,7 +88,7 @@ public:
     explicit Dielectric(double refraction_index) : refraction_index_(refraction_index) {}
 
     bool Scatter(const Ray& r_in, const HitRecord& record, ScatterRecord& scatter_record,
-                 std::mt19937& generator) const override {
+                 Rng& generator) const override {
         scatter_record.attenuation = Color(1.0, 1.0, 1.0);
         const double refraction_ratio = record.front_face ? (1.0 / refraction_index_) : refraction_index_;
 
@@ -125,7 +124,7 @@ public:
     explicit DiffuseLight(const Color& emit) : emit_(emit) {}
 
     bool Scatter(const Ray& /*r_in*/, const HitRecord& /*record*/, ScatterRecord& /*scatter_record*/,
-                 std::mt19937& /*generator*/) const override {
+                 Rng& /*generator*/) const override {
         return false;
     }
 
@@ -141,7 +140,7 @@ public:
     explicit Isotropic(std::shared_ptr<Texture> texture) : albedo_(std::move(texture)) {}
 
     bool Scatter(const Ray& r_in, const HitRecord& record, ScatterRecord& scatter_record,
-                 std::mt19937& generator) const override {
+                 Rng& generator) const override {
         scatter_record.is_specular = false;
         scatter_record.attenuation = albedo_->Value(record.u, record.v, record.p);
         scatter_record.pdf = std::make_shared<UniformSpherePdf>();
@@ -0,0 +1,79 @@
+/*
+ * 설명: 노드마다 셔터 시작/끝 두 경계 상자를 저장하고, 순회할 때 레이 시각으로 두 상자를 선형 보간해 그 시각의
+ *       좁은 상자로 판정하는 모션 블러용 선형 BVH를 제공한다. 트리 모양은 셔터 중간 시각의 경계로 빌드한다.
+ * 버전: v1.25.0
+ * 관련 문서: design/renderer/v1.25.0-motion-bvh.md
+ * 테스트: tests/unit/bvh_test.cpp
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "raytracer/aabb.hpp"
+#include "raytracer/bvh.hpp"
+#include "raytracer/hittable.hpp"
+
+namespace raytracer {
+
+// 경계는 float로 저장하되 최솟값은 내림, 최댓값은 올림한 뒤 한 칸 더 바깥으로 밀어, 보간 계산의 반올림 오차가
+// 있어도 그 시각의 double 상자를 감싼다. 자식 배치와 offset은 LinearBvhNode와 같다.
+struct alignas(64) MotionBvhNode {
+    float min_open[3];
+    float max_open[3];
+    float min_close[3];
+    float max_close[3];
+    std::uint32_t offset;
+    // 0이면 내부 노드다.
+    std::uint16_t primitive_count;
+    std::uint8_t axis;
+    std::uint8_t padding;
+};
+
+static_assert(sizeof(MotionBvhNode) == 64, "MotionBvhNode는 64바이트여야 한다.");
+
+class MotionBvh : public Hittable {
+public:
+    // 객체 경계를 셔터 중간 시각 하나로 계산해 options로 트리를 빌드하고, 노드 상자는 객체의 MotionBounds로
+    // 셔터 시작/끝에서 다시 계산한다. 레이 시각은 [shutter_open, shutter_close] 안에 있어야 한다.
+    // options.split이 kSpatialSah이면 std::invalid_argument를 던진다(잘린 상자는 움직이는 객체를 감싸지 않는다).
+    MotionBvh(std::vector<std::shared_ptr<Hittable>> objects, double shutter_open, double shutter_close,
+              const BvhBuildOptions& options = BvhBuildOptions{});
+
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override;
+    bool Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const override;
+    bool BoundingBox(double time0, double time1, Aabb& output_box) const override;
+
+    std::size_t NodeCount() const { return nodes_.size(); }
+    std::size_t PrimitiveCount() const { return primitives_.size(); }
+    int Depth() const { return depth_; }
+
+private:
+    // 셔터 시작/끝 상자 쌍.
+    struct MotionBox {
+        Aabb open;
+        Aabb close;
+    };
+
+    std::uint32_t AppendNode(std::uint8_t axis);
+    void SetBounds(std::uint32_t index, const MotionBox& box);
+    MotionBox FlattenNode(const BvhNode& node, int depth, std::uint32_t& index);
+    MotionBox FlattenChild(const std::shared_ptr<Hittable>& child, BvhNode::ChildKind kind, int depth,
+                           std::uint32_t& index);
+    MotionBox PrimitiveBounds(const Hittable& object) const;
+    // 레이 시각을 셔터 구간의 [0, 1] 비율로 바꾼다. 구간 길이가 0이면 0이다.
+    double ShutterRatio(double time) const;
+
+    template <bool AnyHit>
+    bool Traverse(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const;
+
+    std::vector<MotionBvhNode> nodes_;
+    std::vector<std::shared_ptr<Hittable>> primitives_;
+    double shutter_open_ = 0.0;
+    double shutter_close_ = 0.0;
+    int depth_ = 0;
+};
+
+}  // namespace raytracer
@@ -8,7 +8,6 @@
 
 #include <cmath>
 #include <memory>
-#include <random>
 
 #include "raytracer/hittable.hpp"
 #include "raytracer/onb.hpp"
@@ -20,7 +19,7 @@ class Pdf {
 public:
     virtual ~Pdf() = default;
     virtual double Value(const Vec3& direction) const = 0;
-    virtual Vec3 Generate(std::mt19937& generator) const = 0;
+    virtual Vec3 Generate(Rng& generator) const = 0;
 };
 
 class CosinePdf : public Pdf {
@@ -32,7 +31,7 @@ public:
         return cosine > 0.0 ? cosine / kPi : 0.0;
     }
 
-    Vec3 Generate(std::mt19937& generator) const override { return uvw_.Local(RandomCosineDirection(generator)); }
+    Vec3 Generate(Rng& generator) const override { return uvw_.Local(RandomCosineDirection(generator)); }
 
 private:
     static constexpr double kPi = 3.1415926535897932385;
@@ -52,7 +51,7 @@ public:
         return 1.0 / solid_angle;
     }
 
-    Vec3 Generate(std::mt19937& generator) const override {
+    Vec3 Generate(Rng& generator) const override {
         const Vec3 direction = center_ - origin_;
         const Onb onb_builder = [&]() {
             Onb basis;
@@ -73,7 +72,7 @@ class UniformSpherePdf : public Pdf {
 public:
     double Value(const Vec3& /*direction*/) const override { return uniform_pdf_; }
 
-    Vec3 Generate(std::mt19937& generator) const override { return RandomUnitVector(generator); }
+    Vec3 Generate(Rng& generator) const override { return RandomUnitVector(generator); }
 
 private:
     static constexpr double uniform_pdf_ = 1.0 / (4.0 * 3.1415926535897932385);
@@ -85,7 +84,7 @@ public:
 
     double Value(const Vec3& direction) const override { return hittable_ ? hittable_->PdfValue(origin_, direction) : 0.0; }
 
-    Vec3 Generate(std::mt19937& generator) const override { return hittable_ ? hittable_->Random(origin_, generator) : Vec3(1.0, 0.0, 0.0); }
+    Vec3 Generate(Rng& generator) const override { return hittable_ ? hittable_->Random(origin_, generator) : Vec3(1.0, 0.0, 0.0); }
 
 private:
     std::shared_ptr<Hittable> hittable_;
@@ -100,7 +99,7 @@ public:
         return 0.5 * p0_->Value(direction) + 0.5 * p1_->Value(direction);
     }
 
-    Vec3 Generate(std::mt19937& generator) const override {
+    Vec3 Generate(Rng& generator) const override {
         if (RandomDouble(generator) < 0.5) {
             return p0_->Generate(generator);
         }
@@ -1,28 +1,60 @@
 /*
  * 설명: Cornell smoke 기반 볼륨 장면을 BVH로 가속하고 PDF 기반 중요도 샘플링을 적용해 PPM(P3) 규격으로 렌더링한다.
- * 버전: v1.0.0
- * 관련 문서: design/protocol/contract.md, design/renderer/v1.0.0-overview.md
+ * 버전: v1.9.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.2.0-progressive.md, design/renderer/v1.3.0-shards.md,
+ *           design/renderer/v1.4.0-streaming-output.md, design/renderer/v1.5.0-render-server.md,
+ *           design/renderer/v1.7.0-time-budget.md, design/renderer/v1.9.0-animation.md
  * 테스트: tests/integration/ppm_integration_test.cpp
  */
 #pragma once
 
-#include <cstdint>
+#include <chrono>
 #include <string>
 
+#include "raytracer/camera.hpp"
+#include "raytracer/image_sink.hpp"
+#include "raytracer/render_options.hpp"
+#include "raytracer/scene.hpp"
+#include "raytracer/shard.hpp"
+#include "raytracer/thread_pool.hpp"
+#include "raytracer/tile.hpp"
+
 namespace raytracer {
 
-struct RenderOptions {
-    int width = 256;
-    int height = 256;
-    int samples_per_pixel = 10;
-    double vertical_fov_degrees = 40.0;
-    int max_depth = 20;
-    std::uint32_t seed = 1;
-    double aperture = 0.0;
-    double shutter_open_time = 0.0;
-    double shutter_close_time = 0.0;
+struct ProgressiveOptions {
+    std::string checkpoint_path;
+    int checkpoint_interval = 16;
+    std::string resume_path;
+    // 0보다 크면 samples_per_pixel을 상한으로 두고 마감까지 패스를 더한다. 마감에 걸린 패스는 버린다.
+    std::chrono::milliseconds time_budget{0};
 };
 
+// 미리 구성한 장면과 공유 스레드 풀로 전체 이미지(options.width x options.height) 중 region 영역만 렌더링한다.
+// 픽셀 시드는 전체 이미지 좌표를 쓰므로 결과는 같은 옵션 전체 렌더의 해당 영역과 같다. options.thread_count는 쓰지 않으며,
+// 여러 스레드가 같은 scene/pool로 동시에 호출할 수 있다. 영역이 이미지를 벗어나면 std::invalid_argument를 던진다.
+void RenderMaterialRegion(const RenderOptions& options, const Scene& scene, ThreadPool& pool, const Tile& region,
+                          ImageSink& sink);
+// 계약 카메라 대신 호출자가 만든 카메라(애니메이션 카메라 경로 등)로 렌더링한다.
+void RenderMaterialRegion(const RenderOptions& options, const Scene& scene, const Camera& camera, ThreadPool& pool,
+                          const Tile& region, ImageSink& sink);
+
+// 타일 한 줄 높이의 띠가 끝날 때마다 완성된 행을 위에서 아래로 sink에 넘긴다.
+// 프레임 전체 대신 띠 하나의 샘플 합만 보관하므로 첫 행이 렌더 초반에 출력된다.
+void RenderMaterialImage(const RenderOptions& options, ImageSink& sink);
+// PPM(P3) 문자열을 반환하는 편의 함수다.
 std::string RenderMaterialImage(const RenderOptions& options);
 
+// 샘플 인덱스 하나씩을 전체 이미지 패스로 누적한다. 결과는 RenderMaterialImage와 바이트 단위로 같고,
+// checkpoint_interval 패스마다(그리고 마지막 패스 후) 누적 버퍼를 checkpoint_path에 저장한다.
+// resume_path가 있으면 해당 체크포인트의 완료 패스부터 이어서 렌더링하며 체크포인트 오류는 std::runtime_error로 던진다.
+// 누적 버퍼가 모든 패스를 거쳐야 완성되므로 행은 마지막 패스 후 한꺼번에 sink로 나간다.
+// 완료 패스 수 N을 반환하며, 출력은 samples_per_pixel = N인 RenderMaterialImage와 바이트 단위로 같다.
+// 시간 예산 모드에서도 첫 패스는 항상 끝까지 렌더링한다.
+int RenderProgressiveImage(const RenderOptions& options, const ProgressiveOptions& progressive, ImageSink& sink);
+std::string RenderProgressiveImage(const RenderOptions& options, const ProgressiveOptions& progressive);
+
+// 행 우선 타일 구간 [range.begin, range.end)만 렌더링해 샤드 텍스트로 반환한다.
+// 모든 샤드를 MergeShards로 합치면 같은 옵션의 RenderMaterialImage와 바이트 단위로 같다.
+std::string RenderMaterialShard(const RenderOptions& options, const TileRange& range);
+
 }  // namespace raytracer
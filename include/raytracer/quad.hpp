@@ -1,13 +1,12 @@
 /*
- * 설명: Quad와 Box 기하를 정의하고 경계 상자, UV, 샘플링 PDF 정보를 계산한다.
- * 버전: v1.0.0
- * 관련 문서: design/renderer/v1.0.0-overview.md
+ * 설명: Quad와 Box 기하를 정의하고 경계 상자, UV, 샘플링 PDF 정보를 계산한다. Quad는 영역으로 자른 경계 상자도 계산한다.
+ * 버전: v1.20.0
+ * 관련 문서: design/renderer/v1.0.0-overview.md, design/renderer/v1.15.0-sbvh.md, design/renderer/v1.20.0-occlusion.md
  * 테스트: tests/unit/quad_test.cpp, tests/unit/pdf_test.cpp
  */
 #pragma once
 
 #include <memory>
-#include <random>
 
 #include "raytracer/aabb.hpp"
 #include "raytracer/hittable.hpp"
@@ -21,10 +20,14 @@ class Quad : public Hittable {
 public:
     Quad(const Point3& q, const Vec3& u, const Vec3& v, std::shared_ptr<Material> material);
 
-    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const override;
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override;
+    bool Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const override;
     bool BoundingBox(double time0, double time1, Aabb& output_box) const override;
     double PdfValue(const Point3& origin, const Vec3& direction) const override;
-    Vec3 Random(const Point3& origin, std::mt19937& generator) const override;
+    Vec3 Random(const Point3& origin, Rng& generator) const override;
+    // 평행사변형을 region의 여섯 평면으로 잘라 남은 다각형의 상자를 구한다. u와 v가 직교하지 않으면
+    // 교차 영역이 꼭짓점 평행사변형과 달라지므로 false를 반환한다.
+    bool ClipBox(double time0, double time1, const Aabb& region, Aabb& output_box) const override;
 
 private:
     Point3 q_;
@@ -36,6 +39,9 @@ private:
     std::shared_ptr<Material> material_;
     Aabb bbox_;
 
+    // 평면 교차 거리 t가 [t_min, t_max] 안이고 교차점이 평행사변형 안이면 t, 교차점, u/v 방향 사영을 쓴다.
+    bool Intersect(const Ray& r, double t_min, double t_max, double& t, Point3& intersection, double& alpha,
+                   double& beta) const;
     bool IsInside(double alpha, double beta) const;
     void SetBoundingBox();
 };
@@ -44,7 +50,8 @@ class Box : public Hittable {
 public:
     Box(const Point3& min_point, const Point3& max_point, std::shared_ptr<Material> material);
 
-    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const override;
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override;
+    bool Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const override;
     bool BoundingBox(double time0, double time1, Aabb& output_box) const override;
 
 private:
@@ -0,0 +1,79 @@
+/*
+ * 설명: 이진 BvhNode 트리를 자식 경계가 부모 상자 기준 8/16비트 격자 좌표인 압축 노드 배열로 평탄화하고,
+ *       순회 중 스택에 부모 상자를 함께 실어 자식 경계를 복원하며 가까운 자식부터 방문한다.
+ * 버전: v1.17.0
+ * 관련 문서: design/renderer/v1.17.0-quantized-bvh.md
+ * 테스트: tests/unit/bvh_test.cpp
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "raytracer/bvh.hpp"
+#include "raytracer/hittable.hpp"
+
+namespace raytracer {
+
+// 내부 노드만 저장한다. 두 자식의 경계는 이 노드 상자를 축마다 2^Bits - 1칸으로 나눈 격자 좌표이며,
+// 최솟값은 내림, 최댓값은 올림으로 양자화해 복원한 상자가 항상 원래 상자를 감싼다.
+// child는 kQuantizedLeaf 비트가 서 있으면 잎(하위 26비트 첫 객체 인덱스, 그 위 5비트 객체 수 - 1),
+// kQuantizedEmpty면 빈 자식(객체 하나짜리 뿌리), 그 외에는 내부 노드 인덱스다.
+template <int Bits>
+struct QuantizedBvhNode {
+    using Quantum = std::conditional_t<Bits == 8, std::uint8_t, std::uint16_t>;
+
+    Quantum child_min[2][3];
+    Quantum child_max[2][3];
+    std::uint32_t child[2];
+};
+
+constexpr std::uint32_t kQuantizedLeaf = 0x80000000u;
+constexpr std::uint32_t kQuantizedEmpty = 0xffffffffu;
+
+static_assert(sizeof(QuantizedBvhNode<8>) == 20, "8비트 양자화 노드는 20바이트여야 한다.");
+static_assert(sizeof(QuantizedBvhNode<16>) == 32, "16비트 양자화 노드는 32바이트여야 한다.");
+
+template <int Bits>
+class QuantizedBvh : public Hittable {
+public:
+    static_assert(Bits == 8 || Bits == 16, "양자화 비트 수는 8 또는 16이다.");
+
+    // tree의 구조를 그대로 평탄화한다. 잎 객체 경계는 [time0, time1] 구간으로 계산한다(tree 빌드 구간과 같아야 한다).
+    // 객체 33개 이상의 잎 목록은 목록 자체를 객체 하나로 담는다. 기본 도형이 2^26개를 넘으면 std::runtime_error.
+    QuantizedBvh(const BvhNode& tree, double time0, double time1);
+    QuantizedBvh(std::vector<std::shared_ptr<Hittable>> objects, double time0, double time1,
+                 const BvhBuildOptions& options = BvhBuildOptions{});
+
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override;
+    bool BoundingBox(double time0, double time1, Aabb& output_box) const override;
+
+    std::size_t NodeCount() const { return nodes_.size(); }
+    std::size_t PrimitiveCount() const { return primitives_.size(); }
+    int Depth() const { return depth_; }
+    // 노드 배열과 객체 포인터 배열이 차지하는 바이트 수.
+    std::size_t MemoryBytes() const {
+        return nodes_.size() * sizeof(QuantizedBvhNode<Bits>) + primitives_.size() * sizeof(std::shared_ptr<Hittable>);
+    }
+
+private:
+    // 부모 상자 [lo, hi]를 기준으로 한 자식 참조를 만들고, 내부 노드면 복원한 상자를 기준으로 재귀한다.
+    std::uint32_t FlattenChild(const std::shared_ptr<Hittable>& child, BvhNode::ChildKind kind, const float lo[3],
+                               const float hi[3], double time0, double time1, int depth);
+    std::uint32_t FlattenNode(const BvhNode& node, const float lo[3], const float hi[3], double time0, double time1,
+                              int depth);
+
+    std::vector<QuantizedBvhNode<Bits>> nodes_;
+    std::vector<std::shared_ptr<Hittable>> primitives_;
+    float root_min_[3] = {0.0f, 0.0f, 0.0f};
+    float root_max_[3] = {0.0f, 0.0f, 0.0f};
+    int depth_ = 0;
+};
+
+using QuantizedBvh8 = QuantizedBvh<8>;
+using QuantizedBvh16 = QuantizedBvh<16>;
+
+}  // namespace raytracer
@@ -1,23 +1,72 @@
 /*
- * 설명: 결정적 랜덤 값을 생성하고 벡터 샘플링 유틸리티를 제공한다.
- * 버전: v1.0.0
- * 관련 문서: design/renderer/v1.0.0-overview.md
- * 테스트: tests/unit/material_scatter_test.cpp, tests/unit/pdf_test.cpp
+ * 설명: 결정적 랜덤 값을 생성하고 샘플별 시드 파생과 벡터 샘플링 유틸리티를 제공한다.
+ * 버전: v1.1.0
+ * 관련 문서: design/renderer/v1.0.0-overview.md, design/renderer/v1.1.0-tile-threads.md
+ * 테스트: tests/unit/material_scatter_test.cpp, tests/unit/pdf_test.cpp, tests/unit/tile_test.cpp
  */
 #pragma once
 
+#include <cstdint>
 #include <random>
 
 #include "raytracer/vec3.hpp"
 
 namespace raytracer {
 
-inline double RandomDouble(std::mt19937& generator, double min = 0.0, double max = 1.0) {
+inline std::uint64_t SplitMix64(std::uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+// 전역 시드, 픽셀 인덱스(y * width + x), 샘플 인덱스만으로 샘플 생성기 시드를 만든다.
+// 렌더 순서나 스레드 수와 무관하게 같은 샘플은 항상 같은 난수열을 사용한다.
+inline std::uint64_t SampleSeed(std::uint32_t seed, std::uint64_t pixel_index, std::uint32_t sample_index) {
+    std::uint64_t state = SplitMix64(seed);
+    state = SplitMix64(state ^ pixel_index);
+    return SplitMix64(state ^ sample_index);
+}
+
+// PCG32(XSH-RR) 생성기. 상태가 16바이트라 샘플마다 새로 시드해도 비용이 거의 없다.
+// UniformRandomBitGenerator 요건을 만족해 표준 분포와 함께 사용할 수 있다.
+class Rng {
+public:
+    using result_type = std::uint32_t;
+
+    explicit Rng(std::uint64_t seed = 0) { Seed(seed); }
+
+    void Seed(std::uint64_t seed) {
+        state_ = 0;
+        (*this)();
+        state_ += seed;
+        (*this)();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    result_type operator()() {
+        const std::uint64_t old_state = state_;
+        state_ = old_state * kMultiplier + kIncrement;
+        const auto xorshifted = static_cast<std::uint32_t>(((old_state >> 18u) ^ old_state) >> 27u);
+        const auto rotation = static_cast<std::uint32_t>(old_state >> 59u);
+        return (xorshifted >> rotation) | (xorshifted << ((32u - rotation) & 31u));
+    }
+
+private:
+    static constexpr std::uint64_t kMultiplier = 6364136223846793005ULL;
+    static constexpr std::uint64_t kIncrement = 1442695040888963407ULL;
+
+    std::uint64_t state_ = 0;
+};
+
+inline double RandomDouble(Rng& generator, double min = 0.0, double max = 1.0) {
     std::uniform_real_distribution<double> distribution(min, max);
     return distribution(generator);
 }
 
-inline Vec3 RandomInUnitSphere(std::mt19937& generator) {
+inline Vec3 RandomInUnitSphere(Rng& generator) {
     while (true) {
         const Vec3 candidate(RandomDouble(generator, -1.0, 1.0), RandomDouble(generator, -1.0, 1.0),
                              RandomDouble(generator, -1.0, 1.0));
@@ -27,9 +76,9 @@ inline Vec3 RandomInUnitSphere(std::mt19937& generator) {
     }
 }
 
-inline Vec3 RandomUnitVector(std::mt19937& generator) { return UnitVector(RandomInUnitSphere(generator)); }
+inline Vec3 RandomUnitVector(Rng& generator) { return UnitVector(RandomInUnitSphere(generator)); }
 
-inline Vec3 RandomInUnitDisk(std::mt19937& generator) {
+inline Vec3 RandomInUnitDisk(Rng& generator) {
     while (true) {
         const Vec3 candidate(RandomDouble(generator, -1.0, 1.0), RandomDouble(generator, -1.0, 1.0), 0.0);
         if (candidate.length_squared() < 1.0) {
@@ -38,7 +87,7 @@ inline Vec3 RandomInUnitDisk(std::mt19937& generator) {
     }
 }
 
-inline Vec3 RandomCosineDirection(std::mt19937& generator) {
+inline Vec3 RandomCosineDirection(Rng& generator) {
     const double r1 = RandomDouble(generator);
     const double r2 = RandomDouble(generator);
     const double z = std::sqrt(1.0 - r2);
@@ -48,7 +97,7 @@ inline Vec3 RandomCosineDirection(std::mt19937& generator) {
     return Vec3(x, y, z);
 }
 
-inline Vec3 RandomToSphere(double radius, double distance_squared, std::mt19937& generator) {
+inline Vec3 RandomToSphere(double radius, double distance_squared, Rng& generator) {
     const double r1 = RandomDouble(generator);
     const double r2 = RandomDouble(generator);
     const double z = 1.0 + r2 * (std::sqrt(1.0 - radius * radius / distance_squared) - 1.0);
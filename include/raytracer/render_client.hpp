@@ -0,0 +1,35 @@
+/*
+ * 설명: 렌더 서버에 연결해 한 줄 JSON 요청을 보내고 PPM 응답을 해상도 헤더로 경계를 찾아 출력 스트림에 복사한다.
+ * 버전: v1.5.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.5.0-render-server.md
+ * 테스트: tests/integration/render_server_test.cpp
+ */
+#pragma once
+
+#include <ostream>
+#include <string>
+
+namespace raytracer {
+
+class RenderClient {
+public:
+    // 연결할 수 없으면 std::runtime_error를 던진다.
+    explicit RenderClient(const std::string& socket_path);
+    ~RenderClient();
+
+    RenderClient(const RenderClient&) = delete;
+    RenderClient& operator=(const RenderClient&) = delete;
+
+    // request_line(개행 제외)을 보내고 응답 PPM을 받는 대로 output에 쓴다. 같은 연결로 여러 번 호출할 수 있다.
+    // 서버가 "ERR"로 응답하면 그 메시지로, 연결이 응답 도중 끊기면 std::runtime_error를 던진다.
+    void Render(const std::string& request_line, std::ostream& output);
+
+private:
+    bool Fill();
+    std::string TakeLine();
+
+    int fd_ = -1;
+    std::string pending_;
+};
+
+}  // namespace raytracer
@@ -0,0 +1,54 @@
+/*
+ * 설명: 픽셀 샘플 하나와 타일 하나의 샘플 합을 계산하는 렌더 핵심 함수를 모든 렌더 경로(일반, 점진, 샤드, 세션)에 제공한다.
+ * 버전: v1.23.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.6.0-render-session.md, design/renderer/v1.21.0-ray-packets.md,
+ *           design/renderer/v1.22.0-wavefront.md, design/renderer/v1.23.0-tile-culling.md
+ * 테스트: tests/integration/ppm_integration_test.cpp, tests/integration/render_session_test.cpp
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "raytracer/camera.hpp"
+#include "raytracer/hittable.hpp"
+#include "raytracer/random.hpp"
+#include "raytracer/ray.hpp"
+#include "raytracer/render_options.hpp"
+#include "raytracer/tile.hpp"
+#include "raytracer/vec3.hpp"
+
+namespace raytracer {
+
+struct RenderContext {
+    const RenderOptions& options;
+    const Camera& camera;
+    const Hittable& world;
+    const std::shared_ptr<Hittable>& lights;
+};
+
+// 모든 적분기가 교차를 찾는 구간의 시작. 방금 부딪힌 표면에 다시 맞는 자기 교차를 피한다.
+constexpr double kHitEpsilon = 0.001;
+
+// 계약에 고정된 Cornell 카메라를 options의 종횡비/시야각/셔터로 만든다.
+Camera MakeCamera(const RenderOptions& options);
+
+// 픽셀 (x, y)의 sample번째 샘플 생성기를 시드하고 화면 레이를 만든다. 생성기는 이어서 그 샘플의 경로 추적에 쓴다.
+Ray PrimaryRay(const RenderContext& context, int x, int y, int sample, Rng& generator);
+
+// 샘플마다 (seed, 픽셀, 샘플 인덱스)에서 파생한 생성기를 새로 만들어 렌더 순서와 무관한 결과를 보장한다.
+Color RenderSample(const RenderContext& context, int x, int y, int sample);
+
+// options.tile_culling이 켜져 있으면 타일 화면 레이가 지나는 절두체로 장면을 잘라 낸 부분 구조(Hittable::CullFrustum)를
+// 돌려준다. 꺼져 있거나, 렌즈 반경이 있어 절두체를 만들 수 없거나, 장면이 자르기를 지원하지 않으면 nullptr다.
+// 부분 구조는 화면 레이의 첫 교차에만 쓰며 context.world보다 오래 쓰면 안 된다.
+std::unique_ptr<Hittable> CullTileWorld(const RenderContext& context, const Tile& tile);
+
+// 타일 안 픽셀의 샘플 합(샘플 0부터 순서대로 누적)을 행 우선 순서의 타일 로컬 버퍼로 반환한다.
+// options.packet_size가 1이 아니면 화면 레이를 픽셀 블록 단위로 묶어 순회하며, 합은 비트 단위로 같다.
+// packet_size가 1, 4, 8, 16이 아니면 std::invalid_argument를 던진다.
+// options.integrator가 kWavefront이면 RenderTileSumsWavefront로 계산하며, 합은 역시 비트 단위로 같다.
+// options.tile_culling이 켜져 있으면 화면 레이의 첫 교차를 CullTileWorld의 부분 구조에서 찾으며, 합은 역시 같다.
+std::vector<Color> RenderTileSums(const RenderContext& context, const Tile& tile);
+
+}  // namespace raytracer
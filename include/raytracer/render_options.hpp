@@ -0,0 +1,45 @@
+/*
+ * 설명: 해상도, 샘플 수, 시드, 스레드/타일 설정, 화면 레이 묶음 크기, 적분기, 타일 절두체 컬링 등 모든 렌더 경로가 공유하는
+ *       렌더 옵션을 정의한다.
+ * 버전: v1.23.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.6.0-render-session.md,
+ *           design/renderer/v1.21.0-ray-packets.md, design/renderer/v1.22.0-wavefront.md,
+ *           design/renderer/v1.23.0-tile-culling.md
+ * 테스트: tests/integration/ppm_integration_test.cpp
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace raytracer {
+
+// 타일 샘플 합을 계산하는 방식. 둘은 같은 추정량을 같은 난수 순서로 계산하므로 출력이 같다.
+enum class Integrator {
+    // 경로 하나를 깊이 우선 재귀로 끝까지 추적한다.
+    kRecursive,
+    // 타일의 경로들을 모아 교차·음영·광원 샘플링 단계를 차례로 한꺼번에 돈다.
+    kWavefront,
+};
+
+struct RenderOptions {
+    int width = 256;
+    int height = 256;
+    int samples_per_pixel = 10;
+    double vertical_fov_degrees = 40.0;
+    int max_depth = 20;
+    std::uint32_t seed = 1;
+    double aperture = 0.0;
+    double shutter_open_time = 0.0;
+    double shutter_close_time = 0.0;
+    int thread_count = 1;
+    int tile_size = 16;
+    // 타일 렌더에서 첫 교차를 함께 찾는 화면 레이 수(1, 4, 8, 16). 1이면 레이마다 따로 순회한다. 출력은 값과 무관하게 같다.
+    int packet_size = 1;
+    // 점진 패스는 픽셀 샘플 하나씩 렌더하므로 이 값과 무관하게 재귀 적분기를 쓴다.
+    Integrator integrator = Integrator::kRecursive;
+    // 타일마다 장면 BVH를 타일 절두체로 잘라 두고 화면 레이를 그 부분 트리에서 순회한다. 출력은 켜고 끄는 것과 무관하게
+    // 같다. 렌즈 반경이 있으면(aperture > 0) 절두체를 만들 수 없어 쓰지 않는다. 점진 패스에서도 쓰지 않는다.
+    bool tile_culling = false;
+};
+
+}  // namespace raytracer
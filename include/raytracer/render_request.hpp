@@ -0,0 +1,37 @@
+/*
+ * 설명: 렌더 서버 요청과 배치 매니페스트 줄이 쓰는 한 줄 JSON 렌더 요청을 해석해 렌더 옵션, 잘라낼 영역, 출력 형식으로 바꾼다.
+ * 버전: v1.8.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.5.0-render-server.md, design/renderer/v1.8.0-batch.md
+ * 테스트: tests/unit/render_request_test.cpp
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "raytracer/image_sink.hpp"
+#include "raytracer/ppm.hpp"
+#include "raytracer/tile.hpp"
+
+namespace raytracer {
+
+// 요청 하나가 서버 메모리와 스레드 풀을 독차지하지 못하도록 요청 값에 두는 상한. CLI 기본값에는 적용하지 않는다.
+constexpr int kMaxRequestDimension = 8192;
+constexpr std::int64_t kMaxRequestPixels = std::int64_t{4096} * 4096;
+constexpr int kMaxRequestSamplesPerPixel = 65536;
+constexpr int kMaxRequestDepth = 1024;
+
+struct RenderRequest {
+    RenderOptions options;
+    Tile crop;  // 전체 이미지 좌표의 출력 영역
+    PpmFormat format = PpmFormat::kAscii;
+    std::string output_path;  // "output" 키. 배치 매니페스트에서만 쓴다.
+};
+
+// {"width":W,"height":H,"spp":S,"seed":N,"max_depth":D,"crop":[x,y,w,h],"format":"p3"|"p6","output":"경로"}
+// 형식의 평평한 객체를 해석한다.
+// 모든 키는 생략할 수 있고 생략하면 defaults 값(crop은 전체 이미지)을 쓴다.
+// 문법 오류, 모르는 키, 허용 범위 밖 값(위 상한 초과 포함)은 std::invalid_argument로 던진다.
+RenderRequest ParseRenderRequest(const std::string& line, const RenderOptions& defaults);
+
+}  // namespace raytracer
@@ -0,0 +1,61 @@
+/*
+ * 설명: 장면과 BVH를 한 번 구성해 두고 유닉스 도메인 소켓으로 받은 렌더 요청을 공유 스레드 풀에서 처리하는 상주 서버를 정의한다.
+ * 버전: v1.5.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.5.0-render-server.md
+ * 테스트: tests/integration/render_server_test.cpp
+ */
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "raytracer/ppm.hpp"
+#include "raytracer/scene.hpp"
+#include "raytracer/thread_pool.hpp"
+
+namespace raytracer {
+
+class RenderServer {
+public:
+    // 장면/BVH와 defaults.thread_count 크기의 스레드 풀을 만들고 socket_path에 소켓을 연다.
+    // 같은 경로에 남은 소켓 파일은 지우고 다시 만든다. 소켓을 열 수 없으면 std::runtime_error를 던진다.
+    RenderServer(const std::string& socket_path, const RenderOptions& defaults);
+    ~RenderServer();
+
+    RenderServer(const RenderServer&) = delete;
+    RenderServer& operator=(const RenderServer&) = delete;
+
+    // Stop이 호출될 때까지 연결을 받는다. 연결마다 스레드 하나가 요청을 순서대로 처리하고,
+    // 요청들의 타일 작업은 모두 같은 스레드 풀에 분배된다. 반환 전에 열린 연결을 끊고 연결 스레드를 모두
+    // join한다. 처리 중이던 요청은 응답 기록이 실패하면서 끝난다.
+    void Serve();
+
+    // 다른 스레드나 시그널 처리기에서 호출할 수 있다(락을 잡지 않는다).
+    void Stop();
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::thread thread;
+        std::atomic<bool> finished{false};
+    };
+
+    void HandleConnection(Connection& connection);
+    void ReapFinishedConnections();
+    void CloseAllConnections();
+
+    std::string socket_path_;
+    RenderOptions defaults_;
+    Scene scene_;
+    ThreadPool pool_;
+    int listen_fd_ = -1;
+    std::atomic<bool> stopping_{false};
+    std::mutex connections_mutex_;
+    std::list<std::unique_ptr<Connection>> connections_;
+};
+
+}  // namespace raytracer
@@ -0,0 +1,78 @@
+/*
+ * 설명: 호출자가 소유한 장면과 프레임버퍼로 힐베르트 타일 렌더를 실행하고 타일 진행 콜백, 협조적 취소, 부분 결과 읽기를 제공한다.
+ * 버전: v1.6.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.6.0-render-session.md
+ * 테스트: tests/integration/render_session_test.cpp
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "raytracer/framebuffer.hpp"
+#include "raytracer/image_sink.hpp"
+#include "raytracer/render_options.hpp"
+#include "raytracer/scene.hpp"
+#include "raytracer/thread_pool.hpp"
+#include "raytracer/tile.hpp"
+
+namespace raytracer {
+
+struct TileProgress {
+    std::size_t tile_index = 0;  // Tiles() 안의 위치
+    Tile tile;
+    std::size_t completed_tiles = 0;
+    std::size_t total_tiles = 0;
+};
+
+// scene과 framebuffer는 세션보다 오래 살아야 한다. framebuffer에는 픽셀별 샘플 합(평균 전)이 기록된다.
+class RenderSession {
+public:
+    using ProgressCallback = std::function<void(const TileProgress&)>;
+
+    // framebuffer 해상도가 options와 다르면 std::invalid_argument를 던진다.
+    RenderSession(const RenderOptions& options, const Scene& scene, Framebuffer& framebuffer);
+
+    RenderSession(const RenderSession&) = delete;
+    RenderSession& operator=(const RenderSession&) = delete;
+
+    // 타일이 끝날 때마다 호출된다. 호출은 직렬화되지만 워커 스레드에서 일어나므로 오래 걸리는 작업은 피한다.
+    void SetProgressCallback(ProgressCallback callback);
+
+    // 모든 타일을 렌더링하거나 취소될 때까지 블록한다. 끝까지 렌더링했으면 true, 취소됐으면 false를 반환한다.
+    // 인자가 없으면 options.thread_count 크기의 풀을 만들고, 주어진 풀은 다른 작업과 공유할 수 있다.
+    bool Run();
+    bool Run(ThreadPool& pool);
+
+    // 아무 스레드(진행 콜백 포함)에서나 호출할 수 있다. 진행 중인 타일은 끝까지 렌더링하고 새 타일은 시작하지 않는다.
+    void Cancel();
+    bool IsCancelled() const;
+
+    const std::vector<Tile>& Tiles() const { return tiles_; }
+    std::size_t CompletedTiles() const;
+
+    // true를 반환한 타일의 framebuffer 영역은 최종 샘플 합이며 렌더 도중에도 안전하게 읽을 수 있다.
+    bool IsTileComplete(std::size_t tile_index) const;
+
+    // 완료된 타일만 양자화해 sink로 내보내고 아직 렌더링되지 않은 픽셀은 검은색으로 채운다. 렌더 도중에도 호출할 수 있다.
+    void ResolvePartial(ImageSink& sink) const;
+
+private:
+    void RenderTileAt(std::size_t index);
+
+    RenderOptions options_;
+    const Scene& scene_;
+    Framebuffer& framebuffer_;
+    std::vector<Tile> tiles_;
+    std::unique_ptr<std::atomic<bool>[]> tile_done_;
+    std::atomic<std::size_t> completed_{0};
+    std::atomic<bool> cancelled_{false};
+    std::mutex callback_mutex_;
+    ProgressCallback callback_;
+};
+
+}  // namespace raytracer
@@ -0,0 +1,54 @@
+/*
+ * 설명: Cornell smoke 장면 기하, BVH, 광원 목록을 한 번 구성해 여러 렌더가 읽기 전용으로 공유하도록 묶는다.
+ *       애니메이션용으로 상자 볼륨의 회전/이동 변환 손잡이도 함께 노출한다. 렌더는 8칸 넓은 BVH로 순회한다.
+ * 버전: v1.12.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.5.0-render-server.md, design/renderer/v1.9.0-animation.md,
+ *           design/renderer/v1.11.0-linear-bvh.md, design/renderer/v1.12.0-wide-bvh.md
+ * 테스트: tests/integration/ppm_integration_test.cpp
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "raytracer/bvh.hpp"
+#include "raytracer/hittable.hpp"
+#include "raytracer/hittable_list.hpp"
+#include "raytracer/transform.hpp"
+#include "raytracer/vec3.hpp"
+#include "raytracer/wide_bvh.hpp"
+
+namespace raytracer {
+
+// RotateY -> Translate로 배치한 물체를 자기 중심(pivot, 회전 전 객체 좌표) 기준으로 돌리기 위한 손잡이.
+// 구성 직후의 각도/이동량을 기억해 추가 회전이 0이면 정지 장면과 비트 단위로 같은 변환을 되돌려 준다.
+struct TurntableHandle {
+    std::shared_ptr<RotateY> rotation;
+    std::shared_ptr<Translate> translation;
+    double base_angle_degrees = 0.0;
+    Vec3 base_offset;
+    Point3 pivot;
+};
+
+// 카메라는 해상도(종횡비)에 따라 달라지므로 포함하지 않는다. 구성 후에는 const로만 접근해 스레드 간 공유한다.
+struct Scene {
+    HittableList world;
+    HittableList lights;
+    // bvh_tree는 빌드/재맞춤용 원본이고, 렌더는 이를 접은 wide_bvh를 순회한다. 재맞춤 후에는 다시 접는다.
+    std::shared_ptr<BvhNode> bvh_tree;
+    std::shared_ptr<Bvh8> wide_bvh;
+    std::shared_ptr<Hittable> lights_view;
+    std::vector<TurntableHandle> turntables;
+
+    const Hittable& WorldView() const {
+        if (wide_bvh) {
+            return *wide_bvh;
+        }
+        return bvh_tree ? static_cast<const Hittable&>(*bvh_tree) : static_cast<const Hittable&>(world);
+    }
+};
+
+// BVH 경계는 셔터 구간 [time0, time1]에 대해 계산한다.
+Scene BuildCornellSmokeScene(double time0, double time1);
+
+}  // namespace raytracer
@@ -0,0 +1,60 @@
+/*
+ * 설명: 행 우선 타일 구간 단위의 부분 이미지(샤드)를 텍스트로 기록/해석하고 전체 PPM으로 병합한다.
+ * 버전: v1.4.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.3.0-shards.md, design/renderer/v1.4.0-streaming-output.md
+ * 테스트: tests/integration/ppm_integration_test.cpp
+ */
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "raytracer/color.hpp"
+#include "raytracer/image_sink.hpp"
+
+namespace raytracer {
+
+// 행 우선 타일 인덱스 구간 [begin, end)을 나타낸다.
+struct TileRange {
+    int begin = 0;
+    int end = 0;
+};
+
+// shard_index번째(0부터) 샤드가 맡을 구간을 전체 타일 수에 대해 균등 분할로 계산한다.
+TileRange ShardTileRange(int shard_index, int shard_count, int tile_count);
+
+// 샤드 픽셀을 정하는 렌더 설정. 병합할 샤드는 이 값이 모두 같아야 한다.
+struct ShardRenderSettings {
+    std::uint32_t seed = 0;
+    int samples_per_pixel = 0;
+    int max_depth = 0;
+    // 공백 없는 장면 이름과, 장면·카메라를 바꾸는 옵션.
+    std::string scene;
+    double vertical_fov_degrees = 0.0;
+    double aperture = 0.0;
+    double shutter_open_time = 0.0;
+    double shutter_close_time = 0.0;
+};
+
+// 구간 안 타일을 인덱스 순서로, 각 타일 안은 행 우선 픽셀 순서로 8비트 색을 담는다.
+struct ShardImage {
+    int width = 0;
+    int height = 0;
+    int tile_size = 0;
+    ShardRenderSettings settings;
+    TileRange range;
+    std::vector<Rgb8> pixels;
+};
+
+std::string EncodeShard(const ShardImage& shard);
+ShardImage DecodeShard(std::istream& input);
+
+// 샤드들이 전체 타일을 겹침 없이 정확히 덮으면 단일 프로세스 렌더와 같은 행들을 sink로 내보낸다.
+// 해상도/타일 크기/렌더 설정 불일치, 구간 겹침, 누락이 있으면 sink를 호출하기 전에 std::runtime_error를 던진다.
+void MergeShards(const std::vector<ShardImage>& shards, ImageSink& sink);
+// PPM(P3) 문자열을 반환하는 편의 함수다.
+std::string MergeShards(const std::vector<ShardImage>& shards);
+
+}  // namespace raytracer
@@ -1,13 +1,14 @@
 /*
- * 설명: 고정 구와 시간에 따라 이동하는 구의 레이 교차, 경계 상자, 샘플링 PDF를 계산한다.
- * 버전: v1.0.0
- * 관련 문서: design/renderer/v1.0.0-overview.md
+ * 설명: 고정 구와 시간에 따라 이동하는 구의 레이 교차, 경계 상자, 샘플링 PDF를 계산한다. 고정 구는 영역으로 자른 경계 상자도 계산한다.
+ *       이동하는 구는 셔터 양 끝 경계 상자도 계산한다.
+ * 버전: v1.25.0
+ * 관련 문서: design/renderer/v1.0.0-overview.md, design/renderer/v1.15.0-sbvh.md, design/renderer/v1.20.0-occlusion.md,
+ *           design/renderer/v1.25.0-motion-bvh.md
  * 테스트: tests/unit/sphere_test.cpp, tests/unit/bvh_test.cpp, tests/unit/pdf_test.cpp
  */
 #pragma once
 
 #include <memory>
-#include <random>
 
 #include "raytracer/aabb.hpp"
 #include "raytracer/hittable.hpp"
@@ -19,10 +20,13 @@ public:
     Sphere(const Point3& center, double radius, std::shared_ptr<Material> material)
         : center_(center), radius_(radius), material_(std::move(material)) {}
 
-    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const override;
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override;
+    bool Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const override;
     bool BoundingBox(double time0, double time1, Aabb& output_box) const override;
     double PdfValue(const Point3& origin, const Vec3& direction) const override;
-    Vec3 Random(const Point3& origin, std::mt19937& generator) const override;
+    Vec3 Random(const Point3& origin, Rng& generator) const override;
+    // 다른 두 축에서 region까지의 거리로 각 축의 단면 반지름 상한을 구해 region과 겹친다.
+    bool ClipBox(double time0, double time1, const Aabb& region, Aabb& output_box) const override;
 
 private:
     Point3 center_;
@@ -41,8 +45,11 @@ public:
           radius_(radius),
           material_(std::move(material)) {}
 
-    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const override;
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override;
+    bool Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const override;
     bool BoundingBox(double time0, double time1, Aabb& output_box) const override;
+    // 중심이 시간에 선형으로 움직이므로 양 끝 시각의 상자를 보간하면 그 사이 시각의 상자와 같다.
+    bool MotionBounds(double time0, double time1, Aabb& box0, Aabb& box1) const override;
 
 private:
     Point3 Center(double time) const;
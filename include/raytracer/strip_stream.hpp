@@ -0,0 +1,36 @@
+/*
+ * 설명: 영역의 타일을 모두 한 번에 스레드 풀에 넘겨 렌더링하면서, 타일 한 줄 높이의 띠(strip)가 끝나고 그 위 띠가 모두
+ *       나갔으면 곧바로 위→아래 순서로 내보내는 스트리밍 스케줄러. 아직 나가지 못한 띠는 작은 창 안에서만 보관한다.
+ * 버전: v1.4.0
+ * 관련 문서: design/renderer/v1.4.0-streaming-output.md
+ * 테스트: tests/unit/tile_test.cpp
+ */
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "raytracer/thread_pool.hpp"
+#include "raytracer/tile.hpp"
+#include "raytracer/vec3.hpp"
+
+namespace raytracer {
+
+// 띠 하나. tiles는 왼쪽→오른쪽 순서이고 sums[i]는 tiles[i]의 행 우선 픽셀 값이다.
+struct StripResult {
+    Tile strip;
+    const std::vector<Tile>& tiles;
+    const std::vector<std::vector<Color>>& sums;
+};
+
+// region을 tile_size 타일로 나눠 render_tile로 렌더링하고, 띠마다 emit_strip을 위에서 아래 순서로 한 번씩 부른다.
+// emit_strip은 한 번에 한 스레드에서만 불린다(풀 워커일 수도 있다).
+// 띠 사이에 장벽이 없어 한 띠의 느린 타일이 다른 워커를 놀리지 않는다. 타일은 띠 몇 개씩 묶은 구간(band)마다 힐베르트
+// 순서로 넘기고, 두 구간 앞 띠가 모두 나가야 다음 구간 타일을 시작하므로 보관하는 띠 수는 구간 두 개로 묶인다.
+// 구간 높이는 영역 폭이 좁아도 두 구간이 풀 스레드 수의 네 배 이상의 타일을 담도록 정한다.
+// render_tile이나 emit_strip이 던지면 남은 타일을 건너뛰고 그 예외를 다시 던진다.
+void RenderStripsInOrder(ThreadPool& pool, const Tile& region, int tile_size,
+                         const std::function<std::vector<Color>(const Tile&)>& render_tile,
+                         const std::function<void(const StripResult&)>& emit_strip);
+
+}  // namespace raytracer
@@ -60,7 +60,7 @@ private:
 class Perlin {
 public:
     Perlin() {
-        std::mt19937 generator(20240701);
+        Rng generator(20240701);
         for (int i = 0; i < kPointCount; ++i) {
             random_vectors_[i] = UnitVector(Vec3(RandomDouble(generator, -1.0, 1.0), RandomDouble(generator, -1.0, 1.0),
                                                  RandomDouble(generator, -1.0, 1.0)));
@@ -115,7 +115,7 @@ private:
             perm[i] = i;
         }
 
-        std::mt19937 generator(seed);
+        Rng generator(seed);
         for (int i = kPointCount - 1; i > 0; --i) {
             std::uniform_int_distribution<int> distribution(0, i);
             const int target = distribution(generator);
@@ -0,0 +1,58 @@
+/*
+ * 설명: 고정 개수의 워커 스레드로 인덱스 구간 작업을 분배하는 스레드 풀을 정의한다.
+ * 버전: v1.1.0
+ * 관련 문서: design/renderer/v1.1.0-tile-threads.md
+ * 테스트: tests/unit/tile_test.cpp, tests/integration/ppm_integration_test.cpp
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace raytracer {
+
+class ThreadPool {
+public:
+    // thread_count는 호출 스레드를 포함한 전체 실행 스레드 수다. 1이면 워커 없이 호출 스레드에서만 실행한다.
+    explicit ThreadPool(int thread_count);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int ThreadCount() const { return thread_count_; }
+
+    // [0, task_count) 인덱스를 앞에서부터 순서대로 배분하고 모두 끝날 때까지 대기한다.
+    // 여러 스레드에서 동시에 호출할 수 있으며, 작업 중 예외는 호출 스레드로 다시 던진다.
+    void ParallelFor(std::size_t task_count, const std::function<void(std::size_t)>& task);
+
+private:
+    struct Batch {
+        const std::function<void(std::size_t)>* task = nullptr;
+        std::size_t task_count = 0;
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> completed{0};
+        std::exception_ptr error;
+    };
+
+    void WorkerLoop();
+    void RunTasks(Batch& batch);
+
+    int thread_count_ = 1;
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable batch_done_;
+    std::deque<std::shared_ptr<Batch>> batches_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace raytracer
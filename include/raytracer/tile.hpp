@@ -0,0 +1,31 @@
+/*
+ * 설명: 이미지를 사각 타일로 나누고 캐시 지역성이 좋은 일반화 힐베르트 곡선 순서 또는 행 우선 인덱스로 나열한다.
+ * 버전: v1.3.0
+ * 관련 문서: design/renderer/v1.1.0-tile-threads.md, design/renderer/v1.3.0-shards.md
+ * 테스트: tests/unit/tile_test.cpp
+ */
+#pragma once
+
+#include <vector>
+
+namespace raytracer {
+
+// 픽셀 영역 [x0, x1) x [y0, y1)을 나타낸다.
+struct Tile {
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+
+    int Width() const { return x1 - x0; }
+    int Height() const { return y1 - y0; }
+};
+
+// 타일 격자를 일반화 힐베르트(gilbert) 곡선 순서로 반환한다. 가장자리 타일은 이미지 경계에 맞춰 잘린다.
+std::vector<Tile> BuildHilbertTiles(int width, int height, int tile_size);
+
+// 행 우선 타일 인덱스(0 = 왼쪽 위)는 스케줄 순서와 무관한 안정적인 타일 식별자로 샤드 범위 지정에 사용한다.
+int TileCount(int width, int height, int tile_size);
+Tile TileAt(int index, int width, int height, int tile_size);
+
+}  // namespace raytracer
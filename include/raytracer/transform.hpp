@@ -1,7 +1,8 @@
 /*
- * 설명: Hittable 객체에 평행 이동과 Y축 회전을 적용하는 변환 래퍼를 제공한다.
- * 버전: v0.9.0
- * 관련 문서: design/renderer/v0.8.0-cornell.md, design/renderer/v0.9.0-volume.md
+ * 설명: Hittable 객체에 평행 이동과 Y축 회전을 적용하는 변환 래퍼를 제공한다. 애니메이션 프레임 사이에 변환 값을 바꿀 수 있다.
+ * 버전: v1.20.0
+ * 관련 문서: design/renderer/v0.8.0-cornell.md, design/renderer/v0.9.0-volume.md, design/renderer/v1.9.0-animation.md,
+ *           design/renderer/v1.20.0-occlusion.md
  * 테스트: tests/unit/quad_test.cpp
  */
 #pragma once
@@ -18,9 +19,14 @@ class Translate : public Hittable {
 public:
     Translate(std::shared_ptr<Hittable> object, const Vec3& offset);
 
-    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const override;
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override;
+    bool Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const override;
     bool BoundingBox(double time0, double time1, Aabb& output_box) const override;
 
+    // 렌더 중에는 호출하면 안 된다. 이 객체를 담은 BVH는 BvhNode::Refit으로 경계를 갱신해야 한다.
+    void SetOffset(const Vec3& offset) { offset_ = offset; }
+    const Vec3& Offset() const { return offset_; }
+
 private:
     std::shared_ptr<Hittable> object_;
     Vec3 offset_;
@@ -30,10 +36,16 @@ class RotateY : public Hittable {
 public:
     RotateY(std::shared_ptr<Hittable> object, double angle_degrees);
 
-    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const override;
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override;
+    bool Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const override;
     bool BoundingBox(double time0, double time1, Aabb& output_box) const override;
 
+    // 회전각과 회전된 경계 상자를 다시 계산한다. SetOffset과 같은 호출 제약을 따른다.
+    void SetAngle(double angle_degrees);
+
 private:
+    Ray ToObject(const Ray& r) const;
+
     std::shared_ptr<Hittable> object_;
     double sin_theta_ = 0.0;
     double cos_theta_ = 1.0;
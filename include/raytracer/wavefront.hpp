@@ -0,0 +1,28 @@
+/*
+ * 설명: 타일의 (픽셀, 샘플) 경로들을 SoA 버퍼에 모아 생성·교차·재질별 음영·광원 샘플링·누적 단계를 한꺼번에 도는
+ *       웨이브프런트 적분기를 제공한다. 재귀 적분기와 같은 추정량을 경로마다 같은 난수 순서로 계산한다.
+ * 버전: v1.22.0
+ * 관련 문서: design/renderer/v1.22.0-wavefront.md
+ * 테스트: tests/integration/ppm_integration_test.cpp
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "raytracer/render_kernel.hpp"
+#include "raytracer/tile.hpp"
+#include "raytracer/vec3.hpp"
+
+namespace raytracer {
+
+// 한 번에 추적하는 경로 수 상한. 타일의 경로가 더 많으면 (픽셀, 샘플) 순서로 잘라 차례로 처리한다.
+// 경로 상태와 교차 기록이 캐시에 남는 크기로 골랐다(측정은 설계 문서 참고).
+constexpr std::size_t kWavefrontBatchSize = 1024;
+
+// RenderTileSums와 같은 타일 로컬 샘플 합을 돌려준다. 비트 단위로 같다.
+// options.packet_size가 1이 아니면 첫 교차 단계에서 이어진 경로들을 그 크기씩 묶어 HitPacket으로 순회한다.
+// packet_size가 1, 4, 8, 16이 아니면 std::invalid_argument를 던진다.
+std::vector<Color> RenderTileSumsWavefront(const RenderContext& context, const Tile& tile);
+
+}  // namespace raytracer
@@ -0,0 +1,103 @@
+/*
+ * 설명: 이진 BvhNode 트리를 접어 노드마다 자식 4개/8개의 경계를 SoA로 담은 넓은 BVH(BVH4/BVH8)를 만들고,
+ *       SIMD(AVX 또는 SSE2)로 한 레이를 여러 자식 상자와 한 번에 비교해 가까운 자식부터 순회한다.
+ *       노드 배열은 공유 저장소에 두어 캐시 파일을 mmap한 영역도 복사 없이 순회할 수 있다.
+ *       가림 판정은 칸을 정렬하지 않고 처음 찾은 교차에서 멈춘다. 화면 레이 묶음은 노드를 함께 방문한다.
+ *       타일 절두체 밖 칸을 지우고 외길 노드를 건너뛴 부분 트리를 만들어 화면 레이가 위쪽 노드를 다시 검사하지 않게 한다.
+ * 버전: v1.23.0
+ * 관련 문서: design/renderer/v1.12.0-wide-bvh.md, design/renderer/v1.18.0-bvh-cache.md,
+ *           design/renderer/v1.20.0-occlusion.md, design/renderer/v1.21.0-ray-packets.md,
+ *           design/renderer/v1.23.0-tile-culling.md
+ * 테스트: tests/unit/bvh_test.cpp
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "raytracer/bvh.hpp"
+#include "raytracer/frustum.hpp"
+#include "raytracer/hittable.hpp"
+
+namespace raytracer {
+
+// 자식 칸(lane)마다 경계를 축/최소·최대별 배열에 나눠 담아 SIMD로 한 번에 읽는다.
+// 경계는 LinearBvhNode와 같이 바깥쪽으로 반올림한 float다. child가 0 이상이면 내부 노드 인덱스,
+// 음수면 잎이며 첫 객체 인덱스는 -(child + 1), 객체 수는 count다. lane_count 이후 칸은 비어 있다.
+template <int Width>
+struct alignas(64) WideBvhNode {
+    float min_x[Width];
+    float min_y[Width];
+    float min_z[Width];
+    float max_x[Width];
+    float max_y[Width];
+    float max_z[Width];
+    std::int32_t child[Width];
+    std::uint16_t count[Width];
+    std::uint8_t lane_count;
+};
+
+static_assert(sizeof(WideBvhNode<4>) == 128, "BVH4 노드는 128바이트여야 한다.");
+static_assert(sizeof(WideBvhNode<8>) == 256, "BVH8 노드는 256바이트여야 한다.");
+
+template <int Width>
+class WideBvh : public Hittable {
+public:
+    static_assert(Width == 4 || Width == 8, "넓은 BVH 폭은 4 또는 8이다.");
+
+    // tree의 이진 노드를 표면적이 큰 내부 자식부터 펼쳐 노드당 최대 Width개 자식으로 접는다.
+    // 잎 객체 경계는 [time0, time1] 구간으로 계산한다(tree 빌드 구간과 같아야 한다).
+    WideBvh(const BvhNode& tree, double time0, double time1);
+    WideBvh(std::vector<std::shared_ptr<Hittable>> objects, double time0, double time1,
+            const BvhBuildOptions& options = BvhBuildOptions{});
+    // 이미 만든 노드 배열(예: mmap한 캐시 파일)로 순회 구조를 복원한다. storage가 nodes의 수명을 유지한다.
+    // 노드 참조와 잎 범위가 올바르고 depth가 실제 깊이 이상이라는 검증은 호출자가 한다.
+    WideBvh(std::shared_ptr<const void> storage, const WideBvhNode<Width>* nodes, std::size_t node_count,
+            std::vector<std::shared_ptr<Hittable>> primitives, const Aabb& root_box, int depth);
+
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override;
+    bool Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const override;
+    // 묶음의 레이가 모두 빗나간 자식만 건너뛰고, 자식 순서가 묶음과 어긋난 레이는 그 자리에서 단일 순회로 끝낸다.
+    std::uint32_t HitPacket(const Ray* rays, int count, double t_min, double t_max, HitRecord* records,
+                            Rng* generators) const override;
+    bool BoundingBox(double time0, double time1, Aabb& output_box) const override;
+    std::unique_ptr<Hittable> CullFrustum(const Frustum& frustum) const override;
+
+    // frustum 밖에 완전히 있는 칸을 지우고, 내부 노드 자식 하나만 남은 노드는 그 자식으로 건너뛴 부분 트리를 만든다.
+    // frustum 꼭짓점에서 나가 그 안을 지나는 레이는 지운 칸 상자에 닿을 수 없고 건너뛴 노드에서는 남은 자식 하나만
+    // 쌓으므로, 이 트리에서 같은 도형을 같은 순서로 검사한다. 객체 배열은 원본과 공유한다. 남는 칸이 없으면 뿌리는 빈 노드다.
+    WideBvh CulledBy(const Frustum& frustum) const;
+
+    std::size_t NodeCount() const { return node_count_; }
+    std::size_t PrimitiveCount() const { return primitives_->size(); }
+    int Depth() const { return depth_; }
+    const WideBvhNode<Width>* Nodes() const { return nodes_; }
+    const std::vector<std::shared_ptr<Hittable>>& Primitives() const { return *primitives_; }
+
+private:
+    struct Lane {
+        Aabb box;
+        std::shared_ptr<Hittable> object;
+        BvhNode::ChildKind kind;
+    };
+
+    void CollectLanes(const BvhNode& node, double time0, double time1, std::vector<Lane>& lanes) const;
+    std::int32_t AppendNode(const BvhNode& node, double time0, double time1, int depth,
+                            std::vector<WideBvhNode<Width>>& nodes, std::vector<std::shared_ptr<Hittable>>& primitives);
+
+    // 복사해도 같은 노드 배열을 가리키도록 저장소를 공유한다.
+    std::shared_ptr<const void> storage_;
+    const WideBvhNode<Width>* nodes_ = nullptr;
+    std::size_t node_count_ = 0;
+    // 절두체로 잘라 낸 부분 트리와 공유하므로 타일마다 객체 포인터를 복사하지 않는다.
+    std::shared_ptr<const std::vector<std::shared_ptr<Hittable>>> primitives_;
+    Aabb root_box_;
+    int depth_ = 0;
+};
+
+using Bvh4 = WideBvh<4>;
+using Bvh8 = WideBvh<8>;
+
+}  // namespace raytracer
@@ -0,0 +1,116 @@
+/*
+ * 설명: 턴테이블 프레임 자세(상자 자전 각도, 카메라 흔들림)를 계산해 변환 손잡이에 적용하고 BVH 재맞춤으로 프레임들을 렌더링한다.
+ * 버전: v1.12.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.9.0-animation.md, design/renderer/v1.11.0-linear-bvh.md,
+ *           design/renderer/v1.12.0-wide-bvh.md
+ * 테스트: tests/integration/animation_test.cpp
+ */
+#include "raytracer/animation.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+#include "raytracer/ppm.hpp"
+#include "raytracer/tile.hpp"
+
+namespace raytracer {
+namespace {
+
+constexpr double kPi = 3.1415926535897932385;
+// 카메라는 방 중심을 기준으로 좌우 최대 이 각도까지 한 번 흔들렸다가 프레임 0 위치로 돌아온다.
+constexpr double kCameraSwayDegrees = 10.0;
+
+// RotateY와 같은 방향(객체 좌표 -> 월드 좌표)으로 Y축 회전한다.
+Vec3 RotateAroundY(const Vec3& v, double angle_degrees) {
+    const double radians = angle_degrees * kPi / 180.0;
+    const double sin_theta = std::sin(radians);
+    const double cos_theta = std::cos(radians);
+    return Vec3(cos_theta * v.x() + sin_theta * v.z(), v.y(), -sin_theta * v.x() + cos_theta * v.z());
+}
+
+// 회전 중심의 월드 위치가 구성 직후와 같도록 이동량을 보정한다. 추가 회전이 0이면 보정량도 정확히 0이다.
+void PoseTurntable(const TurntableHandle& handle, double extra_degrees) {
+    const double angle = handle.base_angle_degrees + extra_degrees;
+    const Vec3 drift = RotateAroundY(handle.pivot, handle.base_angle_degrees) - RotateAroundY(handle.pivot, angle);
+    handle.rotation->SetAngle(angle);
+    handle.translation->SetOffset(handle.base_offset + drift);
+}
+
+double FramePhase(const AnimationOptions& animation, int frame) {
+    return static_cast<double>(frame) / static_cast<double>(animation.frame_count);
+}
+
+}  // namespace
+
+std::string FrameOutputPath(const std::string& pattern, int frame) {
+    const std::size_t begin = pattern.find('#');
+    if (begin == std::string::npos) {
+        throw std::invalid_argument("프레임 출력 경로에 프레임 번호 자리 '#'가 필요하다.");
+    }
+    std::size_t end = begin;
+    while (end < pattern.size() && pattern[end] == '#') {
+        ++end;
+    }
+
+    std::string number = std::to_string(frame);
+    if (number.size() < end - begin) {
+        number.insert(0, end - begin - number.size(), '0');
+    }
+    return pattern.substr(0, begin) + number + pattern.substr(end);
+}
+
+Camera MakeAnimationCamera(const RenderOptions& options, const AnimationOptions& animation, int frame) {
+    const double aspect_ratio = static_cast<double>(options.width) / static_cast<double>(options.height);
+    const Point3 room_center(278.0, 278.0, 278.0);
+    const double sway = kCameraSwayDegrees * std::sin(2.0 * kPi * FramePhase(animation, frame));
+    const Point3 look_from = room_center + RotateAroundY(Point3(278.0, 278.0, -800.0) - room_center, sway);
+    const Point3 look_at = room_center + RotateAroundY(Point3(278.0, 278.0, 0.0) - room_center, sway);
+    const Vec3 vup(0.0, 1.0, 0.0);
+    const double focus_dist = (look_from - look_at).length();
+    return Camera(look_from, look_at, vup, options.vertical_fov_degrees, aspect_ratio, options.aperture, focus_dist,
+                  options.shutter_open_time, options.shutter_close_time);
+}
+
+BvhRefitStats PoseAnimationFrame(Scene& scene, const RenderOptions& options, const AnimationOptions& animation, int frame) {
+    const double turn = 360.0 * FramePhase(animation, frame);
+    for (const TurntableHandle& handle : scene.turntables) {
+        PoseTurntable(handle, turn);
+    }
+    if (!scene.bvh_tree) {
+        return BvhRefitStats{};
+    }
+    const BvhRefitStats stats =
+        scene.bvh_tree->Refit(options.shutter_open_time, options.shutter_close_time, animation.rebuild_threshold);
+    // 재맞춤한 경계와 재구성한 서브트리를 렌더용 넓은 BVH에 반영한다. 접기는 노드 수에 선형이다.
+    scene.wide_bvh = std::make_shared<Bvh8>(*scene.bvh_tree, options.shutter_open_time, options.shutter_close_time);
+    return stats;
+}
+
+AnimationStats RenderAnimation(const RenderOptions& options, const AnimationOptions& animation,
+                               const std::string& output_pattern, PpmFormat format, ThreadPool& pool) {
+    if (animation.frame_count < 1) {
+        throw std::invalid_argument("프레임 수는 1 이상이어야 한다.");
+    }
+
+    Scene scene = BuildCornellSmokeScene(options.shutter_open_time, options.shutter_close_time);
+    const Tile full{0, 0, options.width, options.height};
+    AnimationStats stats;
+    for (int frame = 0; frame < animation.frame_count; ++frame) {
+        const BvhRefitStats refit = PoseAnimationFrame(scene, options, animation, frame);
+        stats.bvh.refitted_nodes += refit.refitted_nodes;
+        stats.bvh.rebuilt_subtrees += refit.rebuilt_subtrees;
+
+        const std::string path = FrameOutputPath(output_pattern, frame);
+        std::ofstream file(path, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("프레임 출력 파일을 열 수 없다: " + path);
+        }
+        PpmStreamWriter writer(file, format);
+        RenderMaterialRegion(options, scene, MakeAnimationCamera(options, animation, frame), pool, full, writer);
+        ++stats.frames;
+    }
+    return stats;
+}
+
+}  // namespace raytracer
@@ -0,0 +1,70 @@
+/*
+ * 설명: 배치 매니페스트를 검증·해석하고, 변형마다 출력 파일을 열어 공유 장면/스레드 풀로 행 단위 렌더링한다.
+ * 버전: v1.8.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.8.0-batch.md
+ * 테스트: tests/integration/batch_test.cpp
+ */
+#include "raytracer/batch.hpp"
+
+#include <exception>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+
+#include "raytracer/image_sink.hpp"
+#include "raytracer/ppm.hpp"
+
+namespace raytracer {
+
+std::vector<RenderRequest> ParseBatchManifest(std::istream& input, const RenderOptions& defaults) {
+    std::vector<RenderRequest> requests;
+    std::set<std::string> outputs;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(input, line)) {
+        ++line_number;
+        const std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        const std::string prefix = std::to_string(line_number) + "행: ";
+        RenderRequest request;
+        try {
+            request = ParseRenderRequest(line, defaults);
+        } catch (const std::invalid_argument& error) {
+            throw std::runtime_error(prefix + error.what());
+        }
+        if (request.output_path.empty()) {
+            throw std::runtime_error(prefix + "output 경로가 필요하다.");
+        }
+        if (!outputs.insert(request.output_path).second) {
+            throw std::runtime_error(prefix + "output 경로가 앞 줄과 겹친다: " + request.output_path);
+        }
+        requests.push_back(std::move(request));
+    }
+    if (requests.empty()) {
+        throw std::runtime_error("매니페스트에 렌더 요청이 없다.");
+    }
+    return requests;
+}
+
+std::vector<std::string> RenderBatch(const std::vector<RenderRequest>& requests, const Scene& scene, ThreadPool& pool) {
+    std::vector<std::string> errors(requests.size());
+    pool.ParallelFor(requests.size(), [&](std::size_t index) {
+        const RenderRequest& request = requests[index];
+        try {
+            std::ofstream file(request.output_path, std::ios::out | std::ios::trunc | std::ios::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("파일을 열 수 없다.");
+            }
+            PpmStreamWriter writer(file, request.format);
+            RenderMaterialRegion(request.options, scene, pool, request.crop, writer);
+        } catch (const std::exception& error) {
+            errors[index] = error.what();
+        }
+    });
+    return errors;
+}
+
+}  // namespace raytracer
@@ -1,59 +1,735 @@
 /*
- * 설명: Hittable들을 BVH로 구성해 경계 상자를 이용한 빠른 hit 판정을 수행한다.
- * 버전: v0.9.0
- * 관련 문서: design/renderer/v0.6.0-bvh.md, design/renderer/v0.9.0-volume.md
+ * 설명: Hittable들을 BVH로 구성해 경계 상자를 이용한 빠른 hit 판정을 수행하고, 애니메이션 프레임 사이에 경계를 재맞춤한다.
+ *       객체별 경계 상자/무게중심을 한 번만 계산해 두고 구간 분할 SAH 또는 중앙값 분할로 트리를 만든다.
+ *       스레드 풀이 있으면 큰 구간의 집계를 조각별로 나눠 계산해 고정 순서로 합치고, 두 자식 서브트리를 동시에 빌드한다.
+ *       hit는 가까운 자식부터 방문해 먼저 찾은 교차 거리로 먼 자식의 구간을 줄이고, 교차 기록 하나에 바로 쓴다.
+ *       공간 분할 모드는 노드마다 참조 벡터를 따로 두고, 가로지르는 참조를 평면에서 잘라 복제 상한 안에서 양쪽에 넣는다.
+ *       순회 카운터를 켠 빌드에서만 hit가 방문 노드와 잎 도형 검사 수를 더한다.
+ *       가림 판정은 같은 순서로 내려가되 먼 자식 구간을 줄이지 않고 처음 가리는 자식에서 멈춘다.
+ *       지연 빌드 노드는 공유 객체 배열의 구간과 경계만 갖고 있다가, 레이가 처음 들어오면 once 가드 안에서 한 단계 나눈다.
+ * 버전: v1.24.0
+ * 관련 문서: design/renderer/v0.6.0-bvh.md, design/renderer/v0.9.0-volume.md, design/renderer/v1.9.0-animation.md,
+ *           design/renderer/v1.10.0-sah-build.md, design/renderer/v1.13.0-parallel-build.md,
+ *           design/renderer/v1.14.0-ordered-traversal.md, design/renderer/v1.15.0-sbvh.md,
+ *           design/renderer/v1.19.0-bvh-stats.md, design/renderer/v1.20.0-occlusion.md,
+ *           design/renderer/v1.24.0-lazy-bvh.md
  * 테스트: tests/unit/bvh_test.cpp
  */
 #include "raytracer/bvh.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <stdexcept>
+#include <unordered_set>
 
+#include "raytracer/bvh_stats.hpp"
 #include "raytracer/hittable_list.hpp"
+#include "raytracer/thread_pool.hpp"
+
+#include "bvh_float_util.hpp"
 
 namespace raytracer {
+namespace {
+
+using detail::SurfaceArea;
+
+// SurroundingBox의 항등원. 첫 상자를 합치면 그 상자가 된다.
+Aabb EmptyBox() {
+    constexpr double kInf = std::numeric_limits<double>::infinity();
+    return Aabb(Point3(kInf, kInf, kInf), Point3(-kInf, -kInf, -kInf));
+}
+
+Aabb PointBox(const Point3& point) { return Aabb(point, point); }
+
+int LongestAxis(const Aabb& box) {
+    const Vec3 diag = box.maximum() - box.minimum();
+    if (diag.x() >= diag.y() && diag.x() >= diag.z()) {
+        return 0;
+    }
+    if (diag.y() >= diag.z()) {
+        return 1;
+    }
+    return 2;
+}
+
+void ValidateBuildOptions(const BvhBuildOptions& options) {
+    if (options.max_leaf_size < 1) {
+        throw std::invalid_argument("BVH 잎 최대 객체 수는 1 이상이어야 한다.");
+    }
+    if (options.bin_count < 2) {
+        throw std::invalid_argument("BVH SAH 구간 수는 2 이상이어야 한다.");
+    }
+    if (!(options.max_reference_growth >= 0.0)) {
+        throw std::invalid_argument("BVH 참조 증가 비율은 0 이상이어야 한다.");
+    }
+    if (options.lazy && options.split == BvhSplitMethod::kSpatialSah) {
+        throw std::invalid_argument("BVH 지연 빌드는 공간 분할(kSpatialSah)과 함께 쓸 수 없다.");
+    }
+}
+
+// 이보다 작은 구간은 조각으로 나누거나 자식을 따로 빌드해도 작업 배분 비용이 더 크다.
+constexpr size_t kParallelBuildMinimum = size_t{1} << 14;
+constexpr size_t kChunkSize = size_t{1} << 12;
+
+// 스레드 풀이 없거나 구간이 작으면 조각 1개(직렬)다. 조각 수는 스레드 수에 따라 달라지지만,
+// 조각 결과는 min/max와 정수 합으로만 합치므로 합친 값은 조각 수와 무관하다.
+size_t ChunkCount(const ThreadPool* pool, size_t count) {
+    if (pool == nullptr || pool->ThreadCount() < 2 || count < kParallelBuildMinimum) {
+        return 1;
+    }
+    return std::min(count / kChunkSize, static_cast<size_t>(pool->ThreadCount()) * 4);
+}
 
-BvhNode::BvhNode(std::vector<std::shared_ptr<Hittable>> objects, double time0, double time1) {
+// task(chunk, begin, end)를 조각마다 호출한다. 직렬일 때는 std::function으로 감싸지 않고 바로 호출한다.
+// 노드마다 불리므로 작은 노드에서는 감싸는 비용도 빌드 시간에 그대로 보인다.
+template <typename Task>
+void ForEachChunk(ThreadPool* pool, size_t start, size_t end, size_t chunk_count, const Task& task) {
+    if (chunk_count == 1) {
+        task(size_t{0}, start, end);
+        return;
+    }
+    pool->ParallelFor(chunk_count, [&](size_t chunk) {
+        task(chunk, start + (end - start) * chunk / chunk_count, start + (end - start) * (chunk + 1) / chunk_count);
+    });
+}
+
+// 조각마다 box_of(i)를 합친 상자를 구한 뒤 조각 순서대로 합친다.
+template <typename BoxOf>
+Aabb ReduceBoxes(ThreadPool* pool, size_t start, size_t end, size_t chunk_count, const BoxOf& box_of) {
+    const auto reduce = [&box_of](size_t begin, size_t finish) {
+        Aabb merged = EmptyBox();
+        for (size_t i = begin; i < finish; ++i) {
+            merged = SurroundingBox(merged, box_of(i));
+        }
+        return merged;
+    };
+    if (chunk_count == 1) {
+        return reduce(start, end);
+    }
+
+    std::vector<Aabb> chunk_boxes(chunk_count);
+    ForEachChunk(pool, start, end, chunk_count,
+                 [&](size_t chunk, size_t begin, size_t finish) { chunk_boxes[chunk] = reduce(begin, finish); });
+    Aabb merged = EmptyBox();
+    for (const Aabb& box : chunk_boxes) {
+        merged = SurroundingBox(merged, box);
+    }
+    return merged;
+}
+
+bool IsEmptyBox(const Aabb& box) {
+    return box.minimum().x() > box.maximum().x() || box.minimum().y() > box.maximum().y() ||
+           box.minimum().z() > box.maximum().z();
+}
+
+Aabb IntersectBoxes(const Aabb& a, const Aabb& b) {
+    return Aabb(Point3(std::max(a.minimum().x(), b.minimum().x()), std::max(a.minimum().y(), b.minimum().y()),
+                       std::max(a.minimum().z(), b.minimum().z())),
+                Point3(std::min(a.maximum().x(), b.maximum().x()), std::min(a.maximum().y(), b.maximum().y()),
+                       std::min(a.maximum().z(), b.maximum().z())));
+}
+
+Aabb WithAxisBounds(const Aabb& box, int axis, double low, double high) {
+    double minimum[3] = {box.minimum().x(), box.minimum().y(), box.minimum().z()};
+    double maximum[3] = {box.maximum().x(), box.maximum().y(), box.maximum().z()};
+    minimum[axis] = low;
+    maximum[axis] = high;
+    return Aabb(Point3(minimum[0], minimum[1], minimum[2]), Point3(maximum[0], maximum[1], maximum[2]));
+}
+
+// 무게중심 구간 경계 중 SAH 비용이 가장 작은 객체 분할. axis < 0이면 무게중심이 한 점에 모여 나눌 수 없다.
+struct ObjectSplit {
+    double cost = std::numeric_limits<double>::infinity();
+    int axis = -1;
+    size_t bin = 0;
+    size_t bin_count = 0;
+    double low = 0.0;
+    double scale = 0.0;
+    Aabb left_box;
+    Aabb right_box;
+
+    size_t BinOf(const Point3& centroid) const {
+        return std::min(bin_count - 1, static_cast<size_t>((centroid[axis] - low) * scale));
+    }
+};
+
+// 교차 비용과 순회 비용을 같다고 두고 A(L)N(L) + A(R)N(R)을 최소화한다(부모 면적은 모든 후보에 공통이라 뺀다).
+// 큰 구간은 조각별로 구간을 모은 뒤 조각 순서대로 합친다.
+template <typename Primitive>
+ObjectSplit FindObjectSplit(const std::vector<Primitive>& primitives, size_t start, size_t end, size_t bins,
+                            ThreadPool* pool) {
+    const size_t chunk_count = ChunkCount(pool, end - start);
+    const Aabb centroid_bounds = ReduceBoxes(pool, start, end, chunk_count,
+                                             [&primitives](size_t i) { return PointBox(primitives[i].centroid); });
+
+    double lows[3];
+    double scales[3];
+    bool splittable[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        lows[axis] = centroid_bounds.minimum()[axis];
+        const double extent = centroid_bounds.maximum()[axis] - lows[axis];
+        splittable[axis] = extent > 0.0;
+        scales[axis] = splittable[axis] ? static_cast<double>(bins) / extent : 0.0;
+    }
+
+    // [축][구간] 순서로 모은다. 축마다 따로 돌아 구간 배열과 축 상수를 레지스터/L1에 붙잡아 둔다.
+    const auto accumulate = [&](size_t begin, size_t finish, Aabb* boxes, size_t* counts) {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (!splittable[axis]) {
+                continue;
+            }
+            Aabb* axis_boxes = boxes + static_cast<size_t>(axis) * bins;
+            size_t* axis_counts = counts + static_cast<size_t>(axis) * bins;
+            const double low = lows[axis];
+            const double scale = scales[axis];
+            for (size_t i = begin; i < finish; ++i) {
+                const size_t bin = std::min(bins - 1, static_cast<size_t>((primitives[i].centroid[axis] - low) * scale));
+                axis_boxes[bin] = SurroundingBox(axis_boxes[bin], primitives[i].box);
+                ++axis_counts[bin];
+            }
+        }
+    };
+    std::vector<Aabb> bin_boxes(3 * bins, EmptyBox());
+    std::vector<size_t> bin_counts(3 * bins, 0);
+    if (chunk_count == 1) {
+        accumulate(start, end, bin_boxes.data(), bin_counts.data());
+    } else {
+        std::vector<Aabb> chunk_boxes(chunk_count * 3 * bins, EmptyBox());
+        std::vector<size_t> chunk_counts(chunk_count * 3 * bins, 0);
+        ForEachChunk(pool, start, end, chunk_count, [&](size_t chunk, size_t begin, size_t finish) {
+            accumulate(begin, finish, chunk_boxes.data() + chunk * 3 * bins, chunk_counts.data() + chunk * 3 * bins);
+        });
+        for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+            for (size_t slot = 0; slot < 3 * bins; ++slot) {
+                bin_boxes[slot] = SurroundingBox(bin_boxes[slot], chunk_boxes[chunk * 3 * bins + slot]);
+                bin_counts[slot] += chunk_counts[chunk * 3 * bins + slot];
+            }
+        }
+    }
+
+    ObjectSplit best;
+    best.bin_count = bins;
+    std::vector<Aabb> right_boxes(bins);
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!splittable[axis]) {
+            continue;
+        }
+
+        const Aabb* axis_boxes = bin_boxes.data() + static_cast<size_t>(axis) * bins;
+        const size_t* axis_counts = bin_counts.data() + static_cast<size_t>(axis) * bins;
+        Aabb right_box = EmptyBox();
+        for (size_t bin = bins - 1; bin > 0; --bin) {
+            right_box = SurroundingBox(right_box, axis_boxes[bin]);
+            right_boxes[bin] = right_box;
+        }
+
+        Aabb left_box = EmptyBox();
+        size_t left_count = 0;
+        const size_t total = end - start;
+        for (size_t split = 1; split < bins; ++split) {
+            left_box = SurroundingBox(left_box, axis_boxes[split - 1]);
+            left_count += axis_counts[split - 1];
+            const size_t right_count = total - left_count;
+            if (left_count == 0 || right_count == 0) {
+                continue;
+            }
+            const double cost = SurfaceArea(left_box) * static_cast<double>(left_count) +
+                                SurfaceArea(right_boxes[split]) * static_cast<double>(right_count);
+            if (cost < best.cost) {
+                best.cost = cost;
+                best.axis = axis;
+                best.bin = split;
+                best.left_box = left_box;
+                best.right_box = right_boxes[split];
+            }
+        }
+    }
+    if (best.axis >= 0) {
+        best.low = lows[best.axis];
+        best.scale = scales[best.axis];
+    }
+    return best;
+}
+
+// 공간 분할 후보는 객체 분할의 두 자식 상자 겹침이 뿌리 표면적의 이 비율을 넘을 때만 계산한다(Stich et al.의 alpha).
+constexpr double kSpatialOverlapRatio = 1.0e-5;
+
+// 공간 분할로 잘린 참조. 교차는 원래 객체에 맡기고 경계 상자만 잘린 상자를 돌려, 평탄화/넓은 BVH도 좁은 상자를 쓰게 한다.
+class ClippedReference : public Hittable {
+public:
+    ClippedReference(std::shared_ptr<Hittable> object, const Aabb& box) : object_(std::move(object)), box_(box) {}
+
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override {
+        return object_->Hit(r, t_min, t_max, record, generator);
+    }
+
+    bool Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const override {
+        return object_->Occluded(r, t_min, t_max, generator);
+    }
+
+    bool BoundingBox(double /*time0*/, double /*time1*/, Aabb& output_box) const override {
+        output_box = box_;
+        return true;
+    }
+
+    const std::shared_ptr<Hittable>& Object() const { return object_; }
+
+private:
+    std::shared_ptr<Hittable> object_;
+    Aabb box_;
+};
+
+enum class ClipResult { kUnsupported, kEmpty, kClipped };
+
+// 참조의 현재 상자 안에서 region을 자른다. 이전에 잘린 참조도 결과가 현재 상자를 넘지 않는다.
+template <typename Primitive>
+ClipResult ClipReference(const Primitive& reference, const Aabb& region, double time0, double time1, Aabb& output_box) {
+    if (!reference.object->ClipBox(time0, time1, IntersectBoxes(reference.box, region), output_box)) {
+        return ClipResult::kUnsupported;
+    }
+    return IsEmptyBox(output_box) ? ClipResult::kEmpty : ClipResult::kClipped;
+}
+
+template <typename Primitive>
+Primitive MakeClippedReference(const Primitive& reference, const Aabb& box) {
+    return Primitive{reference.object, box, 0.5 * (box.minimum() + box.maximum()), true};
+}
+
+struct SpatialSplit {
+    double cost = std::numeric_limits<double>::infinity();
+    int axis = -1;
+    double plane = 0.0;
+};
+
+// 노드 상자를 축마다 bins개 구간으로 나누고, 구간을 가로지르는 참조는 구간마다 잘라 그 구간 상자에 더한다.
+// 참조는 시작 구간에서 들어오고(entries) 끝 구간에서 나가며(exits), 경계 k의 비용은 A(L)·들어온 수 + A(R)·나간 수다.
+// 쪼갤 수 없는 참조는 무게중심 구간에 통째로 넣는다.
+template <typename Primitive>
+SpatialSplit FindSpatialSplit(const std::vector<Primitive>& references, const Aabb& bounds, size_t bins, double time0,
+                              double time1) {
+    SpatialSplit best;
+    std::vector<Aabb> bin_boxes(bins);
+    std::vector<size_t> entries(bins);
+    std::vector<size_t> exits(bins);
+    std::vector<Aabb> right_boxes(bins);
+    for (int axis = 0; axis < 3; ++axis) {
+        const double low = bounds.minimum()[axis];
+        const double high = bounds.maximum()[axis];
+        const double width = (high - low) / static_cast<double>(bins);
+        if (!(width > 0.0)) {
+            continue;
+        }
+        const auto bin_of = [&](double coordinate) {
+            return std::min(bins - 1, static_cast<size_t>(std::max(0.0, (coordinate - low) / width)));
+        };
+        const auto bin_low = [&](size_t bin) { return low + width * static_cast<double>(bin); };
+        const auto bin_high = [&](size_t bin) { return bin + 1 == bins ? high : low + width * static_cast<double>(bin + 1); };
+
+        std::fill(bin_boxes.begin(), bin_boxes.end(), EmptyBox());
+        std::fill(entries.begin(), entries.end(), 0);
+        std::fill(exits.begin(), exits.end(), 0);
+        for (const Primitive& reference : references) {
+            const size_t first = bin_of(reference.box.minimum()[axis]);
+            const size_t last = bin_of(reference.box.maximum()[axis]);
+            bool whole = first == last;
+            for (size_t bin = first; !whole && bin <= last; ++bin) {
+                Aabb clipped;
+                const ClipResult result = ClipReference(
+                    reference, WithAxisBounds(reference.box, axis, bin_low(bin), bin_high(bin)), time0, time1, clipped);
+                if (result == ClipResult::kUnsupported) {
+                    whole = true;
+                } else if (result == ClipResult::kClipped) {
+                    bin_boxes[bin] = SurroundingBox(bin_boxes[bin], clipped);
+                }
+            }
+            if (whole) {
+                const size_t bin = bin_of(reference.centroid[axis]);
+                bin_boxes[bin] = SurroundingBox(bin_boxes[bin], reference.box);
+                ++entries[bin];
+                ++exits[bin];
+            } else {
+                ++entries[first];
+                ++exits[last];
+            }
+        }
+
+        Aabb right_box = EmptyBox();
+        for (size_t bin = bins - 1; bin > 0; --bin) {
+            right_box = SurroundingBox(right_box, bin_boxes[bin]);
+            right_boxes[bin] = right_box;
+        }
+        size_t right_count = 0;
+        for (const size_t count : exits) {
+            right_count += count;
+        }
+
+        Aabb left_box = EmptyBox();
+        size_t left_count = 0;
+        for (size_t split = 1; split < bins; ++split) {
+            left_box = SurroundingBox(left_box, bin_boxes[split - 1]);
+            left_count += entries[split - 1];
+            right_count -= exits[split - 1];
+            if (left_count == 0 || right_count == 0 || IsEmptyBox(left_box) || IsEmptyBox(right_boxes[split])) {
+                continue;
+            }
+            const double cost = SurfaceArea(left_box) * static_cast<double>(left_count) +
+                                SurfaceArea(right_boxes[split]) * static_cast<double>(right_count);
+            if (cost < best.cost) {
+                best.cost = cost;
+                best.axis = axis;
+                best.plane = bin_low(split);
+            }
+        }
+    }
+    return best;
+}
+
+// 평면 한쪽에만 있는 참조는 그쪽으로, 가로지르는 참조는 양쪽으로 잘라 복제한다. 복제 여유가 없거나 쪼갤 수 없으면
+// 무게중심 쪽으로 통째로 보낸다. 한쪽이 비면 false를 반환하고 여유를 쓰지 않는다.
+template <typename Primitive>
+bool ApplySpatialSplit(const std::vector<Primitive>& references, const SpatialSplit& split, double time0, double time1,
+                       size_t& remaining_references, std::vector<Primitive>& left, std::vector<Primitive>& right) {
+    size_t duplicates = 0;
+    for (const Primitive& reference : references) {
+        if (reference.box.maximum()[split.axis] <= split.plane) {
+            left.push_back(reference);
+            continue;
+        }
+        if (reference.box.minimum()[split.axis] >= split.plane) {
+            right.push_back(reference);
+            continue;
+        }
+
+        Aabb left_box;
+        Aabb right_box;
+        const ClipResult left_result = ClipReference(
+            reference, WithAxisBounds(reference.box, split.axis, reference.box.minimum()[split.axis], split.plane), time0,
+            time1, left_box);
+        const ClipResult right_result = ClipReference(
+            reference, WithAxisBounds(reference.box, split.axis, split.plane, reference.box.maximum()[split.axis]), time0,
+            time1, right_box);
+        const bool supported = left_result != ClipResult::kUnsupported && right_result != ClipResult::kUnsupported;
+        if (supported && left_result == ClipResult::kClipped && right_result == ClipResult::kClipped &&
+            duplicates < remaining_references) {
+            left.push_back(MakeClippedReference(reference, left_box));
+            right.push_back(MakeClippedReference(reference, right_box));
+            ++duplicates;
+        } else if (supported && left_result == ClipResult::kEmpty && right_result == ClipResult::kClipped) {
+            right.push_back(MakeClippedReference(reference, right_box));
+        } else if (supported && left_result == ClipResult::kClipped && right_result == ClipResult::kEmpty) {
+            left.push_back(MakeClippedReference(reference, left_box));
+        } else if (reference.centroid[split.axis] < split.plane) {
+            left.push_back(reference);
+        } else {
+            right.push_back(reference);
+        }
+    }
+
+    if (left.empty() || right.empty()) {
+        left.clear();
+        right.clear();
+        return false;
+    }
+    remaining_references -= duplicates;
+    return true;
+}
+
+}  // namespace
+
+BvhNode::BvhNode(const std::vector<std::shared_ptr<Hittable>>& objects, double time0, double time1,
+                 const BvhBuildOptions& options)
+    : BvhNode(objects, time0, time1, options, nullptr) {}
+
+BvhNode::BvhNode(const HittableList& list, double time0, double time1, const BvhBuildOptions& options)
+    : BvhNode(list.Objects(), time0, time1, options, nullptr) {}
+
+BvhNode::BvhNode(const std::vector<std::shared_ptr<Hittable>>& objects, double time0, double time1,
+                 const BvhBuildOptions& options, ThreadPool& pool)
+    : BvhNode(objects, time0, time1, options, &pool) {}
+
+BvhNode::BvhNode(const HittableList& list, double time0, double time1, const BvhBuildOptions& options, ThreadPool& pool)
+    : BvhNode(list.Objects(), time0, time1, options, &pool) {}
+
+BvhNode::BvhNode(const std::vector<std::shared_ptr<Hittable>>& objects, double time0, double time1,
+                 const BvhBuildOptions& options, ThreadPool* pool)
+    : options_(options) {
     if (objects.empty()) {
         throw std::invalid_argument("BVH에 빈 객체 목록이 전달되었다.");
     }
-    Build(objects, 0, objects.size(), time0, time1);
+    ValidateBuildOptions(options);
+    std::vector<BuildPrimitive> primitives = MakePrimitives(objects, time0, time1, pool);
+    if (options.lazy) {
+        auto build = std::make_shared<LazyBuild>();
+        build->objects = objects;
+        build->primitives = std::move(primitives);
+        const size_t count = build->primitives.size();
+        *this = BvhNode(std::move(build), 0, count, options);
+        return;
+    }
+    if (options.split == BvhSplitMethod::kSpatialSah) {
+        SpatialBuildState state;
+        state.time0 = time0;
+        state.time1 = time1;
+        state.root_area = SurfaceArea(ReduceBoxes(nullptr, 0, primitives.size(), 1,
+                                                  [&primitives](size_t i) -> const Aabb& { return primitives[i].box; }));
+        state.remaining_references =
+            static_cast<size_t>(options.max_reference_growth * static_cast<double>(primitives.size()));
+        BuildSpatial(std::move(primitives), state);
+        return;
+    }
+    Build(primitives, 0, primitives.size(), pool);
+}
+
+BvhNode::BvhNode(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, const BvhBuildOptions& options,
+                 ThreadPool* pool)
+    : options_(options) {
+    Build(primitives, start, end, pool);
 }
 
-BvhNode::BvhNode(const HittableList& list, double time0, double time1) : BvhNode(CopyObjects(list.Objects()), time0, time1) {}
+BvhNode::BvhNode(std::vector<BuildPrimitive> references, const BvhBuildOptions& options, SpatialBuildState& state)
+    : options_(options) {
+    BuildSpatial(std::move(references), state);
+}
+
+// 즉시 빌드에서도 노드마다 구간 경계를 한 번 합치므로, 경계 계산은 미루지 않고 나누는 일만 미룬다.
+BvhNode::BvhNode(std::shared_ptr<LazyBuild> build, size_t start, size_t end, const BvhBuildOptions& options)
+    : options_(options), lazy_(std::make_unique<LazyRange>()) {
+    const std::vector<BuildPrimitive>& primitives = build->primitives;
+    box_ = ReduceBoxes(nullptr, start, end, 1, [&primitives](size_t i) -> const Aabb& { return primitives[i].box; });
+    area_sum_ = SurfaceArea(box_);
+    build->pending_nodes.fetch_add(1, std::memory_order_relaxed);
+    build->pending_primitives.fetch_add(end - start, std::memory_order_relaxed);
+    lazy_->build = std::move(build);
+    lazy_->start = start;
+    lazy_->end = end;
+}
+
+std::vector<BvhNode::BuildPrimitive> BvhNode::MakePrimitives(const std::vector<std::shared_ptr<Hittable>>& objects,
+                                                             double time0, double time1, ThreadPool* pool) {
+    std::vector<BuildPrimitive> primitives(objects.size());
+    const size_t chunk_count = ChunkCount(pool, objects.size());
+    ForEachChunk(pool, 0, objects.size(), chunk_count, [&](size_t /*chunk*/, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Aabb box;
+            if (!objects[i]->BoundingBox(time0, time1, box)) {
+                throw std::runtime_error("BVH 노드 생성 중 경계 상자를 계산할 수 없다.");
+            }
+            primitives[i] = BuildPrimitive{objects[i], box, 0.5 * (box.minimum() + box.maximum()), false};
+        }
+    });
+    return primitives;
+}
+
+void BvhNode::Build(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, ThreadPool* pool) {
+    const size_t chunk_count = ChunkCount(pool, end - start);
+    box_ = ReduceBoxes(pool, start, end, chunk_count, [&primitives](size_t i) -> const Aabb& { return primitives[i].box; });
+    Split(primitives, start, end, chunk_count, pool);
+}
+
+void BvhNode::Split(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, size_t chunk_count,
+                    ThreadPool* pool) {
+    if (end - start == 1) {
+        left_ = right_ = primitives[start].object;
+        left_kind_ = right_kind_ = ChildKind::kObject;
+    } else {
+        const size_t mid = options_.split == BvhSplitMethod::kMedian
+                               ? SplitMedian(primitives, start, end, box_)
+                               : SplitBinnedSah(primitives, start, end, options_.bin_count, pool);
+        // 두 자식은 겹치지 않는 구간만 재배열하고 서로 다른 멤버에 기록하므로 동시에 빌드해도 된다.
+        if (chunk_count > 1) {
+            pool->ParallelFor(2, [&](size_t side) {
+                if (side == 0) {
+                    left_ = MakeChild(primitives, start, mid, left_kind_, pool);
+                } else {
+                    right_ = MakeChild(primitives, mid, end, right_kind_, pool);
+                }
+            });
+        } else {
+            left_ = MakeChild(primitives, start, mid, left_kind_, pool);
+            right_ = MakeChild(primitives, mid, end, right_kind_, pool);
+        }
 
-BvhNode::BvhNode(std::vector<std::shared_ptr<Hittable>>& objects, size_t start, size_t end, double time0, double time1) {
-    Build(objects, start, end, time0, time1);
+        // 잎 자식은 객체가 max_leaf_size개 이하이므로 캐시한 상자를 직접 합친다.
+        const auto child_box = [&primitives](const std::shared_ptr<Hittable>& child, ChildKind kind, size_t begin,
+                                             size_t finish) {
+            if (kind == ChildKind::kNode) {
+                return static_cast<const BvhNode&>(*child).box_;
+            }
+            return ReduceBoxes(nullptr, begin, finish, 1, [&primitives](size_t i) -> const Aabb& { return primitives[i].box; });
+        };
+        UpdateVisitOrder(child_box(left_, left_kind_, start, mid), child_box(right_, right_kind_, mid, end));
+    }
+
+    UpdateAreaSum();
+    build_cost_ = AreaCost();
+}
+
+// 이 노드의 구간만 재배열하고 자식은 다시 지연 노드로 만든다. 조상이 이미 구간을 나눴으므로 다른 노드와 겹치지 않는다.
+void BvhNode::BuildLazy() {
+    LazyBuild& build = *lazy_->build;
+    Split(build.primitives, lazy_->start, lazy_->end, 1, nullptr);
+    build.built_nodes.fetch_add(1, std::memory_order_relaxed);
+    build.pending_nodes.fetch_sub(1, std::memory_order_relaxed);
+    build.pending_primitives.fetch_sub(lazy_->end - lazy_->start, std::memory_order_relaxed);
+}
+
+void BvhNode::BuildAll() const {
+    if (!lazy_) {
+        return;
+    }
+    EnsureBuilt();
+    if (left_kind_ == ChildKind::kNode) {
+        static_cast<const BvhNode&>(*left_).BuildAll();
+    }
+    if (right_ != left_ && right_kind_ == ChildKind::kNode) {
+        static_cast<const BvhNode&>(*right_).BuildAll();
+    }
+}
+
+BvhLazyBuildStats BvhNode::LazyBuildStats() const {
+    BvhLazyBuildStats stats;
+    if (lazy_) {
+        const LazyBuild& build = *lazy_->build;
+        stats.built_nodes = build.built_nodes.load(std::memory_order_relaxed);
+        stats.pending_nodes = build.pending_nodes.load(std::memory_order_relaxed);
+        stats.pending_primitives = build.pending_primitives.load(std::memory_order_relaxed);
+        stats.primitive_count = build.primitives.size();
+    }
+    return stats;
+}
+
+// v0.6.0 빌더와 같은 트리를 만든다. 비교 기준 상자만 가상 호출 대신 캐시한 값을 쓴다.
+size_t BvhNode::SplitMedian(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, const Aabb& bounds) {
+    const int axis = LongestAxis(bounds);
+    std::sort(primitives.begin() + static_cast<std::ptrdiff_t>(start), primitives.begin() + static_cast<std::ptrdiff_t>(end),
+              [axis](const BuildPrimitive& a, const BuildPrimitive& b) { return a.box.minimum()[axis] < b.box.minimum()[axis]; });
+    return start + (end - start) / 2;
+}
+
+size_t BvhNode::SplitBinnedSah(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, int bin_count,
+                               ThreadPool* pool) {
+    const ObjectSplit split = FindObjectSplit(primitives, start, end, static_cast<size_t>(bin_count), pool);
+    if (split.axis < 0) {
+        return start + (end - start) / 2;
+    }
+
+    const auto middle = std::partition(
+        primitives.begin() + static_cast<std::ptrdiff_t>(start), primitives.begin() + static_cast<std::ptrdiff_t>(end),
+        [&split](const BuildPrimitive& primitive) { return split.BinOf(primitive.centroid) < split.bin; });
+    return static_cast<size_t>(middle - primitives.begin());
+}
+
+std::shared_ptr<Hittable> BvhNode::MakeChild(std::vector<BuildPrimitive>& primitives, size_t start, size_t end,
+                                             ChildKind& kind, ThreadPool* pool) const {
+    const size_t count = end - start;
+    if (count == 1) {
+        kind = ChildKind::kObject;
+        return primitives[start].object;
+    }
+    if (count <= static_cast<size_t>(options_.max_leaf_size)) {
+        kind = ChildKind::kLeafList;
+        auto leaf = std::make_shared<HittableList>();
+        for (size_t i = start; i < end; ++i) {
+            leaf->Add(primitives[i].object);
+        }
+        return leaf;
+    }
+    kind = ChildKind::kNode;
+    if (lazy_) {
+        return std::shared_ptr<BvhNode>(new BvhNode(lazy_->build, start, end, options_));
+    }
+    return std::shared_ptr<BvhNode>(new BvhNode(primitives, start, end, options_, pool));
 }
 
-void BvhNode::Build(std::vector<std::shared_ptr<Hittable>>& objects, size_t start, size_t end, double time0, double time1) {
-    const int axis = ChooseSplitAxis(objects, start, end, time0, time1);
-    auto comparator = [axis, time0, time1](const std::shared_ptr<Hittable>& a, const std::shared_ptr<Hittable>& b) {
-        return BoxComparator(a, b, axis, time0, time1);
+// 객체 분할 후보를 먼저 구하고, 두 자식 상자가 겹칠 때만 공간 분할 후보를 더 계산해 비용이 작은 쪽으로 나눈다.
+// 참조 벡터를 노드마다 따로 가지므로 복제된 참조가 있어도 구간 재배열 없이 양쪽에 나눠 담을 수 있다.
+void BvhNode::BuildSpatial(std::vector<BuildPrimitive> references, SpatialBuildState& state) {
+    const auto reference_bounds = [](const std::vector<BuildPrimitive>& group) {
+        return ReduceBoxes(nullptr, 0, group.size(), 1, [&group](size_t i) -> const Aabb& { return group[i].box; });
     };
+    box_ = reference_bounds(references);
 
-    const size_t object_span = end - start;
+    if (references.size() == 1) {
+        left_ = right_ = MakeSpatialChild(std::move(references), left_kind_, state);
+        right_kind_ = left_kind_;
+        UpdateAreaSum();
+        build_cost_ = AreaCost();
+        return;
+    }
+
+    const auto bins = static_cast<size_t>(options_.bin_count);
+    const ObjectSplit object_split = FindObjectSplit(references, 0, references.size(), bins, nullptr);
+    std::vector<BuildPrimitive> left_references;
+    std::vector<BuildPrimitive> right_references;
+    bool split_done = false;
 
-    if (object_span == 1) {
-        left_ = right_ = objects[start];
-    } else if (object_span == 2) {
-        if (comparator(objects[start], objects[start + 1])) {
-            left_ = objects[start];
-            right_ = objects[start + 1];
+    if (state.remaining_references > 0 && state.root_area > 0.0) {
+        const double overlap = object_split.axis < 0
+                                   ? SurfaceArea(box_)
+                                   : (IsEmptyBox(IntersectBoxes(object_split.left_box, object_split.right_box))
+                                          ? 0.0
+                                          : SurfaceArea(IntersectBoxes(object_split.left_box, object_split.right_box)));
+        if (overlap / state.root_area > kSpatialOverlapRatio) {
+            const SpatialSplit spatial = FindSpatialSplit(references, box_, bins, state.time0, state.time1);
+            if (spatial.axis >= 0 && spatial.cost < object_split.cost) {
+                split_done = ApplySpatialSplit(references, spatial, state.time0, state.time1, state.remaining_references,
+                                               left_references, right_references);
+            }
+        }
+    }
+
+    if (!split_done) {
+        if (object_split.axis < 0) {
+            const auto middle = references.begin() + static_cast<std::ptrdiff_t>(references.size() / 2);
+            left_references.assign(references.begin(), middle);
+            right_references.assign(middle, references.end());
         } else {
-            left_ = objects[start + 1];
-            right_ = objects[start];
+            for (const BuildPrimitive& reference : references) {
+                (object_split.BinOf(reference.centroid) < object_split.bin ? left_references : right_references)
+                    .push_back(reference);
+            }
         }
-    } else {
-        std::sort(objects.begin() + static_cast<std::ptrdiff_t>(start), objects.begin() + static_cast<std::ptrdiff_t>(end),
-                  comparator);
+    }
+    references.clear();
+    references.shrink_to_fit();
 
-        const size_t mid = start + object_span / 2;
-        left_ = std::shared_ptr<BvhNode>(new BvhNode(objects, start, mid, time0, time1));
-        right_ = std::shared_ptr<BvhNode>(new BvhNode(objects, mid, end, time0, time1));
+    const Aabb left_box = reference_bounds(left_references);
+    const Aabb right_box = reference_bounds(right_references);
+    left_ = MakeSpatialChild(std::move(left_references), left_kind_, state);
+    right_ = MakeSpatialChild(std::move(right_references), right_kind_, state);
+    UpdateVisitOrder(left_box, right_box);
+    UpdateAreaSum();
+    build_cost_ = AreaCost();
+}
+
+std::shared_ptr<Hittable> BvhNode::MakeSpatialChild(std::vector<BuildPrimitive> references, ChildKind& kind,
+                                                    SpatialBuildState& state) const {
+    const auto leaf_object = [](const BuildPrimitive& reference) -> std::shared_ptr<Hittable> {
+        if (reference.clipped) {
+            return std::make_shared<ClippedReference>(reference.object, reference.box);
+        }
+        return reference.object;
+    };
+
+    if (references.size() == 1) {
+        kind = ChildKind::kObject;
+        return leaf_object(references.front());
     }
+    if (references.size() <= static_cast<size_t>(options_.max_leaf_size)) {
+        kind = ChildKind::kLeafList;
+        auto leaf = std::make_shared<HittableList>();
+        for (const BuildPrimitive& reference : references) {
+            leaf->Add(leaf_object(reference));
+        }
+        return leaf;
+    }
+    kind = ChildKind::kNode;
+    return std::shared_ptr<BvhNode>(new BvhNode(std::move(references), options_, state));
+}
 
+void BvhNode::UpdateBounds(double time0, double time1) {
     Aabb box_left;
     Aabb box_right;
 
@@ -62,77 +738,187 @@ void BvhNode::Build(std::vector<std::shared_ptr<Hittable>>& objects, size_t star
     }
 
     box_ = SurroundingBox(box_left, box_right);
+    UpdateVisitOrder(box_left, box_right);
+    UpdateAreaSum();
+}
+
+// 물체가 움직이면 자식의 상대 위치도 바뀌므로 재맞춤 때도 다시 고른다.
+void BvhNode::UpdateVisitOrder(const Aabb& left_box, const Aabb& right_box) {
+    const Vec3 gap = (right_box.minimum() + right_box.maximum()) - (left_box.minimum() + left_box.maximum());
+    order_axis_ = 0;
+    for (int axis = 1; axis < 3; ++axis) {
+        if (std::fabs(gap[axis]) > std::fabs(gap[order_axis_])) {
+            order_axis_ = axis;
+        }
+    }
+    left_is_lower_ = gap[order_axis_] >= 0.0;
 }
 
-std::vector<std::shared_ptr<Hittable>> BvhNode::CopyObjects(const std::vector<std::shared_ptr<Hittable>>& source) {
-    return std::vector<std::shared_ptr<Hittable>>(source.begin(), source.end());
+void BvhNode::UpdateAreaSum() {
+    area_sum_ = SurfaceArea(box_);
+    if (left_kind_ == ChildKind::kNode) {
+        area_sum_ += static_cast<const BvhNode&>(*left_).area_sum_;
+    }
+    if (right_kind_ == ChildKind::kNode) {
+        area_sum_ += static_cast<const BvhNode&>(*right_).area_sum_;
+    }
 }
 
-bool BvhNode::BoxComparator(const std::shared_ptr<Hittable>& a, const std::shared_ptr<Hittable>& b, int axis, double time0,
-                            double time1) {
-    Aabb box_a;
-    Aabb box_b;
+// 면적이 0인 상자(한 점에 모인 잎)는 비용을 비교할 수 없으므로 1로 둔다.
+double BvhNode::AreaCost() const {
+    const double area = SurfaceArea(box_);
+    return area > 0.0 ? area_sum_ / area : 1.0;
+}
 
-    if (!a->BoundingBox(time0, time1, box_a) || !b->BoundingBox(time0, time1, box_b)) {
-        throw std::runtime_error("BVH 비교 중 경계 상자를 계산할 수 없다.");
+BvhRefitStats BvhNode::Refit(double time0, double time1, double rebuild_threshold) {
+    if (!(rebuild_threshold >= 1.0)) {
+        throw std::invalid_argument("BVH 재구성 임계값은 1 이상이어야 한다.");
     }
 
-    return box_a.minimum()[axis] < box_b.minimum()[axis];
+    BvhRefitStats stats;
+    if (lazy_) {
+        // 처음 받은 객체 순서로 다시 지연 빌드한다. 이미 나눈 노드의 재배열 결과에 따라 트리가 달라지지 않는다.
+        const std::vector<std::shared_ptr<Hittable>> objects = lazy_->build->objects;
+        *this = BvhNode(objects, time0, time1, options_);
+        stats.rebuilt_subtrees = 1;
+        return stats;
+    }
+    if (options_.split == BvhSplitMethod::kSpatialSah) {
+        // 잘린 참조를 원래 객체로 되돌리고 중복을 뺀 뒤, 트리 순서대로 다시 빌드한다.
+        std::vector<std::shared_ptr<Hittable>> references;
+        CollectObjects(references);
+        std::vector<std::shared_ptr<Hittable>> objects;
+        std::unordered_set<const Hittable*> seen;
+        for (const auto& reference : references) {
+            const auto* clipped = dynamic_cast<const ClippedReference*>(reference.get());
+            const std::shared_ptr<Hittable>& object = clipped != nullptr ? clipped->Object() : reference;
+            if (seen.insert(object.get()).second) {
+                objects.push_back(object);
+            }
+        }
+        *this = BvhNode(objects, time0, time1, options_);
+        stats.rebuilt_subtrees = 1;
+        return stats;
+    }
+    RefitBounds(time0, time1, stats);
+    RebuildDegraded(time0, time1, rebuild_threshold, stats);
+    return stats;
 }
 
-int BvhNode::ChooseSplitAxis(const std::vector<std::shared_ptr<Hittable>>& objects, size_t start, size_t end, double time0,
-                             double time1) {
-    if (end <= start) {
-        throw std::invalid_argument("BVH 분할 축 계산에 잘못된 인덱스가 전달되었다.");
+void BvhNode::RefitBounds(double time0, double time1, BvhRefitStats& stats) {
+    if (left_kind_ == ChildKind::kNode) {
+        static_cast<BvhNode&>(*left_).RefitBounds(time0, time1, stats);
+    }
+    if (right_kind_ == ChildKind::kNode) {
+        static_cast<BvhNode&>(*right_).RefitBounds(time0, time1, stats);
+    }
+    UpdateBounds(time0, time1);
+    ++stats.refitted_nodes;
+}
+
+// 위에서부터 내려가며 처음 만나는 열화 서브트리를 통째로 다시 빌드하므로 같은 객체를 두 번 빌드하지 않는다.
+// 다시 빌드해도 서브트리 경계는 같으므로 조상 노드의 상자는 그대로 유효하고 표면적 합만 갱신한다.
+void BvhNode::RebuildDegraded(double time0, double time1, double rebuild_threshold, BvhRefitStats& stats) {
+    if (AreaCost() > rebuild_threshold * build_cost_) {
+        std::vector<std::shared_ptr<Hittable>> objects;
+        CollectObjects(objects);
+        std::vector<BuildPrimitive> primitives = MakePrimitives(objects, time0, time1, nullptr);
+        Build(primitives, 0, primitives.size(), nullptr);
+        ++stats.rebuilt_subtrees;
+        return;
     }
 
-    Aabb aggregate_box;
-    bool first_box = true;
+    if (left_kind_ == ChildKind::kNode) {
+        static_cast<BvhNode&>(*left_).RebuildDegraded(time0, time1, rebuild_threshold, stats);
+    }
+    if (right_kind_ == ChildKind::kNode) {
+        static_cast<BvhNode&>(*right_).RebuildDegraded(time0, time1, rebuild_threshold, stats);
+    }
+    UpdateAreaSum();
+}
 
-    for (size_t i = start; i < end; ++i) {
-        Aabb object_box;
-        if (!objects[i]->BoundingBox(time0, time1, object_box)) {
-            throw std::runtime_error("BVH 축 선택 중 경계 상자를 계산할 수 없다.");
+void BvhNode::CollectObjects(std::vector<std::shared_ptr<Hittable>>& objects) const {
+    const auto collect = [&objects](const std::shared_ptr<Hittable>& child, ChildKind kind) {
+        switch (kind) {
+            case ChildKind::kNode:
+                static_cast<const BvhNode&>(*child).CollectObjects(objects);
+                break;
+            case ChildKind::kLeafList: {
+                const auto& leaf_objects = static_cast<const HittableList&>(*child).Objects();
+                objects.insert(objects.end(), leaf_objects.begin(), leaf_objects.end());
+                break;
+            }
+            case ChildKind::kObject:
+                objects.push_back(child);
+                break;
         }
-        aggregate_box = first_box ? object_box : SurroundingBox(aggregate_box, object_box);
-        first_box = false;
+    };
+
+    collect(left_, left_kind_);
+    if (right_ != left_) {
+        collect(right_, right_kind_);
     }
+}
 
-    const Vec3 diag = aggregate_box.maximum() - aggregate_box.minimum();
-    if (diag.x() >= diag.y() && diag.x() >= diag.z()) {
+std::size_t BvhNode::LeafTestCount(const Hittable& child, ChildKind kind) {
+    switch (kind) {
+    case ChildKind::kNode:
         return 0;
+    case ChildKind::kLeafList:
+        return static_cast<const HittableList&>(child).Objects().size();
+    case ChildKind::kObject:
+        break;
     }
-    if (diag.y() >= diag.z()) {
-        return 1;
-    }
-    return 2;
+    return 1;
 }
 
-bool BvhNode::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const {
+// 모든 도형은 교차할 때만 record를 바꾸므로, 먼 자식은 가까운 자식이 찾은 거리까지만 찾으면서 같은 record에 덮어쓴다.
+// 같은 거리의 교차가 양쪽에 있으면 나중에 방문한 쪽이 남는다.
+bool BvhNode::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const {
+    RAYTRACER_BVH_COUNT(nodes_visited, 1);
     if (!box_.Hit(r, t_min, t_max)) {
         return false;
     }
+    EnsureBuilt();
+    if (left_ == right_) {
+        RAYTRACER_BVH_COUNT(primitives_tested, LeafTestCount(*left_, left_kind_));
+        return left_->Hit(r, t_min, t_max, record, generator);
+    }
+    RAYTRACER_BVH_COUNT(primitives_tested, LeafTestCount(*left_, left_kind_) + LeafTestCount(*right_, right_kind_));
 
-    HitRecord left_record;
-    HitRecord right_record;
+    const bool left_first = (r.direction()[order_axis_] >= 0.0) == left_is_lower_;
+    const Hittable& near_child = left_first ? *left_ : *right_;
+    const Hittable& far_child = left_first ? *right_ : *left_;
 
-    const bool hit_left = left_->Hit(r, t_min, t_max, left_record, generator);
-    const bool hit_right = right_->Hit(r, t_min, hit_left ? left_record.t : t_max, right_record, generator);
+    const bool hit_near = near_child.Hit(r, t_min, t_max, record, generator);
+    const bool hit_far = far_child.Hit(r, t_min, hit_near ? record.t : t_max, record, generator);
+    return hit_near || hit_far;
+}
 
-    if (hit_left && hit_right) {
-        record = right_record.t < left_record.t ? right_record : left_record;
-        return true;
+// 가장 가까운 교차가 필요 없으므로 먼 자식의 구간을 줄이지 않고, 어느 자식이든 가리면 바로 멈춘다.
+bool BvhNode::Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const {
+    RAYTRACER_BVH_COUNT(nodes_visited, 1);
+    if (!box_.Hit(r, t_min, t_max)) {
+        return false;
     }
-    if (hit_left) {
-        record = left_record;
-        return true;
+    EnsureBuilt();
+    if (left_ == right_) {
+        RAYTRACER_BVH_COUNT(primitives_tested, LeafTestCount(*left_, left_kind_));
+        return left_->Occluded(r, t_min, t_max, generator);
     }
-    if (hit_right) {
-        record = right_record;
+
+    const bool left_first = (r.direction()[order_axis_] >= 0.0) == left_is_lower_;
+    const Hittable& near_child = left_first ? *left_ : *right_;
+    const Hittable& far_child = left_first ? *right_ : *left_;
+    [[maybe_unused]] const ChildKind near_kind = left_first ? left_kind_ : right_kind_;
+    [[maybe_unused]] const ChildKind far_kind = left_first ? right_kind_ : left_kind_;
+
+    RAYTRACER_BVH_COUNT(primitives_tested, LeafTestCount(near_child, near_kind));
+    if (near_child.Occluded(r, t_min, t_max, generator)) {
         return true;
     }
-
-    return false;
+    RAYTRACER_BVH_COUNT(primitives_tested, LeafTestCount(far_child, far_kind));
+    return far_child.Occluded(r, t_min, t_max, generator);
 }
 
 bool BvhNode::BoundingBox(double /*time0*/, double /*time1*/, Aabb& output_box) const {
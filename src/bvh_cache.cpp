@@ -0,0 +1,290 @@
+/*
+ * 설명: Bvh8 노드 배열과 잎 객체 인덱스를 고정 헤더가 붙은 이진 캐시 파일로 기록하고, mmap으로 읽어 검증한 뒤
+ *       노드 배열을 복사 없이 순회 구조로 복원한다.
+ * 버전: v1.18.0
+ * 관련 문서: design/renderer/v1.18.0-bvh-cache.md
+ * 테스트: tests/unit/bvh_cache_test.cpp
+ */
+#include "raytracer/bvh_cache.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace raytracer {
+namespace {
+
+constexpr char kMagic[8] = {'R', 'T', 'B', 'V', 'H', 'C', 'A', 'C'};
+constexpr std::uint32_t kFormatVersion = 1;
+constexpr std::uint32_t kByteOrderMark = 0x01020304u;
+constexpr int kCacheWidth = 8;
+
+// 노드 배열이 64바이트 정렬 위치에서 시작하도록 헤더를 128바이트로 고정한다.
+struct CacheHeader {
+    char magic[8];
+    std::uint32_t format_version;
+    std::uint32_t byte_order;
+    std::uint32_t node_size;
+    std::int32_t depth;
+    std::uint64_t key;
+    std::uint64_t node_count;
+    std::uint64_t primitive_count;
+    double root_min[3];
+    double root_max[3];
+    unsigned char padding[32];
+};
+
+static_assert(sizeof(CacheHeader) == 128, "캐시 헤더는 128바이트여야 한다.");
+static_assert(sizeof(CacheHeader) % alignof(WideBvhNode<kCacheWidth>) == 0, "노드 배열은 정렬 위치에서 시작해야 한다.");
+
+// 64비트 단어 단위 FNV-1a. 경계 상자 double의 비트 패턴을 그대로 섞는다.
+class KeyHasher {
+public:
+    void Add(std::uint64_t word) {
+        state_ ^= word;
+        state_ *= 0x100000001b3ull;
+    }
+
+    void Add(double value) {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        Add(bits);
+    }
+
+    std::uint64_t Value() const { return state_; }
+
+private:
+    std::uint64_t state_ = 0xcbf29ce484222325ull;
+};
+
+// 읽기 전용 mmap 영역. 마지막 참조가 사라질 때 해제한다.
+class MappedFile {
+public:
+    MappedFile(void* data, std::size_t size) : data_(data), size_(size) {}
+    ~MappedFile() { munmap(data_, size_); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* Data() const { return static_cast<const unsigned char*>(data_); }
+    std::size_t Size() const { return size_; }
+
+private:
+    void* data_;
+    std::size_t size_;
+};
+
+std::shared_ptr<const MappedFile> MapFile(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat status {};
+    if (fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(CacheHeader))) {
+        close(fd);
+        return nullptr;
+    }
+    const auto size = static_cast<std::size_t>(status.st_size);
+    // 검증이 곧 노드 전체를 읽으므로, 지원하면 한 번에 미리 읽어 페이지 폴트를 줄인다.
+#ifdef MAP_POPULATE
+    constexpr int kMapFlags = MAP_PRIVATE | MAP_POPULATE;
+#else
+    constexpr int kMapFlags = MAP_PRIVATE;
+#endif
+    void* data = mmap(nullptr, size, PROT_READ, kMapFlags, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    return std::make_shared<const MappedFile>(data, size);
+}
+
+// 내부 자식은 부모보다 뒤 인덱스(깊이 우선 기록 순서)여야 순환이 없다. 부모에서 자식으로 깊이를 전파해 실제 깊이를 구한다.
+// 순회 스택 크기가 이 깊이로 정해지므로 헤더 값을 믿지 않고 다시 계산한 값과 비교한다.
+bool ValidateNodes(const WideBvhNode<kCacheWidth>* nodes, std::uint64_t node_count, std::uint64_t primitive_count,
+                   int& depth) {
+    std::vector<int> levels(static_cast<std::size_t>(node_count), 0);
+    levels[0] = 1;
+    depth = 1;
+    for (std::uint64_t index = 0; index < node_count; ++index) {
+        const WideBvhNode<kCacheWidth>& node = nodes[index];
+        if (node.lane_count < 1 || node.lane_count > kCacheWidth || levels[index] == 0) {
+            return false;
+        }
+        for (int lane = 0; lane < node.lane_count; ++lane) {
+            const std::int64_t child = node.child[lane];
+            if (child >= 0) {
+                if (static_cast<std::uint64_t>(child) <= index || static_cast<std::uint64_t>(child) >= node_count) {
+                    return false;
+                }
+                int& level = levels[static_cast<std::size_t>(child)];
+                level = std::max(level, levels[index] + 1);
+                depth = std::max(depth, level);
+            } else {
+                const std::uint64_t first = static_cast<std::uint64_t>(-(child + 1));
+                if (node.count[lane] == 0 || first + node.count[lane] > primitive_count) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+std::uint64_t BvhCacheKey(const std::vector<std::shared_ptr<Hittable>>& objects, double time0, double time1,
+                          const BvhBuildOptions& options) {
+    if (options.split == BvhSplitMethod::kSpatialSah) {
+        throw std::invalid_argument("공간 분할 BVH는 캐시할 수 없다.");
+    }
+
+    KeyHasher hasher;
+    hasher.Add(static_cast<std::uint64_t>(kFormatVersion));
+    hasher.Add(static_cast<std::uint64_t>(kCacheWidth));
+    hasher.Add(static_cast<std::uint64_t>(options.split));
+    hasher.Add(static_cast<std::uint64_t>(options.max_leaf_size));
+    hasher.Add(static_cast<std::uint64_t>(options.bin_count));
+    hasher.Add(time0);
+    hasher.Add(time1);
+    hasher.Add(static_cast<std::uint64_t>(objects.size()));
+    for (const auto& object : objects) {
+        Aabb box;
+        if (!object->BoundingBox(time0, time1, box)) {
+            throw std::runtime_error("BVH 캐시 키 계산 중 경계 상자를 계산할 수 없다.");
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            hasher.Add(box.minimum()[axis]);
+            hasher.Add(box.maximum()[axis]);
+        }
+    }
+    return hasher.Value();
+}
+
+void SaveBvhCache(const std::string& path, const Bvh8& bvh, const std::vector<std::shared_ptr<Hittable>>& objects,
+                  std::uint64_t key) {
+    std::unordered_map<const Hittable*, std::uint32_t> indices;
+    indices.reserve(objects.size());
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        indices.emplace(objects[i].get(), static_cast<std::uint32_t>(i));
+    }
+    std::vector<std::uint32_t> primitive_indices;
+    primitive_indices.reserve(bvh.PrimitiveCount());
+    for (const auto& primitive : bvh.Primitives()) {
+        const auto found = indices.find(primitive.get());
+        if (found == indices.end()) {
+            throw std::invalid_argument("BVH 잎 객체가 장면 객체 목록에 없어 캐시할 수 없다.");
+        }
+        primitive_indices.push_back(found->second);
+    }
+
+    CacheHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.format_version = kFormatVersion;
+    header.byte_order = kByteOrderMark;
+    header.node_size = sizeof(WideBvhNode<kCacheWidth>);
+    header.depth = bvh.Depth();
+    header.key = key;
+    header.node_count = bvh.NodeCount();
+    header.primitive_count = primitive_indices.size();
+    Aabb root_box;
+    bvh.BoundingBox(0.0, 0.0, root_box);
+    for (int axis = 0; axis < 3; ++axis) {
+        header.root_min[axis] = root_box.minimum()[axis];
+        header.root_max[axis] = root_box.maximum()[axis];
+    }
+
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("BVH 캐시 파일을 열 수 없다.");
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(bvh.Nodes()),
+                   static_cast<std::streamsize>(bvh.NodeCount() * sizeof(WideBvhNode<kCacheWidth>)));
+        file.write(reinterpret_cast<const char*>(primitive_indices.data()),
+                   static_cast<std::streamsize>(primitive_indices.size() * sizeof(std::uint32_t)));
+        if (!file) {
+            throw std::runtime_error("BVH 캐시 기록에 실패했다.");
+        }
+    }
+
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("BVH 캐시 파일을 교체할 수 없다.");
+    }
+}
+
+std::shared_ptr<Bvh8> LoadBvhCache(const std::string& path, const std::vector<std::shared_ptr<Hittable>>& objects,
+                                   std::uint64_t key) {
+    const std::shared_ptr<const MappedFile> file = MapFile(path);
+    if (!file) {
+        return nullptr;
+    }
+
+    CacheHeader header{};
+    std::memcpy(&header, file->Data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.format_version != kFormatVersion ||
+        header.byte_order != kByteOrderMark || header.node_size != sizeof(WideBvhNode<kCacheWidth>) ||
+        header.key != key || header.node_count == 0 || header.primitive_count > objects.size()) {
+        return nullptr;
+    }
+    // 곱셈이 넘치지 않는 범위에서만 파일 크기와 비교한다.
+    const std::uint64_t max_nodes = file->Size() / sizeof(WideBvhNode<kCacheWidth>);
+    if (header.node_count > max_nodes ||
+        file->Size() != sizeof(CacheHeader) + header.node_count * sizeof(WideBvhNode<kCacheWidth>) +
+                            header.primitive_count * sizeof(std::uint32_t)) {
+        return nullptr;
+    }
+
+    const auto* nodes = reinterpret_cast<const WideBvhNode<kCacheWidth>*>(file->Data() + sizeof(CacheHeader));
+    int depth = 0;
+    if (!ValidateNodes(nodes, header.node_count, header.primitive_count, depth) || depth != header.depth) {
+        return nullptr;
+    }
+
+    const unsigned char* index_data =
+        file->Data() + sizeof(CacheHeader) + header.node_count * sizeof(WideBvhNode<kCacheWidth>);
+    std::vector<std::shared_ptr<Hittable>> primitives;
+    primitives.reserve(static_cast<std::size_t>(header.primitive_count));
+    for (std::uint64_t i = 0; i < header.primitive_count; ++i) {
+        std::uint32_t index = 0;
+        std::memcpy(&index, index_data + i * sizeof(index), sizeof(index));
+        if (index >= objects.size()) {
+            return nullptr;
+        }
+        primitives.push_back(objects[index]);
+    }
+
+    const Aabb root_box(Point3(header.root_min[0], header.root_min[1], header.root_min[2]),
+                        Point3(header.root_max[0], header.root_max[1], header.root_max[2]));
+    return std::make_shared<Bvh8>(file, nodes, static_cast<std::size_t>(header.node_count), std::move(primitives),
+                                  root_box, depth);
+}
+
+BvhCacheResult LoadOrBuildBvh(const std::string& path, const std::vector<std::shared_ptr<Hittable>>& objects,
+                              double time0, double time1, const BvhBuildOptions& options) {
+    const std::uint64_t key = BvhCacheKey(objects, time0, time1, options);
+    if (std::shared_ptr<Bvh8> cached = LoadBvhCache(path, objects, key)) {
+        return BvhCacheResult{std::move(cached), true, {}};
+    }
+
+    auto built = std::make_shared<Bvh8>(objects, time0, time1, options);
+    BvhCacheResult result{std::move(built), false, {}};
+    try {
+        SaveBvhCache(path, *result.bvh, objects, key);
+    } catch (const std::runtime_error& error) {
+        result.save_error = error.what();
+    }
+    return result;
+}
+
+}  // namespace raytracer
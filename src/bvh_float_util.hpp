@@ -0,0 +1,59 @@
+/*
+ * 설명: BVH 빌더와 평탄화·양자화·넓은·모션 BVH가 함께 쓰는 내부 도우미. double 경계를 float로 보수적으로 내리고/올리고,
+ *       상자 표면적과 두 자식 상자가 가장 멀리 떨어진 축을 계산한다. 공개 헤더가 아니라 src/ 안에서만 포함한다.
+ * 버전: v1.25.0
+ * 관련 문서: design/renderer/v1.11.0-linear-bvh.md, design/renderer/v1.12.0-wide-bvh.md,
+ *           design/renderer/v1.17.0-quantized-bvh.md, design/renderer/v1.25.0-motion-bvh.md
+ * 테스트: tests/unit/bvh_test.cpp
+ */
+#pragma once
+
+#include <cmath>
+#include <limits>
+
+#include "raytracer/aabb.hpp"
+#include "raytracer/vec3.hpp"
+
+namespace raytracer::detail {
+
+// value 이하인 가장 큰 float. float로 저장한 최솟값이 원래 double 상자를 안쪽으로 자르지 않게 한다.
+inline float RoundDown(double value) {
+    float result = static_cast<float>(value);
+    if (static_cast<double>(result) > value) {
+        result = std::nextafter(result, -std::numeric_limits<float>::infinity());
+    }
+    return result;
+}
+
+// value 이상인 가장 작은 float.
+inline float RoundUp(double value) {
+    float result = static_cast<float>(value);
+    if (static_cast<double>(result) < value) {
+        result = std::nextafter(result, std::numeric_limits<float>::infinity());
+    }
+    return result;
+}
+
+// RoundDown/RoundUp에서 한 칸 더 바깥으로 민다. 저장한 float 경계로 다시 계산(보간 등)할 때 생기는 반올림 오차를 흡수한다.
+inline float PadDown(double value) { return std::nextafter(RoundDown(value), -std::numeric_limits<float>::infinity()); }
+
+inline float PadUp(double value) { return std::nextafter(RoundUp(value), std::numeric_limits<float>::infinity()); }
+
+inline double SurfaceArea(const Aabb& box) {
+    const Vec3 extent = box.maximum() - box.minimum();
+    return 2.0 * (extent.x() * extent.y() + extent.y() * extent.z() + extent.z() * extent.x());
+}
+
+// 두 자식 중심이 가장 멀리 떨어진 축. 순회 시 레이 방향 부호로 가까운 자식을 고르는 기준이 된다.
+inline int SeparatingAxis(const Aabb& a, const Aabb& b) {
+    const Vec3 gap = (b.minimum() + b.maximum()) - (a.minimum() + a.maximum());
+    const double x = std::fabs(gap.x());
+    const double y = std::fabs(gap.y());
+    const double z = std::fabs(gap.z());
+    if (x >= y && x >= z) {
+        return 0;
+    }
+    return y >= z ? 1 : 2;
+}
+
+}  // namespace raytracer::detail
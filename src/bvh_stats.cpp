@@ -0,0 +1,256 @@
+/*
+ * 설명: 이진/넓은 BVH를 위에서부터 한 번 훑어 노드·잎 수, 깊이별 잎 수, 잎 크기 분포, SAH 비용, 형제 상자 겹침 비율을 모으고,
+ *       카운터를 켠 빌드에서는 스레드별 카운터 칸을 전역 목록에 등록해 합산한다.
+ *       지연 빌드 트리는 남은 노드를 모두 나눈 뒤 훑는다.
+ * 버전: v1.24.0
+ * 관련 문서: design/renderer/v1.19.0-bvh-stats.md, design/renderer/v1.21.0-ray-packets.md,
+ *           design/renderer/v1.24.0-lazy-bvh.md
+ * 테스트: tests/unit/bvh_stats_test.cpp
+ */
+#include "raytracer/bvh_stats.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "raytracer/hittable_list.hpp"
+
+#include "bvh_float_util.hpp"
+
+namespace raytracer {
+namespace {
+
+using detail::SurfaceArea;
+
+// 두 상자가 떨어져 있으면 0, 면이나 모서리만 맞닿으면 그 평평한 교집합의 표면적이다.
+double OverlapArea(const Aabb& a, const Aabb& b) {
+    double extent[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        extent[axis] = std::min(a.maximum()[axis], b.maximum()[axis]) - std::max(a.minimum()[axis], b.minimum()[axis]);
+        if (extent[axis] < 0.0) {
+            return 0.0;
+        }
+    }
+    return 2.0 * (extent[0] * extent[1] + extent[1] * extent[2] + extent[2] * extent[0]);
+}
+
+double OverlapSum(const std::vector<Aabb>& boxes) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < boxes.size(); ++i) {
+        for (std::size_t j = i + 1; j < boxes.size(); ++j) {
+            sum += OverlapArea(boxes[i], boxes[j]);
+        }
+    }
+    return sum;
+}
+
+// 트리를 훑으며 비율의 분자/분모를 따로 모은 뒤 Finish에서 한 번에 나눈다.
+class StatsAccumulator {
+public:
+    void AddNode(const std::vector<Aabb>& child_boxes) {
+        Aabb box = child_boxes.front();
+        for (const Aabb& child : child_boxes) {
+            box = SurroundingBox(box, child);
+        }
+        if (stats_.node_count == 0) {
+            root_area_ = SurfaceArea(box);
+        }
+        ++stats_.node_count;
+        node_area_ += SurfaceArea(box);
+        overlap_area_ += OverlapSum(child_boxes);
+    }
+
+    void AddLeaf(int depth, std::size_t size, const Aabb& box) {
+        ++stats_.leaf_count;
+        stats_.primitive_references += size;
+        Increment(stats_.leaves_per_depth, static_cast<std::size_t>(depth));
+        Increment(stats_.leaf_sizes, size);
+        leaf_cost_ += SurfaceArea(box) * static_cast<double>(size);
+    }
+
+    BvhStats Finish() {
+        // 면적이 0인 뿌리(한 점에 모인 객체)는 비용을 정의할 수 없으므로 0으로 둔다.
+        stats_.sah_cost = root_area_ > 0.0 ? (node_area_ + leaf_cost_) / root_area_ : 0.0;
+        stats_.sibling_overlap_ratio = node_area_ > 0.0 ? overlap_area_ / node_area_ : 0.0;
+        return std::move(stats_);
+    }
+
+private:
+    static void Increment(std::vector<std::size_t>& histogram, std::size_t index) {
+        if (histogram.size() <= index) {
+            histogram.resize(index + 1, 0);
+        }
+        ++histogram[index];
+    }
+
+    BvhStats stats_;
+    double root_area_ = 0.0;
+    double node_area_ = 0.0;
+    double leaf_cost_ = 0.0;
+    double overlap_area_ = 0.0;
+};
+
+template <int Width>
+BvhStats InspectWide(const WideBvh<Width>& bvh) {
+    StatsAccumulator accumulator;
+    if (bvh.NodeCount() == 0) {
+        return accumulator.Finish();
+    }
+
+    const WideBvhNode<Width>* nodes = bvh.Nodes();
+    std::vector<std::pair<std::int32_t, int>> pending{{0, 0}};
+    std::vector<Aabb> lane_boxes;
+    while (!pending.empty()) {
+        const auto [index, depth] = pending.back();
+        pending.pop_back();
+        const WideBvhNode<Width>& node = nodes[static_cast<std::size_t>(index)];
+
+        lane_boxes.clear();
+        for (int lane = 0; lane < node.lane_count; ++lane) {
+            lane_boxes.emplace_back(Point3(node.min_x[lane], node.min_y[lane], node.min_z[lane]),
+                                    Point3(node.max_x[lane], node.max_y[lane], node.max_z[lane]));
+        }
+        accumulator.AddNode(lane_boxes);
+        for (int lane = 0; lane < node.lane_count; ++lane) {
+            if (node.child[lane] >= 0) {
+                pending.emplace_back(node.child[lane], depth + 1);
+            } else {
+                accumulator.AddLeaf(depth + 1, node.count[lane], lane_boxes[static_cast<std::size_t>(lane)]);
+            }
+        }
+    }
+    return accumulator.Finish();
+}
+
+}  // namespace
+
+// BvhNode의 자식 종류를 읽으려고 friend로 선언된 검사기.
+class BvhInspector {
+public:
+    static void VisitRoot(const BvhNode& tree, double time0, double time1, StatsAccumulator& accumulator) {
+        tree.BuildAll();
+        // 기본 생성한 빈 노드는 자식이 없다.
+        if (tree.left_) {
+            Visit(tree, time0, time1, 0, accumulator);
+        }
+    }
+
+private:
+    static void Visit(const BvhNode& node, double time0, double time1, int depth, StatsAccumulator& accumulator) {
+        // 객체 하나짜리 뿌리는 두 자식이 같은 객체다.
+        const bool single = node.left_ == node.right_;
+        std::vector<Aabb> child_boxes(single ? 1 : 2);
+        if (!node.left_->BoundingBox(time0, time1, child_boxes[0]) ||
+            (!single && !node.right_->BoundingBox(time0, time1, child_boxes[1]))) {
+            throw std::runtime_error("BVH 검사 중 경계 상자를 계산할 수 없다.");
+        }
+        accumulator.AddNode(child_boxes);
+
+        VisitChild(node.left_, node.left_kind_, child_boxes[0], time0, time1, depth + 1, accumulator);
+        if (!single) {
+            VisitChild(node.right_, node.right_kind_, child_boxes[1], time0, time1, depth + 1, accumulator);
+        }
+    }
+
+    static void VisitChild(const std::shared_ptr<Hittable>& child, BvhNode::ChildKind kind, const Aabb& box,
+                           double time0, double time1, int depth, StatsAccumulator& accumulator) {
+        switch (kind) {
+        case BvhNode::ChildKind::kNode:
+            Visit(static_cast<const BvhNode&>(*child), time0, time1, depth, accumulator);
+            break;
+        case BvhNode::ChildKind::kLeafList:
+            accumulator.AddLeaf(depth, static_cast<const HittableList&>(*child).Objects().size(), box);
+            break;
+        case BvhNode::ChildKind::kObject:
+            accumulator.AddLeaf(depth, 1, box);
+            break;
+        }
+    }
+};
+
+BvhStats InspectBvh(const BvhNode& tree, double time0, double time1) {
+    StatsAccumulator accumulator;
+    BvhInspector::VisitRoot(tree, time0, time1, accumulator);
+    return accumulator.Finish();
+}
+
+BvhStats InspectBvh(const Bvh4& bvh) { return InspectWide(bvh); }
+
+BvhStats InspectBvh(const Bvh8& bvh) { return InspectWide(bvh); }
+
+std::string FormatBvhStats(const BvhStats& stats) {
+    std::ostringstream output;
+    output << "  노드 " << stats.node_count << "개, 잎 " << stats.leaf_count << "개, 도형 참조 "
+           << stats.primitive_references << "개\n";
+    output << "  SAH 비용: " << stats.sah_cost << ", 형제 겹침 비율: " << stats.sibling_overlap_ratio << "\n";
+    output << "  깊이별 잎 수:";
+    for (std::size_t depth = 0; depth < stats.leaves_per_depth.size(); ++depth) {
+        if (stats.leaves_per_depth[depth] != 0) {
+            output << ' ' << depth << ':' << stats.leaves_per_depth[depth];
+        }
+    }
+    output << "\n  잎 크기 분포:";
+    for (std::size_t size = 0; size < stats.leaf_sizes.size(); ++size) {
+        if (stats.leaf_sizes[size] != 0) {
+            output << ' ' << size << ':' << stats.leaf_sizes[size];
+        }
+    }
+    output << "\n";
+    return output.str();
+}
+
+#if defined(RAYTRACER_BVH_COUNTERS)
+namespace {
+
+struct SlotRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<detail::BvhCounterSlot>> slots;
+};
+
+SlotRegistry& Registry() {
+    static SlotRegistry registry;
+    return registry;
+}
+
+}  // namespace
+
+detail::BvhCounterSlot* detail::RegisterBvhCounterSlot() {
+    SlotRegistry& registry = Registry();
+    const std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.slots.push_back(std::make_unique<BvhCounterSlot>());
+    return registry.slots.back().get();
+}
+
+BvhTraversalCounters ReadBvhCounters() {
+    SlotRegistry& registry = Registry();
+    const std::lock_guard<std::mutex> lock(registry.mutex);
+    BvhTraversalCounters total;
+    for (const auto& slot : registry.slots) {
+        total.rays += slot->rays.load(std::memory_order_relaxed);
+        total.nodes_visited += slot->nodes_visited.load(std::memory_order_relaxed);
+        total.primitives_tested += slot->primitives_tested.load(std::memory_order_relaxed);
+        total.packet_detached_rays += slot->packet_detached_rays.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void ResetBvhCounters() {
+    SlotRegistry& registry = Registry();
+    const std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& slot : registry.slots) {
+        slot->rays.store(0, std::memory_order_relaxed);
+        slot->nodes_visited.store(0, std::memory_order_relaxed);
+        slot->primitives_tested.store(0, std::memory_order_relaxed);
+        slot->packet_detached_rays.store(0, std::memory_order_relaxed);
+    }
+}
+#else
+BvhTraversalCounters ReadBvhCounters() { return BvhTraversalCounters{}; }
+
+void ResetBvhCounters() {}
+#endif
+
+}  // namespace raytracer
@@ -0,0 +1,117 @@
+/*
+ * 설명: 누적 버퍼를 16진 부동소수 텍스트로 기록해 비트 단위로 동일하게 복원한다.
+ * 버전: v1.2.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.2.0-progressive.md
+ * 테스트: tests/integration/ppm_integration_test.cpp
+ */
+#include "raytracer/checkpoint.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+namespace raytracer {
+namespace {
+
+constexpr const char* kMagic = "RTCHECKPOINT";
+constexpr int kFormatVersion = 2;
+
+void AppendHex(std::string& line, double value) {
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::hex);
+    line.append(buffer, result.ptr);
+}
+
+double ParseHex(const std::string& token) {
+    double value = 0.0;
+    const auto result = std::from_chars(token.data(), token.data() + token.size(), value, std::chars_format::hex);
+    if (result.ec != std::errc() || result.ptr != token.data() + token.size()) {
+        throw std::runtime_error("체크포인트의 누적 값 형식이 올바르지 않다.");
+    }
+    return value;
+}
+
+}  // namespace
+
+void SaveCheckpoint(const std::string& path, const Checkpoint& checkpoint) {
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("체크포인트 파일을 열 수 없다.");
+        }
+
+        file << kMagic << ' ' << kFormatVersion << "\n";
+        file << checkpoint.width << ' ' << checkpoint.height << "\n";
+        file << checkpoint.seed << ' ' << checkpoint.max_depth << "\n";
+        // 재개 때 카메라 설정을 정확히 비교하도록 double은 되읽으면 같은 값이 되는 자릿수로 기록한다.
+        file << std::setprecision(std::numeric_limits<double>::max_digits10) << checkpoint.vertical_fov_degrees << ' '
+             << checkpoint.aperture << ' ' << checkpoint.shutter_open_time << ' ' << checkpoint.shutter_close_time
+             << "\n";
+        file << checkpoint.completed_passes << "\n";
+
+        std::string line;
+        for (int y = 0; y < checkpoint.height; ++y) {
+            for (int x = 0; x < checkpoint.width; ++x) {
+                const Color& sum = checkpoint.accumulation.At(x, y);
+                line.clear();
+                AppendHex(line, sum.x());
+                line.push_back(' ');
+                AppendHex(line, sum.y());
+                line.push_back(' ');
+                AppendHex(line, sum.z());
+                line.push_back('\n');
+                file << line;
+            }
+        }
+
+        if (!file) {
+            throw std::runtime_error("체크포인트 기록에 실패했다.");
+        }
+    }
+
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("체크포인트 파일을 교체할 수 없다.");
+    }
+}
+
+Checkpoint LoadCheckpoint(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("체크포인트 파일을 열 수 없다.");
+    }
+
+    std::string magic;
+    int version = 0;
+    Checkpoint checkpoint;
+    file >> magic >> version >> checkpoint.width >> checkpoint.height >> checkpoint.seed >> checkpoint.max_depth >>
+        checkpoint.vertical_fov_degrees >> checkpoint.aperture >> checkpoint.shutter_open_time >>
+        checkpoint.shutter_close_time >> checkpoint.completed_passes;
+    if (!file || magic != kMagic || version != kFormatVersion) {
+        throw std::runtime_error("체크포인트 헤더가 올바르지 않다.");
+    }
+    if (checkpoint.width < 1 || checkpoint.height < 1 || checkpoint.completed_passes < 0) {
+        throw std::runtime_error("체크포인트 해상도 또는 패스 수가 올바르지 않다.");
+    }
+
+    checkpoint.accumulation = Framebuffer(checkpoint.width, checkpoint.height);
+    std::string r;
+    std::string g;
+    std::string b;
+    for (int y = 0; y < checkpoint.height; ++y) {
+        for (int x = 0; x < checkpoint.width; ++x) {
+            if (!(file >> r >> g >> b)) {
+                throw std::runtime_error("체크포인트 누적 버퍼가 잘렸다.");
+            }
+            checkpoint.accumulation.At(x, y) = Color(ParseHex(r), ParseHex(g), ParseHex(b));
+        }
+    }
+
+    return checkpoint;
+}
+
+}  // namespace raytracer
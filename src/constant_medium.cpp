@@ -21,7 +21,7 @@ ConstantMedium::ConstantMedium(std::shared_ptr<Hittable> boundary, double densit
 ConstantMedium::ConstantMedium(std::shared_ptr<Hittable> boundary, double density, const Color& albedo)
     : ConstantMedium(std::move(boundary), density, std::make_shared<SolidColor>(albedo)) {}
 
-bool ConstantMedium::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const {
+bool ConstantMedium::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const {
     HitRecord rec1;
     HitRecord rec2;
 
@@ -0,0 +1,75 @@
+/*
+ * 설명: PPM(P3/P6) 헤더와 행을 재사용 버퍼에 서식화해 출력 스트림으로 흘려보낸다.
+ * 버전: v1.4.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.4.0-streaming-output.md
+ * 테스트: tests/unit/image_sink_test.cpp
+ */
+#include "raytracer/image_sink.hpp"
+
+#include <charconv>
+#include <stdexcept>
+
+namespace raytracer {
+namespace {
+
+void AppendInt(std::string& buffer, int value) {
+    char digits[16];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr);
+}
+
+}  // namespace
+
+PpmStreamWriter::PpmStreamWriter(std::ostream& output, PpmFormat format) : output_(output), format_(format) {}
+
+void PpmStreamWriter::Begin(int width, int height) {
+    width_ = width;
+    buffer_.clear();
+    buffer_.append(format_ == PpmFormat::kBinary ? "P6\n" : "P3\n");
+    AppendInt(buffer_, width);
+    buffer_.push_back(' ');
+    AppendInt(buffer_, height);
+    buffer_.append("\n255\n");
+    Flush();
+}
+
+void PpmStreamWriter::WriteRow(int /*y*/, const std::vector<Rgb8>& row) {
+    if (static_cast<int>(row.size()) != width_) {
+        throw std::invalid_argument("행 픽셀 수가 이미지 너비와 다르다.");
+    }
+
+    buffer_.clear();
+    if (format_ == PpmFormat::kBinary) {
+        for (const Rgb8& rgb : row) {
+            buffer_.push_back(static_cast<char>(rgb.r));
+            buffer_.push_back(static_cast<char>(rgb.g));
+            buffer_.push_back(static_cast<char>(rgb.b));
+        }
+    } else {
+        for (const Rgb8& rgb : row) {
+            AppendInt(buffer_, rgb.r);
+            buffer_.push_back(' ');
+            AppendInt(buffer_, rgb.g);
+            buffer_.push_back(' ');
+            AppendInt(buffer_, rgb.b);
+            buffer_.push_back('\n');
+        }
+    }
+    Flush();
+}
+
+void PpmStreamWriter::End() {
+    output_.flush();
+    if (!output_) {
+        throw std::runtime_error("이미지 출력 기록에 실패했다.");
+    }
+}
+
+void PpmStreamWriter::Flush() {
+    output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    if (!output_) {
+        throw std::runtime_error("이미지 출력 기록에 실패했다.");
+    }
+}
+
+}  // namespace raytracer
@@ -0,0 +1,148 @@
+/*
+ * 설명: 아핀 변환의 합성/역변환과, 레이를 물체 좌표로 한 번 바꿔 공유 BLAS를 순회하는 인스턴스 교차·가림 판정을 구현한다.
+ * 버전: v1.20.0
+ * 관련 문서: design/renderer/v1.16.0-instancing.md, design/renderer/v1.20.0-occlusion.md
+ * 테스트: tests/unit/instance_test.cpp
+ */
+#include "raytracer/instance.hpp"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "raytracer/ray.hpp"
+
+namespace raytracer {
+
+AffineTransform AffineTransform::Translation(const Vec3& offset) {
+    AffineTransform transform;
+    for (int row = 0; row < 3; ++row) {
+        transform.m_[row][3] = offset[row];
+    }
+    return transform;
+}
+
+AffineTransform AffineTransform::RotationY(double angle_degrees) {
+    const double radians = angle_degrees * 3.1415926535897932385 / 180.0;
+    const double sin_theta = std::sin(radians);
+    const double cos_theta = std::cos(radians);
+    AffineTransform transform;
+    transform.m_[0][0] = cos_theta;
+    transform.m_[0][2] = sin_theta;
+    transform.m_[2][0] = -sin_theta;
+    transform.m_[2][2] = cos_theta;
+    return transform;
+}
+
+AffineTransform AffineTransform::Scaling(const Vec3& factors) {
+    AffineTransform transform;
+    for (int row = 0; row < 3; ++row) {
+        transform.m_[row][row] = factors[row];
+    }
+    return transform;
+}
+
+AffineTransform AffineTransform::Then(const AffineTransform& next) const {
+    AffineTransform result;
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            double value = column == 3 ? next.m_[row][3] : 0.0;
+            for (int k = 0; k < 3; ++k) {
+                value += next.m_[row][k] * m_[k][column];
+            }
+            result.m_[row][column] = value;
+        }
+    }
+    return result;
+}
+
+AffineTransform AffineTransform::Inverse() const {
+    // 선형 부분은 여인수 행렬로 뒤집고, 이동은 -A^-1 * b로 되돌린다.
+    const auto& a = m_;
+    const double c00 = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+    const double c01 = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+    const double c02 = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+    const double determinant = a[0][0] * c00 + a[0][1] * c01 + a[0][2] * c02;
+    if (!(std::fabs(determinant) > 1.0e-12) || !std::isfinite(determinant)) {
+        throw std::invalid_argument("인스턴스 변환의 선형 부분이 특이 행렬이다.");
+    }
+
+    const double inverse_determinant = 1.0 / determinant;
+    AffineTransform result;
+    auto& r = result.m_;
+    r[0][0] = c00 * inverse_determinant;
+    r[1][0] = c01 * inverse_determinant;
+    r[2][0] = c02 * inverse_determinant;
+    r[0][1] = (a[0][2] * a[2][1] - a[0][1] * a[2][2]) * inverse_determinant;
+    r[1][1] = (a[0][0] * a[2][2] - a[0][2] * a[2][0]) * inverse_determinant;
+    r[2][1] = (a[0][1] * a[2][0] - a[0][0] * a[2][1]) * inverse_determinant;
+    r[0][2] = (a[0][1] * a[1][2] - a[0][2] * a[1][1]) * inverse_determinant;
+    r[1][2] = (a[0][2] * a[1][0] - a[0][0] * a[1][2]) * inverse_determinant;
+    r[2][2] = (a[0][0] * a[1][1] - a[0][1] * a[1][0]) * inverse_determinant;
+    for (int row = 0; row < 3; ++row) {
+        r[row][3] = -(r[row][0] * a[0][3] + r[row][1] * a[1][3] + r[row][2] * a[2][3]);
+    }
+    return result;
+}
+
+Point3 AffineTransform::ApplyPoint(const Point3& p) const {
+    return ApplyVector(p) + Vec3(m_[0][3], m_[1][3], m_[2][3]);
+}
+
+Vec3 AffineTransform::ApplyVector(const Vec3& v) const {
+    return Vec3(m_[0][0] * v.x() + m_[0][1] * v.y() + m_[0][2] * v.z(),
+                m_[1][0] * v.x() + m_[1][1] * v.y() + m_[1][2] * v.z(),
+                m_[2][0] * v.x() + m_[2][1] * v.y() + m_[2][2] * v.z());
+}
+
+Vec3 AffineTransform::ApplyTransposedVector(const Vec3& v) const {
+    return Vec3(m_[0][0] * v.x() + m_[1][0] * v.y() + m_[2][0] * v.z(),
+                m_[0][1] * v.x() + m_[1][1] * v.y() + m_[2][1] * v.z(),
+                m_[0][2] * v.x() + m_[1][2] * v.y() + m_[2][2] * v.z());
+}
+
+Instance::Instance(std::shared_ptr<Hittable> blas, const AffineTransform& object_to_world)
+    : blas_(std::move(blas)), object_to_world_(object_to_world), world_to_object_(object_to_world.Inverse()) {}
+
+bool Instance::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const {
+    const Ray object_ray(world_to_object_.ApplyPoint(r.origin()), world_to_object_.ApplyVector(r.direction()), r.time());
+    if (!blas_->Hit(object_ray, t_min, t_max, record, generator)) {
+        return false;
+    }
+
+    // 아핀 변환은 레이 방향과 법선의 내적 부호를 보존하므로 물체 좌표에서 정한 front_face를 그대로 쓴다.
+    record.p = object_to_world_.ApplyPoint(record.p);
+    record.normal = UnitVector(world_to_object_.ApplyTransposedVector(record.normal));
+    return true;
+}
+
+// 방향을 정규화하지 않으므로 물체 좌표의 t가 월드 t와 같아 구간을 그대로 넘긴다.
+bool Instance::Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const {
+    const Ray object_ray(world_to_object_.ApplyPoint(r.origin()), world_to_object_.ApplyVector(r.direction()), r.time());
+    return blas_->Occluded(object_ray, t_min, t_max, generator);
+}
+
+bool Instance::BoundingBox(double time0, double time1, Aabb& output_box) const {
+    Aabb object_box;
+    if (!blas_->BoundingBox(time0, time1, object_box)) {
+        return false;
+    }
+
+    Point3 min_point(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(),
+                     std::numeric_limits<double>::infinity());
+    Point3 max_point = -min_point;
+    for (int corner = 0; corner < 8; ++corner) {
+        const Point3 local((corner & 1) != 0 ? object_box.maximum().x() : object_box.minimum().x(),
+                           (corner & 2) != 0 ? object_box.maximum().y() : object_box.minimum().y(),
+                           (corner & 4) != 0 ? object_box.maximum().z() : object_box.minimum().z());
+        const Point3 world = object_to_world_.ApplyPoint(local);
+        min_point = Point3(std::fmin(min_point.x(), world.x()), std::fmin(min_point.y(), world.y()),
+                           std::fmin(min_point.z(), world.z()));
+        max_point = Point3(std::fmax(max_point.x(), world.x()), std::fmax(max_point.y(), world.y()),
+                           std::fmax(max_point.z(), world.z()));
+    }
+    output_box = Aabb(min_point, max_point);
+    return true;
+}
+
+}  // namespace raytracer
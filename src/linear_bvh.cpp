@@ -0,0 +1,140 @@
+/*
+ * 설명: BvhNode 트리를 32바이트 노드 배열로 평탄화하고 명시적 스택으로 가까운 자식부터 순회한다.
+ *       지연 빌드 트리는 남은 노드를 모두 나눈 뒤 평탄화한다.
+ * 버전: v1.24.0
+ * 관련 문서: design/renderer/v1.11.0-linear-bvh.md, design/renderer/v1.24.0-lazy-bvh.md
+ * 테스트: tests/unit/bvh_test.cpp
+ */
+#include "raytracer/linear_bvh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "raytracer/hittable_list.hpp"
+
+#include "bvh_float_util.hpp"
+#include "linear_bvh_traversal.hpp"
+
+namespace raytracer {
+namespace {
+
+using detail::RoundDown;
+using detail::RoundUp;
+using detail::SeparatingAxis;
+
+Aabb ChildBox(const std::shared_ptr<Hittable>& child, double time0, double time1) {
+    Aabb box;
+    if (!child->BoundingBox(time0, time1, box)) {
+        throw std::runtime_error("BVH 평탄화 중 경계 상자를 계산할 수 없다.");
+    }
+    return box;
+}
+
+double Center(const Aabb& box, int axis) { return box.minimum()[axis] + box.maximum()[axis]; }
+
+// Aabb::Hit과 같은 슬래브 판정을 미리 계산한 역방향으로 수행한다.
+bool NodeHit(const LinearBvhNode& node, const Point3& origin, const Vec3& inv_dir, double t_min, double t_max) {
+    for (int axis = 0; axis < 3; ++axis) {
+        double t0 = (static_cast<double>(node.bounds_min[axis]) - origin[axis]) * inv_dir[axis];
+        double t1 = (static_cast<double>(node.bounds_max[axis]) - origin[axis]) * inv_dir[axis];
+        if (inv_dir[axis] < 0.0) {
+            std::swap(t0, t1);
+        }
+
+        t_min = t0 > t_min ? t0 : t_min;
+        t_max = t1 < t_max ? t1 : t_max;
+        if (t_max <= t_min) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+LinearBvh::LinearBvh(const BvhNode& tree, double time0, double time1) {
+    tree.BuildAll();
+    FlattenNode(tree, time0, time1, 1);
+}
+
+LinearBvh::LinearBvh(std::vector<std::shared_ptr<Hittable>> objects, double time0, double time1,
+                     const BvhBuildOptions& options)
+    : LinearBvh(BvhNode(std::move(objects), time0, time1, options), time0, time1) {}
+
+std::uint32_t LinearBvh::AppendNode(const Aabb& box, std::uint8_t axis) {
+    if (nodes_.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("선형 BVH 노드 수가 32비트 인덱스 범위를 넘었다.");
+    }
+    LinearBvhNode node{};
+    for (int i = 0; i < 3; ++i) {
+        node.bounds_min[i] = RoundDown(box.minimum()[i]);
+        node.bounds_max[i] = RoundUp(box.maximum()[i]);
+    }
+    node.axis = axis;
+    nodes_.push_back(node);
+    return static_cast<std::uint32_t>(nodes_.size() - 1);
+}
+
+std::uint32_t LinearBvh::FlattenNode(const BvhNode& node, double time0, double time1, int depth) {
+    depth_ = std::max(depth_, depth);
+    if (node.left_ == node.right_) {
+        return FlattenChild(node.left_, node.left_kind_, node.box_, time0, time1, depth);
+    }
+
+    const Aabb left_box = node.left_kind_ == BvhNode::ChildKind::kNode ? static_cast<const BvhNode&>(*node.left_).box_
+                                                                        : ChildBox(node.left_, time0, time1);
+    const Aabb right_box = node.right_kind_ == BvhNode::ChildKind::kNode ? static_cast<const BvhNode&>(*node.right_).box_
+                                                                          : ChildBox(node.right_, time0, time1);
+    const int axis = SeparatingAxis(left_box, right_box);
+    const std::uint32_t index = AppendNode(node.box_, static_cast<std::uint8_t>(axis));
+
+    // 축 위에서 중심이 작은 자식을 바로 다음 인덱스에 둔다.
+    if (Center(left_box, axis) <= Center(right_box, axis)) {
+        FlattenChild(node.left_, node.left_kind_, left_box, time0, time1, depth + 1);
+        nodes_[index].offset = FlattenChild(node.right_, node.right_kind_, right_box, time0, time1, depth + 1);
+    } else {
+        FlattenChild(node.right_, node.right_kind_, right_box, time0, time1, depth + 1);
+        nodes_[index].offset = FlattenChild(node.left_, node.left_kind_, left_box, time0, time1, depth + 1);
+    }
+    return index;
+}
+
+std::uint32_t LinearBvh::FlattenChild(const std::shared_ptr<Hittable>& child, BvhNode::ChildKind kind, const Aabb& box,
+                                      double time0, double time1, int depth) {
+    if (kind == BvhNode::ChildKind::kNode) {
+        return FlattenNode(static_cast<const BvhNode&>(*child), time0, time1, depth);
+    }
+
+    depth_ = std::max(depth_, depth);
+    const std::uint32_t index = AppendNode(box, 0);
+    const std::size_t first = primitives_.size();
+    if (kind == BvhNode::ChildKind::kLeafList) {
+        const auto& objects = static_cast<const HittableList&>(*child).Objects();
+        primitives_.insert(primitives_.end(), objects.begin(), objects.end());
+    } else {
+        primitives_.push_back(child);
+    }
+
+    const std::size_t count = primitives_.size() - first;
+    if (count > std::numeric_limits<std::uint16_t>::max() || first > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("선형 BVH 잎 객체 수 또는 객체 인덱스가 범위를 넘었다.");
+    }
+    nodes_[index].offset = static_cast<std::uint32_t>(first);
+    nodes_[index].primitive_count = static_cast<std::uint16_t>(count);
+    return index;
+}
+
+bool LinearBvh::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const {
+    return detail::TraverseLinearNodes<false>(nodes_, primitives_, depth_, r, t_min, t_max, record, generator, NodeHit);
+}
+
+bool LinearBvh::BoundingBox(double /*time0*/, double /*time1*/, Aabb& output_box) const {
+    const LinearBvhNode& root = nodes_.front();
+    output_box = Aabb(Point3(root.bounds_min[0], root.bounds_min[1], root.bounds_min[2]),
+                      Point3(root.bounds_max[0], root.bounds_max[1], root.bounds_max[2]));
+    return true;
+}
+
+}  // namespace raytracer
@@ -0,0 +1,79 @@
+/*
+ * 설명: 깊이 우선 노드 배열(LinearBvhNode와 같은 offset/primitive_count/axis 배치)을 명시적 스택으로 가까운 자식부터
+ *       순회하는 공용 루프. 노드 상자 판정만 형식마다 다르므로 호출자가 판정 함수로 넘긴다. src/ 안에서만 포함한다.
+ * 버전: v1.25.0
+ * 관련 문서: design/renderer/v1.11.0-linear-bvh.md, design/renderer/v1.25.0-motion-bvh.md
+ * 테스트: tests/unit/bvh_test.cpp
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "raytracer/hittable.hpp"
+#include "raytracer/ray.hpp"
+#include "raytracer/vec3.hpp"
+
+namespace raytracer::detail {
+
+constexpr int kLinearStackSize = 64;
+
+// 내부 노드는 axis 위에서 중심이 작은 자식을 바로 다음 인덱스에, 다른 자식을 offset에 둔다. 레이 방향 부호로 먼저
+// 방문할 자식을 고른다. 잎의 offset은 primitives 안 첫 객체 인덱스다.
+// node_hit(node, origin, inv_dir, t_min, t_max)는 노드 상자가 [t_min, t_max] 안에서 레이와 만나면 true를 낸다.
+// AnyHit이면 도형의 Occluded로 판정하고 처음 찾은 교차에서 멈추며 record를 쓰지 않는다.
+template <bool AnyHit, typename Node, typename BoxTest>
+bool TraverseLinearNodes(const std::vector<Node>& nodes, const std::vector<std::shared_ptr<Hittable>>& primitives,
+                         int depth, const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator,
+                         const BoxTest& node_hit) {
+    const Point3& origin = r.origin();
+    const Vec3 inv_dir(1.0 / r.direction().x(), 1.0 / r.direction().y(), 1.0 / r.direction().z());
+
+    std::uint32_t local_stack[kLinearStackSize];
+    std::vector<std::uint32_t> deep_stack;
+    std::uint32_t* stack = local_stack;
+    if (depth > kLinearStackSize) {
+        deep_stack.resize(static_cast<std::size_t>(depth));
+        stack = deep_stack.data();
+    }
+
+    bool hit_anything = false;
+    double closest = t_max;
+    int stack_size = 0;
+    std::uint32_t current = 0;
+    while (true) {
+        const Node& node = nodes[current];
+        if (node_hit(node, origin, inv_dir, t_min, closest)) {
+            if (node.primitive_count > 0) {
+                const auto begin = primitives.begin() + node.offset;
+                for (auto it = begin; it != begin + node.primitive_count; ++it) {
+                    if constexpr (AnyHit) {
+                        if ((*it)->Occluded(r, t_min, t_max, generator)) {
+                            return true;
+                        }
+                    } else if ((*it)->Hit(r, t_min, closest, record, generator)) {
+                        hit_anything = true;
+                        closest = record.t;
+                    }
+                }
+            } else if (inv_dir[node.axis] < 0.0) {
+                stack[stack_size++] = current + 1;
+                current = node.offset;
+                continue;
+            } else {
+                stack[stack_size++] = node.offset;
+                current = current + 1;
+                continue;
+            }
+        }
+        if (stack_size == 0) {
+            break;
+        }
+        current = stack[--stack_size];
+    }
+    return hit_anything;
+}
+
+}  // namespace raytracer::detail
@@ -1,24 +1,212 @@
 /*
- * 설명: CLI 인자를 해석해 Cornell smoke 장면을 BVH로 가속하고 중요도 샘플링을 사용해 결정적으로 렌더링한다.
- * 버전: v1.0.0
- * 관련 문서: design/protocol/contract.md, design/renderer/v1.0.0-overview.md
+ * 설명: CLI 인자를 해석해 Cornell smoke 장면을 타일 멀티스레드, 체크포인트 가능한 점진 패스, 타일 구간 샤드로 결정적으로
+ *       렌더링하거나(시간 예산 모드 포함) 장면을 한 번 구성해 두고 소켓 요청, 배치 매니페스트의 변형들, 애니메이션 프레임들을 처리한다.
+ *       --bvh-stats를 주면 장면 BVH 품질 지표와 렌더 동안 모은 순회 카운터를 표준 오류로 출력한다.
+ *       --packet-size로 타일 렌더의 화면 레이를 묶어 순회하고, --integrator로 재귀/웨이브프런트 적분기를 고르며,
+ *       --tile-culling으로 화면 레이를 타일 절두체로 잘라 낸 BVH에서 순회한다.
+ * 버전: v1.23.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.2.0-progressive.md, design/renderer/v1.3.0-shards.md,
+ *           design/renderer/v1.4.0-streaming-output.md, design/renderer/v1.5.0-render-server.md,
+ *           design/renderer/v1.7.0-time-budget.md, design/renderer/v1.8.0-batch.md, design/renderer/v1.9.0-animation.md,
+ *           design/renderer/v1.19.0-bvh-stats.md, design/renderer/v1.21.0-ray-packets.md,
+ *           design/renderer/v1.22.0-wavefront.md, design/renderer/v1.23.0-tile-culling.md
  * 테스트: tests/integration/ppm_integration_test.cpp
  */
+#include <signal.h>
+
+#include <chrono>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <ostream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
+#include "raytracer/animation.hpp"
+#include "raytracer/batch.hpp"
+#include "raytracer/bvh_stats.hpp"
+#include "raytracer/image_sink.hpp"
 #include "raytracer/ppm.hpp"
+#include "raytracer/render_server.hpp"
+#include "raytracer/shard.hpp"
+#include "raytracer/tile.hpp"
 
 namespace {
 
+struct CommandLine {
+    raytracer::RenderOptions options;
+    raytracer::ProgressiveOptions progressive;
+    std::string output_path = "-";
+    raytracer::PpmFormat format = raytracer::PpmFormat::kAscii;
+    std::string tile_range;
+    std::string shard;
+    std::string serve_path;
+    std::string batch_path;
+    raytracer::AnimationOptions animation;
+    bool has_frames = false;
+    bool has_spp = false;
+    bool bvh_stats = false;
+};
+
+raytracer::RenderServer* active_server = nullptr;
+
+void StopServer(int /*signal*/) {
+    if (active_server != nullptr) {
+        active_server->Stop();
+    }
+}
+
+// 매니페스트 전체를 먼저 검증한 뒤 장면/BVH와 스레드 풀을 한 번만 만들어 모든 변형을 렌더링한다.
+int RunBatch(const CommandLine& command_line) {
+    std::ifstream manifest(command_line.batch_path);
+    if (!manifest.is_open()) {
+        std::cerr << "오류: 매니페스트 파일을 열 수 없다." << std::endl;
+        return 2;
+    }
+
+    std::vector<raytracer::RenderRequest> requests;
+    try {
+        requests = raytracer::ParseBatchManifest(manifest, command_line.options);
+    } catch (const std::runtime_error& error) {
+        std::cerr << "오류: 매니페스트 " << error.what() << std::endl;
+        return 2;
+    }
+
+    const raytracer::RenderOptions& options = command_line.options;
+    const raytracer::Scene scene = raytracer::BuildCornellSmokeScene(options.shutter_open_time, options.shutter_close_time);
+    raytracer::ThreadPool pool(options.thread_count);
+    const std::vector<std::string> errors = raytracer::RenderBatch(requests, scene, pool);
+
+    std::size_t failed = 0;
+    for (std::size_t index = 0; index < errors.size(); ++index) {
+        if (!errors[index].empty()) {
+            std::cerr << "오류: " << requests[index].output_path << ": " << errors[index] << std::endl;
+            ++failed;
+        }
+    }
+    std::cerr << "배치 완료: " << requests.size() - failed << "/" << requests.size() << std::endl;
+    return failed == 0 ? 0 : 2;
+}
+
+// 장면/BVH와 스레드 풀을 한 번만 만들고 프레임마다 자세를 바꿔 BVH를 재맞춤한 뒤 프레임 파일로 기록한다.
+int RunFrames(const CommandLine& command_line) {
+    raytracer::ThreadPool pool(command_line.options.thread_count);
+    try {
+        const raytracer::AnimationStats stats = raytracer::RenderAnimation(
+            command_line.options, command_line.animation, command_line.output_path, command_line.format, pool);
+        std::cerr << "프레임 완료: " << stats.frames << ", BVH 재맞춤 노드: " << stats.bvh.refitted_nodes
+                  << ", 재구성 서브트리: " << stats.bvh.rebuilt_subtrees << std::endl;
+    } catch (const std::runtime_error& error) {
+        std::cerr << "오류: " << error.what() << std::endl;
+        return 2;
+    }
+    return 0;
+}
+
+// SIGINT/SIGTERM을 받으면 새 연결을 멈추고 진행 중인 연결을 닫은 뒤 소켓 파일을 지우고 종료한다.
+int RunServer(const CommandLine& command_line) {
+    try {
+        raytracer::RenderServer server(command_line.serve_path, command_line.options);
+        active_server = &server;
+        struct sigaction action {};
+        action.sa_handler = StopServer;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+
+        std::cerr << "렌더 서버 대기 중: " << command_line.serve_path << std::endl;
+        server.Serve();
+        active_server = nullptr;
+    } catch (const std::runtime_error& error) {
+        active_server = nullptr;
+        std::cerr << "오류: " << error.what() << std::endl;
+        return 2;
+    }
+    return 0;
+}
+
+// 장면 구성은 렌더 경로와 같은 셔터 구간으로 한 번 더 하지만, Cornell 장면은 객체가 적어 비용이 무시할 만하다.
+void PrintSceneBvhStats(const raytracer::RenderOptions& options) {
+    const raytracer::Scene scene = raytracer::BuildCornellSmokeScene(options.shutter_open_time, options.shutter_close_time);
+    if (!scene.bvh_tree || !scene.wide_bvh) {
+        std::cerr << "BVH 통계: 장면이 비어 있다." << std::endl;
+        return;
+    }
+    std::cerr << "BVH 통계(이진 트리):\n"
+              << raytracer::FormatBvhStats(
+                     raytracer::InspectBvh(*scene.bvh_tree, options.shutter_open_time, options.shutter_close_time))
+              << "BVH 통계(Bvh8, 렌더 순회):\n"
+              << raytracer::FormatBvhStats(raytracer::InspectBvh(*scene.wide_bvh)) << std::flush;
+}
+
+void PrintBvhCounters() {
+    if (!raytracer::kBvhCountersEnabled) {
+        std::cerr << "BVH 순회 카운터: 꺼짐(RAYTRACER_ENABLE_BVH_COUNTERS=ON으로 빌드하면 센다)" << std::endl;
+        return;
+    }
+    const raytracer::BvhTraversalCounters counters = raytracer::ReadBvhCounters();
+    const double rays = counters.rays > 0 ? static_cast<double>(counters.rays) : 1.0;
+    std::cerr << "BVH 순회 카운터: 레이 " << counters.rays << ", 방문 노드 " << counters.nodes_visited << "(레이당 "
+              << static_cast<double>(counters.nodes_visited) / rays << "), 검사한 도형 " << counters.primitives_tested
+              << "(레이당 " << static_cast<double>(counters.primitives_tested) / rays << "), 묶음에서 떨어진 레이 "
+              << counters.packet_detached_rays << std::endl;
+}
+
 bool HasNext(int argc, int index) { return index + 1 < argc; }
 
-int ParseOptions(int argc, char* argv[], raytracer::RenderOptions& options, std::string& output_path) {
-    output_path = "-";
+// "<a><separator><b>" 형식의 0 이상 정수 쌍을 해석한다.
+bool ParseIntPair(const std::string& text, char separator, int& first, int& second) {
+    const std::size_t position = text.find(separator);
+    if (position == std::string::npos) {
+        return false;
+    }
+    try {
+        std::size_t first_length = 0;
+        std::size_t second_length = 0;
+        first = std::stoi(text.substr(0, position), &first_length);
+        second = std::stoi(text.substr(position + 1), &second_length);
+        return first_length == position && second_length == text.size() - position - 1 && first >= 0 && second >= 0;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// --tile-range 또는 --shard를 행 우선 타일 구간으로 바꾼다. 둘 다 없으면 has_range를 false로 둔다.
+int ResolveTileRange(const CommandLine& command_line, bool& has_range, raytracer::TileRange& range) {
+    has_range = !command_line.tile_range.empty() || !command_line.shard.empty();
+    if (!has_range) {
+        return 0;
+    }
+
+    const raytracer::RenderOptions& options = command_line.options;
+    const int tile_count = raytracer::TileCount(options.width, options.height, options.tile_size);
+
+    if (!command_line.tile_range.empty()) {
+        if (!ParseIntPair(command_line.tile_range, ':', range.begin, range.end) || range.begin > range.end ||
+            range.end > tile_count) {
+            std::cerr << "오류: --tile-range 값은 0 <= 시작 <= 끝 <= 타일 수(" << tile_count << ")인 <시작>:<끝> 형식이어야 한다."
+                      << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    int shard_index = 0;
+    int shard_count = 0;
+    if (!ParseIntPair(command_line.shard, '/', shard_index, shard_count) || shard_count < 1 || shard_index >= shard_count) {
+        std::cerr << "오류: --shard 값은 0 <= i < N인 <i>/<N> 형식이어야 한다." << std::endl;
+        return 1;
+    }
+    range = raytracer::ShardTileRange(shard_index, shard_count, tile_count);
+    return 0;
+}
+
+int ParseOptions(int argc, char* argv[], CommandLine& command_line) {
+    raytracer::RenderOptions& options = command_line.options;
+    raytracer::ProgressiveOptions& progressive = command_line.progressive;
+    std::string& output_path = command_line.output_path;
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "--width") {
@@ -49,6 +237,20 @@ int ParseOptions(int argc, char* argv[], raytracer::RenderOptions& options, std:
                 return 1;
             }
             output_path = argv[++i];
+        } else if (arg == "--format") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --format 옵션에 값이 필요하다." << std::endl;
+                return 1;
+            }
+            const std::string format = argv[++i];
+            if (format == "p3") {
+                command_line.format = raytracer::PpmFormat::kAscii;
+            } else if (format == "p6") {
+                command_line.format = raytracer::PpmFormat::kBinary;
+            } else {
+                std::cerr << "오류: --format 값은 p3 또는 p6이어야 한다." << std::endl;
+                return 1;
+            }
         } else if (arg == "--spp") {
             if (!HasNext(argc, i)) {
                 std::cerr << "오류: --spp 옵션에 값이 필요하다." << std::endl;
@@ -56,6 +258,7 @@ int ParseOptions(int argc, char* argv[], raytracer::RenderOptions& options, std:
             }
             try {
                 options.samples_per_pixel = std::stoi(argv[++i]);
+                command_line.has_spp = true;
             } catch (const std::exception&) {
                 std::cerr << "오류: --spp 값은 정수여야 한다." << std::endl;
                 return 1;
@@ -87,6 +290,132 @@ int ParseOptions(int argc, char* argv[], raytracer::RenderOptions& options, std:
                 std::cerr << "오류: --seed 값은 0 이상 정수여야 한다." << std::endl;
                 return 1;
             }
+        } else if (arg == "--threads") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --threads 옵션에 값이 필요하다." << std::endl;
+                return 1;
+            }
+            try {
+                options.thread_count = std::stoi(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "오류: --threads 값은 정수여야 한다." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--packet-size") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --packet-size 옵션에 값이 필요하다." << std::endl;
+                return 1;
+            }
+            try {
+                options.packet_size = std::stoi(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "오류: --packet-size 값은 1, 4, 8, 16 중 하나여야 한다." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--integrator") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --integrator 옵션에 값이 필요하다." << std::endl;
+                return 1;
+            }
+            const std::string integrator = argv[++i];
+            if (integrator == "recursive") {
+                options.integrator = raytracer::Integrator::kRecursive;
+            } else if (integrator == "wavefront") {
+                options.integrator = raytracer::Integrator::kWavefront;
+            } else {
+                std::cerr << "오류: --integrator 값은 recursive 또는 wavefront여야 한다." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--checkpoint") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --checkpoint 옵션에 경로가 필요하다." << std::endl;
+                return 1;
+            }
+            progressive.checkpoint_path = argv[++i];
+        } else if (arg == "--checkpoint-interval") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --checkpoint-interval 옵션에 값이 필요하다." << std::endl;
+                return 1;
+            }
+            try {
+                progressive.checkpoint_interval = std::stoi(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "오류: --checkpoint-interval 값은 정수여야 한다." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--time-budget") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --time-budget 옵션에 값이 필요하다." << std::endl;
+                return 1;
+            }
+            try {
+                const long long budget = std::stoll(argv[++i]);
+                if (budget < 1) {
+                    std::cerr << "오류: --time-budget 값은 1 이상 정수(밀리초)여야 한다." << std::endl;
+                    return 1;
+                }
+                progressive.time_budget = std::chrono::milliseconds(budget);
+            } catch (const std::exception&) {
+                std::cerr << "오류: --time-budget 값은 정수여야 한다." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--resume") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --resume 옵션에 경로가 필요하다." << std::endl;
+                return 1;
+            }
+            progressive.resume_path = argv[++i];
+        } else if (arg == "--tile-range") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --tile-range 옵션에 값이 필요하다." << std::endl;
+                return 1;
+            }
+            command_line.tile_range = argv[++i];
+        } else if (arg == "--serve") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --serve 옵션에 소켓 경로가 필요하다." << std::endl;
+                return 1;
+            }
+            command_line.serve_path = argv[++i];
+        } else if (arg == "--batch") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --batch 옵션에 매니페스트 경로가 필요하다." << std::endl;
+                return 1;
+            }
+            command_line.batch_path = argv[++i];
+        } else if (arg == "--frames") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --frames 옵션에 값이 필요하다." << std::endl;
+                return 1;
+            }
+            try {
+                command_line.animation.frame_count = std::stoi(argv[++i]);
+                command_line.has_frames = true;
+            } catch (const std::exception&) {
+                std::cerr << "오류: --frames 값은 정수여야 한다." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--rebuild-threshold") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --rebuild-threshold 옵션에 값이 필요하다." << std::endl;
+                return 1;
+            }
+            try {
+                command_line.animation.rebuild_threshold = std::stod(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "오류: --rebuild-threshold 값은 실수여야 한다." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--bvh-stats") {
+            command_line.bvh_stats = true;
+        } else if (arg == "--tile-culling") {
+            options.tile_culling = true;
+        } else if (arg == "--shard") {
+            if (!HasNext(argc, i)) {
+                std::cerr << "오류: --shard 옵션에 값이 필요하다." << std::endl;
+                return 1;
+            }
+            command_line.shard = argv[++i];
         } else {
             std::cerr << "오류: 지원하지 않는 옵션." << std::endl;
             return 1;
@@ -108,38 +437,160 @@ int ParseOptions(int argc, char* argv[], raytracer::RenderOptions& options, std:
         return 1;
     }
 
+    if (options.thread_count < 1) {
+        std::cerr << "오류: --threads 값은 1 이상 정수여야 한다." << std::endl;
+        return 1;
+    }
+
+    if (options.packet_size != 1 && options.packet_size != 4 && options.packet_size != 8 && options.packet_size != 16) {
+        std::cerr << "오류: --packet-size 값은 1, 4, 8, 16 중 하나여야 한다." << std::endl;
+        return 1;
+    }
+
+    if (progressive.checkpoint_interval < 1) {
+        std::cerr << "오류: --checkpoint-interval 값은 1 이상 정수여야 한다." << std::endl;
+        return 1;
+    }
+
+    const bool use_budget = progressive.time_budget.count() > 0;
+    const bool use_progressive = !progressive.checkpoint_path.empty() || !progressive.resume_path.empty() || use_budget;
+    if (use_budget && !command_line.has_spp) {
+        // 시간 예산만 주면 샘플 수 상한 없이 마감까지 패스를 더한다.
+        options.samples_per_pixel = std::numeric_limits<int>::max();
+    }
+    if (!command_line.tile_range.empty() && !command_line.shard.empty()) {
+        std::cerr << "오류: --tile-range와 --shard는 함께 사용할 수 없다." << std::endl;
+        return 1;
+    }
+    if (use_progressive && (!command_line.tile_range.empty() || !command_line.shard.empty())) {
+        std::cerr << "오류: 샤드 렌더는 체크포인트/재개/시간 예산과 함께 사용할 수 없다." << std::endl;
+        return 1;
+    }
+    if (!command_line.serve_path.empty() &&
+        (use_progressive || !command_line.tile_range.empty() || !command_line.shard.empty() || output_path != "-")) {
+        std::cerr << "오류: --serve는 --output, 체크포인트/재개/시간 예산, 샤드 옵션과 함께 사용할 수 없다." << std::endl;
+        return 1;
+    }
+    if (command_line.bvh_stats && !command_line.serve_path.empty()) {
+        std::cerr << "오류: --bvh-stats는 끝나지 않는 --serve와 함께 사용할 수 없다." << std::endl;
+        return 1;
+    }
+    if (!command_line.batch_path.empty() &&
+        (!command_line.serve_path.empty() || use_progressive || !command_line.tile_range.empty() ||
+         !command_line.shard.empty() || output_path != "-")) {
+        std::cerr << "오류: --batch는 --serve, --output, 체크포인트/재개/시간 예산, 샤드 옵션과 함께 사용할 수 없다." << std::endl;
+        return 1;
+    }
+    if (command_line.has_frames) {
+        if (command_line.animation.frame_count < 1) {
+            std::cerr << "오류: --frames 값은 1 이상 정수여야 한다." << std::endl;
+            return 1;
+        }
+        if (!(command_line.animation.rebuild_threshold >= 1.0)) {
+            std::cerr << "오류: --rebuild-threshold 값은 1 이상이어야 한다." << std::endl;
+            return 1;
+        }
+        if (!command_line.serve_path.empty() || !command_line.batch_path.empty() || use_progressive ||
+            !command_line.tile_range.empty() || !command_line.shard.empty()) {
+            std::cerr << "오류: --frames는 --serve, --batch, 체크포인트/재개/시간 예산, 샤드 옵션과 함께 사용할 수 없다."
+                      << std::endl;
+            return 1;
+        }
+        if (output_path.find('#') == std::string::npos) {
+            std::cerr << "오류: --frames에는 프레임 번호 자리 '#'가 든 --output 경로 패턴이 필요하다." << std::endl;
+            return 1;
+        }
+    }
+    if (command_line.format == raytracer::PpmFormat::kBinary &&
+        (!command_line.tile_range.empty() || !command_line.shard.empty())) {
+        std::cerr << "오류: 샤드 출력은 텍스트 형식만 지원하므로 --format p6과 함께 사용할 수 없다." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+// 배치, 애니메이션, 단일 이미지(일반/점진/샤드) 렌더 중 하나를 실행한다. has_range면 range 구간만 샤드로 렌더링한다.
+int RunRender(const CommandLine& command_line, bool has_range, const raytracer::TileRange& range) {
+    if (!command_line.batch_path.empty()) {
+        return RunBatch(command_line);
+    }
+    if (command_line.has_frames) {
+        return RunFrames(command_line);
+    }
+
+    const raytracer::RenderOptions& options = command_line.options;
+    const raytracer::ProgressiveOptions& progressive = command_line.progressive;
+    const std::string& output_path = command_line.output_path;
+    const bool use_budget = progressive.time_budget.count() > 0;
+    const bool use_progressive = !progressive.checkpoint_path.empty() || !progressive.resume_path.empty() || use_budget;
+
+    // 행을 렌더 도중 바로 흘려보내므로 렌더 전에 출력 대상을 연다.
+    std::ofstream file;
+    std::ostream* output = &std::cout;
+    if (output_path != "-") {
+        file.open(output_path, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "오류: 파일을 열 수 없다." << std::endl;
+            return 2;
+        }
+        output = &file;
+    }
+
+    try {
+        if (has_range) {
+            const std::string shard = raytracer::RenderMaterialShard(options, range);
+            output->write(shard.data(), static_cast<std::streamsize>(shard.size()));
+            output->flush();
+            if (!*output) {
+                throw std::runtime_error("파일 기록에 실패했다.");
+            }
+        } else {
+            raytracer::PpmStreamWriter writer(*output, command_line.format);
+            if (use_progressive) {
+                const int completed_passes = raytracer::RenderProgressiveImage(options, progressive, writer);
+                if (use_budget) {
+                    std::cerr << "완료 패스 수: " << completed_passes << std::endl;
+                }
+            } else {
+                raytracer::RenderMaterialImage(options, writer);
+            }
+        }
+    } catch (const std::runtime_error& error) {
+        std::cerr << "오류: " << error.what() << std::endl;
+        return 2;
+    }
+
     return 0;
 }
 
 }  // namespace
 
 int main(int argc, char* argv[]) {
-    raytracer::RenderOptions options;
-    std::string output_path;
-
-    const int parse_result = ParseOptions(argc, argv, options, output_path);
+    CommandLine command_line;
+    const int parse_result = ParseOptions(argc, argv, command_line);
     if (parse_result != 0) {
         return parse_result;
     }
 
-    const std::string image = raytracer::RenderMaterialImage(options);
-
-    if (output_path == "-") {
-        std::cout << image;
-        return 0;
+    if (!command_line.serve_path.empty()) {
+        return RunServer(command_line);
     }
 
-    std::ofstream file(output_path, std::ios::out | std::ios::trunc);
-    if (!file.is_open()) {
-        std::cerr << "오류: 파일을 열 수 없다." << std::endl;
-        return 2;
+    bool has_range = false;
+    raytracer::TileRange range;
+    const int range_result = ResolveTileRange(command_line, has_range, range);
+    if (range_result != 0) {
+        return range_result;
     }
 
-    file << image;
-    if (!file) {
-        std::cerr << "오류: 파일 기록에 실패했다." << std::endl;
-        return 2;
+    if (command_line.bvh_stats) {
+        PrintSceneBvhStats(command_line.options);
+        raytracer::ResetBvhCounters();
     }
-
-    return 0;
+    const int result = RunRender(command_line, has_range, range);
+    if (command_line.bvh_stats) {
+        PrintBvhCounters();
+    }
+    return result;
 }
@@ -0,0 +1,193 @@
+/*
+ * 설명: 셔터 중간 시각 경계로 빌드한 BvhNode 트리를 셔터 시작/끝 상자 쌍을 가진 64바이트 노드 배열로 평탄화하고,
+ *       레이 시각으로 두 상자를 보간한 상자로 명시적 스택 순회를 한다. 가림 판정은 처음 찾은 교차에서 멈춘다.
+ * 버전: v1.25.0
+ * 관련 문서: design/renderer/v1.25.0-motion-bvh.md
+ * 테스트: tests/unit/bvh_test.cpp
+ */
+#include "raytracer/motion_bvh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "raytracer/hittable_list.hpp"
+
+#include "bvh_float_util.hpp"
+#include "linear_bvh_traversal.hpp"
+
+namespace raytracer {
+namespace {
+
+using detail::PadDown;
+using detail::PadUp;
+using detail::SeparatingAxis;
+
+// 셔터 시작/끝 상자를 ratio로 보간한 상자에 대해 Aabb::Hit과 같은 슬래브 판정을 한다.
+bool NodeHit(const MotionBvhNode& node, double ratio, const Point3& origin, const Vec3& inv_dir, double t_min,
+             double t_max) {
+    for (int axis = 0; axis < 3; ++axis) {
+        const double low = static_cast<double>(node.min_open[axis]) +
+                           ratio * (static_cast<double>(node.min_close[axis]) - static_cast<double>(node.min_open[axis]));
+        const double high = static_cast<double>(node.max_open[axis]) +
+                            ratio * (static_cast<double>(node.max_close[axis]) - static_cast<double>(node.max_open[axis]));
+        double t0 = (low - origin[axis]) * inv_dir[axis];
+        double t1 = (high - origin[axis]) * inv_dir[axis];
+        if (inv_dir[axis] < 0.0) {
+            std::swap(t0, t1);
+        }
+
+        t_min = t0 > t_min ? t0 : t_min;
+        t_max = t1 < t_max ? t1 : t_max;
+        if (t_max <= t_min) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+MotionBvh::MotionBvh(std::vector<std::shared_ptr<Hittable>> objects, double shutter_open, double shutter_close,
+                     const BvhBuildOptions& options)
+    : shutter_open_(shutter_open), shutter_close_(shutter_close) {
+    if (options.split == BvhSplitMethod::kSpatialSah) {
+        throw std::invalid_argument("모션 BVH는 공간 분할(kSpatialSah)로 빌드할 수 없다.");
+    }
+    // 빠르게 움직이는 객체도 한 시각에서는 작으므로, 셔터 중간의 위치로 묶어야 형제 상자가 덜 겹친다.
+    const double middle = 0.5 * (shutter_open + shutter_close);
+    const BvhNode tree(std::move(objects), middle, middle, options);
+    tree.BuildAll();
+    std::uint32_t root = 0;
+    FlattenNode(tree, 1, root);
+}
+
+std::uint32_t MotionBvh::AppendNode(std::uint8_t axis) {
+    if (nodes_.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("모션 BVH 노드 수가 32비트 인덱스 범위를 넘었다.");
+    }
+    MotionBvhNode node{};
+    node.axis = axis;
+    nodes_.push_back(node);
+    return static_cast<std::uint32_t>(nodes_.size() - 1);
+}
+
+void MotionBvh::SetBounds(std::uint32_t index, const MotionBox& box) {
+    MotionBvhNode& node = nodes_[index];
+    for (int i = 0; i < 3; ++i) {
+        node.min_open[i] = PadDown(box.open.minimum()[i]);
+        node.max_open[i] = PadUp(box.open.maximum()[i]);
+        node.min_close[i] = PadDown(box.close.minimum()[i]);
+        node.max_close[i] = PadUp(box.close.maximum()[i]);
+    }
+}
+
+MotionBvh::MotionBox MotionBvh::FlattenNode(const BvhNode& node, int depth, std::uint32_t& index) {
+    depth_ = std::max(depth_, depth);
+    if (node.left_ == node.right_) {
+        return FlattenChild(node.left_, node.left_kind_, depth, index);
+    }
+
+    // 가까운 자식을 고르는 축은 트리를 빌드한 셔터 중간 시각의 상자로 정한다.
+    Aabb left_box;
+    Aabb right_box;
+    const double middle = 0.5 * (shutter_open_ + shutter_close_);
+    if (!node.left_->BoundingBox(middle, middle, left_box) || !node.right_->BoundingBox(middle, middle, right_box)) {
+        throw std::runtime_error("모션 BVH 평탄화 중 경계 상자를 계산할 수 없다.");
+    }
+    const int axis = SeparatingAxis(left_box, right_box);
+    index = AppendNode(static_cast<std::uint8_t>(axis));
+
+    // 축 위에서 중심이 작은 자식을 바로 다음 인덱스에 둔다.
+    const bool left_lower = left_box.minimum()[axis] + left_box.maximum()[axis] <=
+                            right_box.minimum()[axis] + right_box.maximum()[axis];
+    std::uint32_t near_index = 0;
+    std::uint32_t far_index = 0;
+    const MotionBox near = left_lower ? FlattenChild(node.left_, node.left_kind_, depth + 1, near_index)
+                                      : FlattenChild(node.right_, node.right_kind_, depth + 1, near_index);
+    const MotionBox far = left_lower ? FlattenChild(node.right_, node.right_kind_, depth + 1, far_index)
+                                     : FlattenChild(node.left_, node.left_kind_, depth + 1, far_index);
+    nodes_[index].offset = far_index;
+
+    // 두 끝 상자가 각각 자식의 끝 상자를 감싸면, 보간한 상자도 같은 시각의 자식 보간 상자를 감싼다.
+    const MotionBox box{SurroundingBox(near.open, far.open), SurroundingBox(near.close, far.close)};
+    SetBounds(index, box);
+    return box;
+}
+
+MotionBvh::MotionBox MotionBvh::FlattenChild(const std::shared_ptr<Hittable>& child, BvhNode::ChildKind kind, int depth,
+                                             std::uint32_t& index) {
+    if (kind == BvhNode::ChildKind::kNode) {
+        return FlattenNode(static_cast<const BvhNode&>(*child), depth, index);
+    }
+
+    depth_ = std::max(depth_, depth);
+    index = AppendNode(0);
+    const std::size_t first = primitives_.size();
+    if (kind == BvhNode::ChildKind::kLeafList) {
+        const auto& objects = static_cast<const HittableList&>(*child).Objects();
+        primitives_.insert(primitives_.end(), objects.begin(), objects.end());
+    } else {
+        primitives_.push_back(child);
+    }
+
+    const std::size_t count = primitives_.size() - first;
+    if (count > std::numeric_limits<std::uint16_t>::max() || first > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("모션 BVH 잎 객체 수 또는 객체 인덱스가 범위를 넘었다.");
+    }
+    nodes_[index].offset = static_cast<std::uint32_t>(first);
+    nodes_[index].primitive_count = static_cast<std::uint16_t>(count);
+
+    MotionBox box = PrimitiveBounds(*primitives_[first]);
+    for (std::size_t i = first + 1; i < primitives_.size(); ++i) {
+        const MotionBox object_box = PrimitiveBounds(*primitives_[i]);
+        box.open = SurroundingBox(box.open, object_box.open);
+        box.close = SurroundingBox(box.close, object_box.close);
+    }
+    SetBounds(index, box);
+    return box;
+}
+
+MotionBvh::MotionBox MotionBvh::PrimitiveBounds(const Hittable& object) const {
+    MotionBox box;
+    if (!object.MotionBounds(shutter_open_, shutter_close_, box.open, box.close)) {
+        throw std::runtime_error("모션 BVH 평탄화 중 경계 상자를 계산할 수 없다.");
+    }
+    return box;
+}
+
+double MotionBvh::ShutterRatio(double time) const {
+    const double span = shutter_close_ - shutter_open_;
+    return span == 0.0 ? 0.0 : (time - shutter_open_) / span;
+}
+
+template <bool AnyHit>
+bool MotionBvh::Traverse(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const {
+    const double ratio = ShutterRatio(r.time());
+    const auto node_hit = [ratio](const MotionBvhNode& node, const Point3& origin, const Vec3& inv_dir, double low,
+                                  double high) { return NodeHit(node, ratio, origin, inv_dir, low, high); };
+    return detail::TraverseLinearNodes<AnyHit>(nodes_, primitives_, depth_, r, t_min, t_max, record, generator,
+                                               node_hit);
+}
+
+bool MotionBvh::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const {
+    return Traverse<false>(r, t_min, t_max, record, generator);
+}
+
+bool MotionBvh::Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const {
+    HitRecord unused;
+    return Traverse<true>(r, t_min, t_max, unused, generator);
+}
+
+// 셔터 구간 전체에서 루트의 두 끝 상자를 합친 상자다.
+bool MotionBvh::BoundingBox(double /*time0*/, double /*time1*/, Aabb& output_box) const {
+    const MotionBvhNode& root = nodes_.front();
+    output_box = SurroundingBox(Aabb(Point3(root.min_open[0], root.min_open[1], root.min_open[2]),
+                                     Point3(root.max_open[0], root.max_open[1], root.max_open[2])),
+                                Aabb(Point3(root.min_close[0], root.min_close[1], root.min_close[2]),
+                                     Point3(root.max_close[0], root.max_close[1], root.max_close[2])));
+    return true;
+}
+
+}  // namespace raytracer
@@ -1,172 +1,260 @@
 /*
- * 설명: Cornell smoke 볼륨 장면을 BVH로 가속하고 광원 PDF를 혼합해 PPM(P3) 규격으로 렌더링한다.
- * 버전: v1.0.0
- * 관련 문서: design/protocol/contract.md, design/renderer/v1.0.0-overview.md
+ * 설명: Cornell smoke 볼륨 장면을 BVH로 가속하고 광원 PDF를 혼합해 타일 단위 멀티스레드, 점진 패스, 타일 구간 샤드로 렌더링한다.
+ * 버전: v1.9.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.2.0-progressive.md, design/renderer/v1.3.0-shards.md,
+ *           design/renderer/v1.4.0-streaming-output.md, design/renderer/v1.5.0-render-server.md,
+ *           design/renderer/v1.7.0-time-budget.md, design/renderer/v1.9.0-animation.md
  * 테스트: tests/integration/ppm_integration_test.cpp
  */
 #include "raytracer/ppm.hpp"
 
 #include <algorithm>
-#include <cmath>
-#include <limits>
-#include <memory>
-#include <random>
+#include <atomic>
+#include <chrono>
 #include <sstream>
-
-#include "raytracer/bvh.hpp"
-#include "raytracer/camera.hpp"
-#include "raytracer/constant_medium.hpp"
-#include "raytracer/hittable_list.hpp"
-#include "raytracer/material.hpp"
-#include "raytracer/pdf.hpp"
-#include "raytracer/quad.hpp"
-#include "raytracer/random.hpp"
-#include "raytracer/ray.hpp"
-#include "raytracer/transform.hpp"
+#include <stdexcept>
+#include <vector>
+
+#include "raytracer/checkpoint.hpp"
+#include "raytracer/color.hpp"
+#include "raytracer/framebuffer.hpp"
+#include "raytracer/image_sink.hpp"
+#include "raytracer/render_kernel.hpp"
+#include "raytracer/scene.hpp"
+#include "raytracer/shard.hpp"
+#include "raytracer/strip_stream.hpp"
+#include "raytracer/thread_pool.hpp"
+#include "raytracer/tile.hpp"
 #include "raytracer/vec3.hpp"
 
 namespace raytracer {
 namespace {
 
-int ClampColor(int value) { return std::clamp(value, 0, 255); }
+// 샤드 헤더에 기록하는 장면 이름. 렌더 장면이 바뀌면 다른 이름을 써서 옛 샤드와 섞이지 않게 한다.
+constexpr const char* kShardSceneName = "cornell-smoke";
 
-int ToChannel(double value) {
-    const double clamped = std::clamp(value, 0.0, 0.999);
-    return ClampColor(static_cast<int>(std::lround(255.0 * clamped)));
+// 패스 하나는 타일 안 모든 픽셀에 샘플 인덱스 pass 하나를 더한다. 누적 순서가 타일 렌더와 같아 합이 비트 단위로 일치한다.
+void AccumulateTilePass(const RenderContext& context, const Tile& tile, int pass, Framebuffer& accumulation) {
+    for (int y = tile.y0; y < tile.y1; ++y) {
+        for (int x = tile.x0; x < tile.x1; ++x) {
+            accumulation.At(x, y) += RenderSample(context, x, y, pass);
+        }
+    }
 }
 
-Color RayColor(const Ray& r, int depth, const Hittable& world, const std::shared_ptr<Hittable>& lights,
-               std::mt19937& generator) {
-    if (depth <= 0) {
-        return Color(0.0, 0.0, 0.0);
+// 시간 예산 모드에서는 패스를 별도 버퍼에 먼저 기록해, 마감으로 중단된 패스를 누적 버퍼에 섞지 않고 버린다.
+void RenderTilePass(const RenderContext& context, const Tile& tile, int pass, Framebuffer& pass_buffer) {
+    for (int y = tile.y0; y < tile.y1; ++y) {
+        for (int x = tile.x0; x < tile.x1; ++x) {
+            pass_buffer.At(x, y) = RenderSample(context, x, y, pass);
+        }
     }
+}
 
-    HitRecord record;
-    if (!world.Hit(r, 0.001, std::numeric_limits<double>::infinity(), record, generator)) {
-        return Color(0.0, 0.0, 0.0);
+void CommitPass(const Framebuffer& pass_buffer, Framebuffer& accumulation) {
+    for (int y = 0; y < accumulation.height(); ++y) {
+        for (int x = 0; x < accumulation.width(); ++x) {
+            accumulation.At(x, y) += pass_buffer.At(x, y);
+        }
     }
+}
 
-    const Color emitted = (record.material && record.front_face) ? record.material->Emitted(record.u, record.v, record.p)
-                                                                  : Color(0.0, 0.0, 0.0);
-
-    if (!record.material) {
-        return emitted;
+void EmitFramebuffer(const Framebuffer& sums, int samples, ImageSink& sink) {
+    sink.Begin(sums.width(), sums.height());
+    std::vector<Rgb8> row(static_cast<std::size_t>(sums.width()));
+    for (int y = 0; y < sums.height(); ++y) {
+        for (int x = 0; x < sums.width(); ++x) {
+            row[static_cast<std::size_t>(x)] = QuantizeColor(sums.At(x, y) / static_cast<double>(samples));
+        }
+        sink.WriteRow(y, row);
     }
+    sink.End();
+}
 
-    ScatterRecord scatter_record;
-    if (!record.material->Scatter(r, record, scatter_record, generator)) {
-        return emitted;
+Checkpoint ResumeCheckpoint(const RenderOptions& options, const std::string& path) {
+    Checkpoint checkpoint = LoadCheckpoint(path);
+    if (checkpoint.width != options.width || checkpoint.height != options.height || checkpoint.seed != options.seed ||
+        checkpoint.max_depth != options.max_depth || checkpoint.vertical_fov_degrees != options.vertical_fov_degrees ||
+        checkpoint.aperture != options.aperture || checkpoint.shutter_open_time != options.shutter_open_time ||
+        checkpoint.shutter_close_time != options.shutter_close_time) {
+        throw std::runtime_error("체크포인트의 해상도/시드/최대 깊이/카메라 설정이 현재 옵션과 다르다.");
     }
-
-    if (scatter_record.is_specular) {
-        return emitted + scatter_record.attenuation * RayColor(scatter_record.specular_ray, depth - 1, world, lights, generator);
+    if (checkpoint.completed_passes > options.samples_per_pixel) {
+        throw std::runtime_error("체크포인트의 완료 패스 수가 --spp 값보다 크다.");
     }
+    return checkpoint;
+}
 
-    if (!scatter_record.pdf) {
-        return emitted;
-    }
+}  // namespace
 
-    std::shared_ptr<Pdf> light_pdf = lights ? std::make_shared<HittablePdf>(lights, record.p) : nullptr;
-    std::shared_ptr<Pdf> mixed_pdf = light_pdf ? std::make_shared<MixturePdf>(light_pdf, scatter_record.pdf) : scatter_record.pdf;
+// 영역의 타일을 모두 스레드 풀에 넘기고, 타일 한 줄 높이의 띠(strip)가 위에서부터 끝나는 대로 행을 싱크로 내보낸다.
+// 프레임 전체 대신 아직 내보내지 않은 띠 몇 개의 샘플 합만 보관한다(RenderStripsInOrder).
+void RenderMaterialRegion(const RenderOptions& options, const Scene& scene, ThreadPool& pool, const Tile& region,
+                          ImageSink& sink) {
+    RenderMaterialRegion(options, scene, MakeCamera(options), pool, region, sink);
+}
 
-    const Vec3 direction = mixed_pdf->Generate(generator);
-    const Ray scattered(record.p, direction, r.time());
-    const double pdf_value = mixed_pdf->Value(scattered.direction());
-    if (pdf_value <= 0.0) {
-        return emitted;
+void RenderMaterialRegion(const RenderOptions& options, const Scene& scene, const Camera& camera, ThreadPool& pool,
+                          const Tile& region, ImageSink& sink) {
+    if (region.x0 < 0 || region.y0 < 0 || region.x1 > options.width || region.y1 > options.height ||
+        region.Width() < 1 || region.Height() < 1) {
+        throw std::invalid_argument("렌더 영역이 이미지 범위를 벗어났다.");
     }
 
-    const double scattering_pdf = record.material->ScatteringPdf(r, record, scattered);
-    const Color recursive = RayColor(scattered, depth - 1, world, lights, generator);
-    return emitted + scatter_record.attenuation * scattering_pdf * recursive / pdf_value;
+    const RenderContext context{options, camera, scene.WorldView(), scene.lights_view};
+    const double samples = static_cast<double>(options.samples_per_pixel);
+    std::vector<Rgb8> row(static_cast<std::size_t>(region.Width()));
+
+    sink.Begin(region.Width(), region.Height());
+    RenderStripsInOrder(
+        pool, region, options.tile_size, [&](const Tile& tile) { return RenderTileSums(context, tile); },
+        [&](const StripResult& result) {
+            for (int y = result.strip.y0; y < result.strip.y1; ++y) {
+                for (std::size_t column = 0; column < result.tiles.size(); ++column) {
+                    const Tile& tile = result.tiles[column];
+                    const Color* sums = &result.sums[column][static_cast<std::size_t>(y - tile.y0) *
+                                                            static_cast<std::size_t>(tile.Width())];
+                    for (int x = tile.x0; x < tile.x1; ++x) {
+                        row[static_cast<std::size_t>(x - region.x0)] = QuantizeColor(sums[x - tile.x0] / samples);
+                    }
+                }
+                sink.WriteRow(y - region.y0, row);
+            }
+        });
+    sink.End();
 }
 
-void WriteColor(std::ostringstream& output, const Color& pixel_color) {
-    const Color gamma_corrected(std::sqrt(pixel_color.x()), std::sqrt(pixel_color.y()), std::sqrt(pixel_color.z()));
-    const int ir = ToChannel(gamma_corrected.x());
-    const int ig = ToChannel(gamma_corrected.y());
-    const int ib = ToChannel(gamma_corrected.z());
-    output << ir << ' ' << ig << ' ' << ib << "\n";
+void RenderMaterialImage(const RenderOptions& options, ImageSink& sink) {
+    const Scene scene = BuildCornellSmokeScene(options.shutter_open_time, options.shutter_close_time);
+    ThreadPool pool(options.thread_count);
+    RenderMaterialRegion(options, scene, pool, Tile{0, 0, options.width, options.height}, sink);
 }
 
-HittableList BuildCornellSmoke(HittableList& lights) {
-    HittableList world;
-
-    const auto red = std::make_shared<Lambertian>(Color(0.65, 0.05, 0.05));
-    const auto white = std::make_shared<Lambertian>(Color(0.73, 0.73, 0.73));
-    const auto green = std::make_shared<Lambertian>(Color(0.12, 0.45, 0.15));
-    const auto light = std::make_shared<DiffuseLight>(Color(15.0, 15.0, 15.0));
-
-    world.Add(std::make_shared<Quad>(Point3(555.0, 0.0, 0.0), Vec3(0.0, 0.0, 555.0), Vec3(0.0, 555.0, 0.0), green));
-    world.Add(std::make_shared<Quad>(Point3(0.0, 0.0, 0.0), Vec3(0.0, 555.0, 0.0), Vec3(0.0, 0.0, 555.0), red));
-    const auto ceiling_light = std::make_shared<Quad>(Point3(213.0, 554.0, 227.0), Vec3(130.0, 0.0, 0.0), Vec3(0.0, 0.0, 105.0), light);
-    world.Add(ceiling_light);
-    lights.Add(ceiling_light);
-    world.Add(std::make_shared<Quad>(Point3(0.0, 555.0, 0.0), Vec3(555.0, 0.0, 0.0), Vec3(0.0, 0.0, 555.0), white));
-    world.Add(std::make_shared<Quad>(Point3(0.0, 0.0, 0.0), Vec3(555.0, 0.0, 0.0), Vec3(0.0, 0.0, 555.0), white));
-    world.Add(std::make_shared<Quad>(Point3(0.0, 0.0, 555.0), Vec3(555.0, 0.0, 0.0), Vec3(0.0, 555.0, 0.0), white));
-
-    std::shared_ptr<Hittable> short_box = std::make_shared<Box>(Point3(0.0, 0.0, 0.0), Point3(165.0, 165.0, 165.0), white);
-    short_box = std::make_shared<RotateY>(short_box, -18.0);
-    short_box = std::make_shared<Translate>(short_box, Vec3(130.0, 0.0, 65.0));
-    world.Add(std::make_shared<ConstantMedium>(short_box, 0.01, Color(0.0, 0.0, 0.0)));
-
-    std::shared_ptr<Hittable> tall_box = std::make_shared<Box>(Point3(0.0, 0.0, 0.0), Point3(165.0, 330.0, 165.0), white);
-    tall_box = std::make_shared<RotateY>(tall_box, 15.0);
-    tall_box = std::make_shared<Translate>(tall_box, Vec3(265.0, 0.0, 295.0));
-    world.Add(std::make_shared<ConstantMedium>(tall_box, 0.01, Color(1.0, 1.0, 1.0)));
-
-    return world;
+std::string RenderMaterialImage(const RenderOptions& options) {
+    std::ostringstream output;
+    PpmStreamWriter writer(output, PpmFormat::kAscii);
+    RenderMaterialImage(options, writer);
+    return output.str();
 }
 
-}  // namespace
-
-std::string RenderMaterialImage(const RenderOptions& options) {
-    const double aspect_ratio = static_cast<double>(options.width) / static_cast<double>(options.height);
-    const Point3 look_from(278.0, 278.0, -800.0);
-    const Point3 look_at(278.0, 278.0, 0.0);
-    const Vec3 vup(0.0, 1.0, 0.0);
-    const double focus_dist = (look_from - look_at).length();
-    const Camera camera(look_from, look_at, vup, options.vertical_fov_degrees, aspect_ratio, options.aperture, focus_dist,
-                       options.shutter_open_time, options.shutter_close_time);
-
-    HittableList lights;
-    HittableList world = BuildCornellSmoke(lights);
-    const std::shared_ptr<BvhNode> bvh_tree =
-        world.Objects().empty() ? nullptr : std::make_shared<BvhNode>(world, options.shutter_open_time, options.shutter_close_time);
-    const Hittable& world_view = bvh_tree ? static_cast<const Hittable&>(*bvh_tree) : static_cast<const Hittable&>(world);
-    const std::shared_ptr<Hittable> lights_view = lights.Objects().empty() ? nullptr : std::make_shared<HittableList>(lights);
-
-    std::mt19937 generator(options.seed);
+int RenderProgressiveImage(const RenderOptions& options, const ProgressiveOptions& progressive, ImageSink& sink) {
+    Checkpoint checkpoint;
+    if (progressive.resume_path.empty()) {
+        checkpoint.width = options.width;
+        checkpoint.height = options.height;
+        checkpoint.seed = options.seed;
+        checkpoint.max_depth = options.max_depth;
+        checkpoint.vertical_fov_degrees = options.vertical_fov_degrees;
+        checkpoint.aperture = options.aperture;
+        checkpoint.shutter_open_time = options.shutter_open_time;
+        checkpoint.shutter_close_time = options.shutter_close_time;
+        checkpoint.accumulation = Framebuffer(options.width, options.height);
+    } else {
+        checkpoint = ResumeCheckpoint(options, progressive.resume_path);
+    }
 
-    std::ostringstream output;
-    output << "P3\n";
-    output << options.width << ' ' << options.height << "\n";
-    output << "255\n";
-
-    for (int y = 0; y < options.height; ++y) {
-        for (int x = 0; x < options.width; ++x) {
-            Color pixel_color(0.0, 0.0, 0.0);
-            for (int sample = 0; sample < options.samples_per_pixel; ++sample) {
-                const double u = (options.width == 1)
-                                     ? 0.5
-                                     : (static_cast<double>(x) + RandomDouble(generator)) /
-                                           (static_cast<double>(options.width) - 1.0);
-                const double v = (options.height == 1)
-                                     ? 0.5
-                                     : (static_cast<double>(options.height - 1 - y) + RandomDouble(generator)) /
-                                           (static_cast<double>(options.height) - 1.0);
-
-                const Ray r = camera.GetRay(u, v, generator);
-                pixel_color += RayColor(r, options.max_depth, world_view, lights_view, generator);
+    const std::string& checkpoint_path =
+        progressive.checkpoint_path.empty() ? progressive.resume_path : progressive.checkpoint_path;
+
+    const Scene scene = BuildCornellSmokeScene(options.shutter_open_time, options.shutter_close_time);
+    const Camera camera = MakeCamera(options);
+    const RenderContext context{options, camera, scene.WorldView(), scene.lights_view};
+    const std::vector<Tile> tiles = BuildHilbertTiles(options.width, options.height, options.tile_size);
+
+    using Clock = std::chrono::steady_clock;
+    const bool budgeted = progressive.time_budget.count() > 0;
+    const Clock::time_point deadline = Clock::now() + progressive.time_budget;
+    Framebuffer pass_buffer = budgeted ? Framebuffer(options.width, options.height) : Framebuffer();
+    int saved_passes = checkpoint.completed_passes;
+
+    ThreadPool pool(options.thread_count);
+    while (checkpoint.completed_passes < options.samples_per_pixel) {
+        const int pass = checkpoint.completed_passes;
+        if (budgeted) {
+            // 첫 패스는 끝까지 렌더링해 항상 1패스 이상을 보장한다. 마감 확인은 타일 시작 때만 해 비용을 무시할 만하게 둔다.
+            const bool interruptible = pass > 0;
+            if (interruptible && Clock::now() >= deadline) {
+                break;
+            }
+            std::atomic<bool> expired{false};
+            pool.ParallelFor(tiles.size(), [&](std::size_t index) {
+                if (interruptible && (expired.load(std::memory_order_relaxed) || Clock::now() >= deadline)) {
+                    expired.store(true, std::memory_order_relaxed);
+                    return;
+                }
+                RenderTilePass(context, tiles[index], pass, pass_buffer);
+            });
+            if (expired.load()) {
+                break;
             }
+            CommitPass(pass_buffer, checkpoint.accumulation);
+        } else {
+            pool.ParallelFor(tiles.size(),
+                             [&](std::size_t index) { AccumulateTilePass(context, tiles[index], pass, checkpoint.accumulation); });
+        }
+        ++checkpoint.completed_passes;
 
-            const Color averaged_color = pixel_color / static_cast<double>(options.samples_per_pixel);
-            WriteColor(output, averaged_color);
+        const bool interval_reached =
+            progressive.checkpoint_interval > 0 && checkpoint.completed_passes % progressive.checkpoint_interval == 0;
+        if (!checkpoint_path.empty() && interval_reached) {
+            SaveCheckpoint(checkpoint_path, checkpoint);
+            saved_passes = checkpoint.completed_passes;
         }
     }
+    if (!checkpoint_path.empty() && saved_passes != checkpoint.completed_passes) {
+        SaveCheckpoint(checkpoint_path, checkpoint);
+    }
 
+    EmitFramebuffer(checkpoint.accumulation, checkpoint.completed_passes, sink);
+    return checkpoint.completed_passes;
+}
+
+std::string RenderProgressiveImage(const RenderOptions& options, const ProgressiveOptions& progressive) {
+    std::ostringstream output;
+    PpmStreamWriter writer(output, PpmFormat::kAscii);
+    RenderProgressiveImage(options, progressive, writer);
     return output.str();
 }
 
+std::string RenderMaterialShard(const RenderOptions& options, const TileRange& range) {
+    const int tile_count = TileCount(options.width, options.height, options.tile_size);
+    if (range.begin < 0 || range.begin > range.end || range.end > tile_count) {
+        throw std::invalid_argument("샤드 타일 구간이 전체 타일 범위를 벗어났다.");
+    }
+
+    const Scene scene = BuildCornellSmokeScene(options.shutter_open_time, options.shutter_close_time);
+    const Camera camera = MakeCamera(options);
+    const RenderContext context{options, camera, scene.WorldView(), scene.lights_view};
+
+    std::vector<Tile> tiles;
+    for (int index = range.begin; index < range.end; ++index) {
+        tiles.push_back(TileAt(index, options.width, options.height, options.tile_size));
+    }
+
+    std::vector<std::vector<Color>> tile_sums(tiles.size());
+    ThreadPool pool(options.thread_count);
+    pool.ParallelFor(tiles.size(), [&](std::size_t index) { tile_sums[index] = RenderTileSums(context, tiles[index]); });
+
+    ShardImage shard;
+    shard.width = options.width;
+    shard.height = options.height;
+    shard.tile_size = options.tile_size;
+    shard.settings.seed = options.seed;
+    shard.settings.samples_per_pixel = options.samples_per_pixel;
+    shard.settings.max_depth = options.max_depth;
+    shard.settings.scene = kShardSceneName;
+    shard.settings.vertical_fov_degrees = options.vertical_fov_degrees;
+    shard.settings.aperture = options.aperture;
+    shard.settings.shutter_open_time = options.shutter_open_time;
+    shard.settings.shutter_close_time = options.shutter_close_time;
+    shard.range = range;
+    for (const std::vector<Color>& sums : tile_sums) {
+        for (const Color& sum : sums) {
+            shard.pixels.push_back(QuantizeColor(sum / static_cast<double>(options.samples_per_pixel)));
+        }
+    }
+
+    return EncodeShard(shard);
+}
+
 }  // namespace raytracer
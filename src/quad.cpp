@@ -1,15 +1,16 @@
 /*
- * 설명: Quad와 Box의 레이 교차, 경계 상자, 샘플링 PDF를 계산한다.
- * 버전: v1.0.0
- * 관련 문서: design/renderer/v1.0.0-overview.md
+ * 설명: Quad와 Box의 레이 교차, 경계 상자, 샘플링 PDF를 계산한다. Quad는 영역으로 자른 경계 상자도 계산한다.
+ *       교차 거리·내부 판정을 Hit, 가림 판정, PDF가 공유하며 가림 판정과 PDF는 교차 기록을 만들지 않는다.
+ * 버전: v1.20.0
+ * 관련 문서: design/renderer/v1.0.0-overview.md, design/renderer/v1.15.0-sbvh.md, design/renderer/v1.20.0-occlusion.md
  * 테스트: tests/unit/quad_test.cpp, tests/unit/pdf_test.cpp
  */
 #include "raytracer/quad.hpp"
 
 #include <algorithm>
 #include <cmath>
-#include <random>
 #include <limits>
+#include <vector>
 
 #include "raytracer/random.hpp"
 
@@ -21,6 +22,30 @@ constexpr double kPadding = 1e-4;
 
 double LengthSquared(const Vec3& v) { return v.length_squared(); }
 
+// 다각형에서 axis 좌표가 bound보다 작은(keep_below) 또는 큰 쪽만 남긴다(Sutherland-Hodgman).
+std::vector<Point3> ClipPolygon(const std::vector<Point3>& polygon, int axis, double bound, bool keep_below) {
+    std::vector<Point3> clipped;
+    const auto inside = [axis, bound, keep_below](const Point3& p) {
+        return keep_below ? p[axis] <= bound : p[axis] >= bound;
+    };
+    for (std::size_t i = 0; i < polygon.size(); ++i) {
+        const Point3& current = polygon[i];
+        const Point3& next = polygon[(i + 1) % polygon.size()];
+        if (inside(current)) {
+            clipped.push_back(current);
+        }
+        if (inside(current) != inside(next)) {
+            const double s = (bound - current[axis]) / (next[axis] - current[axis]);
+            const Point3 crossing = current + s * (next - current);
+            // 교차점은 평면 위에 있어야 하므로 반올림 오차가 남지 않게 그 축 좌표를 bound로 고정한다.
+            double coordinates[3] = {crossing.x(), crossing.y(), crossing.z()};
+            coordinates[axis] = bound;
+            clipped.emplace_back(coordinates[0], coordinates[1], coordinates[2]);
+        }
+    }
+    return clipped;
+}
+
 }  // namespace
 
 Quad::Quad(const Point3& q, const Vec3& u, const Vec3& v, std::shared_ptr<Material> material)
@@ -32,23 +57,31 @@ Quad::Quad(const Point3& q, const Vec3& u, const Vec3& v, std::shared_ptr<Materi
     SetBoundingBox();
 }
 
-bool Quad::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& /*generator*/) const {
+bool Quad::Intersect(const Ray& r, double t_min, double t_max, double& t, Point3& intersection, double& alpha,
+                     double& beta) const {
     const double denominator = Dot(normal_, r.direction());
     if (std::fabs(denominator) < kEpsilon) {
         return false;
     }
 
-    const double t = (d_ - Dot(normal_, r.origin())) / denominator;
+    t = (d_ - Dot(normal_, r.origin())) / denominator;
     if (t < t_min || t > t_max) {
         return false;
     }
 
-    const Point3 intersection = r.At(t);
+    intersection = r.At(t);
     const Vec3 planar_vector = intersection - q_;
-    const double alpha = Dot(planar_vector, u_);
-    const double beta = Dot(planar_vector, v_);
+    alpha = Dot(planar_vector, u_);
+    beta = Dot(planar_vector, v_);
+    return IsInside(alpha, beta);
+}
 
-    if (!IsInside(alpha, beta)) {
+bool Quad::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& /*generator*/) const {
+    double t = 0.0;
+    Point3 intersection;
+    double alpha = 0.0;
+    double beta = 0.0;
+    if (!Intersect(r, t_min, t_max, t, intersection, alpha, beta)) {
         return false;
     }
 
@@ -62,6 +95,14 @@ bool Quad::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std:
     return true;
 }
 
+bool Quad::Occluded(const Ray& r, double t_min, double t_max, Rng& /*generator*/) const {
+    double t = 0.0;
+    Point3 intersection;
+    double alpha = 0.0;
+    double beta = 0.0;
+    return Intersect(r, t_min, t_max, t, intersection, alpha, beta);
+}
+
 bool Quad::BoundingBox(double /*time0*/, double /*time1*/, Aabb& output_box) const {
     output_box = bbox_;
     return true;
@@ -71,6 +112,40 @@ bool Quad::IsInside(double alpha, double beta) const {
     return (alpha >= 0.0) && (beta >= 0.0) && (alpha <= LengthSquared(u_)) && (beta <= LengthSquared(v_));
 }
 
+// 교차 판정이 u, v 방향 사영으로 범위를 정하므로, u와 v가 직교할 때만 꼭짓점 평행사변형이 교차 영역과 같다.
+// 자른 다각형 상자도 BoundingBox처럼 kPadding만큼 넓힌 뒤 region과 겹쳐, 납작한 축에서도 두께가 남게 한다.
+bool Quad::ClipBox(double /*time0*/, double /*time1*/, const Aabb& region, Aabb& output_box) const {
+    if (std::fabs(Dot(u_, v_)) > kEpsilon * u_.length() * v_.length()) {
+        return false;
+    }
+
+    std::vector<Point3> polygon = {q_, q_ + u_, q_ + u_ + v_, q_ + v_};
+    for (int axis = 0; axis < 3 && !polygon.empty(); ++axis) {
+        polygon = ClipPolygon(polygon, axis, region.minimum()[axis] - kPadding, false);
+        polygon = ClipPolygon(polygon, axis, region.maximum()[axis] + kPadding, true);
+    }
+    if (polygon.empty()) {
+        output_box = Aabb(Point3(1.0, 1.0, 1.0), Point3(0.0, 0.0, 0.0));
+        return true;
+    }
+
+    constexpr double kInf = std::numeric_limits<double>::infinity();
+    double minimum[3] = {kInf, kInf, kInf};
+    double maximum[3] = {-kInf, -kInf, -kInf};
+    for (const Point3& p : polygon) {
+        for (int axis = 0; axis < 3; ++axis) {
+            minimum[axis] = std::min(minimum[axis], p[axis]);
+            maximum[axis] = std::max(maximum[axis], p[axis]);
+        }
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        minimum[axis] = std::max(minimum[axis] - kPadding, region.minimum()[axis]);
+        maximum[axis] = std::min(maximum[axis] + kPadding, region.maximum()[axis]);
+    }
+    output_box = Aabb(Point3(minimum[0], minimum[1], minimum[2]), Point3(maximum[0], maximum[1], maximum[2]));
+    return true;
+}
+
 void Quad::SetBoundingBox() {
     const Point3 p0 = q_;
     const Point3 p1 = q_ + u_;
@@ -87,15 +162,18 @@ void Quad::SetBoundingBox() {
     bbox_ = Aabb(Point3(min_x, min_y, min_z), Point3(max_x, max_y, max_z));
 }
 
+// 거리와 코사인만 쓰므로 교차 기록 대신 교차 거리만 구한다. 코사인은 절댓값이라 법선 방향 뒤집기가 필요 없다.
 double Quad::PdfValue(const Point3& origin, const Vec3& direction) const {
-    HitRecord record;
-    std::mt19937 dummy_generator(0);
-    if (!Hit(Ray(origin, direction), 0.001, std::numeric_limits<double>::infinity(), record, dummy_generator)) {
+    double t = 0.0;
+    Point3 intersection;
+    double alpha = 0.0;
+    double beta = 0.0;
+    if (!Intersect(Ray(origin, direction), 0.001, std::numeric_limits<double>::infinity(), t, intersection, alpha, beta)) {
         return 0.0;
     }
 
-    const double distance_squared = record.t * record.t * direction.length_squared();
-    const double cosine = std::fabs(Dot(direction, record.normal) / direction.length());
+    const double distance_squared = t * t * direction.length_squared();
+    const double cosine = std::fabs(Dot(direction, normal_) / direction.length());
     if (cosine < kEpsilon) {
         return 0.0;
     }
@@ -103,7 +181,7 @@ double Quad::PdfValue(const Point3& origin, const Vec3& direction) const {
     return distance_squared / (cosine * area_);
 }
 
-Vec3 Quad::Random(const Point3& origin, std::mt19937& generator) const {
+Vec3 Quad::Random(const Point3& origin, Rng& generator) const {
     const double r1 = RandomDouble(generator);
     const double r2 = RandomDouble(generator);
     const Point3 random_point = q_ + r1 * u_ + r2 * v_;
@@ -130,10 +208,14 @@ Box::Box(const Point3& min_point, const Point3& max_point, std::shared_ptr<Mater
                                       Vec3(0.0, 0.0, dz), material));
 }
 
-bool Box::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const {
+bool Box::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const {
     return sides_.Hit(r, t_min, t_max, record, generator);
 }
 
+bool Box::Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const {
+    return sides_.Occluded(r, t_min, t_max, generator);
+}
+
 bool Box::BoundingBox(double /*time0*/, double /*time1*/, Aabb& output_box) const {
     output_box = Aabb(min_, max_);
     return true;
@@ -0,0 +1,278 @@
+/*
+ * 설명: BvhNode 트리를 부모 상자 기준 격자 좌표로 양자화한 노드 배열로 평탄화하고, 스택에 부모 상자를 실어
+ *       두 자식 상자를 복원·판정하며 가까운 자식부터 순회한다. 지연 빌드 트리는 남은 노드를 모두 나눈 뒤 평탄화한다.
+ * 버전: v1.24.0
+ * 관련 문서: design/renderer/v1.17.0-quantized-bvh.md, design/renderer/v1.24.0-lazy-bvh.md
+ * 테스트: tests/unit/bvh_test.cpp
+ */
+#include "raytracer/quantized_bvh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "raytracer/hittable_list.hpp"
+
+#include "bvh_float_util.hpp"
+
+namespace raytracer {
+namespace {
+
+using detail::RoundDown;
+using detail::RoundUp;
+
+constexpr int kStackSize = 64;
+constexpr std::uint32_t kMaxLeafPrimitives = 32;
+constexpr std::uint32_t kFirstPrimitiveMask = (1u << 26) - 1;
+constexpr int kLeafCountShift = 26;
+
+Aabb ChildBox(const std::shared_ptr<Hittable>& child, double time0, double time1) {
+    Aabb box;
+    if (!child->BoundingBox(time0, time1, box)) {
+        throw std::runtime_error("BVH 양자화 중 경계 상자를 계산할 수 없다.");
+    }
+    return box;
+}
+
+// 빌드와 순회가 같은 float 연산으로 격자 좌표를 복원해야 보수적 반올림이 순회에서도 성립한다.
+// 빌드가 복원 값을 직접 확인하며 격자 좌표를 고르므로 칸 너비 계산의 반올림 오차는 상관없다.
+// 마지막 격자 좌표는 부모 최댓값을 그대로 돌려, 어떤 자식 최댓값이든 덮을 수 있게 한다.
+template <int Bits>
+struct Grid {
+    static constexpr int kMax = (1 << Bits) - 1;
+
+    static float Step(float lo, float hi) { return (hi - lo) * (1.0f / static_cast<float>(kMax)); }
+
+    static float Dequantize(float lo, float hi, float step, int q) {
+        return q == kMax ? hi : lo + static_cast<float>(q) * step;
+    }
+
+    // value 이하로 복원되는 가장 큰 격자 좌표.
+    static int QuantizeDown(float lo, float hi, double value) {
+        const float step = Step(lo, hi);
+        if (!(step > 0.0f)) {
+            return 0;
+        }
+        int q = std::clamp(static_cast<int>(std::floor((value - lo) / step)), 0, kMax);
+        while (q > 0 && static_cast<double>(Dequantize(lo, hi, step, q)) > value) {
+            --q;
+        }
+        while (q < kMax && static_cast<double>(Dequantize(lo, hi, step, q + 1)) <= value) {
+            ++q;
+        }
+        return q;
+    }
+
+    // value 이상으로 복원되는 가장 작은 격자 좌표.
+    static int QuantizeUp(float lo, float hi, double value) {
+        const float step = Step(lo, hi);
+        if (!(step > 0.0f)) {
+            return kMax;
+        }
+        int q = std::clamp(static_cast<int>(std::ceil((value - lo) / step)), 0, kMax);
+        while (q < kMax && static_cast<double>(Dequantize(lo, hi, step, q)) < value) {
+            ++q;
+        }
+        while (q > 0 && static_cast<double>(Dequantize(lo, hi, step, q - 1)) >= value) {
+            --q;
+        }
+        return q;
+    }
+};
+
+// 내부 노드 자식은 복원한 자기 상자를 함께 실어야 그 아래 격자 좌표를 풀 수 있다.
+struct StackEntry {
+    std::uint32_t child;
+    float lo[3];
+    float hi[3];
+    double tnear;
+};
+
+// 복원한 자식 상자와 레이의 슬래브 판정. 맞으면 진입 거리를 tnear에 쓴다.
+bool BoxHit(const float lo[3], const float hi[3], const Point3& origin, const Vec3& inv_dir, double t_min, double t_max,
+            double& tnear) {
+    for (int axis = 0; axis < 3; ++axis) {
+        double t0 = (static_cast<double>(lo[axis]) - origin[axis]) * inv_dir[axis];
+        double t1 = (static_cast<double>(hi[axis]) - origin[axis]) * inv_dir[axis];
+        if (inv_dir[axis] < 0.0) {
+            std::swap(t0, t1);
+        }
+
+        t_min = t0 > t_min ? t0 : t_min;
+        t_max = t1 < t_max ? t1 : t_max;
+        if (t_max <= t_min) {
+            return false;
+        }
+    }
+    tnear = t_min;
+    return true;
+}
+
+}  // namespace
+
+template <int Bits>
+QuantizedBvh<Bits>::QuantizedBvh(const BvhNode& tree, double time0, double time1) {
+    tree.BuildAll();
+    for (int axis = 0; axis < 3; ++axis) {
+        root_min_[axis] = RoundDown(tree.box_.minimum()[axis]);
+        root_max_[axis] = RoundUp(tree.box_.maximum()[axis]);
+    }
+    FlattenNode(tree, root_min_, root_max_, time0, time1, 1);
+}
+
+template <int Bits>
+QuantizedBvh<Bits>::QuantizedBvh(std::vector<std::shared_ptr<Hittable>> objects, double time0, double time1,
+                                 const BvhBuildOptions& options)
+    : QuantizedBvh(BvhNode(std::move(objects), time0, time1, options), time0, time1) {}
+
+template <int Bits>
+std::uint32_t QuantizedBvh<Bits>::FlattenNode(const BvhNode& node, const float lo[3], const float hi[3], double time0,
+                                              double time1, int depth) {
+    depth_ = std::max(depth_, depth);
+    if (nodes_.size() >= kQuantizedLeaf) {
+        throw std::runtime_error("양자화 BVH 노드 수가 31비트 인덱스 범위를 넘었다.");
+    }
+    const auto index = static_cast<std::uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+
+    const std::shared_ptr<Hittable>* children[2] = {&node.left_, &node.right_};
+    const BvhNode::ChildKind kinds[2] = {node.left_kind_, node.right_kind_};
+    const int child_count = node.left_ == node.right_ ? 1 : 2;
+    if (child_count == 1) {
+        nodes_[index].child[1] = kQuantizedEmpty;
+    }
+
+    for (int slot = 0; slot < child_count; ++slot) {
+        const Aabb box = kinds[slot] == BvhNode::ChildKind::kNode ? static_cast<const BvhNode&>(**children[slot]).box_
+                                                                  : ChildBox(*children[slot], time0, time1);
+        float child_lo[3];
+        float child_hi[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            const float step = Grid<Bits>::Step(lo[axis], hi[axis]);
+            const int q_min = Grid<Bits>::QuantizeDown(lo[axis], hi[axis], box.minimum()[axis]);
+            const int q_max = Grid<Bits>::QuantizeUp(lo[axis], hi[axis], box.maximum()[axis]);
+            nodes_[index].child_min[slot][axis] = static_cast<typename QuantizedBvhNode<Bits>::Quantum>(q_min);
+            nodes_[index].child_max[slot][axis] = static_cast<typename QuantizedBvhNode<Bits>::Quantum>(q_max);
+            child_lo[axis] = Grid<Bits>::Dequantize(lo[axis], hi[axis], step, q_min);
+            child_hi[axis] = Grid<Bits>::Dequantize(lo[axis], hi[axis], step, q_max);
+        }
+        // 재귀 중 nodes_가 재할당될 수 있으므로 인덱스로 다시 쓴다.
+        const std::uint32_t child =
+            FlattenChild(*children[slot], kinds[slot], child_lo, child_hi, time0, time1, depth + 1);
+        nodes_[index].child[slot] = child;
+    }
+    return index;
+}
+
+template <int Bits>
+std::uint32_t QuantizedBvh<Bits>::FlattenChild(const std::shared_ptr<Hittable>& child, BvhNode::ChildKind kind,
+                                               const float lo[3], const float hi[3], double time0, double time1,
+                                               int depth) {
+    if (kind == BvhNode::ChildKind::kNode) {
+        return FlattenNode(static_cast<const BvhNode&>(*child), lo, hi, time0, time1, depth);
+    }
+
+    depth_ = std::max(depth_, depth);
+    const std::size_t first = primitives_.size();
+    if (kind == BvhNode::ChildKind::kLeafList &&
+        static_cast<const HittableList&>(*child).Objects().size() <= kMaxLeafPrimitives) {
+        const auto& objects = static_cast<const HittableList&>(*child).Objects();
+        primitives_.insert(primitives_.end(), objects.begin(), objects.end());
+    } else {
+        primitives_.push_back(child);
+    }
+
+    const std::size_t count = primitives_.size() - first;
+    if (primitives_.size() > kFirstPrimitiveMask + 1) {
+        throw std::runtime_error("양자화 BVH 기본 도형 수가 2^26개를 넘었다.");
+    }
+    return kQuantizedLeaf | (static_cast<std::uint32_t>(count - 1) << kLeafCountShift) |
+           static_cast<std::uint32_t>(first);
+}
+
+template <int Bits>
+bool QuantizedBvh<Bits>::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const {
+    const Point3& origin = r.origin();
+    const Vec3 inv_dir(1.0 / r.direction().x(), 1.0 / r.direction().y(), 1.0 / r.direction().z());
+    double tnear = 0.0;
+    if (!BoxHit(root_min_, root_max_, origin, inv_dir, t_min, t_max, tnear)) {
+        return false;
+    }
+
+    StackEntry local_stack[kStackSize];
+    std::vector<StackEntry> deep_stack;
+    StackEntry* stack = local_stack;
+    if (depth_ > kStackSize) {
+        deep_stack.resize(static_cast<std::size_t>(depth_));
+        stack = deep_stack.data();
+    }
+
+    bool hit_anything = false;
+    double closest = t_max;
+    int stack_size = 0;
+    StackEntry current{
+        0, {root_min_[0], root_min_[1], root_min_[2]}, {root_max_[0], root_max_[1], root_max_[2]}, tnear};
+    while (true) {
+        if ((current.child & kQuantizedLeaf) != 0) {
+            const std::uint32_t first = current.child & kFirstPrimitiveMask;
+            const std::uint32_t count = ((current.child & ~kQuantizedLeaf) >> kLeafCountShift) + 1;
+            for (std::uint32_t i = first; i < first + count; ++i) {
+                if (primitives_[i]->Hit(r, t_min, closest, record, generator)) {
+                    hit_anything = true;
+                    closest = record.t;
+                }
+            }
+        } else {
+            const QuantizedBvhNode<Bits>& node = nodes_[current.child];
+            StackEntry children[2];
+            bool hits[2] = {false, false};
+            const float steps[3] = {Grid<Bits>::Step(current.lo[0], current.hi[0]),
+                                    Grid<Bits>::Step(current.lo[1], current.hi[1]),
+                                    Grid<Bits>::Step(current.lo[2], current.hi[2])};
+            for (int slot = 0; slot < 2; ++slot) {
+                if (node.child[slot] == kQuantizedEmpty) {
+                    continue;
+                }
+                StackEntry& entry = children[slot];
+                entry.child = node.child[slot];
+                for (int axis = 0; axis < 3; ++axis) {
+                    entry.lo[axis] = Grid<Bits>::Dequantize(current.lo[axis], current.hi[axis], steps[axis],
+                                                            node.child_min[slot][axis]);
+                    entry.hi[axis] = Grid<Bits>::Dequantize(current.lo[axis], current.hi[axis], steps[axis],
+                                                            node.child_max[slot][axis]);
+                }
+                hits[slot] = BoxHit(entry.lo, entry.hi, origin, inv_dir, t_min, closest, entry.tnear);
+            }
+
+            if (hits[0] && hits[1]) {
+                const int near = children[1].tnear < children[0].tnear ? 1 : 0;
+                stack[stack_size++] = children[1 - near];
+                current = children[near];
+                continue;
+            }
+            if (hits[0] || hits[1]) {
+                current = children[hits[0] ? 0 : 1];
+                continue;
+            }
+        }
+        // 밀어 둔 먼 자식은 그사이 줄어든 교차 거리보다 멀면 건너뛴다.
+        do {
+            if (stack_size == 0) {
+                return hit_anything;
+            }
+            current = stack[--stack_size];
+        } while (current.tnear >= closest);
+    }
+}
+
+template <int Bits>
+bool QuantizedBvh<Bits>::BoundingBox(double /*time0*/, double /*time1*/, Aabb& output_box) const {
+    output_box = Aabb(Point3(root_min_[0], root_min_[1], root_min_[2]), Point3(root_max_[0], root_max_[1], root_max_[2]));
+    return true;
+}
+
+template class QuantizedBvh<8>;
+template class QuantizedBvh<16>;
+
+}  // namespace raytracer
@@ -0,0 +1,128 @@
+/*
+ * 설명: 렌더 서버 응답(PPM 또는 ERR 한 줄)을 읽어 PPM 헤더의 해상도로 본문 길이를 정하고 그대로 전달한다.
+ * 버전: v1.5.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.5.0-render-server.md
+ * 테스트: tests/integration/render_server_test.cpp
+ */
+#include "raytracer/render_client.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace raytracer {
+
+RenderClient::RenderClient(const std::string& socket_path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("소켓 경로가 비었거나 너무 길다.");
+    }
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd_ < 0 || ::connect(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        throw std::runtime_error("렌더 서버에 연결할 수 없다: " + socket_path);
+    }
+}
+
+RenderClient::~RenderClient() { ::close(fd_); }
+
+bool RenderClient::Fill() {
+    char chunk[64 * 1024];
+    for (;;) {
+        const ssize_t received = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        pending_.append(chunk, static_cast<std::size_t>(received));
+        return true;
+    }
+}
+
+std::string RenderClient::TakeLine() {
+    std::size_t newline = pending_.find('\n');
+    while (newline == std::string::npos) {
+        if (!Fill()) {
+            throw std::runtime_error("렌더 서버 응답이 잘렸다.");
+        }
+        newline = pending_.find('\n');
+    }
+    std::string line = pending_.substr(0, newline);
+    pending_.erase(0, newline + 1);
+    return line;
+}
+
+void RenderClient::Render(const std::string& request_line, std::ostream& output) {
+    const std::string message = request_line + "\n";
+    const char* data = message.data();
+    std::size_t remaining = message.size();
+    while (remaining > 0) {
+        const ssize_t sent = ::send(fd_, data, remaining, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            throw std::runtime_error("렌더 요청을 보낼 수 없다.");
+        }
+        data += sent;
+        remaining -= static_cast<std::size_t>(sent);
+    }
+
+    const std::string magic = TakeLine();
+    if (magic.rfind("ERR ", 0) == 0) {
+        throw std::runtime_error(magic.substr(4));
+    }
+    if (magic != "P3" && magic != "P6") {
+        throw std::runtime_error("렌더 서버 응답 형식이 올바르지 않다.");
+    }
+    const std::string size_line = TakeLine();
+    const std::string max_line = TakeLine();
+    std::istringstream size_stream(size_line);
+    std::int64_t width = 0;
+    std::int64_t height = 0;
+    if (!(size_stream >> width >> height) || width < 1 || height < 1 || max_line != "255") {
+        throw std::runtime_error("렌더 서버 응답 헤더가 올바르지 않다.");
+    }
+    output << magic << "\n" << size_line << "\n" << max_line << "\n";
+
+    // P6 본문은 픽셀당 3바이트, P3 본문은 픽셀당 한 줄이다.
+    const bool binary = magic == "P6";
+    std::int64_t remaining_units = binary ? width * height * 3 : width * height;
+    while (remaining_units > 0) {
+        if (pending_.empty() && !Fill()) {
+            throw std::runtime_error("렌더 서버 응답이 잘렸다.");
+        }
+        std::size_t take = 0;
+        if (binary) {
+            take = static_cast<std::size_t>(std::min<std::int64_t>(remaining_units, static_cast<std::int64_t>(pending_.size())));
+            remaining_units -= static_cast<std::int64_t>(take);
+        } else {
+            while (take < pending_.size() && remaining_units > 0) {
+                if (pending_[take++] == '\n') {
+                    --remaining_units;
+                }
+            }
+        }
+        output.write(pending_.data(), static_cast<std::streamsize>(take));
+        pending_.erase(0, take);
+    }
+    if (!output) {
+        throw std::runtime_error("렌더 결과 기록에 실패했다.");
+    }
+}
+
+}  // namespace raytracer
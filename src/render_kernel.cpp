@@ -0,0 +1,233 @@
+/*
+ * 설명: 광원 PDF와 재질 PDF를 혼합한 rayColor 재귀와 샘플별 시드 파생으로 픽셀 샘플과 타일 샘플 합을 계산한다.
+ *       묶음 크기를 주면 픽셀 블록의 화면 레이를 묶어 첫 교차를 함께 찾고, 웨이브프런트 적분기를 고르면 타일 합을 그쪽에 맡긴다.
+ *       타일 절두체 컬링을 켜면 타일마다 장면을 절두체로 잘라 낸 부분 구조에서 화면 레이의 첫 교차를 찾는다.
+ * 버전: v1.23.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.6.0-render-session.md, design/renderer/v1.21.0-ray-packets.md,
+ *           design/renderer/v1.22.0-wavefront.md, design/renderer/v1.23.0-tile-culling.md
+ * 테스트: tests/integration/ppm_integration_test.cpp
+ */
+#include "raytracer/render_kernel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+#include "raytracer/frustum.hpp"
+#include "raytracer/material.hpp"
+#include "raytracer/pdf.hpp"
+#include "raytracer/random.hpp"
+#include "raytracer/ray.hpp"
+#include "raytracer/wavefront.hpp"
+
+namespace raytracer {
+namespace {
+
+Color RayColor(const Ray& r, int depth, const Hittable& world, const std::shared_ptr<Hittable>& lights,
+               Rng& generator);
+
+// r이 record에서 처음 부딪힌 뒤의 방출·산란 기여. depth는 이 교차를 포함한 남은 깊이다.
+Color ShadeHit(const Ray& r, const HitRecord& record, int depth, const Hittable& world,
+               const std::shared_ptr<Hittable>& lights, Rng& generator) {
+    const Color emitted = (record.material && record.front_face) ? record.material->Emitted(record.u, record.v, record.p)
+                                                                  : Color(0.0, 0.0, 0.0);
+
+    if (!record.material) {
+        return emitted;
+    }
+
+    ScatterRecord scatter_record;
+    if (!record.material->Scatter(r, record, scatter_record, generator)) {
+        return emitted;
+    }
+
+    if (scatter_record.is_specular) {
+        return emitted + scatter_record.attenuation * RayColor(scatter_record.specular_ray, depth - 1, world, lights, generator);
+    }
+
+    if (!scatter_record.pdf) {
+        return emitted;
+    }
+
+    std::shared_ptr<Pdf> light_pdf = lights ? std::make_shared<HittablePdf>(lights, record.p) : nullptr;
+    std::shared_ptr<Pdf> mixed_pdf = light_pdf ? std::make_shared<MixturePdf>(light_pdf, scatter_record.pdf) : scatter_record.pdf;
+
+    const Vec3 direction = mixed_pdf->Generate(generator);
+    const Ray scattered(record.p, direction, r.time());
+    const double pdf_value = mixed_pdf->Value(scattered.direction());
+    if (pdf_value <= 0.0) {
+        return emitted;
+    }
+
+    const double scattering_pdf = record.material->ScatteringPdf(r, record, scattered);
+    const Color recursive = RayColor(scattered, depth - 1, world, lights, generator);
+    return emitted + scatter_record.attenuation * scattering_pdf * recursive / pdf_value;
+}
+
+Color RayColor(const Ray& r, int depth, const Hittable& world, const std::shared_ptr<Hittable>& lights,
+               Rng& generator) {
+    if (depth <= 0) {
+        return Color(0.0, 0.0, 0.0);
+    }
+
+    HitRecord record;
+    if (!world.Hit(r, kHitEpsilon, std::numeric_limits<double>::infinity(), record, generator)) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    return ShadeHit(r, record, depth, world, lights, generator);
+}
+
+// 묶음 크기별 픽셀 블록 모양(가로 x 세로). 정사각형에 가까울수록 화면 레이가 모인다.
+Tile PacketBlock(int packet_size) {
+    switch (packet_size) {
+    case 4:
+        return Tile{0, 0, 2, 2};
+    case 8:
+        return Tile{0, 0, 4, 2};
+    case 16:
+        return Tile{0, 0, 4, 4};
+    default:
+        throw std::invalid_argument("레이 묶음 크기는 1, 4, 8, 16 중 하나여야 한다.");
+    }
+}
+
+// 타일을 픽셀 블록으로 나눠 블록의 같은 샘플 인덱스 화면 레이를 한 묶음으로 첫 교차까지 순회한다. 두 번째 교차부터는
+// 방향이 흩어지므로 레이마다 따로 추적한다. 픽셀마다 샘플 0부터 순서대로 더하므로 합이 단일 레이 경로와 비트 단위로 같다.
+void AccumulatePacketTile(const RenderContext& context, const Hittable& primary_world, const Tile& tile,
+                          std::vector<Color>& local) {
+    const RenderOptions& options = context.options;
+    const Tile block = PacketBlock(options.packet_size);
+    Ray rays[kMaxPacketSize];
+    HitRecord records[kMaxPacketSize];
+    Rng generators[kMaxPacketSize];
+    std::size_t pixels[kMaxPacketSize];
+
+    for (int by = tile.y0; by < tile.y1; by += block.Height()) {
+        for (int bx = tile.x0; bx < tile.x1; bx += block.Width()) {
+            const int x1 = std::min(bx + block.Width(), tile.x1);
+            const int y1 = std::min(by + block.Height(), tile.y1);
+            for (int sample = 0; sample < options.samples_per_pixel; ++sample) {
+                int count = 0;
+                for (int y = by; y < y1; ++y) {
+                    for (int x = bx; x < x1; ++x) {
+                        rays[count] = PrimaryRay(context, x, y, sample, generators[count]);
+                        pixels[count] = static_cast<std::size_t>(y - tile.y0) * static_cast<std::size_t>(tile.Width()) +
+                                        static_cast<std::size_t>(x - tile.x0);
+                        ++count;
+                    }
+                }
+                const std::uint32_t hits =
+                    options.max_depth <= 0 ? 0u
+                                           : primary_world.HitPacket(rays, count, kHitEpsilon,
+                                                                     std::numeric_limits<double>::infinity(), records,
+                                                                     generators);
+                // 빗나간 샘플도 단일 레이 경로처럼 검은색을 더한다.
+                for (int i = 0; i < count; ++i) {
+                    local[pixels[i]] += (hits & (1u << i)) != 0 ? ShadeHit(rays[i], records[i], options.max_depth,
+                                                                          context.world, context.lights, generators[i])
+                                                                : Color(0.0, 0.0, 0.0);
+                }
+            }
+        }
+    }
+}
+
+// 화면 레이의 첫 교차만 primary_world에서 찾고 그 뒤는 RayColor와 같다.
+Color TraceSample(const RenderContext& context, const Hittable& primary_world, int x, int y, int sample) {
+    Rng generator;
+    const Ray r = PrimaryRay(context, x, y, sample, generator);
+    if (context.options.max_depth <= 0) {
+        return Color(0.0, 0.0, 0.0);
+    }
+
+    HitRecord record;
+    if (!primary_world.Hit(r, kHitEpsilon, std::numeric_limits<double>::infinity(), record, generator)) {
+        return Color(0.0, 0.0, 0.0);
+    }
+    return ShadeHit(r, record, context.options.max_depth, context.world, context.lights, generator);
+}
+
+}  // namespace
+
+Ray PrimaryRay(const RenderContext& context, int x, int y, int sample, Rng& generator) {
+    const RenderOptions& options = context.options;
+    const std::uint64_t pixel_index =
+        static_cast<std::uint64_t>(y) * static_cast<std::uint64_t>(options.width) + static_cast<std::uint64_t>(x);
+    generator.Seed(SampleSeed(options.seed, pixel_index, static_cast<std::uint32_t>(sample)));
+
+    const double u = (options.width == 1)
+                         ? 0.5
+                         : (static_cast<double>(x) + RandomDouble(generator)) / (static_cast<double>(options.width) - 1.0);
+    const double v = (options.height == 1)
+                         ? 0.5
+                         : (static_cast<double>(options.height - 1 - y) + RandomDouble(generator)) /
+                               (static_cast<double>(options.height) - 1.0);
+    return context.camera.GetRay(u, v, generator);
+}
+
+Camera MakeCamera(const RenderOptions& options) {
+    const double aspect_ratio = static_cast<double>(options.width) / static_cast<double>(options.height);
+    const Point3 look_from(278.0, 278.0, -800.0);
+    const Point3 look_at(278.0, 278.0, 0.0);
+    const Vec3 vup(0.0, 1.0, 0.0);
+    const double focus_dist = (look_from - look_at).length();
+    return Camera(look_from, look_at, vup, options.vertical_fov_degrees, aspect_ratio, options.aperture, focus_dist,
+                  options.shutter_open_time, options.shutter_close_time);
+}
+
+Color RenderSample(const RenderContext& context, int x, int y, int sample) {
+    return TraceSample(context, context.world, x, y, sample);
+}
+
+std::unique_ptr<Hittable> CullTileWorld(const RenderContext& context, const Tile& tile) {
+    const RenderOptions& options = context.options;
+    if (!options.tile_culling) {
+        return nullptr;
+    }
+
+    // PrimaryRay의 지터 범위: 픽셀 x는 s ∈ [x / (W - 1), (x + 1) / (W - 1)), 행 y는 t ∈ [(H - 1 - y) / (H - 1), (H - y) / (H - 1)).
+    const double s0 = options.width == 1 ? 0.5 : static_cast<double>(tile.x0) / (static_cast<double>(options.width) - 1.0);
+    const double s1 = options.width == 1 ? 0.5 : static_cast<double>(tile.x1) / (static_cast<double>(options.width) - 1.0);
+    const double t0 = options.height == 1 ? 0.5
+                                          : static_cast<double>(options.height - tile.y1) /
+                                                (static_cast<double>(options.height) - 1.0);
+    const double t1 = options.height == 1 ? 0.5
+                                          : static_cast<double>(options.height - tile.y0) /
+                                                (static_cast<double>(options.height) - 1.0);
+    Frustum frustum;
+    if (!context.camera.RegionFrustum(s0, s1, t0, t1, frustum)) {
+        return nullptr;
+    }
+    return context.world.CullFrustum(frustum);
+}
+
+std::vector<Color> RenderTileSums(const RenderContext& context, const Tile& tile) {
+    if (context.options.integrator == Integrator::kWavefront) {
+        return RenderTileSumsWavefront(context, tile);
+    }
+
+    const std::unique_ptr<Hittable> culled = CullTileWorld(context, tile);
+    const Hittable& primary_world = culled ? *culled : context.world;
+    std::vector<Color> local(static_cast<std::size_t>(tile.Width()) * static_cast<std::size_t>(tile.Height()));
+    if (context.options.packet_size != 1) {
+        AccumulatePacketTile(context, primary_world, tile, local);
+        return local;
+    }
+
+    for (int y = tile.y0; y < tile.y1; ++y) {
+        for (int x = tile.x0; x < tile.x1; ++x) {
+            Color pixel_color(0.0, 0.0, 0.0);
+            for (int sample = 0; sample < context.options.samples_per_pixel; ++sample) {
+                pixel_color += TraceSample(context, primary_world, x, y, sample);
+            }
+            local[static_cast<std::size_t>(y - tile.y0) * static_cast<std::size_t>(tile.Width()) +
+                  static_cast<std::size_t>(x - tile.x0)] = pixel_color;
+        }
+    }
+
+    return local;
+}
+
+}  // namespace raytracer
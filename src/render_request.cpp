@@ -0,0 +1,190 @@
+/*
+ * 설명: 정수, 문자열, 정수 배열 값만 갖는 평평한 JSON 객체를 해석해 렌더 요청을 만든다.
+ * 버전: v1.8.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.5.0-render-server.md, design/renderer/v1.8.0-batch.md
+ * 테스트: tests/unit/render_request_test.cpp
+ */
+#include "raytracer/render_request.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+namespace raytracer {
+namespace {
+
+class RequestParser {
+public:
+    explicit RequestParser(const std::string& text) : text_(text) {}
+
+    void SkipSpace() {
+        while (position_ < text_.size() &&
+               (text_[position_] == ' ' || text_[position_] == '\t' || text_[position_] == '\r' || text_[position_] == '\n')) {
+            ++position_;
+        }
+    }
+
+    bool Consume(char expected) {
+        SkipSpace();
+        if (position_ < text_.size() && text_[position_] == expected) {
+            ++position_;
+            return true;
+        }
+        return false;
+    }
+
+    void Expect(char expected) {
+        if (!Consume(expected)) {
+            Fail();
+        }
+    }
+
+    char Peek() {
+        SkipSpace();
+        return position_ < text_.size() ? text_[position_] : '\0';
+    }
+
+    bool AtEnd() {
+        SkipSpace();
+        return position_ == text_.size();
+    }
+
+    // 이스케이프가 필요한 키/값은 쓰지 않으므로 역슬래시는 허용하지 않는다.
+    std::string String() {
+        Expect('"');
+        const std::size_t begin = position_;
+        while (position_ < text_.size() && text_[position_] != '"') {
+            if (text_[position_] == '\\') {
+                Fail();
+            }
+            ++position_;
+        }
+        if (position_ == text_.size()) {
+            Fail();
+        }
+        return text_.substr(begin, position_++ - begin);
+    }
+
+    std::int64_t Integer() {
+        SkipSpace();
+        std::int64_t value = 0;
+        const char* begin = text_.data() + position_;
+        const char* end = text_.data() + text_.size();
+        const auto result = std::from_chars(begin, end, value);
+        if (result.ec != std::errc() || (result.ptr < end && (*result.ptr == '.' || *result.ptr == 'e' || *result.ptr == 'E'))) {
+            throw std::invalid_argument("요청 값은 정수여야 한다.");
+        }
+        position_ += static_cast<std::size_t>(result.ptr - begin);
+        return value;
+    }
+
+    std::vector<std::int64_t> IntegerArray() {
+        Expect('[');
+        std::vector<std::int64_t> values;
+        if (Consume(']')) {
+            return values;
+        }
+        do {
+            values.push_back(Integer());
+        } while (Consume(','));
+        Expect(']');
+        return values;
+    }
+
+    [[noreturn]] void Fail() const { throw std::invalid_argument("요청 JSON 형식이 올바르지 않다."); }
+
+private:
+    const std::string& text_;
+    std::size_t position_ = 0;
+};
+
+int BoundedInt(std::int64_t value, int maximum, const char* message) {
+    if (value < 1 || value > maximum) {
+        throw std::invalid_argument(message);
+    }
+    return static_cast<int>(value);
+}
+
+}  // namespace
+
+RenderRequest ParseRenderRequest(const std::string& line, const RenderOptions& defaults) {
+    RenderRequest request;
+    request.options = defaults;
+    bool has_crop = false;
+    bool has_size = false;
+    std::vector<std::int64_t> crop;
+
+    RequestParser parser(line);
+    parser.Expect('{');
+    if (!parser.Consume('}')) {
+        do {
+            const std::string key = parser.String();
+            parser.Expect(':');
+            if (key == "width") {
+                request.options.width =
+                    BoundedInt(parser.Integer(), kMaxRequestDimension, "width는 1 이상 8192 이하 정수여야 한다.");
+                has_size = true;
+            } else if (key == "height") {
+                request.options.height =
+                    BoundedInt(parser.Integer(), kMaxRequestDimension, "height는 1 이상 8192 이하 정수여야 한다.");
+                has_size = true;
+            } else if (key == "spp") {
+                request.options.samples_per_pixel =
+                    BoundedInt(parser.Integer(), kMaxRequestSamplesPerPixel, "spp는 1 이상 65536 이하 정수여야 한다.");
+            } else if (key == "max_depth") {
+                request.options.max_depth =
+                    BoundedInt(parser.Integer(), kMaxRequestDepth, "max_depth는 1 이상 1024 이하 정수여야 한다.");
+            } else if (key == "seed") {
+                const std::int64_t seed = parser.Integer();
+                if (seed < 0 || seed > std::numeric_limits<std::uint32_t>::max()) {
+                    throw std::invalid_argument("seed는 0 이상 32비트 정수여야 한다.");
+                }
+                request.options.seed = static_cast<std::uint32_t>(seed);
+            } else if (key == "crop") {
+                crop = parser.IntegerArray();
+                has_crop = true;
+            } else if (key == "format") {
+                const std::string format = parser.Peek() == '"' ? parser.String() : "";
+                if (format == "p3") {
+                    request.format = PpmFormat::kAscii;
+                } else if (format == "p6") {
+                    request.format = PpmFormat::kBinary;
+                } else {
+                    throw std::invalid_argument("format은 \"p3\" 또는 \"p6\"이어야 한다.");
+                }
+            } else if (key == "output") {
+                request.output_path = parser.Peek() == '"' ? parser.String() : "";
+                if (request.output_path.empty()) {
+                    throw std::invalid_argument("output은 비어 있지 않은 문자열이어야 한다.");
+                }
+            } else {
+                throw std::invalid_argument("지원하지 않는 요청 키: " + key);
+            }
+        } while (parser.Consume(','));
+        parser.Expect('}');
+    }
+    if (!parser.AtEnd()) {
+        parser.Fail();
+    }
+
+    const RenderOptions& options = request.options;
+    if (has_size && static_cast<std::int64_t>(options.width) * options.height > kMaxRequestPixels) {
+        throw std::invalid_argument("요청 해상도는 4096x4096 픽셀 이하여야 한다.");
+    }
+    request.crop = Tile{0, 0, options.width, options.height};
+    if (has_crop) {
+        if (crop.size() != 4 || crop[0] < 0 || crop[1] < 0 || crop[2] < 1 || crop[3] < 1 ||
+            crop[2] > options.width || crop[3] > options.height || crop[0] > options.width - crop[2] ||
+            crop[1] > options.height - crop[3]) {
+            throw std::invalid_argument("crop은 이미지 안의 [x, y, 너비, 높이]여야 한다.");
+        }
+        request.crop = Tile{static_cast<int>(crop[0]), static_cast<int>(crop[1]), static_cast<int>(crop[0] + crop[2]),
+                            static_cast<int>(crop[1] + crop[3])};
+    }
+    return request;
+}
+
+}  // namespace raytracer
@@ -0,0 +1,249 @@
+/*
+ * 설명: 유닉스 도메인 소켓에서 한 줄 JSON 요청을 읽어 공유 장면/스레드 풀로 렌더링하고 PPM 행을 소켓으로 바로 흘려보낸다.
+ * 버전: v1.8.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.5.0-render-server.md, design/renderer/v1.8.0-batch.md
+ * 테스트: tests/integration/render_server_test.cpp
+ */
+#include "raytracer/render_server.hpp"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <vector>
+
+#include "raytracer/image_sink.hpp"
+#include "raytracer/render_request.hpp"
+
+namespace raytracer {
+namespace {
+
+constexpr std::size_t kMaxRequestLength = 64 * 1024;
+
+bool SendAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        const ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+    return true;
+}
+
+// 소켓으로 쓰는 출력 버퍼. 전송 실패는 스트림 오류로 드러나 PpmStreamWriter가 std::runtime_error로 바꾼다.
+class SocketStreamBuffer : public std::streambuf {
+public:
+    explicit SocketStreamBuffer(int fd) : fd_(fd), buffer_(64 * 1024) { setp(buffer_.data(), buffer_.data() + buffer_.size()); }
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (sync() != 0) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int sync() override {
+        const std::size_t size = static_cast<std::size_t>(pptr() - pbase());
+        if (size > 0 && !SendAll(fd_, pbase(), size)) {
+            return -1;
+        }
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+        return 0;
+    }
+
+private:
+    int fd_;
+    std::vector<char> buffer_;
+};
+
+// 요청 줄을 읽는다. 연결 종료나 읽기 오류면 false, 줄이 너무 길면 std::invalid_argument.
+bool ReadLine(int fd, std::string& pending, std::string& line) {
+    for (;;) {
+        const std::size_t newline = pending.find('\n');
+        if (newline != std::string::npos) {
+            line = pending.substr(0, newline);
+            pending.erase(0, newline + 1);
+            return true;
+        }
+        if (pending.size() > kMaxRequestLength) {
+            throw std::invalid_argument("요청 줄이 너무 길다.");
+        }
+
+        char chunk[4096];
+        const ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        pending.append(chunk, static_cast<std::size_t>(received));
+    }
+}
+
+bool SendError(int fd, const std::string& message) {
+    const std::string line = "ERR " + message + "\n";
+    return SendAll(fd, line.data(), line.size());
+}
+
+}  // namespace
+
+RenderServer::RenderServer(const std::string& socket_path, const RenderOptions& defaults)
+    : socket_path_(socket_path),
+      defaults_(defaults),
+      scene_(BuildCornellSmokeScene(defaults.shutter_open_time, defaults.shutter_close_time)),
+      pool_(defaults.thread_count) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("소켓 경로가 비었거나 너무 길다.");
+    }
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    struct stat status {};
+    if (::stat(socket_path.c_str(), &status) == 0) {
+        if (!S_ISSOCK(status.st_mode)) {
+            throw std::runtime_error("소켓 경로에 소켓이 아닌 파일이 있다.");
+        }
+        ::unlink(socket_path.c_str());
+    }
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error("소켓을 만들 수 없다.");
+    }
+    if (::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listen_fd_, SOMAXCONN) != 0) {
+        ::close(listen_fd_);
+        throw std::runtime_error("소켓을 열 수 없다: " + socket_path);
+    }
+}
+
+RenderServer::~RenderServer() {
+    Stop();
+    CloseAllConnections();
+    ::close(listen_fd_);
+    ::unlink(socket_path_.c_str());
+}
+
+void RenderServer::Serve() {
+    while (!stopping_.load()) {
+        const int client_fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client_fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (stopping_.load()) {
+                break;
+            }
+            throw std::runtime_error("연결을 받을 수 없다.");
+        }
+
+        ReapFinishedConnections();
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        connections_.push_back(std::make_unique<Connection>());
+        Connection& connection = *connections_.back();
+        connection.fd = client_fd;
+        connection.thread = std::thread([this, &connection] { HandleConnection(connection); });
+    }
+
+    CloseAllConnections();
+}
+
+void RenderServer::Stop() {
+    stopping_.store(true);
+    ::shutdown(listen_fd_, SHUT_RDWR);
+}
+
+// 소켓을 먼저 끊어 읽기나 응답 기록에서 막힌 연결 스레드가 빠져나오게 한 뒤 회수한다.
+// 목록은 잠금 밖으로 옮겨 join하는 동안 다른 스레드가 잠금을 기다리지 않게 한다.
+void RenderServer::CloseAllConnections() {
+    std::list<std::unique_ptr<Connection>> connections;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        for (const auto& connection : connections_) {
+            ::shutdown(connection->fd, SHUT_RDWR);
+        }
+        connections.swap(connections_);
+    }
+    for (const auto& connection : connections) {
+        if (connection->thread.joinable()) {
+            connection->thread.join();
+        }
+        ::close(connection->fd);
+    }
+}
+
+void RenderServer::ReapFinishedConnections() {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    for (auto it = connections_.begin(); it != connections_.end();) {
+        if ((*it)->finished.load()) {
+            (*it)->thread.join();
+            ::close((*it)->fd);
+            it = connections_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// 요청은 연결 안에서 순서대로 처리한다. 응답은 PPM 자체이거나 "ERR <메시지>" 한 줄이며,
+// PPM은 헤더의 해상도로 길이가 정해지므로 별도 길이 필드 없이 다음 응답과 구분된다.
+void RenderServer::HandleConnection(Connection& connection) {
+    const int fd = connection.fd;
+    std::string pending;
+    std::string line;
+    try {
+        while (ReadLine(fd, pending, line)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+
+            RenderRequest request;
+            try {
+                request = ParseRenderRequest(line, defaults_);
+                if (!request.output_path.empty()) {
+                    throw std::invalid_argument("서버 요청에는 output을 쓸 수 없다.");
+                }
+            } catch (const std::invalid_argument& error) {
+                if (!SendError(fd, error.what())) {
+                    break;
+                }
+                continue;
+            }
+
+            SocketStreamBuffer buffer(fd);
+            std::ostream output(&buffer);
+            PpmStreamWriter writer(output, request.format);
+            RenderMaterialRegion(request.options, scene_, pool_, request.crop, writer);
+        }
+    } catch (const std::invalid_argument& error) {
+        SendError(fd, error.what());
+    } catch (const std::bad_alloc&) {
+        SendError(fd, "요청을 처리할 메모리가 부족하다.");
+    } catch (const std::exception&) {
+        // 응답 도중 연결이 끊겼다. 다른 연결에는 영향이 없다.
+    }
+    ::shutdown(fd, SHUT_RDWR);
+    connection.finished.store(true);
+}
+
+}  // namespace raytracer
@@ -0,0 +1,107 @@
+/*
+ * 설명: 힐베르트 순서 타일을 스레드 풀에 분배해 호출자 프레임버퍼에 샘플 합을 기록하고 타일 완료 표시로 부분 읽기를 허용한다.
+ * 버전: v1.6.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.6.0-render-session.md
+ * 테스트: tests/integration/render_session_test.cpp
+ */
+#include "raytracer/render_session.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "raytracer/camera.hpp"
+#include "raytracer/color.hpp"
+#include "raytracer/render_kernel.hpp"
+
+namespace raytracer {
+
+RenderSession::RenderSession(const RenderOptions& options, const Scene& scene, Framebuffer& framebuffer)
+    : options_(options), scene_(scene), framebuffer_(framebuffer) {
+    if (framebuffer.width() != options.width || framebuffer.height() != options.height) {
+        throw std::invalid_argument("프레임버퍼 해상도가 렌더 옵션과 다르다.");
+    }
+    tiles_ = BuildHilbertTiles(options.width, options.height, options.tile_size);
+    tile_done_ = std::make_unique<std::atomic<bool>[]>(tiles_.size());
+    for (std::size_t index = 0; index < tiles_.size(); ++index) {
+        tile_done_[index].store(false);
+    }
+}
+
+void RenderSession::SetProgressCallback(ProgressCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    callback_ = std::move(callback);
+}
+
+bool RenderSession::Run() {
+    ThreadPool pool(options_.thread_count);
+    return Run(pool);
+}
+
+bool RenderSession::Run(ThreadPool& pool) {
+    const Camera camera = MakeCamera(options_);
+    const RenderContext context{options_, camera, scene_.WorldView(), scene_.lights_view};
+
+    pool.ParallelFor(tiles_.size(), [&](std::size_t index) {
+        if (cancelled_.load(std::memory_order_relaxed) || tile_done_[index].load(std::memory_order_acquire)) {
+            return;
+        }
+
+        const Tile& tile = tiles_[index];
+        const std::vector<Color> local = RenderTileSums(context, tile);
+        for (int y = tile.y0; y < tile.y1; ++y) {
+            const Color* source = &local[static_cast<std::size_t>(y - tile.y0) * static_cast<std::size_t>(tile.Width())];
+            std::copy(source, source + tile.Width(), &framebuffer_.At(tile.x0, y));
+        }
+        tile_done_[index].store(true, std::memory_order_release);
+        const std::size_t completed = completed_.fetch_add(1) + 1;
+
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        if (callback_) {
+            callback_(TileProgress{index, tile, completed, tiles_.size()});
+        }
+    });
+
+    return completed_.load() == tiles_.size();
+}
+
+void RenderSession::Cancel() { cancelled_.store(true); }
+
+bool RenderSession::IsCancelled() const { return cancelled_.load(); }
+
+std::size_t RenderSession::CompletedTiles() const { return completed_.load(); }
+
+bool RenderSession::IsTileComplete(std::size_t tile_index) const {
+    if (tile_index >= tiles_.size()) {
+        throw std::out_of_range("타일 인덱스가 범위를 벗어났다.");
+    }
+    return tile_done_[tile_index].load(std::memory_order_acquire);
+}
+
+void RenderSession::ResolvePartial(ImageSink& sink) const {
+    std::vector<Rgb8> image(static_cast<std::size_t>(options_.width) * static_cast<std::size_t>(options_.height));
+    const double samples = static_cast<double>(options_.samples_per_pixel);
+    for (std::size_t index = 0; index < tiles_.size(); ++index) {
+        if (!tile_done_[index].load(std::memory_order_acquire)) {
+            continue;
+        }
+        const Tile& tile = tiles_[index];
+        for (int y = tile.y0; y < tile.y1; ++y) {
+            for (int x = tile.x0; x < tile.x1; ++x) {
+                image[static_cast<std::size_t>(y) * static_cast<std::size_t>(options_.width) + static_cast<std::size_t>(x)] =
+                    QuantizeColor(framebuffer_.At(x, y) / samples);
+            }
+        }
+    }
+
+    sink.Begin(options_.width, options_.height);
+    std::vector<Rgb8> row(static_cast<std::size_t>(options_.width));
+    for (int y = 0; y < options_.height; ++y) {
+        const auto begin = image.begin() + static_cast<std::ptrdiff_t>(y) * options_.width;
+        std::copy(begin, begin + options_.width, row.begin());
+        sink.WriteRow(y, row);
+    }
+    sink.End();
+}
+
+}  // namespace raytracer
@@ -0,0 +1,72 @@
+/*
+ * 설명: Cornell smoke 장면(벽 Quad, 천장 광원, ConstantMedium 볼륨 두 개)과 BVH(8칸 넓은 BVH 포함), 광원 목록, 볼륨 회전 손잡이를 구성한다.
+ * 버전: v1.12.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.5.0-render-server.md, design/renderer/v1.9.0-animation.md,
+ *           design/renderer/v1.11.0-linear-bvh.md, design/renderer/v1.12.0-wide-bvh.md
+ * 테스트: tests/integration/ppm_integration_test.cpp
+ */
+#include "raytracer/scene.hpp"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "raytracer/constant_medium.hpp"
+#include "raytracer/material.hpp"
+#include "raytracer/quad.hpp"
+#include "raytracer/transform.hpp"
+#include "raytracer/vec3.hpp"
+
+namespace raytracer {
+namespace {
+
+// 상자를 원점 모서리 기준으로 회전/이동하고 애니메이션 손잡이를 기록한다.
+std::shared_ptr<Hittable> PlaceBox(const Point3& size, double angle_degrees, const Vec3& offset,
+                                   const std::shared_ptr<Material>& material, std::vector<TurntableHandle>& turntables) {
+    const auto box = std::make_shared<Box>(Point3(0.0, 0.0, 0.0), size, material);
+    const auto rotation = std::make_shared<RotateY>(box, angle_degrees);
+    const auto translation = std::make_shared<Translate>(rotation, offset);
+    turntables.push_back(TurntableHandle{rotation, translation, angle_degrees, offset, 0.5 * size});
+    return translation;
+}
+
+HittableList BuildCornellSmoke(HittableList& lights, std::vector<TurntableHandle>& turntables) {
+    HittableList world;
+
+    const auto red = std::make_shared<Lambertian>(Color(0.65, 0.05, 0.05));
+    const auto white = std::make_shared<Lambertian>(Color(0.73, 0.73, 0.73));
+    const auto green = std::make_shared<Lambertian>(Color(0.12, 0.45, 0.15));
+    const auto light = std::make_shared<DiffuseLight>(Color(15.0, 15.0, 15.0));
+
+    world.Add(std::make_shared<Quad>(Point3(555.0, 0.0, 0.0), Vec3(0.0, 0.0, 555.0), Vec3(0.0, 555.0, 0.0), green));
+    world.Add(std::make_shared<Quad>(Point3(0.0, 0.0, 0.0), Vec3(0.0, 555.0, 0.0), Vec3(0.0, 0.0, 555.0), red));
+    const auto ceiling_light = std::make_shared<Quad>(Point3(213.0, 554.0, 227.0), Vec3(130.0, 0.0, 0.0), Vec3(0.0, 0.0, 105.0), light);
+    world.Add(ceiling_light);
+    lights.Add(ceiling_light);
+    world.Add(std::make_shared<Quad>(Point3(0.0, 555.0, 0.0), Vec3(555.0, 0.0, 0.0), Vec3(0.0, 0.0, 555.0), white));
+    world.Add(std::make_shared<Quad>(Point3(0.0, 0.0, 0.0), Vec3(555.0, 0.0, 0.0), Vec3(0.0, 0.0, 555.0), white));
+    world.Add(std::make_shared<Quad>(Point3(0.0, 0.0, 555.0), Vec3(555.0, 0.0, 0.0), Vec3(0.0, 555.0, 0.0), white));
+
+    const auto short_box = PlaceBox(Point3(165.0, 165.0, 165.0), -18.0, Vec3(130.0, 0.0, 65.0), white, turntables);
+    world.Add(std::make_shared<ConstantMedium>(short_box, 0.01, Color(0.0, 0.0, 0.0)));
+
+    const auto tall_box = PlaceBox(Point3(165.0, 330.0, 165.0), 15.0, Vec3(265.0, 0.0, 295.0), white, turntables);
+    world.Add(std::make_shared<ConstantMedium>(tall_box, 0.01, Color(1.0, 1.0, 1.0)));
+
+    return world;
+}
+
+}  // namespace
+
+Scene BuildCornellSmokeScene(double time0, double time1) {
+    HittableList lights;
+    std::vector<TurntableHandle> turntables;
+    HittableList world = BuildCornellSmoke(lights, turntables);
+    std::shared_ptr<BvhNode> bvh_tree = world.Objects().empty() ? nullptr : std::make_shared<BvhNode>(world, time0, time1);
+    std::shared_ptr<Bvh8> wide_bvh = bvh_tree ? std::make_shared<Bvh8>(*bvh_tree, time0, time1) : nullptr;
+    std::shared_ptr<Hittable> lights_view = lights.Objects().empty() ? nullptr : std::make_shared<HittableList>(lights);
+    return Scene{std::move(world),      std::move(lights),      std::move(bvh_tree),
+                 std::move(wide_bvh),   std::move(lights_view), std::move(turntables)};
+}
+
+}  // namespace raytracer
@@ -0,0 +1,179 @@
+/*
+ * 설명: 샤드 텍스트 형식을 기록/해석하고 타일 구간을 검증해 전체 PPM(P3)으로 병합한다.
+ * 버전: v1.4.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.3.0-shards.md, design/renderer/v1.4.0-streaming-output.md
+ * 테스트: tests/integration/ppm_integration_test.cpp
+ */
+#include "raytracer/shard.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include "raytracer/tile.hpp"
+
+namespace raytracer {
+namespace {
+
+constexpr const char* kMagic = "RTSHARD";
+constexpr int kFormatVersion = 2;
+
+std::size_t PixelCountInRange(const ShardImage& shard) {
+    std::size_t count = 0;
+    for (int index = shard.range.begin; index < shard.range.end; ++index) {
+        const Tile tile = TileAt(index, shard.width, shard.height, shard.tile_size);
+        count += static_cast<std::size_t>(tile.Width()) * static_cast<std::size_t>(tile.Height());
+    }
+    return count;
+}
+
+bool SameSettings(const ShardRenderSettings& a, const ShardRenderSettings& b) {
+    return a.seed == b.seed && a.samples_per_pixel == b.samples_per_pixel && a.max_depth == b.max_depth &&
+           a.scene == b.scene && a.vertical_fov_degrees == b.vertical_fov_degrees && a.aperture == b.aperture &&
+           a.shutter_open_time == b.shutter_open_time && a.shutter_close_time == b.shutter_close_time;
+}
+
+// P6로 쓸 때 채널을 바이트로 좁히므로 범위 밖 값은 조용히 다른 색이 된다.
+bool InChannelRange(const Rgb8& rgb) {
+    return rgb.r >= 0 && rgb.r <= 255 && rgb.g >= 0 && rgb.g <= 255 && rgb.b >= 0 && rgb.b <= 255;
+}
+
+}  // namespace
+
+TileRange ShardTileRange(int shard_index, int shard_count, int tile_count) {
+    if (shard_count < 1 || shard_index < 0 || shard_index >= shard_count || tile_count < 0) {
+        throw std::invalid_argument("샤드 번호는 0 이상 샤드 수 미만이어야 한다.");
+    }
+
+    const auto begin = static_cast<std::int64_t>(tile_count) * shard_index / shard_count;
+    const auto end = static_cast<std::int64_t>(tile_count) * (shard_index + 1) / shard_count;
+    return TileRange{static_cast<int>(begin), static_cast<int>(end)};
+}
+
+std::string EncodeShard(const ShardImage& shard) {
+    std::ostringstream output;
+    output << kMagic << ' ' << kFormatVersion << "\n";
+    output << shard.width << ' ' << shard.height << ' ' << shard.tile_size << "\n";
+    const ShardRenderSettings& settings = shard.settings;
+    output << settings.seed << ' ' << settings.samples_per_pixel << ' ' << settings.max_depth << "\n";
+    // 병합 때 설정을 정확히 비교하도록 double은 되읽으면 같은 값이 되는 자릿수로 기록한다.
+    output << std::setprecision(std::numeric_limits<double>::max_digits10) << settings.scene << ' '
+           << settings.vertical_fov_degrees << ' ' << settings.aperture << ' ' << settings.shutter_open_time << ' '
+           << settings.shutter_close_time << "\n";
+    output << shard.range.begin << ' ' << shard.range.end << "\n";
+    for (const Rgb8& rgb : shard.pixels) {
+        output << rgb.r << ' ' << rgb.g << ' ' << rgb.b << "\n";
+    }
+    return output.str();
+}
+
+ShardImage DecodeShard(std::istream& input) {
+    std::string magic;
+    int version = 0;
+    ShardImage shard;
+    ShardRenderSettings& settings = shard.settings;
+    input >> magic >> version >> shard.width >> shard.height >> shard.tile_size >> settings.seed >>
+        settings.samples_per_pixel >> settings.max_depth >> settings.scene >> settings.vertical_fov_degrees >>
+        settings.aperture >> settings.shutter_open_time >> settings.shutter_close_time >> shard.range.begin >>
+        shard.range.end;
+    if (!input || magic != kMagic || version != kFormatVersion) {
+        throw std::runtime_error("샤드 헤더가 올바르지 않다.");
+    }
+    if (settings.samples_per_pixel < 1 || settings.max_depth < 1) {
+        throw std::runtime_error("샤드 샘플 수 또는 최대 깊이가 올바르지 않다.");
+    }
+    if (shard.width < 1 || shard.height < 1 || shard.tile_size < 1 || shard.range.begin < 0 ||
+        shard.range.begin > shard.range.end || shard.range.end > TileCount(shard.width, shard.height, shard.tile_size)) {
+        throw std::runtime_error("샤드 해상도 또는 타일 구간이 올바르지 않다.");
+    }
+
+    const std::size_t pixel_count = PixelCountInRange(shard);
+    shard.pixels.resize(pixel_count);
+    for (Rgb8& rgb : shard.pixels) {
+        if (!(input >> rgb.r >> rgb.g >> rgb.b)) {
+            throw std::runtime_error("샤드 픽셀 데이터가 잘렸다.");
+        }
+        if (!InChannelRange(rgb)) {
+            throw std::runtime_error("샤드 픽셀 값이 0~255 범위를 벗어났다.");
+        }
+    }
+
+    return shard;
+}
+
+void MergeShards(const std::vector<ShardImage>& shards, ImageSink& sink) {
+    if (shards.empty()) {
+        throw std::runtime_error("병합할 샤드가 없다.");
+    }
+
+    const int width = shards.front().width;
+    const int height = shards.front().height;
+    const int tile_size = shards.front().tile_size;
+    const int tile_count = TileCount(width, height, tile_size);
+
+    std::vector<const ShardImage*> ordered;
+    for (const ShardImage& shard : shards) {
+        if (shard.width != width || shard.height != height || shard.tile_size != tile_size) {
+            throw std::runtime_error("샤드 간 해상도 또는 타일 크기가 다르다.");
+        }
+        if (!SameSettings(shard.settings, shards.front().settings)) {
+            throw std::runtime_error("샤드 간 렌더 설정(시드, 샘플 수, 최대 깊이, 장면·카메라)이 다르다.");
+        }
+        if (shard.pixels.size() != PixelCountInRange(shard)) {
+            throw std::runtime_error("샤드 픽셀 수가 타일 구간과 맞지 않다.");
+        }
+        if (!std::all_of(shard.pixels.begin(), shard.pixels.end(), InChannelRange)) {
+            throw std::runtime_error("샤드 픽셀 값이 0~255 범위를 벗어났다.");
+        }
+        ordered.push_back(&shard);
+    }
+    // 샤드가 타일보다 많으면 [3,3) 같은 빈 구간이 [3,4)와 시작이 같으므로, 빈 구간이 먼저 오도록 끝으로도 정렬한다.
+    std::sort(ordered.begin(), ordered.end(), [](const ShardImage* a, const ShardImage* b) {
+        return a->range.begin != b->range.begin ? a->range.begin < b->range.begin : a->range.end < b->range.end;
+    });
+
+    std::vector<Rgb8> image(static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+    int next_tile = 0;
+    for (const ShardImage* shard : ordered) {
+        if (shard->range.begin != next_tile) {
+            throw std::runtime_error("샤드 타일 구간이 겹치거나 비어 있다.");
+        }
+
+        std::size_t cursor = 0;
+        for (int index = shard->range.begin; index < shard->range.end; ++index) {
+            const Tile tile = TileAt(index, width, height, tile_size);
+            for (int y = tile.y0; y < tile.y1; ++y) {
+                for (int x = tile.x0; x < tile.x1; ++x) {
+                    image[static_cast<std::size_t>(y) * static_cast<std::size_t>(width) + static_cast<std::size_t>(x)] =
+                        shard->pixels[cursor++];
+                }
+            }
+        }
+        next_tile = shard->range.end;
+    }
+    if (next_tile != tile_count) {
+        throw std::runtime_error("샤드가 전체 타일을 덮지 않는다.");
+    }
+
+    sink.Begin(width, height);
+    std::vector<Rgb8> row(static_cast<std::size_t>(width));
+    for (int y = 0; y < height; ++y) {
+        const auto begin = image.begin() + static_cast<std::ptrdiff_t>(y) * width;
+        std::copy(begin, begin + width, row.begin());
+        sink.WriteRow(y, row);
+    }
+    sink.End();
+}
+
+std::string MergeShards(const std::vector<ShardImage>& shards) {
+    std::ostringstream output;
+    PpmStreamWriter writer(output, PpmFormat::kAscii);
+    MergeShards(shards, writer);
+    return output.str();
+}
+
+}  // namespace raytracer
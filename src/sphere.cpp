@@ -1,11 +1,15 @@
 /*
- * 설명: 고정 구와 이동 구의 레이 교차, 경계 상자, 샘플링 PDF를 계산한다.
- * 버전: v1.0.0
- * 관련 문서: design/renderer/v1.0.0-overview.md
+ * 설명: 고정 구와 이동 구의 레이 교차, 경계 상자, 샘플링 PDF를 계산한다. 고정 구는 영역으로 자른 경계 상자도 계산한다.
+ *       교차 거리 계산을 Hit와 가림 판정이 공유하고, 가림 판정과 PDF는 교차 기록을 만들지 않는다.
+ *       이동 구는 모션 BVH용으로 셔터 양 끝 시각의 경계 상자를 따로 돌려준다.
+ * 버전: v1.25.0
+ * 관련 문서: design/renderer/v1.0.0-overview.md, design/renderer/v1.15.0-sbvh.md, design/renderer/v1.20.0-occlusion.md,
+ *           design/renderer/v1.25.0-motion-bvh.md
  * 테스트: tests/unit/sphere_test.cpp, tests/unit/bvh_test.cpp, tests/unit/pdf_test.cpp
  */
 #include "raytracer/sphere.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -24,13 +28,12 @@ void GetSphereUv(const Point3& p, double& u, double& v) {
     v = theta / pi;
 }
 
-}  // namespace
-
-bool Sphere::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& /*generator*/) const {
-    const Vec3 oc = r.origin() - center_;
+// [t_min, t_max] 안의 가까운 근을, 없으면 먼 근을 root에 쓴다. 둘 다 구간 밖이면 false.
+bool FindRoot(const Point3& center, double radius, const Ray& r, double t_min, double t_max, double& root) {
+    const Vec3 oc = r.origin() - center;
     const double a = r.direction().length_squared();
     const double half_b = Dot(oc, r.direction());
-    const double c = oc.length_squared() - radius_ * radius_;
+    const double c = oc.length_squared() - radius * radius;
 
     const double discriminant = half_b * half_b - a * c;
     if (discriminant < 0) {
@@ -39,13 +42,23 @@ bool Sphere::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, st
 
     const double sqrt_d = std::sqrt(discriminant);
 
-    double root = (-half_b - sqrt_d) / a;
+    root = (-half_b - sqrt_d) / a;
     if (root < t_min || root > t_max) {
         root = (-half_b + sqrt_d) / a;
         if (root < t_min || root > t_max) {
             return false;
         }
     }
+    return true;
+}
+
+}  // namespace
+
+bool Sphere::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& /*generator*/) const {
+    double root = 0.0;
+    if (!FindRoot(center_, radius_, r, t_min, t_max, root)) {
+        return false;
+    }
 
     record.t = root;
     record.p = r.At(record.t);
@@ -57,12 +70,46 @@ bool Sphere::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, st
     return true;
 }
 
+bool Sphere::Occluded(const Ray& r, double t_min, double t_max, Rng& /*generator*/) const {
+    double root = 0.0;
+    return FindRoot(center_, radius_, r, t_min, t_max, root);
+}
+
 bool Sphere::BoundingBox(double /*time0*/, double /*time1*/, Aabb& output_box) const {
     const Vec3 radius_vec(radius_, radius_, radius_);
     output_box = Aabb(center_ - radius_vec, center_ + radius_vec);
     return true;
 }
 
+// 축 b, c에서 중심과 region 구간 사이 거리가 d_b, d_c이면 region 안의 구 위 점은 (x_a - c_a)^2 <= r^2 - d_b^2 - d_c^2를
+// 만족한다. 이 반지름으로 축 a의 범위를 줄이고 region과 겹친다.
+bool Sphere::ClipBox(double /*time0*/, double /*time1*/, const Aabb& region, Aabb& output_box) const {
+    double gaps[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        const double below = region.minimum()[axis] - center_[axis];
+        const double above = center_[axis] - region.maximum()[axis];
+        gaps[axis] = std::max({below, above, 0.0});
+    }
+
+    double minimum[3];
+    double maximum[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        const double other_a = gaps[(axis + 1) % 3];
+        const double other_b = gaps[(axis + 2) % 3];
+        const double reach_squared = radius_ * radius_ - other_a * other_a - other_b * other_b;
+        if (reach_squared < 0.0) {
+            minimum[axis] = 1.0;
+            maximum[axis] = 0.0;
+            continue;
+        }
+        const double reach = std::sqrt(reach_squared);
+        minimum[axis] = std::max(center_[axis] - reach, region.minimum()[axis]);
+        maximum[axis] = std::min(center_[axis] + reach, region.maximum()[axis]);
+    }
+    output_box = Aabb(Point3(minimum[0], minimum[1], minimum[2]), Point3(maximum[0], maximum[1], maximum[2]));
+    return true;
+}
+
 Point3 MovingSphere::Center(double time) const {
     const double time_span = time_end_ - time_start_;
     if (time_span == 0.0) {
@@ -73,28 +120,13 @@ Point3 MovingSphere::Center(double time) const {
     return center_start_ + time_ratio * (center_end_ - center_start_);
 }
 
-bool MovingSphere::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& /*generator*/) const {
+bool MovingSphere::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& /*generator*/) const {
     const Point3 center = Center(r.time());
-    const Vec3 oc = r.origin() - center;
-    const double a = r.direction().length_squared();
-    const double half_b = Dot(oc, r.direction());
-    const double c = oc.length_squared() - radius_ * radius_;
-
-    const double discriminant = half_b * half_b - a * c;
-    if (discriminant < 0) {
+    double root = 0.0;
+    if (!FindRoot(center, radius_, r, t_min, t_max, root)) {
         return false;
     }
 
-    const double sqrt_d = std::sqrt(discriminant);
-
-    double root = (-half_b - sqrt_d) / a;
-    if (root < t_min || root > t_max) {
-        root = (-half_b + sqrt_d) / a;
-        if (root < t_min || root > t_max) {
-            return false;
-        }
-    }
-
     record.t = root;
     record.p = r.At(record.t);
     const Vec3 outward_normal = (record.p - center) / radius_;
@@ -105,6 +137,11 @@ bool MovingSphere::Hit(const Ray& r, double t_min, double t_max, HitRecord& reco
     return true;
 }
 
+bool MovingSphere::Occluded(const Ray& r, double t_min, double t_max, Rng& /*generator*/) const {
+    double root = 0.0;
+    return FindRoot(Center(r.time()), radius_, r, t_min, t_max, root);
+}
+
 bool MovingSphere::BoundingBox(double time0, double time1, Aabb& output_box) const {
     const Vec3 radius_vec(radius_, radius_, radius_);
     const Aabb box0(Center(time0) - radius_vec, Center(time0) + radius_vec);
@@ -113,10 +150,17 @@ bool MovingSphere::BoundingBox(double time0, double time1, Aabb& output_box) con
     return true;
 }
 
+bool MovingSphere::MotionBounds(double time0, double time1, Aabb& box0, Aabb& box1) const {
+    const Vec3 radius_vec(radius_, radius_, radius_);
+    box0 = Aabb(Center(time0) - radius_vec, Center(time0) + radius_vec);
+    box1 = Aabb(Center(time1) - radius_vec, Center(time1) + radius_vec);
+    return true;
+}
+
+// 구에 닿는 방향인지만 알면 되므로 교차 기록을 만들지 않는다.
 double Sphere::PdfValue(const Point3& origin, const Vec3& direction) const {
-    HitRecord record;
-    std::mt19937 dummy_generator(0);
-    if (!Hit(Ray(origin, direction), 0.001, std::numeric_limits<double>::infinity(), record, dummy_generator)) {
+    double root = 0.0;
+    if (!FindRoot(center_, radius_, Ray(origin, direction), 0.001, std::numeric_limits<double>::infinity(), root)) {
         return 0.0;
     }
 
@@ -126,7 +170,7 @@ double Sphere::PdfValue(const Point3& origin, const Vec3& direction) const {
     return 1.0 / solid_angle;
 }
 
-Vec3 Sphere::Random(const Point3& origin, std::mt19937& generator) const {
+Vec3 Sphere::Random(const Point3& origin, Rng& generator) const {
     const Vec3 direction = center_ - origin;
     Onb onb;
     onb.BuildFromW(direction);
@@ -0,0 +1,136 @@
+/*
+ * 설명: 구간(band)별 힐베르트 순서로 모든 타일을 한 번의 ParallelFor로 분배하고, 끝난 띠를 완료 순서와 무관하게
+ *       위→아래 순서로 내보낸다. 워커는 두 구간 앞 띠가 나갈 때까지만 기다리므로 띠 사이 장벽이 없다.
+ * 버전: v1.4.0
+ * 관련 문서: design/renderer/v1.4.0-streaming-output.md
+ * 테스트: tests/unit/tile_test.cpp
+ */
+#include "raytracer/strip_stream.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+
+namespace raytracer {
+namespace {
+
+struct StripSlot {
+    Tile strip;
+    std::vector<Tile> tiles;
+    std::vector<std::vector<Color>> sums;
+    std::size_t remaining = 0;
+};
+
+struct TileTask {
+    Tile tile;
+    std::size_t strip = 0;
+    std::size_t column = 0;
+    int band = 0;
+};
+
+}  // namespace
+
+void RenderStripsInOrder(ThreadPool& pool, const Tile& region, int tile_size,
+                         const std::function<std::vector<Color>(const Tile&)>& render_tile,
+                         const std::function<void(const StripResult&)>& emit_strip) {
+    if (tile_size < 1 || region.Width() < 1 || region.Height() < 1) {
+        throw std::invalid_argument("띠 렌더에는 1 이상의 영역과 타일 크기가 필요하다.");
+    }
+
+    const int columns = (region.Width() + tile_size - 1) / tile_size;
+    const int strip_count = (region.Height() + tile_size - 1) / tile_size;
+    // 구간 두 개가 스레드 수의 네 배 이상의 타일을 담으면 한 구간을 기다리는 동안에도 워커가 놀지 않는다.
+    const int band_strips =
+        std::min(strip_count, std::max(1, (2 * pool.ThreadCount() + columns - 1) / columns));
+
+    std::vector<StripSlot> slots(static_cast<std::size_t>(strip_count));
+    for (int s = 0; s < strip_count; ++s) {
+        StripSlot& slot = slots[static_cast<std::size_t>(s)];
+        const int y0 = region.y0 + s * tile_size;
+        slot.strip = Tile{region.x0, y0, region.x1, std::min(y0 + tile_size, region.y1)};
+        for (int column = 0; column < columns; ++column) {
+            const int x0 = region.x0 + column * tile_size;
+            slot.tiles.push_back(Tile{x0, slot.strip.y0, std::min(x0 + tile_size, region.x1), slot.strip.y1});
+        }
+        slot.sums.resize(slot.tiles.size());
+        slot.remaining = slot.tiles.size();
+    }
+
+    // ThreadPool은 인덱스를 앞에서부터 배분하므로, 구간 순서로 나열하면 앞 구간 타일이 항상 먼저 시작된다.
+    std::vector<TileTask> tasks;
+    tasks.reserve(static_cast<std::size_t>(columns) * static_cast<std::size_t>(strip_count));
+    for (int band = 0, first = 0; first < strip_count; ++band, first += band_strips) {
+        const int y0 = region.y0 + first * tile_size;
+        const int y1 = std::min(y0 + band_strips * tile_size, region.y1);
+        for (const Tile& local : BuildHilbertTiles(region.Width(), y1 - y0, tile_size)) {
+            TileTask task;
+            task.tile = Tile{region.x0 + local.x0, y0 + local.y0, region.x0 + local.x1, y0 + local.y1};
+            task.strip = static_cast<std::size_t>(first + local.y0 / tile_size);
+            task.column = static_cast<std::size_t>(local.x0 / tile_size);
+            task.band = band;
+            tasks.push_back(task);
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable strip_emitted;
+    std::size_t next_strip = 0;
+    bool emitting = false;
+    bool failed = false;
+
+    const auto fail = [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = true;
+        strip_emitted.notify_all();
+    };
+
+    pool.ParallelFor(tasks.size(), [&](std::size_t index) {
+        const TileTask& task = tasks[index];
+        {
+            // 두 구간 앞의 띠가 모두 나가야 시작한다. 가장 앞 미완료 구간의 타일은 기다리지 않으므로 항상 진행된다.
+            const std::size_t required = static_cast<std::size_t>(std::max(0, task.band - 1) * band_strips);
+            std::unique_lock<std::mutex> lock(mutex);
+            strip_emitted.wait(lock, [&]() { return failed || next_strip >= required; });
+            if (failed) {
+                return;
+            }
+        }
+
+        std::vector<Color> sums;
+        try {
+            sums = render_tile(task.tile);
+        } catch (...) {
+            fail();
+            throw;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        StripSlot& slot = slots[task.strip];
+        slot.sums[task.column] = std::move(sums);
+        --slot.remaining;
+        if (emitting || failed) {
+            return;
+        }
+        // 내보내는 동안 잠금을 풀어 다른 워커가 타일을 계속 끝내게 한다. 그동안 끝난 띠는 같은 루프가 이어서 내보낸다.
+        emitting = true;
+        while (!failed && next_strip < slots.size() && slots[next_strip].remaining == 0) {
+            StripSlot& ready = slots[next_strip];
+            lock.unlock();
+            try {
+                emit_strip(StripResult{ready.strip, ready.tiles, ready.sums});
+            } catch (...) {
+                fail();
+                throw;
+            }
+            lock.lock();
+            std::vector<std::vector<Color>>().swap(ready.sums);
+            ++next_strip;
+            strip_emitted.notify_all();
+        }
+        emitting = false;
+    });
+}
+
+}  // namespace raytracer
@@ -0,0 +1,112 @@
+/*
+ * 설명: 배치 큐와 원자적 인덱스 카운터로 ParallelFor 작업을 워커와 호출 스레드에 분배한다.
+ * 버전: v1.1.0
+ * 관련 문서: design/renderer/v1.1.0-tile-threads.md
+ * 테스트: tests/unit/tile_test.cpp, tests/integration/ppm_integration_test.cpp
+ */
+#include "raytracer/thread_pool.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace raytracer {
+
+ThreadPool::ThreadPool(int thread_count) : thread_count_(thread_count) {
+    if (thread_count < 1) {
+        throw std::invalid_argument("스레드 수는 1 이상이어야 한다.");
+    }
+
+    workers_.reserve(static_cast<std::size_t>(thread_count - 1));
+    for (int i = 1; i < thread_count; ++i) {
+        workers_.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::ParallelFor(std::size_t task_count, const std::function<void(std::size_t)>& task) {
+    if (task_count == 0) {
+        return;
+    }
+
+    auto batch = std::make_shared<Batch>();
+    batch->task = &task;
+    batch->task_count = task_count;
+
+    if (!workers_.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batches_.push_back(batch);
+        }
+        work_ready_.notify_all();
+    }
+
+    RunTasks(*batch);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    batch_done_.wait(lock, [&batch]() { return batch->completed.load() == batch->task_count; });
+    const auto position = std::find(batches_.begin(), batches_.end(), batch);
+    if (position != batches_.end()) {
+        batches_.erase(position);
+    }
+
+    if (batch->error) {
+        std::rethrow_exception(batch->error);
+    }
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        std::shared_ptr<Batch> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_ready_.wait(lock, [this]() { return stopping_ || !batches_.empty(); });
+            if (stopping_ && batches_.empty()) {
+                return;
+            }
+            batch = batches_.front();
+        }
+
+        RunTasks(*batch);
+
+        // 배분할 인덱스가 남지 않은 배치는 큐에서 내려 다른 배치가 앞에 오도록 한다.
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!batches_.empty() && batches_.front() == batch) {
+            batches_.pop_front();
+        }
+    }
+}
+
+void ThreadPool::RunTasks(Batch& batch) {
+    while (true) {
+        const std::size_t index = batch.next.fetch_add(1);
+        if (index >= batch.task_count) {
+            return;
+        }
+
+        try {
+            (*batch.task)(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!batch.error) {
+                batch.error = std::current_exception();
+            }
+        }
+
+        if (batch.completed.fetch_add(1) + 1 == batch.task_count) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            batch_done_.notify_all();
+        }
+    }
+}
+
+}  // namespace raytracer
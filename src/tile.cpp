@@ -0,0 +1,131 @@
+/*
+ * 설명: 임의 크기 직사각 격자를 덮는 일반화 힐베르트 곡선으로 타일 순서를 생성하고 행 우선 타일 인덱스를 계산한다.
+ * 버전: v1.3.0
+ * 관련 문서: design/renderer/v1.1.0-tile-threads.md, design/renderer/v1.3.0-shards.md
+ * 테스트: tests/unit/tile_test.cpp
+ */
+#include "raytracer/tile.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace raytracer {
+namespace {
+
+int Sign(int value) { return (value > 0) - (value < 0); }
+
+// 음수에서도 내림 나눗셈이 되도록 한다(곡선 분할이 원본 알고리즘과 일치해야 한다).
+int FloorHalf(int value) { return value >= 0 ? value / 2 : -((-value + 1) / 2); }
+
+struct GridCell {
+    int x = 0;
+    int y = 0;
+};
+
+// (x, y)에서 출발해 주축 (ax, ay), 보조축 (bx, by)로 펼쳐진 직사각형을 연속 경로로 방문한다.
+void Generate(int x, int y, int ax, int ay, int bx, int by, std::vector<GridCell>& cells) {
+    const int w = std::abs(ax + ay);
+    const int h = std::abs(bx + by);
+    const int dax = Sign(ax);
+    const int day = Sign(ay);
+    const int dbx = Sign(bx);
+    const int dby = Sign(by);
+
+    if (h == 1) {
+        for (int i = 0; i < w; ++i) {
+            cells.push_back({x, y});
+            x += dax;
+            y += day;
+        }
+        return;
+    }
+
+    if (w == 1) {
+        for (int i = 0; i < h; ++i) {
+            cells.push_back({x, y});
+            x += dbx;
+            y += dby;
+        }
+        return;
+    }
+
+    int ax2 = FloorHalf(ax);
+    int ay2 = FloorHalf(ay);
+    int bx2 = FloorHalf(bx);
+    int by2 = FloorHalf(by);
+    const int w2 = std::abs(ax2 + ay2);
+    const int h2 = std::abs(bx2 + by2);
+
+    if (2 * w > 3 * h) {
+        if ((w2 % 2 != 0) && (w > 2)) {
+            ax2 += dax;
+            ay2 += day;
+        }
+        Generate(x, y, ax2, ay2, bx, by, cells);
+        Generate(x + ax2, y + ay2, ax - ax2, ay - ay2, bx, by, cells);
+        return;
+    }
+
+    if ((h2 % 2 != 0) && (h > 2)) {
+        bx2 += dbx;
+        by2 += dby;
+    }
+    Generate(x, y, bx2, by2, ax2, ay2, cells);
+    Generate(x + bx2, y + by2, ax, ay, bx - bx2, by - by2, cells);
+    Generate(x + (ax - dax) + (bx2 - dbx), y + (ay - day) + (by2 - dby), -bx2, -by2, -(ax - ax2), -(ay - ay2), cells);
+}
+
+}  // namespace
+
+std::vector<Tile> BuildHilbertTiles(int width, int height, int tile_size) {
+    if (width < 1 || height < 1 || tile_size < 1) {
+        throw std::invalid_argument("타일 분할에는 1 이상의 해상도와 타일 크기가 필요하다.");
+    }
+
+    const int columns = (width + tile_size - 1) / tile_size;
+    const int rows = (height + tile_size - 1) / tile_size;
+
+    std::vector<GridCell> cells;
+    cells.reserve(static_cast<std::size_t>(columns) * static_cast<std::size_t>(rows));
+    if (columns >= rows) {
+        Generate(0, 0, columns, 0, 0, rows, cells);
+    } else {
+        Generate(0, 0, 0, rows, columns, 0, cells);
+    }
+
+    std::vector<Tile> tiles;
+    tiles.reserve(cells.size());
+    for (const GridCell& cell : cells) {
+        Tile tile;
+        tile.x0 = cell.x * tile_size;
+        tile.y0 = cell.y * tile_size;
+        tile.x1 = std::min(tile.x0 + tile_size, width);
+        tile.y1 = std::min(tile.y0 + tile_size, height);
+        tiles.push_back(tile);
+    }
+    return tiles;
+}
+
+int TileCount(int width, int height, int tile_size) {
+    if (width < 1 || height < 1 || tile_size < 1) {
+        throw std::invalid_argument("타일 분할에는 1 이상의 해상도와 타일 크기가 필요하다.");
+    }
+    return ((width + tile_size - 1) / tile_size) * ((height + tile_size - 1) / tile_size);
+}
+
+Tile TileAt(int index, int width, int height, int tile_size) {
+    if (index < 0 || index >= TileCount(width, height, tile_size)) {
+        throw std::out_of_range("타일 인덱스가 범위를 벗어났다.");
+    }
+
+    const int columns = (width + tile_size - 1) / tile_size;
+    Tile tile;
+    tile.x0 = (index % columns) * tile_size;
+    tile.y0 = (index / columns) * tile_size;
+    tile.x1 = std::min(tile.x0 + tile_size, width);
+    tile.y1 = std::min(tile.y0 + tile_size, height);
+    return tile;
+}
+
+}  // namespace raytracer
@@ -1,7 +1,8 @@
 /*
- * 설명: Hittable 객체에 평행 이동과 Y축 회전을 적용해 교차와 경계를 변환한다.
- * 버전: v0.9.0
- * 관련 문서: design/renderer/v0.8.0-cornell.md, design/renderer/v0.9.0-volume.md
+ * 설명: Hittable 객체에 평행 이동과 Y축 회전을 적용해 교차, 가림 판정, 경계를 변환한다.
+ * 버전: v1.20.0
+ * 관련 문서: design/renderer/v0.8.0-cornell.md, design/renderer/v0.9.0-volume.md, design/renderer/v1.9.0-animation.md,
+ *           design/renderer/v1.20.0-occlusion.md
  * 테스트: tests/unit/quad_test.cpp
  */
 #include "raytracer/transform.hpp"
@@ -13,7 +14,7 @@ namespace raytracer {
 
 Translate::Translate(std::shared_ptr<Hittable> object, const Vec3& offset) : object_(std::move(object)), offset_(offset) {}
 
-bool Translate::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const {
+bool Translate::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const {
     Ray moved_ray(r.origin() - offset_, r.direction(), r.time());
     if (!object_->Hit(moved_ray, t_min, t_max, record, generator)) {
         return false;
@@ -24,6 +25,10 @@ bool Translate::Hit(const Ray& r, double t_min, double t_max, HitRecord& record,
     return true;
 }
 
+bool Translate::Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const {
+    return object_->Occluded(Ray(r.origin() - offset_, r.direction(), r.time()), t_min, t_max, generator);
+}
+
 bool Translate::BoundingBox(double time0, double time1, Aabb& output_box) const {
     if (!object_->BoundingBox(time0, time1, output_box)) {
         return false;
@@ -34,6 +39,10 @@ bool Translate::BoundingBox(double time0, double time1, Aabb& output_box) const
 }
 
 RotateY::RotateY(std::shared_ptr<Hittable> object, double angle_degrees) : object_(std::move(object)) {
+    SetAngle(angle_degrees);
+}
+
+void RotateY::SetAngle(double angle_degrees) {
     const double radians = angle_degrees * 3.1415926535897932385 / 180.0;
     sin_theta_ = std::sin(radians);
     cos_theta_ = std::cos(radians);
@@ -70,7 +79,7 @@ RotateY::RotateY(std::shared_ptr<Hittable> object, double angle_degrees) : objec
     bbox_ = Aabb(min_point, max_point);
 }
 
-bool RotateY::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, std::mt19937& generator) const {
+Ray RotateY::ToObject(const Ray& r) const {
     const double orig_x = cos_theta_ * r.origin().x() - sin_theta_ * r.origin().z();
     const double orig_z = sin_theta_ * r.origin().x() + cos_theta_ * r.origin().z();
     const Point3 origin(orig_x, r.origin().y(), orig_z);
@@ -79,8 +88,11 @@ bool RotateY::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, s
     const double dir_z = sin_theta_ * r.direction().x() + cos_theta_ * r.direction().z();
     const Vec3 direction(dir_x, r.direction().y(), dir_z);
 
-    const Ray rotated_ray(origin, direction, r.time());
+    return Ray(origin, direction, r.time());
+}
 
+bool RotateY::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const {
+    const Ray rotated_ray = ToObject(r);
     if (!object_->Hit(rotated_ray, t_min, t_max, record, generator)) {
         return false;
     }
@@ -98,6 +110,10 @@ bool RotateY::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, s
     return true;
 }
 
+bool RotateY::Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const {
+    return object_->Occluded(ToObject(r), t_min, t_max, generator);
+}
+
 bool RotateY::BoundingBox(double /*time0*/, double /*time1*/, Aabb& output_box) const {
     if (!has_box_) {
         return false;
@@ -0,0 +1,320 @@
+/*
+ * 설명: 타일 경로들의 SoA 상태를 단계별 커널(생성, 교차와 압축, 재질 종류별 정렬과 음영, 광원 샘플링, 누적)로 처리하고,
+ *       경로마다 남긴 교차 기록을 재귀 적분기의 식으로 안쪽부터 접어 샘플 값을 만든다.
+ * 버전: v1.23.0
+ * 관련 문서: design/renderer/v1.22.0-wavefront.md, design/renderer/v1.23.0-tile-culling.md
+ * 테스트: tests/integration/ppm_integration_test.cpp
+ */
+#include "raytracer/wavefront.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+
+#include "raytracer/material.hpp"
+#include "raytracer/pdf.hpp"
+
+namespace raytracer {
+namespace {
+
+// 교차 기록 칸 수 상한(경로 수 x 최대 깊이). 깊이가 깊으면 한 번에 추적하는 경로 수를 줄인다.
+constexpr std::size_t kMaxBounceRecords = kWavefrontBatchSize * 32;
+
+// 경로가 교차 하나에서 남긴 기여의 모양. 누적 단계가 재귀 적분기의 식을 그대로 다시 쓴다.
+enum class BounceKind : std::uint8_t {
+    // 방출만 남기고 끝났다(재질 없음, 산란 없음, 산란 PDF 없음, 혼합 PDF 값 0).
+    kEmitted,
+    // emitted + attenuation * (다음 기여)
+    kSpecular,
+    // emitted + attenuation * scattering_pdf * (다음 기여) / pdf_value
+    kSampled,
+};
+
+// 경로 상태를 필드별 배열로 둔다. 경로 i의 b번째 교차 기록은 b * capacity + i 칸이어서 한 깊이의 기록이 모여 있다.
+struct PathBatch {
+    PathBatch(std::size_t capacity, int max_depth)
+        : capacity(capacity),
+          rays(capacity),
+          generators(capacity),
+          records(capacity),
+          pixels(capacity),
+          lengths(capacity),
+          scatter_pdfs(capacity),
+          material_keys(capacity),
+          emitted(capacity * static_cast<std::size_t>(max_depth)),
+          attenuation(capacity * static_cast<std::size_t>(max_depth)),
+          scattering_pdf(capacity * static_cast<std::size_t>(max_depth)),
+          pdf_value(capacity * static_cast<std::size_t>(max_depth)),
+          kinds(capacity * static_cast<std::size_t>(max_depth)) {}
+
+    std::size_t Slot(std::uint32_t path, int bounce) const {
+        return static_cast<std::size_t>(bounce) * capacity + static_cast<std::size_t>(path);
+    }
+
+    std::size_t capacity = 0;
+
+    // 경로별 상태. rays는 다음에 추적할 레이이고, 광원 샘플링 전까지는 방금 부딪힌 레이다.
+    std::vector<Ray> rays;
+    std::vector<Rng> generators;
+    std::vector<HitRecord> records;
+    std::vector<std::size_t> pixels;
+    // 남긴 교차 기록 수. 마지막 기록 뒤에 이어지는 기여(빗나감, 깊이 소진)는 검은색이다.
+    std::vector<int> lengths;
+    std::vector<std::shared_ptr<Pdf>> scatter_pdfs;
+    std::vector<std::uint32_t> material_keys;
+
+    // 교차별 기록.
+    std::vector<Color> emitted;
+    std::vector<Color> attenuation;
+    std::vector<double> scattering_pdf;
+    std::vector<double> pdf_value;
+    std::vector<BounceKind> kinds;
+
+    // 단계 사이에 넘기는 경로 번호 큐.
+    std::vector<std::uint32_t> active;
+    std::vector<std::uint32_t> sorted;
+    std::vector<std::uint32_t> light_queue;
+    std::vector<std::uint32_t> continuing;
+    std::vector<std::uint32_t> group_offsets;
+    std::unordered_map<const Material*, std::uint32_t> material_groups;
+    std::vector<const Material*> group_materials;
+    std::vector<std::uint32_t> group_order;
+    std::vector<std::uint32_t> group_rank;
+};
+
+// 타일의 first번째부터 count개 (픽셀, 샘플) 경로를 픽셀 행 우선, 픽셀 안에서는 샘플 순서로 만든다.
+void GeneratePaths(const RenderContext& context, const Tile& tile, std::size_t first, std::size_t count,
+                   PathBatch& batch) {
+    const auto samples = static_cast<std::size_t>(context.options.samples_per_pixel);
+    const auto width = static_cast<std::size_t>(tile.Width());
+    batch.active.clear();
+    for (std::uint32_t path = 0; path < count; ++path) {
+        const std::size_t pixel = (first + path) / samples;
+        const auto sample = static_cast<int>((first + path) % samples);
+        const int x = tile.x0 + static_cast<int>(pixel % width);
+        const int y = tile.y0 + static_cast<int>(pixel / width);
+        batch.rays[path] = PrimaryRay(context, x, y, sample, batch.generators[path]);
+        batch.pixels[path] = pixel;
+        batch.lengths[path] = 0;
+        batch.active.push_back(path);
+    }
+}
+
+// 살아 있는 경로의 가장 가까운 교차를 찾고 빗나간 경로를 큐에서 뺀다. 첫 교차는 primary_world(타일 절두체로 잘라 낸
+// 부분 구조일 수 있다)에서 찾는다. 이때 active가 0부터 이어진 번호이므로 packet_size개씩 잘라 HitPacket으로 함께
+// 순회한다(한 픽셀의 샘플들이 이웃해 화면 레이가 모인다).
+void IntersectPaths(const RenderContext& context, const Hittable& primary_world, int bounce, PathBatch& batch) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    const int packet_size = context.options.packet_size;
+    std::size_t kept = 0;
+
+    if (bounce == 0 && packet_size != 1) {
+        const std::size_t count = batch.active.size();
+        for (std::size_t begin = 0; begin < count; begin += static_cast<std::size_t>(packet_size)) {
+            const int size = static_cast<int>(std::min(count - begin, static_cast<std::size_t>(packet_size)));
+            const std::uint32_t hits = primary_world.HitPacket(&batch.rays[begin], size, kHitEpsilon, infinity,
+                                                               &batch.records[begin], &batch.generators[begin]);
+            for (int i = 0; i < size; ++i) {
+                if ((hits & (1u << i)) != 0) {
+                    batch.active[kept++] = static_cast<std::uint32_t>(begin) + static_cast<std::uint32_t>(i);
+                }
+            }
+        }
+    } else {
+        const Hittable& world = bounce == 0 ? primary_world : context.world;
+        for (const std::uint32_t path : batch.active) {
+            if (world.Hit(batch.rays[path], kHitEpsilon, infinity, batch.records[path], batch.generators[path])) {
+                batch.active[kept++] = path;
+            }
+        }
+    }
+    batch.active.resize(kept);
+}
+
+// 살아 있는 경로를 재질 종류(동적 타입), 같은 종류 안에서는 재질 객체별로 모은다. 같은 재질 안에서는 원래 순서를 지킨다.
+void SortByMaterial(PathBatch& batch) {
+    batch.material_groups.clear();
+    batch.group_materials.clear();
+    const Material* previous = nullptr;
+    std::uint32_t previous_key = 0;
+    bool has_previous = false;
+    for (const std::uint32_t path : batch.active) {
+        const Material* material = batch.records[path].material.get();
+        if (!has_previous || material != previous) {
+            const auto [entry, inserted] =
+                batch.material_groups.emplace(material, static_cast<std::uint32_t>(batch.group_materials.size()));
+            if (inserted) {
+                batch.group_materials.push_back(material);
+            }
+            previous = material;
+            previous_key = entry->second;
+            has_previous = true;
+        }
+        batch.material_keys[path] = previous_key;
+    }
+
+    // 재질 수는 경로 수보다 훨씬 적으므로 재질끼리만 비교 정렬하고 경로는 계수 정렬로 옮긴다.
+    const std::size_t group_count = batch.group_materials.size();
+    std::vector<std::uint32_t>& order = batch.group_order;
+    order.resize(group_count);
+    std::iota(order.begin(), order.end(), 0u);
+    const auto type_of = [](const Material* material) {
+        return material ? std::type_index(typeid(*material)) : std::type_index(typeid(void));
+    };
+    std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+        const Material* left = batch.group_materials[a];
+        const Material* right = batch.group_materials[b];
+        if (type_of(left) != type_of(right)) {
+            return type_of(left) < type_of(right);
+        }
+        return std::less<const Material*>()(left, right);
+    });
+
+    std::vector<std::uint32_t>& rank = batch.group_rank;
+    rank.resize(group_count);
+    for (std::uint32_t position = 0; position < group_count; ++position) {
+        rank[order[position]] = position;
+    }
+    batch.group_offsets.assign(group_count + 1, 0u);
+    for (const std::uint32_t path : batch.active) {
+        ++batch.group_offsets[rank[batch.material_keys[path]] + 1];
+    }
+    std::partial_sum(batch.group_offsets.begin(), batch.group_offsets.end(), batch.group_offsets.begin());
+    batch.sorted.resize(batch.active.size());
+    for (const std::uint32_t path : batch.active) {
+        batch.sorted[batch.group_offsets[rank[batch.material_keys[path]]]++] = path;
+    }
+    batch.active.swap(batch.sorted);
+}
+
+// 정렬된 순서로 방출과 산란을 계산한다. 거울 반사 경로는 바로 다음 깊이로 넘기고, 산란 PDF가 있는 경로는 광원 샘플링
+// 큐로 보낸다. 나머지는 방출만 남기고 끝난다.
+void ShadeByMaterial(int bounce, PathBatch& batch) {
+    batch.light_queue.clear();
+    batch.continuing.clear();
+    for (const std::uint32_t path : batch.active) {
+        const HitRecord& record = batch.records[path];
+        const std::size_t slot = batch.Slot(path, bounce);
+        batch.lengths[path] = bounce + 1;
+        batch.kinds[slot] = BounceKind::kEmitted;
+        batch.emitted[slot] = (record.material && record.front_face) ? record.material->Emitted(record.u, record.v, record.p)
+                                                                     : Color(0.0, 0.0, 0.0);
+        if (!record.material) {
+            continue;
+        }
+
+        ScatterRecord scatter_record;
+        if (!record.material->Scatter(batch.rays[path], record, scatter_record, batch.generators[path])) {
+            continue;
+        }
+
+        if (scatter_record.is_specular) {
+            batch.kinds[slot] = BounceKind::kSpecular;
+            batch.attenuation[slot] = scatter_record.attenuation;
+            batch.rays[path] = scatter_record.specular_ray;
+            batch.continuing.push_back(path);
+            continue;
+        }
+
+        if (!scatter_record.pdf) {
+            continue;
+        }
+        batch.attenuation[slot] = scatter_record.attenuation;
+        batch.scatter_pdfs[path] = std::move(scatter_record.pdf);
+        batch.light_queue.push_back(path);
+    }
+}
+
+// 광원 PDF와 재질 PDF의 혼합에서 다음 방향을 뽑고 두 PDF 값을 기록한다.
+void SampleLights(const RenderContext& context, int bounce, PathBatch& batch) {
+    for (const std::uint32_t path : batch.light_queue) {
+        const HitRecord& record = batch.records[path];
+        const Ray& r = batch.rays[path];
+        const std::size_t slot = batch.Slot(path, bounce);
+        Rng& generator = batch.generators[path];
+
+        std::shared_ptr<Pdf> scatter_pdf = std::move(batch.scatter_pdfs[path]);
+        std::shared_ptr<Pdf> light_pdf = context.lights ? std::make_shared<HittablePdf>(context.lights, record.p) : nullptr;
+        std::shared_ptr<Pdf> mixed_pdf = light_pdf ? std::make_shared<MixturePdf>(light_pdf, scatter_pdf) : scatter_pdf;
+
+        const Vec3 direction = mixed_pdf->Generate(generator);
+        const Ray scattered(record.p, direction, r.time());
+        const double pdf_value = mixed_pdf->Value(scattered.direction());
+        if (pdf_value <= 0.0) {
+            continue;
+        }
+
+        batch.kinds[slot] = BounceKind::kSampled;
+        batch.pdf_value[slot] = pdf_value;
+        batch.scattering_pdf[slot] = record.material->ScatteringPdf(r, record, scattered);
+        batch.rays[path] = scattered;
+        batch.continuing.push_back(path);
+    }
+}
+
+// 경로마다 교차 기록을 마지막부터 접어 재귀 적분기와 같은 연산 순서로 샘플 값을 만들고, 경로 순서(픽셀마다 샘플 0부터)로
+// 타일 합에 더한다.
+void AccumulatePaths(std::size_t count, PathBatch& batch, std::vector<Color>& local) {
+    for (std::uint32_t path = 0; path < count; ++path) {
+        Color value(0.0, 0.0, 0.0);
+        for (int bounce = batch.lengths[path] - 1; bounce >= 0; --bounce) {
+            const std::size_t slot = batch.Slot(path, bounce);
+            switch (batch.kinds[slot]) {
+            case BounceKind::kEmitted:
+                value = batch.emitted[slot];
+                break;
+            case BounceKind::kSpecular:
+                value = batch.emitted[slot] + batch.attenuation[slot] * value;
+                break;
+            case BounceKind::kSampled:
+                value = batch.emitted[slot] + batch.attenuation[slot] * batch.scattering_pdf[slot] * value /
+                                                  batch.pdf_value[slot];
+                break;
+            }
+        }
+        local[batch.pixels[path]] += value;
+    }
+}
+
+}  // namespace
+
+std::vector<Color> RenderTileSumsWavefront(const RenderContext& context, const Tile& tile) {
+    const RenderOptions& options = context.options;
+    if (options.packet_size != 1 && options.packet_size != 4 && options.packet_size != 8 && options.packet_size != 16) {
+        throw std::invalid_argument("레이 묶음 크기는 1, 4, 8, 16 중 하나여야 한다.");
+    }
+
+    const std::size_t pixel_count = static_cast<std::size_t>(tile.Width()) * static_cast<std::size_t>(tile.Height());
+    std::vector<Color> local(pixel_count);
+    const int max_depth = std::max(options.max_depth, 1);
+    const std::size_t path_count = pixel_count * static_cast<std::size_t>(options.samples_per_pixel);
+    const std::size_t depth_limited = std::max(kMaxBounceRecords / static_cast<std::size_t>(max_depth), std::size_t{1});
+    const std::size_t capacity = std::min({path_count, depth_limited, kWavefrontBatchSize});
+    PathBatch batch(capacity, max_depth);
+    const std::unique_ptr<Hittable> culled = CullTileWorld(context, tile);
+    const Hittable& primary_world = culled ? *culled : context.world;
+
+    for (std::size_t first = 0; first < path_count; first += capacity) {
+        const std::size_t count = std::min(capacity, path_count - first);
+        GeneratePaths(context, tile, first, count, batch);
+        for (int bounce = 0; bounce < options.max_depth && !batch.active.empty(); ++bounce) {
+            IntersectPaths(context, primary_world, bounce, batch);
+            SortByMaterial(batch);
+            ShadeByMaterial(bounce, batch);
+            SampleLights(context, bounce, batch);
+            batch.active.swap(batch.continuing);
+        }
+        AccumulatePaths(count, batch, local);
+    }
+    return local;
+}
+
+}  // namespace raytracer
@@ -0,0 +1,660 @@
+/*
+ * 설명: 이진 BvhNode 트리를 BVH4/BVH8로 접고, 자식 상자 교차를 AVX(4칸) 또는 SSE2(2칸) 단위로 계산해
+ *       진입 거리 순으로 가까운 자식부터 순회한다. SIMD가 없으면 같은 연산을 스칼라로 수행한다.
+ *       순회 카운터를 켠 빌드에서만 레이·방문 노드·잎 도형 검사 수를 센다. 가림 판정은 처음 찾은 교차에서 멈춘다.
+ *       레이 묶음은 노드를 함께 방문하되 레이마다 단일 순회와 같은 순서로 도형을 검사한다.
+ *       절두체로 자른 부분 트리는 남은 칸의 순서를 유지해 절두체 안 레이의 방문 순서를 바꾸지 않는다.
+ *       지연 빌드 트리는 남은 노드를 모두 나눈 뒤 접는다.
+ * 버전: v1.24.0
+ * 관련 문서: design/renderer/v1.12.0-wide-bvh.md, design/renderer/v1.18.0-bvh-cache.md,
+ *           design/renderer/v1.19.0-bvh-stats.md, design/renderer/v1.20.0-occlusion.md,
+ *           design/renderer/v1.21.0-ray-packets.md, design/renderer/v1.23.0-tile-culling.md,
+ *           design/renderer/v1.24.0-lazy-bvh.md
+ * 테스트: tests/unit/bvh_test.cpp
+ */
+#include "raytracer/wide_bvh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "raytracer/bvh_stats.hpp"
+#include "raytracer/hittable_list.hpp"
+
+#include "bvh_float_util.hpp"
+
+namespace raytracer {
+namespace {
+
+using detail::RoundDown;
+using detail::RoundUp;
+using detail::SurfaceArea;
+
+constexpr int kStackSize = 128;
+
+Aabb ChildBox(const std::shared_ptr<Hittable>& child, double time0, double time1) {
+    Aabb box;
+    if (!child->BoundingBox(time0, time1, box)) {
+        throw std::runtime_error("넓은 BVH 구성 중 경계 상자를 계산할 수 없다.");
+    }
+    return box;
+}
+
+// 모든 칸이 빈(어떤 레이도 닿지 않는 뒤집힌 상자) 노드.
+template <int Width>
+WideBvhNode<Width> EmptyNode() {
+    WideBvhNode<Width> node{};
+    constexpr float kInf = std::numeric_limits<float>::infinity();
+    std::fill(std::begin(node.min_x), std::end(node.min_x), kInf);
+    std::fill(std::begin(node.min_y), std::end(node.min_y), kInf);
+    std::fill(std::begin(node.min_z), std::end(node.min_z), kInf);
+    std::fill(std::begin(node.max_x), std::end(node.max_x), -kInf);
+    std::fill(std::begin(node.max_y), std::end(node.max_y), -kInf);
+    std::fill(std::begin(node.max_z), std::end(node.max_z), -kInf);
+    return node;
+}
+
+// source[index]에서 frustum 밖 칸을 지우고 남은 자식을 같은 칸 순서로 담은 노드를 nodes에 전위 순서로 붙인다.
+// 내부 노드 자식 하나만 남으면 노드를 만들지 않고 그 자식의 결과를 돌려준다. 남는 칸이 없으면 -1이다.
+// 자식 상자는 부모 칸 상자 안에 있으므로, 건너뛴 노드의 칸 상자를 빗나간 레이는 그 아래 자식 상자도 빗나간다.
+template <int Width>
+std::int32_t CullNode(const WideBvhNode<Width>* source, std::int32_t index, const Frustum& frustum, int depth,
+                      std::vector<WideBvhNode<Width>>& nodes, int& max_depth) {
+    const WideBvhNode<Width>& node = source[static_cast<std::size_t>(index)];
+    int kept[Width];
+    int kept_count = 0;
+    for (int lane = 0; lane < node.lane_count; ++lane) {
+        if (!frustum.Excludes(Point3(node.min_x[lane], node.min_y[lane], node.min_z[lane]),
+                              Point3(node.max_x[lane], node.max_y[lane], node.max_z[lane]))) {
+            kept[kept_count++] = lane;
+        }
+    }
+    if (kept_count == 0) {
+        return -1;
+    }
+    if (kept_count == 1 && node.child[kept[0]] >= 0) {
+        return CullNode(source, node.child[kept[0]], frustum, depth, nodes, max_depth);
+    }
+
+    const auto culled_index = static_cast<std::int32_t>(nodes.size());
+    nodes.emplace_back();
+    WideBvhNode<Width> culled = EmptyNode<Width>();
+    for (int k = 0; k < kept_count; ++k) {
+        const int lane = kept[k];
+        std::int32_t child = node.child[lane];
+        if (child >= 0) {
+            child = CullNode(source, child, frustum, depth + 1, nodes, max_depth);
+            if (child < 0) {
+                continue;
+            }
+        }
+        const int slot = culled.lane_count++;
+        culled.min_x[slot] = node.min_x[lane];
+        culled.min_y[slot] = node.min_y[lane];
+        culled.min_z[slot] = node.min_z[lane];
+        culled.max_x[slot] = node.max_x[lane];
+        culled.max_y[slot] = node.max_y[lane];
+        culled.max_z[slot] = node.max_z[lane];
+        culled.child[slot] = child;
+        culled.count[slot] = node.count[lane];
+    }
+    // 남은 칸이 모두 빈 부분 트리였다면 그 자식들은 스스로 지워졌으므로 이 노드가 마지막 자리다.
+    if (culled.lane_count == 0) {
+        nodes.pop_back();
+        return -1;
+    }
+    max_depth = std::max(max_depth, depth);
+    nodes[static_cast<std::size_t>(culled_index)] = culled;
+    return culled_index;
+}
+
+// 축마다 레이 방향 부호에 따라 진입/진출 쪽 경계 배열을 고른다. Aabb::Hit의 "음수 방향이면 t0/t1 교환"과 같다.
+struct LaneRay {
+    double origin[3];
+    double inv_dir[3];
+    bool negative[3];
+};
+
+template <int Width>
+void SelectPlanes(const WideBvhNode<Width>& node, const LaneRay& ray, const float* near_planes[3],
+                  const float* far_planes[3]) {
+    const float* minimum[3] = {node.min_x, node.min_y, node.min_z};
+    const float* maximum[3] = {node.max_x, node.max_y, node.max_z};
+    for (int axis = 0; axis < 3; ++axis) {
+        near_planes[axis] = ray.negative[axis] ? maximum[axis] : minimum[axis];
+        far_planes[axis] = ray.negative[axis] ? minimum[axis] : maximum[axis];
+    }
+}
+
+// 교차한 칸의 비트마스크를 반환하고 칸별 진입 거리를 t_entry에 기록한다.
+// 모든 경로가 스칼라 판정(t0 > t_min ? t0 : t_min, t1 < t_max ? t1 : t_max, t_min < t_max)과 같은 double 연산을 한다.
+template <int Width>
+unsigned IntersectLanes(const WideBvhNode<Width>& node, const LaneRay& ray, double t_min, double t_max,
+                        double* t_entry) {
+    const float* near_planes[3];
+    const float* far_planes[3];
+    SelectPlanes(node, ray, near_planes, far_planes);
+    unsigned mask = 0;
+
+#if defined(__AVX__)
+    for (int group = 0; group < Width; group += 4) {
+        __m256d low = _mm256_set1_pd(t_min);
+        __m256d high = _mm256_set1_pd(t_max);
+        for (int axis = 0; axis < 3; ++axis) {
+            const __m256d origin = _mm256_set1_pd(ray.origin[axis]);
+            const __m256d inv_dir = _mm256_set1_pd(ray.inv_dir[axis]);
+            const __m256d near_plane = _mm256_cvtps_pd(_mm_loadu_ps(near_planes[axis] + group));
+            const __m256d far_plane = _mm256_cvtps_pd(_mm_loadu_ps(far_planes[axis] + group));
+            // max/min_pd는 첫 피연산자가 NaN이면 두 번째를 돌려주므로 스칼라 삼항 연산과 같다.
+            low = _mm256_max_pd(_mm256_mul_pd(_mm256_sub_pd(near_plane, origin), inv_dir), low);
+            high = _mm256_min_pd(_mm256_mul_pd(_mm256_sub_pd(far_plane, origin), inv_dir), high);
+        }
+        _mm256_storeu_pd(t_entry + group, low);
+        mask |= static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(low, high, _CMP_LT_OQ))) << group;
+    }
+#elif defined(__SSE2__)
+    for (int group = 0; group < Width; group += 2) {
+        __m128d low = _mm_set1_pd(t_min);
+        __m128d high = _mm_set1_pd(t_max);
+        for (int axis = 0; axis < 3; ++axis) {
+            const __m128d origin = _mm_set1_pd(ray.origin[axis]);
+            const __m128d inv_dir = _mm_set1_pd(ray.inv_dir[axis]);
+            const __m128d near_plane = _mm_cvtps_pd(
+                _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(near_planes[axis] + group))));
+            const __m128d far_plane = _mm_cvtps_pd(
+                _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(far_planes[axis] + group))));
+            low = _mm_max_pd(_mm_mul_pd(_mm_sub_pd(near_plane, origin), inv_dir), low);
+            high = _mm_min_pd(_mm_mul_pd(_mm_sub_pd(far_plane, origin), inv_dir), high);
+        }
+        _mm_storeu_pd(t_entry + group, low);
+        mask |= static_cast<unsigned>(_mm_movemask_pd(_mm_cmplt_pd(low, high))) << group;
+    }
+#else
+    for (int lane = 0; lane < Width; ++lane) {
+        double low = t_min;
+        double high = t_max;
+        for (int axis = 0; axis < 3; ++axis) {
+            const double t0 = (static_cast<double>(near_planes[axis][lane]) - ray.origin[axis]) * ray.inv_dir[axis];
+            const double t1 = (static_cast<double>(far_planes[axis][lane]) - ray.origin[axis]) * ray.inv_dir[axis];
+            low = t0 > low ? t0 : low;
+            high = t1 < high ? t1 : high;
+        }
+        t_entry[lane] = low;
+        if (low < high) {
+            mask |= 1u << lane;
+        }
+    }
+#endif
+
+    return mask & ((1u << node.lane_count) - 1u);
+}
+
+struct StackEntry {
+    std::int32_t child;
+    std::uint16_t count;
+    double t_entry;
+};
+
+LaneRay MakeLaneRay(const Ray& r) {
+    LaneRay ray{};
+    for (int axis = 0; axis < 3; ++axis) {
+        ray.origin[axis] = r.origin()[axis];
+        ray.inv_dir[axis] = 1.0 / r.direction()[axis];
+        ray.negative[axis] = ray.inv_dir[axis] < 0.0;
+    }
+    return ray;
+}
+
+// 교차한 칸을 진입 거리 내림차순(같으면 칸 번호 오름차순)으로 hits에 정렬해 담는다. 그대로 쌓으면 가장 가까운 칸이
+// 먼저 나온다.
+template <int Width>
+int SortHitLanes(const WideBvhNode<Width>& node, unsigned mask, const double* t_entry, StackEntry* hits) {
+    int hit_count = 0;
+    while (mask != 0) {
+        const int lane = __builtin_ctz(mask);
+        mask &= mask - 1;
+        const StackEntry candidate{node.child[lane], node.count[lane], t_entry[lane]};
+        int position = hit_count++;
+        while (position > 0 && hits[position - 1].t_entry < candidate.t_entry) {
+            hits[position] = hits[position - 1];
+            --position;
+        }
+        hits[position] = candidate;
+    }
+    return hit_count;
+}
+
+// 레이 하나의 가장 가까운 교차 순회. stack[0, stack_size)와 closest, hit_anything은 지금까지의 순회 상태이며,
+// 묶음 순회에서 떨어져 나온 레이도 같은 상태에서 이어 가므로 처음부터 혼자 순회한 것과 같은 순서로 도형을 검사한다.
+template <int Width>
+bool TraverseClosest(const WideBvhNode<Width>* nodes, const std::vector<std::shared_ptr<Hittable>>& primitives,
+                     const Ray& r, const LaneRay& ray, double t_min, double closest, bool hit_anything,
+                     StackEntry* stack, int stack_size, HitRecord& record, Rng& generator) {
+    alignas(32) double t_entry[Width];
+    StackEntry hits[Width];
+    while (stack_size > 0) {
+        const StackEntry entry = stack[--stack_size];
+        if (entry.t_entry >= closest) {
+            continue;
+        }
+
+        if (entry.child < 0) {
+            const auto begin = primitives.begin() + (-entry.child - 1);
+            RAYTRACER_BVH_COUNT(primitives_tested, entry.count);
+            for (auto it = begin; it != begin + entry.count; ++it) {
+                if ((*it)->Hit(r, t_min, closest, record, generator)) {
+                    hit_anything = true;
+                    closest = record.t;
+                }
+            }
+            continue;
+        }
+
+        RAYTRACER_BVH_COUNT(nodes_visited, 1);
+        const WideBvhNode<Width>& node = nodes[static_cast<std::size_t>(entry.child)];
+        const int hit_count = SortHitLanes(node, IntersectLanes(node, ray, t_min, closest, t_entry), t_entry, hits);
+        for (int i = 0; i < hit_count; ++i) {
+            stack[stack_size++] = hits[i];
+        }
+    }
+    return hit_anything;
+}
+
+// 묶음 스택 항목: 자식 하나와, 그 자식을 아직 방문해야 하는 레이 비트마스크, 레이별 진입 거리.
+struct PacketEntry {
+    std::int32_t child;
+    std::uint16_t count;
+    std::uint32_t rays;
+    double t_entry[kMaxPacketSize];
+};
+
+}  // namespace
+
+template <int Width>
+WideBvh<Width>::WideBvh(const BvhNode& tree, double time0, double time1) : root_box_(tree.box_) {
+    tree.BuildAll();
+    auto nodes = std::make_shared<std::vector<WideBvhNode<Width>>>();
+    auto primitives = std::make_shared<std::vector<std::shared_ptr<Hittable>>>();
+    AppendNode(tree, time0, time1, 1, *nodes, *primitives);
+    nodes_ = nodes->data();
+    node_count_ = nodes->size();
+    storage_ = std::move(nodes);
+    primitives_ = std::move(primitives);
+}
+
+template <int Width>
+WideBvh<Width>::WideBvh(std::vector<std::shared_ptr<Hittable>> objects, double time0, double time1,
+                        const BvhBuildOptions& options)
+    : WideBvh(BvhNode(std::move(objects), time0, time1, options), time0, time1) {}
+
+template <int Width>
+WideBvh<Width>::WideBvh(std::shared_ptr<const void> storage, const WideBvhNode<Width>* nodes, std::size_t node_count,
+                        std::vector<std::shared_ptr<Hittable>> primitives, const Aabb& root_box, int depth)
+    : storage_(std::move(storage)),
+      nodes_(nodes),
+      node_count_(node_count),
+      primitives_(std::make_shared<const std::vector<std::shared_ptr<Hittable>>>(std::move(primitives))),
+      root_box_(root_box),
+      depth_(depth) {}
+
+// 이진 노드의 두 자식에서 시작해 표면적이 가장 큰 내부 노드 칸을 그 자식 둘로 바꾸기를 Width칸이 찰 때까지 반복한다.
+template <int Width>
+void WideBvh<Width>::CollectLanes(const BvhNode& node, double time0, double time1, std::vector<Lane>& lanes) const {
+    const auto make_lane = [time0, time1](const std::shared_ptr<Hittable>& child, BvhNode::ChildKind kind) {
+        const Aabb box = kind == BvhNode::ChildKind::kNode ? static_cast<const BvhNode&>(*child).box_
+                                                           : ChildBox(child, time0, time1);
+        return Lane{box, child, kind};
+    };
+
+    lanes.clear();
+    lanes.push_back(make_lane(node.left_, node.left_kind_));
+    if (node.right_ != node.left_) {
+        lanes.push_back(make_lane(node.right_, node.right_kind_));
+    }
+
+    while (lanes.size() < static_cast<std::size_t>(Width)) {
+        int widest = -1;
+        double widest_area = -1.0;
+        for (std::size_t i = 0; i < lanes.size(); ++i) {
+            if (lanes[i].kind == BvhNode::ChildKind::kNode && SurfaceArea(lanes[i].box) > widest_area) {
+                widest = static_cast<int>(i);
+                widest_area = SurfaceArea(lanes[i].box);
+            }
+        }
+        if (widest < 0) {
+            break;
+        }
+
+        const BvhNode& expanded = static_cast<const BvhNode&>(*lanes[static_cast<std::size_t>(widest)].object);
+        lanes[static_cast<std::size_t>(widest)] = make_lane(expanded.left_, expanded.left_kind_);
+        lanes.push_back(make_lane(expanded.right_, expanded.right_kind_));
+    }
+}
+
+template <int Width>
+std::int32_t WideBvh<Width>::AppendNode(const BvhNode& node, double time0, double time1, int depth,
+                                        std::vector<WideBvhNode<Width>>& nodes,
+                                        std::vector<std::shared_ptr<Hittable>>& primitives) {
+    if (nodes.size() >= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+        throw std::runtime_error("넓은 BVH 노드 수가 인덱스 범위를 넘었다.");
+    }
+    depth_ = std::max(depth_, depth);
+    const auto index = static_cast<std::int32_t>(nodes.size());
+    nodes.emplace_back();
+
+    std::vector<Lane> lanes;
+    CollectLanes(node, time0, time1, lanes);
+
+    WideBvhNode<Width> wide = EmptyNode<Width>();
+    wide.lane_count = static_cast<std::uint8_t>(lanes.size());
+
+    for (std::size_t lane = 0; lane < lanes.size(); ++lane) {
+        const Aabb& box = lanes[lane].box;
+        wide.min_x[lane] = RoundDown(box.minimum().x());
+        wide.min_y[lane] = RoundDown(box.minimum().y());
+        wide.min_z[lane] = RoundDown(box.minimum().z());
+        wide.max_x[lane] = RoundUp(box.maximum().x());
+        wide.max_y[lane] = RoundUp(box.maximum().y());
+        wide.max_z[lane] = RoundUp(box.maximum().z());
+
+        if (lanes[lane].kind == BvhNode::ChildKind::kNode) {
+            wide.child[lane] =
+                AppendNode(static_cast<const BvhNode&>(*lanes[lane].object), time0, time1, depth + 1, nodes, primitives);
+            continue;
+        }
+
+        const std::size_t first = primitives.size();
+        if (lanes[lane].kind == BvhNode::ChildKind::kLeafList) {
+            const auto& objects = static_cast<const HittableList&>(*lanes[lane].object).Objects();
+            primitives.insert(primitives.end(), objects.begin(), objects.end());
+        } else {
+            primitives.push_back(lanes[lane].object);
+        }
+        const std::size_t count = primitives.size() - first;
+        if (count > std::numeric_limits<std::uint16_t>::max() ||
+            first >= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+            throw std::runtime_error("넓은 BVH 잎 객체 수 또는 객체 인덱스가 범위를 넘었다.");
+        }
+        wide.child[lane] = -static_cast<std::int32_t>(first) - 1;
+        wide.count[lane] = static_cast<std::uint16_t>(count);
+    }
+
+    nodes[static_cast<std::size_t>(index)] = wide;
+    return index;
+}
+
+// 꺼낼 때 진입 거리가 이미 찾은 가장 가까운 교차 이상이면 건너뛴다(그 시점에 상자를 다시 검사해도 빗나가므로 결과는 같다).
+template <int Width>
+bool WideBvh<Width>::Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const {
+    RAYTRACER_BVH_COUNT(rays, 1);
+    const LaneRay ray = MakeLaneRay(r);
+
+    StackEntry local_stack[kStackSize];
+    std::vector<StackEntry> deep_stack;
+    StackEntry* stack = local_stack;
+    const int stack_limit = depth_ * (Width - 1) + 1;
+    if (stack_limit > kStackSize) {
+        deep_stack.resize(static_cast<std::size_t>(stack_limit));
+        stack = deep_stack.data();
+    }
+
+    stack[0] = StackEntry{0, 0, -std::numeric_limits<double>::infinity()};
+    return TraverseClosest(nodes_, *primitives_, r, ray, t_min, t_max, false, stack, 1, record, generator);
+}
+
+// 레이마다 단일 순회와 같은 순서로 도형을 검사해야 볼륨처럼 난수를 쓰는 도형까지 결과가 같다. 그래서 묶음이 노드의
+// 자식을 쌓는 공통 순서(레이별 진입 거리 평균 내림차순)가 어떤 레이의 자기 순서와 어긋나면, 그 레이는 그 자리에서
+// 묶음 스택 중 자기 몫만 옮겨 단일 순회로 끝낸다. 나머지 레이에게는 자기 몫 항목만 꺼낸 스택이 단일 순회 스택과 같다.
+template <int Width>
+std::uint32_t WideBvh<Width>::HitPacket(const Ray* rays, int count, double t_min, double t_max, HitRecord* records,
+                                        Rng* generators) const {
+    if (count < 1 || count > kMaxPacketSize) {
+        throw std::invalid_argument("레이 묶음 크기는 1 이상 16 이하여야 한다.");
+    }
+    RAYTRACER_BVH_COUNT(rays, static_cast<std::uint64_t>(count));
+
+    LaneRay lane_rays[kMaxPacketSize];
+    double closest[kMaxPacketSize];
+    for (int i = 0; i < count; ++i) {
+        lane_rays[i] = MakeLaneRay(rays[i]);
+        closest[i] = t_max;
+    }
+
+    PacketEntry local_stack[kStackSize];
+    StackEntry local_single_stack[kStackSize];
+    std::vector<PacketEntry> deep_stack;
+    std::vector<StackEntry> deep_single_stack;
+    PacketEntry* stack = local_stack;
+    StackEntry* single_stack = local_single_stack;
+    const int stack_limit = depth_ * (Width - 1) + 1;
+    if (stack_limit > kStackSize) {
+        deep_stack.resize(static_cast<std::size_t>(stack_limit));
+        deep_single_stack.resize(static_cast<std::size_t>(stack_limit));
+        stack = deep_stack.data();
+        single_stack = deep_single_stack.data();
+    }
+
+    int stack_size = 0;
+    PacketEntry& root = stack[stack_size++];
+    root.child = 0;
+    root.count = 0;
+    root.rays = (1u << count) - 1u;
+    std::fill(std::begin(root.t_entry), std::end(root.t_entry), -std::numeric_limits<double>::infinity());
+
+    alignas(32) double t_entry[kMaxPacketSize][Width];
+    unsigned lane_masks[kMaxPacketSize];
+    std::uint32_t hit_rays = 0;
+    std::uint32_t detached = 0;
+
+    while (stack_size > 0) {
+        // 이 항목 자리는 아래에서 자식을 쌓을 때 덮이므로 참조는 자식을 쌓기 전까지만 쓴다.
+        const PacketEntry& entry = stack[--stack_size];
+        std::uint32_t active = 0;
+        for (std::uint32_t pending = entry.rays & ~detached; pending != 0; pending &= pending - 1) {
+            const int i = __builtin_ctz(pending);
+            if (entry.t_entry[i] < closest[i]) {
+                active |= 1u << i;
+            }
+        }
+        if (active == 0) {
+            continue;
+        }
+
+        if (entry.child < 0) {
+            const auto begin = primitives_->begin() + (-entry.child - 1);
+            for (std::uint32_t pending = active; pending != 0; pending &= pending - 1) {
+                const int i = __builtin_ctz(pending);
+                RAYTRACER_BVH_COUNT(primitives_tested, entry.count);
+                for (auto it = begin; it != begin + entry.count; ++it) {
+                    if ((*it)->Hit(rays[i], t_min, closest[i], records[i], generators[i])) {
+                        hit_rays |= 1u << i;
+                        closest[i] = records[i].t;
+                    }
+                }
+            }
+            continue;
+        }
+
+        const WideBvhNode<Width>& node = nodes_[static_cast<std::size_t>(entry.child)];
+        unsigned any_lane = 0;
+        double key_sum[Width] = {};
+        int key_count[Width] = {};
+        for (std::uint32_t pending = active; pending != 0; pending &= pending - 1) {
+            const int i = __builtin_ctz(pending);
+            RAYTRACER_BVH_COUNT(nodes_visited, 1);
+            lane_masks[i] = IntersectLanes(node, lane_rays[i], t_min, closest[i], t_entry[i]);
+            any_lane |= lane_masks[i];
+            for (unsigned lanes = lane_masks[i]; lanes != 0; lanes &= lanes - 1) {
+                const int lane = __builtin_ctz(lanes);
+                key_sum[lane] += t_entry[i][lane];
+                ++key_count[lane];
+            }
+        }
+        // 모든 레이가 빗나간 자식만 건너뛴다.
+        if (any_lane == 0) {
+            continue;
+        }
+
+        // 공통 순서: 평균 진입 거리 내림차순, 같으면 칸 번호 오름차순(단일 순회의 쌓는 순서와 같은 규칙).
+        int order[Width];
+        double order_key[Width];
+        int order_count = 0;
+        for (unsigned lanes = any_lane; lanes != 0; lanes &= lanes - 1) {
+            const int lane = __builtin_ctz(lanes);
+            const double key = key_sum[lane] / key_count[lane];
+            int position = order_count++;
+            while (position > 0 && order_key[position - 1] < key) {
+                order[position] = order[position - 1];
+                order_key[position] = order_key[position - 1];
+                --position;
+            }
+            order[position] = lane;
+            order_key[position] = key;
+        }
+
+        for (std::uint32_t pending = active; pending != 0; pending &= pending - 1) {
+            const int i = __builtin_ctz(pending);
+            bool agrees = true;
+            int previous = -1;
+            for (int k = 0; k < order_count && agrees; ++k) {
+                const int lane = order[k];
+                if ((lane_masks[i] & (1u << lane)) == 0) {
+                    continue;
+                }
+                if (previous >= 0) {
+                    const double before = t_entry[i][previous];
+                    const double current = t_entry[i][lane];
+                    agrees = before > current || (before == current && previous < lane);
+                }
+                previous = lane;
+            }
+            if (agrees) {
+                continue;
+            }
+
+            // 아직 방문하지 않은 자기 몫 항목을 같은 순서로 옮기고, 이 노드의 자식은 자기 순서로 쌓아 혼자 이어 간다.
+            int single_size = 0;
+            for (int k = 0; k < stack_size; ++k) {
+                if ((stack[k].rays & (1u << i)) != 0) {
+                    single_stack[single_size++] = StackEntry{stack[k].child, stack[k].count, stack[k].t_entry[i]};
+                }
+            }
+            StackEntry hits[Width];
+            const int hit_count = SortHitLanes(node, lane_masks[i], t_entry[i], hits);
+            for (int k = 0; k < hit_count; ++k) {
+                single_stack[single_size++] = hits[k];
+            }
+            if (TraverseClosest(nodes_, *primitives_, rays[i], lane_rays[i], t_min, closest[i], (hit_rays & (1u << i)) != 0,
+                                single_stack, single_size, records[i], generators[i])) {
+                hit_rays |= 1u << i;
+            }
+            RAYTRACER_BVH_COUNT(packet_detached_rays, 1);
+            detached |= 1u << i;
+            lane_masks[i] = 0;
+        }
+
+        for (int k = 0; k < order_count; ++k) {
+            const int lane = order[k];
+            std::uint32_t child_rays = 0;
+            for (std::uint32_t pending = active & ~detached; pending != 0; pending &= pending - 1) {
+                const int i = __builtin_ctz(pending);
+                if ((lane_masks[i] & (1u << lane)) != 0) {
+                    child_rays |= 1u << i;
+                }
+            }
+            if (child_rays == 0) {
+                continue;
+            }
+            PacketEntry& pushed = stack[stack_size++];
+            pushed.child = node.child[lane];
+            pushed.count = node.count[lane];
+            pushed.rays = child_rays;
+            for (std::uint32_t pending = child_rays; pending != 0; pending &= pending - 1) {
+                const int i = __builtin_ctz(pending);
+                pushed.t_entry[i] = t_entry[i][lane];
+            }
+        }
+    }
+    return hit_rays;
+}
+
+// 어느 교차든 찾으면 멈추므로 교차한 칸을 진입 거리로 정렬하지 않고 칸 순서대로 쌓는다. 구간도 줄어들지 않는다.
+template <int Width>
+bool WideBvh<Width>::Occluded(const Ray& r, double t_min, double t_max, Rng& generator) const {
+    RAYTRACER_BVH_COUNT(rays, 1);
+    const LaneRay ray = MakeLaneRay(r);
+
+    StackEntry local_stack[kStackSize];
+    std::vector<StackEntry> deep_stack;
+    StackEntry* stack = local_stack;
+    const int stack_limit = depth_ * (Width - 1) + 1;
+    if (stack_limit > kStackSize) {
+        deep_stack.resize(static_cast<std::size_t>(stack_limit));
+        stack = deep_stack.data();
+    }
+
+    alignas(32) double t_entry[Width];
+    int stack_size = 0;
+    stack[stack_size++] = StackEntry{0, 0, t_min};
+
+    while (stack_size > 0) {
+        const StackEntry entry = stack[--stack_size];
+        if (entry.child < 0) {
+            RAYTRACER_BVH_COUNT(primitives_tested, entry.count);
+            const auto begin = primitives_->begin() + (-entry.child - 1);
+            for (auto it = begin; it != begin + entry.count; ++it) {
+                if ((*it)->Occluded(r, t_min, t_max, generator)) {
+                    return true;
+                }
+            }
+            continue;
+        }
+
+        RAYTRACER_BVH_COUNT(nodes_visited, 1);
+        const WideBvhNode<Width>& node = nodes_[static_cast<std::size_t>(entry.child)];
+        unsigned mask = IntersectLanes(node, ray, t_min, t_max, t_entry);
+        while (mask != 0) {
+            const int lane = __builtin_ctz(mask);
+            mask &= mask - 1;
+            stack[stack_size++] = StackEntry{node.child[lane], node.count[lane], t_entry[lane]};
+        }
+    }
+    return false;
+}
+
+template <int Width>
+WideBvh<Width> WideBvh<Width>::CulledBy(const Frustum& frustum) const {
+    auto nodes = std::make_shared<std::vector<WideBvhNode<Width>>>();
+    int depth = 1;
+    if (CullNode(nodes_, 0, frustum, 1, *nodes, depth) < 0) {
+        nodes->push_back(EmptyNode<Width>());
+    }
+
+    WideBvh culled = *this;
+    culled.nodes_ = nodes->data();
+    culled.node_count_ = nodes->size();
+    culled.storage_ = std::move(nodes);
+    culled.depth_ = depth;
+    return culled;
+}
+
+template <int Width>
+std::unique_ptr<Hittable> WideBvh<Width>::CullFrustum(const Frustum& frustum) const {
+    return std::make_unique<WideBvh>(CulledBy(frustum));
+}
+
+template <int Width>
+bool WideBvh<Width>::BoundingBox(double /*time0*/, double /*time1*/, Aabb& output_box) const {
+    output_box = root_box_;
+    return true;
+}
+
+template class WideBvh<4>;
+template class WideBvh<8>;
+
+}  // namespace raytracer
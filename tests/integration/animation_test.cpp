@@ -0,0 +1,93 @@
+/*
+ * 설명: 턴테이블 애니메이션의 프레임 0이 정지 렌더와 같고, 프레임마다 누적한 BVH 재맞춤 결과가 해당 자세로 바로 맞춘 결과와 같은지 확인한다.
+ * 버전: v1.9.0
+ * 관련 문서: design/renderer/v1.9.0-animation.md
+ * 테스트: tests/integration/animation_test.cpp
+ */
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "raytracer/animation.hpp"
+#include "raytracer/image_sink.hpp"
+#include "raytracer/ppm.hpp"
+
+namespace {
+
+std::string ReadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+raytracer::RenderOptions SmallOptions() {
+    raytracer::RenderOptions options;
+    options.width = 10;
+    options.height = 8;
+    options.samples_per_pixel = 2;
+    options.max_depth = 6;
+    return options;
+}
+
+std::string RenderFrame(const raytracer::RenderOptions& options, const raytracer::Scene& scene,
+                        const raytracer::AnimationOptions& animation, int frame) {
+    raytracer::ThreadPool pool(2);
+    std::ostringstream output;
+    raytracer::PpmStreamWriter writer(output, raytracer::PpmFormat::kAscii);
+    raytracer::RenderMaterialRegion(options, scene, raytracer::MakeAnimationCamera(options, animation, frame), pool,
+                                    raytracer::Tile{0, 0, options.width, options.height}, writer);
+    return output.str();
+}
+
+}  // namespace
+
+TEST(AnimationTest, FirstFrameMatchesStillRenderAndLaterFramesMove) {
+    const raytracer::RenderOptions options = SmallOptions();
+    raytracer::AnimationOptions animation;
+    animation.frame_count = 3;
+
+    const std::string pattern = ::testing::TempDir() + "animation_test_####.ppm";
+    raytracer::ThreadPool pool(2);
+    const raytracer::AnimationStats stats =
+        raytracer::RenderAnimation(options, animation, pattern, raytracer::PpmFormat::kAscii, pool);
+    EXPECT_EQ(stats.frames, 3);
+    EXPECT_GT(stats.bvh.refitted_nodes, 0);
+
+    const std::string first = ReadFile(raytracer::FrameOutputPath(pattern, 0));
+    EXPECT_EQ(first, raytracer::RenderMaterialImage(options));
+    for (int frame = 1; frame < 3; ++frame) {
+        const std::string path = raytracer::FrameOutputPath(pattern, frame);
+        const std::string image = ReadFile(path);
+        EXPECT_EQ(image.compare(0, 11, "P3\n10 8\n255"), 0) << path;
+        EXPECT_NE(image, first) << path;
+        std::remove(path.c_str());
+    }
+    std::remove(raytracer::FrameOutputPath(pattern, 0).c_str());
+}
+
+TEST(AnimationTest, AccumulatedRefitsMatchPosingTheFrameDirectly) {
+    const raytracer::RenderOptions options = SmallOptions();
+    raytracer::AnimationOptions animation;
+    animation.frame_count = 8;
+    // 재구성이 없어야 두 장면의 트리 구조가 같아 볼륨 샘플링 순서까지 일치한다.
+    animation.rebuild_threshold = 1e9;
+
+    raytracer::Scene sequenced = raytracer::BuildCornellSmokeScene(0.0, 0.0);
+    for (int frame = 0; frame <= 5; ++frame) {
+        EXPECT_EQ(raytracer::PoseAnimationFrame(sequenced, options, animation, frame).rebuilt_subtrees, 0);
+    }
+    raytracer::Scene direct = raytracer::BuildCornellSmokeScene(0.0, 0.0);
+    raytracer::PoseAnimationFrame(direct, options, animation, 5);
+
+    EXPECT_EQ(RenderFrame(options, sequenced, animation, 5), RenderFrame(options, direct, animation, 5));
+}
+
+TEST(AnimationTest, FrameOutputPathPadsTheHashRun) {
+    EXPECT_EQ(raytracer::FrameOutputPath("out/frame_####.ppm", 7), "out/frame_0007.ppm");
+    EXPECT_EQ(raytracer::FrameOutputPath("f#.ppm", 123), "f123.ppm");
+    EXPECT_THROW(raytracer::FrameOutputPath("frame.ppm", 0), std::invalid_argument);
+}
@@ -0,0 +1,103 @@
+/*
+ * 설명: 배치 매니페스트의 변형들이 공유 장면/스레드 풀로 렌더링돼 각 출력 파일이 단일 실행 결과와 같은지와 매니페스트 검증을 확인한다.
+ * 버전: v1.8.0
+ * 관련 문서: design/renderer/v1.8.0-batch.md
+ * 테스트: tests/integration/batch_test.cpp
+ */
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "raytracer/batch.hpp"
+#include "raytracer/image_sink.hpp"
+#include "raytracer/ppm.hpp"
+
+namespace {
+
+std::string ReadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+TEST(BatchTest, RendersEveryVariantIntoItsOwnFileLikeSingleRuns) {
+    raytracer::RenderOptions defaults;
+    defaults.width = 10;
+    defaults.height = 8;
+    defaults.max_depth = 6;
+
+    const std::string base = ::testing::TempDir() + "batch_test_";
+    std::istringstream manifest(
+        "# 시드/샘플/깊이 변형\n"
+        "{\"seed\":1,\"spp\":2,\"output\":\"" + base + "a.ppm\"}\n"
+        "\n"
+        "{\"seed\":2,\"spp\":3,\"max_depth\":4,\"format\":\"p6\",\"output\":\"" + base + "b.ppm\"}\n"
+        "{\"seed\":3,\"spp\":1,\"width\":12,\"output\":\"" + base + "c.ppm\"}\n");
+    const std::vector<raytracer::RenderRequest> requests = raytracer::ParseBatchManifest(manifest, defaults);
+    ASSERT_EQ(requests.size(), 3u);
+
+    const raytracer::Scene scene = raytracer::BuildCornellSmokeScene(0.0, 0.0);
+    raytracer::ThreadPool pool(3);
+    const std::vector<std::string> errors = raytracer::RenderBatch(requests, scene, pool);
+    for (const std::string& error : errors) {
+        EXPECT_EQ(error, "");
+    }
+
+    for (const raytracer::RenderRequest& request : requests) {
+        std::ostringstream expected;
+        raytracer::PpmStreamWriter writer(expected, request.format);
+        raytracer::RenderMaterialImage(request.options, writer);
+        EXPECT_EQ(ReadFile(request.output_path), expected.str()) << request.output_path;
+        std::remove(request.output_path.c_str());
+    }
+}
+
+TEST(BatchTest, ReportsFailedVariantWithoutStoppingOthers) {
+    raytracer::RenderOptions defaults;
+    defaults.width = 4;
+    defaults.height = 4;
+    defaults.samples_per_pixel = 1;
+    defaults.max_depth = 4;
+
+    const std::string good = ::testing::TempDir() + "batch_test_good.ppm";
+    std::istringstream manifest("{\"output\":\"/nonexistent-dir/x.ppm\"}\n{\"output\":\"" + good + "\"}\n");
+    const std::vector<raytracer::RenderRequest> requests = raytracer::ParseBatchManifest(manifest, defaults);
+
+    const raytracer::Scene scene = raytracer::BuildCornellSmokeScene(0.0, 0.0);
+    raytracer::ThreadPool pool(2);
+    const std::vector<std::string> errors = raytracer::RenderBatch(requests, scene, pool);
+
+    EXPECT_NE(errors[0], "");
+    EXPECT_EQ(errors[1], "");
+    EXPECT_EQ(ReadFile(good), raytracer::RenderMaterialImage(defaults));
+    std::remove(good.c_str());
+}
+
+TEST(BatchTest, RejectsInvalidManifestWithLineNumber) {
+    const raytracer::RenderOptions defaults;
+    const char* manifests[] = {
+        "{\"seed\":1}\n",
+        "{\"output\":\"a.ppm\"}\n{\"output\":\"a.ppm\"}\n",
+        "{\"output\":\"a.ppm\"}\n{\"spp\":0,\"output\":\"b.ppm\"}\n",
+        "# 주석만 있다\n",
+    };
+    for (const char* text : manifests) {
+        std::istringstream manifest(text);
+        EXPECT_THROW(raytracer::ParseBatchManifest(manifest, defaults), std::runtime_error) << text;
+    }
+
+    std::istringstream manifest("{\"output\":\"a.ppm\"}\n\n{\"bad\":1,\"output\":\"b.ppm\"}\n");
+    try {
+        raytracer::ParseBatchManifest(manifest, defaults);
+        FAIL();
+    } catch (const std::runtime_error& error) {
+        EXPECT_EQ(std::string(error.what()).rfind("3행: ", 0), 0u);
+    }
+}
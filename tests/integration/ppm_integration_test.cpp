@@ -1,6 +1,20 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "raytracer/image_sink.hpp"
 #include "raytracer/ppm.hpp"
+#include "raytracer/render_kernel.hpp"
+#include "raytracer/scene.hpp"
+#include "raytracer/shard.hpp"
+#include "raytracer/tile.hpp"
+#include "raytracer/wavefront.hpp"
 
 TEST(PpmIntegrationTest, RendersCornellMiniSceneDeterministically) {
     raytracer::RenderOptions options;
@@ -18,17 +32,17 @@ TEST(PpmIntegrationTest, RendersCornellMiniSceneDeterministically) {
         "0 0 0\n"
         "0 0 0\n"
         "0 0 0\n"
-        "42 78 41\n"
-        "128 128 128\n"
-        "76 25 22\n"
+        "49 60 34\n"
+        "111 111 111\n"
+        "73 63 62\n"
         "0 0 0\n"
-        "79 119 84\n"
-        "79 62 60\n"
-        "125 59 59\n"
+        "48 93 54\n"
+        "137 145 119\n"
+        "73 20 20\n"
         "0 0 0\n"
-        "61 65 62\n"
-        "54 54 54\n"
-        "100 28 28\n"
+        "64 85 65\n"
+        "90 90 90\n"
+        "52 15 15\n"
         "0 0 0\n";
 
     const std::string actual = raytracer::RenderMaterialImage(options);
@@ -49,3 +63,394 @@ TEST(PpmIntegrationTest, ProducesIdenticalCornellImageWithSameSeed) {
 
     EXPECT_EQ(second, first);
 }
+
+TEST(PpmIntegrationTest, ProducesIdenticalImageForAnyThreadCount) {
+    raytracer::RenderOptions options;
+    options.width = 13;
+    options.height = 9;
+    options.samples_per_pixel = 2;
+    options.max_depth = 6;
+    options.seed = 5;
+    options.tile_size = 4;
+
+    options.thread_count = 1;
+    const std::string single = raytracer::RenderMaterialImage(options);
+    options.thread_count = 3;
+    const std::string triple = raytracer::RenderMaterialImage(options);
+    options.thread_count = 8;
+    const std::string many = raytracer::RenderMaterialImage(options);
+
+    EXPECT_EQ(triple, single);
+    EXPECT_EQ(many, single);
+}
+
+TEST(PpmIntegrationTest, RayPacketsProduceIdenticalImage) {
+    raytracer::RenderOptions options;
+    options.width = 23;
+    options.height = 17;
+    options.samples_per_pixel = 3;
+    options.max_depth = 6;
+    options.seed = 11;
+    options.tile_size = 7;
+    options.thread_count = 2;
+
+    // 타일 크기가 블록 크기의 배수가 아니어서 가장자리 블록은 묶음이 덜 찬다.
+    const std::string single = raytracer::RenderMaterialImage(options);
+    for (const int packet_size : {4, 8, 16}) {
+        options.packet_size = packet_size;
+        EXPECT_EQ(raytracer::RenderMaterialImage(options), single) << "묶음 크기 " << packet_size;
+    }
+
+    options.packet_size = 3;
+    EXPECT_THROW(raytracer::RenderMaterialImage(options), std::invalid_argument);
+}
+
+TEST(PpmIntegrationTest, WavefrontIntegratorMatchesRecursiveSums) {
+    raytracer::RenderOptions options;
+    options.width = 40;
+    options.height = 40;
+    options.samples_per_pixel = 4;
+    // 깊이가 깊으면 한 번에 추적하는 경로 수가 줄어 16x16 타일의 경로 1024개가 여러 묶음으로 나뉜다.
+    options.max_depth = 200;
+    options.seed = 5;
+
+    const raytracer::Scene scene = raytracer::BuildCornellSmokeScene(0.0, 1.0);
+    const raytracer::Camera camera = raytracer::MakeCamera(options);
+    const raytracer::RenderContext context{options, camera, scene.WorldView(), scene.lights_view};
+    const raytracer::Tile tile{12, 10, 28, 26};
+
+    const std::vector<raytracer::Color> recursive = raytracer::RenderTileSums(context, tile);
+    for (const int packet_size : {1, 8}) {
+        options.packet_size = packet_size;
+        const std::vector<raytracer::Color> wavefront = raytracer::RenderTileSumsWavefront(context, tile);
+        ASSERT_EQ(wavefront.size(), recursive.size());
+        for (std::size_t i = 0; i < recursive.size(); ++i) {
+            EXPECT_EQ(wavefront[i].x(), recursive[i].x()) << "픽셀 " << i << ", 묶음 크기 " << packet_size;
+            EXPECT_EQ(wavefront[i].y(), recursive[i].y()) << "픽셀 " << i << ", 묶음 크기 " << packet_size;
+            EXPECT_EQ(wavefront[i].z(), recursive[i].z()) << "픽셀 " << i << ", 묶음 크기 " << packet_size;
+        }
+    }
+    options.packet_size = 3;
+    EXPECT_THROW(raytracer::RenderTileSumsWavefront(context, tile), std::invalid_argument);
+}
+
+TEST(PpmIntegrationTest, WavefrontIntegratorProducesIdenticalImage) {
+    raytracer::RenderOptions options;
+    options.width = 23;
+    options.height = 17;
+    options.samples_per_pixel = 3;
+    options.max_depth = 6;
+    options.seed = 11;
+    options.tile_size = 7;
+    options.thread_count = 2;
+
+    const std::string recursive = raytracer::RenderMaterialImage(options);
+    options.integrator = raytracer::Integrator::kWavefront;
+    EXPECT_EQ(raytracer::RenderMaterialImage(options), recursive);
+}
+
+TEST(PpmIntegrationTest, TileCullingProducesIdenticalImage) {
+    raytracer::RenderOptions options;
+    options.width = 40;
+    options.height = 30;
+    options.samples_per_pixel = 2;
+    options.max_depth = 6;
+    options.seed = 17;
+    options.tile_size = 6;
+    options.thread_count = 2;
+
+    const std::string full = raytracer::RenderMaterialImage(options);
+    options.tile_culling = true;
+    EXPECT_EQ(raytracer::RenderMaterialImage(options), full);
+    options.packet_size = 8;
+    EXPECT_EQ(raytracer::RenderMaterialImage(options), full);
+    options.integrator = raytracer::Integrator::kWavefront;
+    EXPECT_EQ(raytracer::RenderMaterialImage(options), full);
+
+    // 렌즈가 있으면 절두체 없이 전체 트리를 순회한다.
+    options.aperture = 2.0;
+    options.tile_culling = false;
+    const std::string lens = raytracer::RenderMaterialImage(options);
+    options.tile_culling = true;
+    EXPECT_EQ(raytracer::RenderMaterialImage(options), lens);
+}
+
+TEST(PpmIntegrationTest, ProgressivePassesMatchTileRender) {
+    raytracer::RenderOptions options;
+    options.width = 7;
+    options.height = 5;
+    options.samples_per_pixel = 3;
+    options.max_depth = 6;
+    options.seed = 9;
+    options.thread_count = 2;
+
+    const std::string tiled = raytracer::RenderMaterialImage(options);
+    const std::string progressive = raytracer::RenderProgressiveImage(options, raytracer::ProgressiveOptions{});
+
+    EXPECT_EQ(progressive, tiled);
+}
+
+TEST(PpmIntegrationTest, ResumedCheckpointMatchesUninterruptedRender) {
+    raytracer::RenderOptions options;
+    options.width = 6;
+    options.height = 4;
+    options.max_depth = 6;
+    options.seed = 21;
+
+    const std::string checkpoint_path = ::testing::TempDir() + "ppm_integration_checkpoint.txt";
+
+    // 2패스 후 중단된 작업을 흉내 낸다.
+    raytracer::ProgressiveOptions first_run;
+    first_run.checkpoint_path = checkpoint_path;
+    first_run.checkpoint_interval = 1;
+    options.samples_per_pixel = 2;
+    raytracer::RenderProgressiveImage(options, first_run);
+
+    raytracer::ProgressiveOptions resumed_run;
+    resumed_run.resume_path = checkpoint_path;
+    options.samples_per_pixel = 5;
+    const std::string resumed = raytracer::RenderProgressiveImage(options, resumed_run);
+
+    const std::string uninterrupted = raytracer::RenderMaterialImage(options);
+    EXPECT_EQ(resumed, uninterrupted);
+
+    // 해상도·시드·깊이가 같아도 카메라나 셔터가 다르면 다른 이미지이므로 재개를 거부한다.
+    const auto resume_with = [&](const raytracer::RenderOptions& other) {
+        return raytracer::RenderProgressiveImage(other, resumed_run);
+    };
+    raytracer::RenderOptions other = options;
+    other.seed = 22;
+    EXPECT_THROW(resume_with(other), std::runtime_error);
+    other = options;
+    other.vertical_fov_degrees = 41.0;
+    EXPECT_THROW(resume_with(other), std::runtime_error);
+    other = options;
+    other.aperture = 0.1;
+    EXPECT_THROW(resume_with(other), std::runtime_error);
+    other = options;
+    other.shutter_open_time = 0.25;
+    EXPECT_THROW(resume_with(other), std::runtime_error);
+    other = options;
+    other.shutter_close_time = 1.0;
+    EXPECT_THROW(resume_with(other), std::runtime_error);
+
+    std::remove(checkpoint_path.c_str());
+}
+
+TEST(PpmIntegrationTest, MergedShardsMatchSingleProcessRender) {
+    raytracer::RenderOptions options;
+    options.width = 11;
+    options.height = 7;
+    options.samples_per_pixel = 2;
+    options.max_depth = 6;
+    options.seed = 13;
+    options.tile_size = 4;
+
+    const int tile_count = raytracer::TileCount(options.width, options.height, options.tile_size);
+    std::vector<raytracer::ShardImage> shards;
+    for (int shard_index = 3; shard_index >= 0; --shard_index) {
+        std::istringstream text(
+            raytracer::RenderMaterialShard(options, raytracer::ShardTileRange(shard_index, 4, tile_count)));
+        shards.push_back(raytracer::DecodeShard(text));
+    }
+
+    EXPECT_EQ(raytracer::MergeShards(shards), raytracer::RenderMaterialImage(options));
+
+    shards.pop_back();
+    EXPECT_THROW(raytracer::MergeShards(shards), std::runtime_error);
+
+    // 빠진 구간을 다른 설정으로 렌더한 샤드로 채우면 구간은 맞아도 병합하지 않는다.
+    const auto merge_with_missing_shard = [&](const raytracer::RenderOptions& other) {
+        std::istringstream text(raytracer::RenderMaterialShard(other, raytracer::ShardTileRange(0, 4, tile_count)));
+        std::vector<raytracer::ShardImage> mixed = shards;
+        mixed.push_back(raytracer::DecodeShard(text));
+        return raytracer::MergeShards(mixed);
+    };
+    EXPECT_EQ(merge_with_missing_shard(options), raytracer::RenderMaterialImage(options));
+    raytracer::RenderOptions other = options;
+    other.seed = 14;
+    EXPECT_THROW(merge_with_missing_shard(other), std::runtime_error);
+    other = options;
+    other.samples_per_pixel = 3;
+    EXPECT_THROW(merge_with_missing_shard(other), std::runtime_error);
+    other = options;
+    other.max_depth = 5;
+    EXPECT_THROW(merge_with_missing_shard(other), std::runtime_error);
+    other = options;
+    other.vertical_fov_degrees = 41.0;
+    EXPECT_THROW(merge_with_missing_shard(other), std::runtime_error);
+    other = options;
+    other.shutter_close_time = 1.0;
+    EXPECT_THROW(merge_with_missing_shard(other), std::runtime_error);
+}
+
+TEST(PpmIntegrationTest, MergeRejectsOutOfRangeShardPixels) {
+    raytracer::RenderOptions options;
+    options.width = 6;
+    options.height = 5;
+    options.samples_per_pixel = 1;
+    options.max_depth = 4;
+    options.tile_size = 4;
+
+    const int tile_count = raytracer::TileCount(options.width, options.height, options.tile_size);
+    std::vector<raytracer::ShardImage> shards;
+    for (int shard_index = 0; shard_index < 2; ++shard_index) {
+        std::istringstream text(
+            raytracer::RenderMaterialShard(options, raytracer::ShardTileRange(shard_index, 2, tile_count)));
+        shards.push_back(raytracer::DecodeShard(text));
+    }
+    ASSERT_EQ(raytracer::MergeShards(shards), raytracer::RenderMaterialImage(options));
+
+    // P6 병합은 채널을 바이트로 좁히므로 300이나 -1은 파일을 읽을 때와 메모리에서 병합할 때 모두 거부해야 한다.
+    for (const int bad : {300, -1}) {
+        raytracer::ShardImage corrupted = shards[1];
+        corrupted.pixels[2].g = bad;
+        std::istringstream text(raytracer::EncodeShard(corrupted));
+        EXPECT_THROW(raytracer::DecodeShard(text), std::runtime_error);
+
+        std::vector<raytracer::ShardImage> mixed = {shards[0], corrupted};
+        EXPECT_THROW(raytracer::MergeShards(mixed), std::runtime_error);
+    }
+}
+
+TEST(PpmIntegrationTest, MergesMoreShardsThanTiles) {
+    raytracer::RenderOptions options;
+    options.width = 11;
+    options.height = 7;
+    options.samples_per_pixel = 2;
+    options.max_depth = 6;
+    options.seed = 13;
+    options.tile_size = 4;
+
+    // 타일 6개를 샤드 9개로 나누면 빈 구간이 시작이 같은 비지 않은 구간 옆에 생긴다. 순서와 무관하게 병합돼야 한다.
+    const int tile_count = raytracer::TileCount(options.width, options.height, options.tile_size);
+    constexpr int kShardCount = 9;
+    ASSERT_LT(tile_count, kShardCount);
+    std::vector<raytracer::ShardImage> shards;
+    for (int shard_index = kShardCount - 1; shard_index >= 0; --shard_index) {
+        std::istringstream text(raytracer::RenderMaterialShard(
+            options, raytracer::ShardTileRange(shard_index, kShardCount, tile_count)));
+        shards.push_back(raytracer::DecodeShard(text));
+    }
+
+    const std::string expected = raytracer::RenderMaterialImage(options);
+    EXPECT_EQ(raytracer::MergeShards(shards), expected);
+    std::reverse(shards.begin(), shards.end());
+    EXPECT_EQ(raytracer::MergeShards(shards), expected);
+}
+
+namespace {
+
+// 싱크 호출 순서를 기록해 행이 위에서 아래로 한 번씩 전달되는지 확인한다.
+class RecordingSink : public raytracer::ImageSink {
+public:
+    void Begin(int width, int height) override {
+        width_ = width;
+        height_ = height;
+        events.push_back("begin");
+    }
+    void WriteRow(int y, const std::vector<raytracer::Rgb8>& row) override {
+        events.push_back("row " + std::to_string(y));
+        for (const raytracer::Rgb8& rgb : row) {
+            pixels << rgb.r << ' ' << rgb.g << ' ' << rgb.b << "\n";
+        }
+    }
+    void End() override { events.push_back("end"); }
+
+    std::string AsP3() const {
+        return "P3\n" + std::to_string(width_) + ' ' + std::to_string(height_) + "\n255\n" + pixels.str();
+    }
+
+    std::vector<std::string> events;
+    std::ostringstream pixels;
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+};
+
+}  // namespace
+
+TEST(PpmIntegrationTest, StreamsRowsTopToBottomAcrossTileStrips) {
+    raytracer::RenderOptions options;
+    options.width = 9;
+    options.height = 7;
+    options.samples_per_pixel = 2;
+    options.max_depth = 6;
+    options.seed = 17;
+    options.tile_size = 3;
+    options.thread_count = 3;
+
+    RecordingSink sink;
+    raytracer::RenderMaterialImage(options, sink);
+
+    std::vector<std::string> expected_events = {"begin"};
+    for (int y = 0; y < options.height; ++y) {
+        expected_events.push_back("row " + std::to_string(y));
+    }
+    expected_events.push_back("end");
+    EXPECT_EQ(sink.events, expected_events);
+
+    options.tile_size = 16;
+    options.thread_count = 1;
+    EXPECT_EQ(sink.AsP3(), raytracer::RenderMaterialImage(options));
+}
+
+TEST(PpmIntegrationTest, BinaryOutputCarriesSameChannelsAsAscii) {
+    raytracer::RenderOptions options;
+    options.width = 5;
+    options.height = 3;
+    options.samples_per_pixel = 2;
+    options.max_depth = 6;
+    options.seed = 4;
+
+    std::ostringstream binary;
+    raytracer::PpmStreamWriter writer(binary, raytracer::PpmFormat::kBinary);
+    raytracer::RenderMaterialImage(options, writer);
+
+    std::istringstream ascii(raytracer::RenderMaterialImage(options));
+    std::string magic;
+    int width = 0;
+    int height = 0;
+    int max_value = 0;
+    ascii >> magic >> width >> height >> max_value;
+    std::string expected = "P6\n5 3\n255\n";
+    int channel = 0;
+    while (ascii >> channel) {
+        expected.push_back(static_cast<char>(channel));
+    }
+
+    EXPECT_EQ(binary.str(), expected);
+}
+
+TEST(PpmIntegrationTest, TimeBudgetOutputMatchesRenderWithCompletedPassCount) {
+    raytracer::RenderOptions options;
+    options.width = 24;
+    options.height = 18;
+    options.samples_per_pixel = 6;
+    options.max_depth = 6;
+    options.seed = 23;
+    options.thread_count = 2;
+
+    // 짧은 예산: 첫 패스는 항상 끝나고 마감에 걸린 패스는 버려진다.
+    raytracer::ProgressiveOptions short_budget;
+    short_budget.time_budget = std::chrono::milliseconds(1);
+    std::ostringstream budgeted;
+    raytracer::PpmStreamWriter writer(budgeted, raytracer::PpmFormat::kAscii);
+    const int completed = raytracer::RenderProgressiveImage(options, short_budget, writer);
+    ASSERT_GE(completed, 1);
+    ASSERT_LE(completed, options.samples_per_pixel);
+
+    raytracer::RenderOptions fixed = options;
+    fixed.samples_per_pixel = completed;
+    EXPECT_EQ(budgeted.str(), raytracer::RenderMaterialImage(fixed));
+
+    // 넉넉한 예산: samples_per_pixel이 상한이다.
+    raytracer::ProgressiveOptions long_budget;
+    long_budget.time_budget = std::chrono::milliseconds(60000);
+    options.samples_per_pixel = 3;
+    std::ostringstream capped;
+    raytracer::PpmStreamWriter capped_writer(capped, raytracer::PpmFormat::kAscii);
+    EXPECT_EQ(raytracer::RenderProgressiveImage(options, long_budget, capped_writer), 3);
+    EXPECT_EQ(capped.str(), raytracer::RenderMaterialImage(options));
+}
@@ -0,0 +1,130 @@
+/*
+ * 설명: 렌더 서버가 같은 연결의 연속 요청과 동시 연결 요청에 단일 프로세스 렌더와 같은 PPM을 돌려주는지, 멈출 때 열린
+ *       연결을 회수하고 Serve가 반환하는지 검증한다.
+ * 버전: v1.5.0
+ * 관련 문서: design/renderer/v1.5.0-render-server.md
+ * 테스트: tests/integration/render_server_test.cpp
+ */
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "raytracer/ppm.hpp"
+#include "raytracer/render_client.hpp"
+#include "raytracer/render_server.hpp"
+
+namespace {
+
+std::string SocketPath() { return ::testing::TempDir() + "rt_server_" + std::to_string(::getpid()) + ".sock"; }
+
+// 전체 P3 이미지에서 [x, x+w) x [y, y+h) 영역만 잘라 P3로 다시 만든다.
+std::string CropP3(const std::string& image, int x, int y, int w, int h) {
+    std::istringstream input(image);
+    std::string magic;
+    int width = 0;
+    int height = 0;
+    int max_value = 0;
+    input >> magic >> width >> height >> max_value;
+    std::vector<std::string> pixels;
+    std::string line;
+    std::getline(input, line);
+    while (std::getline(input, line)) {
+        pixels.push_back(line);
+    }
+
+    std::string cropped = "P3\n" + std::to_string(w) + ' ' + std::to_string(h) + "\n255\n";
+    for (int row = y; row < y + h; ++row) {
+        for (int column = x; column < x + w; ++column) {
+            cropped += pixels[static_cast<std::size_t>(row * width + column)] + "\n";
+        }
+    }
+    return cropped;
+}
+
+}  // namespace
+
+TEST(RenderServerTest, ServesSequentialAndConcurrentRequestsLikeSingleProcessRender) {
+    raytracer::RenderOptions defaults;
+    defaults.max_depth = 6;
+    defaults.thread_count = 2;
+
+    const std::string socket_path = SocketPath();
+    raytracer::RenderServer server(socket_path, defaults);
+    std::thread serve_thread([&server] { server.Serve(); });
+
+    raytracer::RenderOptions options = defaults;
+    options.width = 12;
+    options.height = 9;
+    options.samples_per_pixel = 2;
+    options.seed = 7;
+    const std::string full = raytracer::RenderMaterialImage(options);
+
+    {
+        raytracer::RenderClient client(socket_path);
+        std::ostringstream first;
+        client.Render(R"({"width":12,"height":9,"spp":2,"seed":7})", first);
+        EXPECT_EQ(first.str(), full);
+
+        std::ostringstream cropped;
+        client.Render(R"({"width":12,"height":9,"spp":2,"seed":7,"crop":[3,2,5,6]})", cropped);
+        EXPECT_EQ(cropped.str(), CropP3(full, 3, 2, 5, 6));
+
+        std::ostringstream rejected;
+        EXPECT_THROW(client.Render(R"({"width":0})", rejected), std::runtime_error);
+        // 큰 프레임 버퍼를 잡기 전에 해상도 상한으로 거절한다.
+        EXPECT_THROW(client.Render(R"({"width":100000,"height":100000})", rejected), std::runtime_error);
+
+        // 오류 응답 뒤에도 같은 연결을 계속 쓸 수 있다.
+        std::ostringstream again;
+        client.Render(R"({"width":12,"height":9,"spp":2,"seed":7})", again);
+        EXPECT_EQ(again.str(), full);
+    }
+
+    std::vector<std::string> results(4);
+    std::vector<std::thread> clients;
+    for (std::size_t index = 0; index < results.size(); ++index) {
+        clients.emplace_back([&, index] {
+            raytracer::RenderClient client(socket_path);
+            std::ostringstream output;
+            client.Render(R"({"width":12,"height":9,"spp":2,"seed":7})", output);
+            results[index] = output.str();
+        });
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    for (const std::string& result : results) {
+        EXPECT_EQ(result, full);
+    }
+
+    server.Stop();
+    serve_thread.join();
+}
+
+TEST(RenderServerTest, ServeReturnsAfterClosingIdleConnections) {
+    raytracer::RenderOptions defaults;
+    defaults.max_depth = 4;
+    defaults.samples_per_pixel = 1;
+
+    const std::string socket_path = SocketPath();
+    raytracer::RenderServer server(socket_path, defaults);
+    std::thread serve_thread([&server] { server.Serve(); });
+
+    // 요청 하나를 끝낸 뒤 연결을 열어 둔 채로 서버를 멈춘다. Serve는 이 연결의 스레드를 회수한 뒤 반환해야 한다.
+    raytracer::RenderClient client(socket_path);
+    std::ostringstream first;
+    client.Render("{\"width\":4,\"height\":3}", first);
+    EXPECT_EQ(first.str().rfind("P3\n4 3\n", 0), 0u);
+
+    server.Stop();
+    serve_thread.join();
+
+    std::ostringstream second;
+    EXPECT_THROW(client.Render("{\"width\":4,\"height\":3}", second), std::runtime_error);
+}
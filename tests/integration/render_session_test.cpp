@@ -0,0 +1,106 @@
+/*
+ * 설명: RenderSession이 호출자 프레임버퍼에 일반 렌더와 같은 결과를 만들고 진행 콜백, 취소, 부분 읽기를 규약대로 지원하는지 검증한다.
+ * 버전: v1.6.0
+ * 관련 문서: design/renderer/v1.6.0-render-session.md
+ * 테스트: tests/integration/render_session_test.cpp
+ */
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "raytracer/framebuffer.hpp"
+#include "raytracer/image_sink.hpp"
+#include "raytracer/ppm.hpp"
+#include "raytracer/render_session.hpp"
+#include "raytracer/scene.hpp"
+
+namespace {
+
+raytracer::RenderOptions SessionOptions() {
+    raytracer::RenderOptions options;
+    options.width = 13;
+    options.height = 11;
+    options.samples_per_pixel = 2;
+    options.max_depth = 6;
+    options.seed = 19;
+    options.tile_size = 4;
+    options.thread_count = 3;
+    return options;
+}
+
+std::string Resolve(const raytracer::RenderSession& session) {
+    std::ostringstream output;
+    raytracer::PpmStreamWriter writer(output, raytracer::PpmFormat::kAscii);
+    session.ResolvePartial(writer);
+    return output.str();
+}
+
+}  // namespace
+
+TEST(RenderSessionTest, CompletedSessionMatchesRenderMaterialImage) {
+    const raytracer::RenderOptions options = SessionOptions();
+    const raytracer::Scene scene = raytracer::BuildCornellSmokeScene(0.0, 0.0);
+    raytracer::Framebuffer framebuffer(options.width, options.height);
+    raytracer::RenderSession session(options, scene, framebuffer);
+
+    std::set<std::size_t> reported;
+    std::size_t last_completed = 0;
+    session.SetProgressCallback([&](const raytracer::TileProgress& progress) {
+        reported.insert(progress.tile_index);
+        EXPECT_EQ(progress.completed_tiles, last_completed + 1);
+        EXPECT_EQ(progress.total_tiles, session.Tiles().size());
+        EXPECT_TRUE(session.IsTileComplete(progress.tile_index));
+        last_completed = progress.completed_tiles;
+    });
+
+    EXPECT_TRUE(session.Run());
+    EXPECT_EQ(reported.size(), session.Tiles().size());
+    EXPECT_EQ(session.CompletedTiles(), session.Tiles().size());
+    EXPECT_EQ(Resolve(session), raytracer::RenderMaterialImage(options));
+}
+
+TEST(RenderSessionTest, CancelStopsNewTilesAndKeepsCompletedOnesReadable) {
+    raytracer::RenderOptions options = SessionOptions();
+    options.thread_count = 1;
+    const raytracer::Scene scene = raytracer::BuildCornellSmokeScene(0.0, 0.0);
+    raytracer::Framebuffer framebuffer(options.width, options.height);
+    raytracer::RenderSession session(options, scene, framebuffer);
+
+    session.SetProgressCallback([&](const raytracer::TileProgress& progress) {
+        if (progress.completed_tiles == 3) {
+            session.Cancel();
+        }
+    });
+
+    EXPECT_FALSE(session.Run());
+    EXPECT_TRUE(session.IsCancelled());
+    EXPECT_EQ(session.CompletedTiles(), 3u);
+
+    raytracer::Framebuffer reference(options.width, options.height);
+    raytracer::RenderSession full(options, scene, reference);
+    ASSERT_TRUE(full.Run());
+    for (std::size_t index = 0; index < session.Tiles().size(); ++index) {
+        const raytracer::Tile& tile = session.Tiles()[index];
+        const bool complete = session.IsTileComplete(index);
+        EXPECT_EQ(complete, index < 3);
+        for (int y = tile.y0; y < tile.y1; ++y) {
+            for (int x = tile.x0; x < tile.x1; ++x) {
+                const raytracer::Color expected = complete ? reference.At(x, y) : raytracer::Color(0.0, 0.0, 0.0);
+                EXPECT_EQ(framebuffer.At(x, y).x(), expected.x());
+                EXPECT_EQ(framebuffer.At(x, y).y(), expected.y());
+                EXPECT_EQ(framebuffer.At(x, y).z(), expected.z());
+            }
+        }
+    }
+}
+
+TEST(RenderSessionTest, RejectsFramebufferWithDifferentResolution) {
+    const raytracer::RenderOptions options = SessionOptions();
+    const raytracer::Scene scene = raytracer::BuildCornellSmokeScene(0.0, 0.0);
+    raytracer::Framebuffer framebuffer(options.width + 1, options.height);
+    EXPECT_THROW(raytracer::RenderSession(options, scene, framebuffer), std::invalid_argument);
+}
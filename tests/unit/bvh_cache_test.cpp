@@ -0,0 +1,159 @@
+/*
+ * 설명: BVH 캐시 파일로 복원한 Bvh8이 새로 빌드한 트리와 같은 hit를 내는지, 장면이나 옵션이 바뀌거나 파일이 손상되면
+ *       캐시를 버리고 다시 빌드하는지 검증한다.
+ * 버전: v1.18.0
+ * 관련 문서: design/renderer/v1.18.0-bvh-cache.md
+ * 테스트: tests/unit/bvh_cache_test.cpp
+ */
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "raytracer/bvh_cache.hpp"
+#include "raytracer/hittable_list.hpp"
+#include "raytracer/material.hpp"
+#include "raytracer/random.hpp"
+#include "raytracer/ray.hpp"
+#include "raytracer/sphere.hpp"
+
+namespace {
+
+using raytracer::Point3;
+using raytracer::Vec3;
+
+std::vector<std::shared_ptr<raytracer::Hittable>> MakeSpheres(std::uint32_t seed, int count) {
+    raytracer::Rng generator(seed);
+    const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    std::vector<std::shared_ptr<raytracer::Hittable>> objects;
+    for (int i = 0; i < count; ++i) {
+        objects.push_back(std::make_shared<raytracer::Sphere>(
+            Point3(raytracer::RandomDouble(generator, -10.0, 10.0), raytracer::RandomDouble(generator, -10.0, 10.0),
+                   raytracer::RandomDouble(generator, -20.0, -5.0)),
+            0.3, material));
+    }
+    return objects;
+}
+
+raytracer::HittableList MakeList(const std::vector<std::shared_ptr<raytracer::Hittable>>& objects) {
+    raytracer::HittableList list;
+    for (const auto& object : objects) {
+        list.Add(object);
+    }
+    return list;
+}
+
+void ExpectSameHits(const raytracer::Hittable& expected, const raytracer::Hittable& actual) {
+    raytracer::Rng generator(4);
+    for (int i = 0; i < 300; ++i) {
+        const raytracer::Ray ray(Point3(0.0, 0.0, 0.0),
+                                 Vec3(raytracer::RandomDouble(generator, -0.6, 0.6),
+                                      raytracer::RandomDouble(generator, -0.6, 0.6), -1.0),
+                                 0.0);
+        raytracer::HitRecord expected_record;
+        raytracer::HitRecord actual_record;
+        raytracer::Rng expected_generator(9);
+        raytracer::Rng actual_generator(9);
+        const double inf = std::numeric_limits<double>::infinity();
+        const bool expected_hit = expected.Hit(ray, 0.001, inf, expected_record, expected_generator);
+        ASSERT_EQ(expected_hit, actual.Hit(ray, 0.001, inf, actual_record, actual_generator));
+        if (expected_hit) {
+            EXPECT_EQ(expected_record.t, actual_record.t);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(BvhCacheTest, SecondRunLoadsTheSameTreeAndSceneChangesRebuild) {
+    const std::string path = ::testing::TempDir() + "bvh_cache_test.bin";
+    std::remove(path.c_str());
+    std::vector<std::shared_ptr<raytracer::Hittable>> objects = MakeSpheres(3, 500);
+    const raytracer::HittableList world = MakeList(objects);
+
+    const raytracer::BvhCacheResult first = raytracer::LoadOrBuildBvh(path, objects, 0.0, 1.0);
+    EXPECT_FALSE(first.loaded);
+    EXPECT_TRUE(first.save_error.empty());
+    const raytracer::BvhCacheResult second = raytracer::LoadOrBuildBvh(path, objects, 0.0, 1.0);
+    ASSERT_TRUE(second.loaded);
+    EXPECT_EQ(second.bvh->NodeCount(), first.bvh->NodeCount());
+    EXPECT_EQ(second.bvh->PrimitiveCount(), first.bvh->PrimitiveCount());
+    EXPECT_EQ(second.bvh->Depth(), first.bvh->Depth());
+    ExpectSameHits(world, *second.bvh);
+
+    // 복사본도 같은 매핑을 공유해 원본이 사라진 뒤에도 순회할 수 있다.
+    const raytracer::Bvh8 copy = *second.bvh;
+    ExpectSameHits(world, copy);
+
+    // 빌드 옵션이나 객체 하나의 위치가 바뀌면 키가 달라져 다시 빌드한다.
+    raytracer::BvhBuildOptions leaf4;
+    leaf4.max_leaf_size = 4;
+    EXPECT_NE(raytracer::BvhCacheKey(objects, 0.0, 1.0, leaf4), raytracer::BvhCacheKey(objects, 0.0, 1.0));
+    objects[17] = std::make_shared<raytracer::Sphere>(Point3(0.0, 0.0, -3.0), 0.5,
+                                                      std::make_shared<raytracer::Lambertian>(raytracer::Color(1.0, 0.0, 0.0)));
+    const raytracer::BvhCacheResult changed = raytracer::LoadOrBuildBvh(path, objects, 0.0, 1.0);
+    EXPECT_FALSE(changed.loaded);
+    ExpectSameHits(MakeList(objects), *changed.bvh);
+    EXPECT_TRUE(raytracer::LoadOrBuildBvh(path, objects, 0.0, 1.0).loaded);
+
+    raytracer::BvhBuildOptions spatial;
+    spatial.split = raytracer::BvhSplitMethod::kSpatialSah;
+    EXPECT_THROW(raytracer::BvhCacheKey(objects, 0.0, 1.0, spatial), std::invalid_argument);
+
+    std::remove(path.c_str());
+}
+
+TEST(BvhCacheTest, UnwritableCachePathStillReturnsBuiltTree) {
+    // 없는 디렉터리 안 경로는 임시 파일을 열 수 없다(root로 실행해도 권한과 무관하게 실패한다).
+    const std::string path = ::testing::TempDir() + "bvh_cache_missing_dir/nested/cache.bin";
+    const std::vector<std::shared_ptr<raytracer::Hittable>> objects = MakeSpheres(7, 200);
+
+    const raytracer::BvhCacheResult result = raytracer::LoadOrBuildBvh(path, objects, 0.0, 1.0);
+    ASSERT_NE(result.bvh, nullptr);
+    EXPECT_FALSE(result.loaded);
+    EXPECT_FALSE(result.save_error.empty());
+    ExpectSameHits(MakeList(objects), *result.bvh);
+    EXPECT_EQ(raytracer::LoadBvhCache(path, objects, raytracer::BvhCacheKey(objects, 0.0, 1.0)), nullptr);
+}
+
+TEST(BvhCacheTest, RejectsTruncatedOrCorruptedFiles) {
+    const std::string path = ::testing::TempDir() + "bvh_cache_corrupt_test.bin";
+    const std::vector<std::shared_ptr<raytracer::Hittable>> objects = MakeSpheres(5, 300);
+    const std::uint64_t key = raytracer::BvhCacheKey(objects, 0.0, 1.0);
+    const raytracer::Bvh8 bvh(objects, 0.0, 1.0);
+    raytracer::SaveBvhCache(path, bvh, objects, key);
+    ASSERT_NE(raytracer::LoadBvhCache(path, objects, key), nullptr);
+    EXPECT_EQ(raytracer::LoadBvhCache(path, objects, key + 1), nullptr);
+
+    std::string bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    const auto write = [&path](const std::string& content) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    };
+
+    write(bytes.substr(0, bytes.size() - 1));
+    EXPECT_EQ(raytracer::LoadBvhCache(path, objects, key), nullptr);
+
+    // 첫 노드의 첫 자식 인덱스(헤더 128바이트 + 상자 6 x 8 float 뒤)를 자기 자신으로 바꿔 순환을 만든다.
+    std::string cyclic = bytes;
+    const std::int32_t self = 0;
+    cyclic.replace(128 + 6 * 8 * sizeof(float), sizeof(self), reinterpret_cast<const char*>(&self), sizeof(self));
+    write(cyclic);
+    EXPECT_EQ(raytracer::LoadBvhCache(path, objects, key), nullptr);
+
+    std::remove(path.c_str());
+    EXPECT_EQ(raytracer::LoadBvhCache(path, objects, key), nullptr);
+
+    // 장면 객체 목록에 없는 잎 객체는 기록할 수 없다.
+    const std::vector<std::shared_ptr<raytracer::Hittable>> others = MakeSpheres(5, 300);
+    EXPECT_THROW(raytracer::SaveBvhCache(path, bvh, others, key), std::invalid_argument);
+}
@@ -0,0 +1,161 @@
+/*
+ * 설명: BVH 품질 지표가 손으로 계산한 작은 트리의 값과 맞는지, 빌더와 노드 형식에 관계없이 노드/잎/도형 수가 서로 맞는지,
+ *       순회 카운터가 켠 빌드에서는 여러 스레드의 계수를 합치고 끈 빌드에서는 0으로 남는지 검증한다.
+ * 버전: v1.19.0
+ * 관련 문서: design/renderer/v1.19.0-bvh-stats.md
+ * 테스트: tests/unit/bvh_stats_test.cpp
+ */
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "raytracer/bvh.hpp"
+#include "raytracer/bvh_stats.hpp"
+#include "raytracer/hittable_list.hpp"
+#include "raytracer/material.hpp"
+#include "raytracer/random.hpp"
+#include "raytracer/ray.hpp"
+#include "raytracer/sphere.hpp"
+#include "raytracer/wide_bvh.hpp"
+
+namespace {
+
+using raytracer::Point3;
+using raytracer::Vec3;
+
+std::size_t Sum(const std::vector<std::size_t>& histogram) {
+    return std::accumulate(histogram.begin(), histogram.end(), std::size_t{0});
+}
+
+raytracer::HittableList MakeSpheres(std::uint32_t seed, int count) {
+    raytracer::Rng generator(seed);
+    const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    raytracer::HittableList world;
+    for (int i = 0; i < count; ++i) {
+        // 절반은 좁은 구역에 몰아 트리가 고르지 않게 만든다.
+        const double spread = i % 2 == 0 ? 2.0 : 40.0;
+        world.Add(std::make_shared<raytracer::Sphere>(
+            Point3(raytracer::RandomDouble(generator, -spread, spread), raytracer::RandomDouble(generator, -spread, spread),
+                   raytracer::RandomDouble(generator, -spread, spread) - 60.0),
+            0.5, material));
+    }
+    return world;
+}
+
+}  // namespace
+
+TEST(BvhStatsTest, MatchesHandComputedCostAndOverlap) {
+    const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+
+    // 떨어진 단위 구 두 개: 잎 상자 표면적 24씩, 뿌리 [-6, 6] x [-1, 1] x [-1, 1]은 104.
+    raytracer::HittableList apart;
+    apart.Add(std::make_shared<raytracer::Sphere>(Point3(-5.0, 0.0, 0.0), 1.0, material));
+    apart.Add(std::make_shared<raytracer::Sphere>(Point3(5.0, 0.0, 0.0), 1.0, material));
+    const raytracer::BvhStats apart_stats = raytracer::InspectBvh(raytracer::BvhNode(apart, 0.0, 1.0), 0.0, 1.0);
+    EXPECT_EQ(apart_stats.node_count, 1u);
+    EXPECT_EQ(apart_stats.leaf_count, 2u);
+    EXPECT_EQ(apart_stats.primitive_references, 2u);
+    EXPECT_EQ(apart_stats.leaves_per_depth, (std::vector<std::size_t>{0, 2}));
+    EXPECT_EQ(apart_stats.leaf_sizes, (std::vector<std::size_t>{0, 2}));
+    EXPECT_DOUBLE_EQ(apart_stats.sah_cost, (104.0 + 24.0 + 24.0) / 104.0);
+    EXPECT_DOUBLE_EQ(apart_stats.sibling_overlap_ratio, 0.0);
+
+    // 중심이 1 떨어진 단위 구 두 개: 겹친 상자 [0, 1] x [-1, 1] x [-1, 1]은 16, 뿌리 [-1, 2] x [-1, 1] x [-1, 1]은 32.
+    raytracer::HittableList overlapping;
+    overlapping.Add(std::make_shared<raytracer::Sphere>(Point3(0.0, 0.0, 0.0), 1.0, material));
+    overlapping.Add(std::make_shared<raytracer::Sphere>(Point3(1.0, 0.0, 0.0), 1.0, material));
+    const raytracer::BvhNode tree(overlapping, 0.0, 1.0);
+    EXPECT_DOUBLE_EQ(raytracer::InspectBvh(tree, 0.0, 1.0).sibling_overlap_ratio, 0.5);
+    // 넓은 BVH는 두 칸짜리 노드 하나가 되어 같은 값을 낸다(경계가 float로 정확히 표현된다).
+    const raytracer::BvhStats wide_stats = raytracer::InspectBvh(raytracer::Bvh8(tree, 0.0, 1.0));
+    EXPECT_EQ(wide_stats.node_count, 1u);
+    EXPECT_EQ(wide_stats.leaf_count, 2u);
+    EXPECT_DOUBLE_EQ(wide_stats.sibling_overlap_ratio, 0.5);
+    EXPECT_DOUBLE_EQ(wide_stats.sah_cost, (32.0 + 24.0 + 24.0) / 32.0);
+
+    const std::string text = raytracer::FormatBvhStats(apart_stats);
+    EXPECT_NE(text.find("노드 1개, 잎 2개"), std::string::npos);
+    EXPECT_NE(text.find("깊이별 잎 수: 1:2"), std::string::npos);
+    EXPECT_NE(text.find("잎 크기 분포: 1:2"), std::string::npos);
+}
+
+TEST(BvhStatsTest, CountsAgreeAcrossBuildersAndNodeFormats) {
+    const raytracer::HittableList world = MakeSpheres(91, 500);
+    const std::size_t object_count = world.Objects().size();
+
+    raytracer::BvhBuildOptions median;
+    median.split = raytracer::BvhSplitMethod::kMedian;
+    raytracer::BvhBuildOptions packed;
+    packed.max_leaf_size = 4;
+
+    double binned_cost = 0.0;
+    for (const raytracer::BvhBuildOptions& options : {raytracer::BvhBuildOptions{}, median, packed}) {
+        const raytracer::BvhNode tree(world, 0.0, 1.0, options);
+        const raytracer::BvhStats stats = raytracer::InspectBvh(tree, 0.0, 1.0);
+        EXPECT_EQ(stats.primitive_references, object_count);
+        EXPECT_EQ(stats.node_count + 1, stats.leaf_count);
+        EXPECT_EQ(Sum(stats.leaves_per_depth), stats.leaf_count);
+        EXPECT_EQ(Sum(stats.leaf_sizes), stats.leaf_count);
+        EXPECT_LE(stats.leaf_sizes.size(), static_cast<std::size_t>(options.max_leaf_size) + 1);
+        EXPECT_GE(stats.sah_cost, 1.0);
+        if (options.split == raytracer::BvhSplitMethod::kBinnedSah && options.max_leaf_size == 1) {
+            binned_cost = stats.sah_cost;
+        }
+
+        const raytracer::Bvh8 wide(tree, 0.0, 1.0);
+        const raytracer::BvhStats wide_stats = raytracer::InspectBvh(wide);
+        EXPECT_EQ(wide_stats.node_count, wide.NodeCount());
+        EXPECT_EQ(wide_stats.primitive_references, object_count);
+        EXPECT_EQ(Sum(wide_stats.leaves_per_depth), wide_stats.leaf_count);
+        // 이진 노드를 접으면 노드 수와 깊이가 줄어 순회 비용 항이 작아진다.
+        EXPECT_LT(wide_stats.node_count, stats.node_count);
+        EXPECT_LT(wide_stats.leaves_per_depth.size(), stats.leaves_per_depth.size());
+        EXPECT_LT(wide_stats.sah_cost, stats.sah_cost);
+    }
+
+    // 같은 잎 크기에서 SAH 빌더는 중앙값 빌더보다 비용이 낮은 트리를 만든다.
+    const raytracer::BvhStats median_stats = raytracer::InspectBvh(raytracer::BvhNode(world, 0.0, 1.0, median), 0.0, 1.0);
+    EXPECT_LT(binned_cost, median_stats.sah_cost);
+    EXPECT_TRUE(raytracer::InspectBvh(raytracer::BvhNode(), 0.0, 1.0).leaf_count == 0);
+}
+
+TEST(BvhStatsTest, TraversalCountersSumAcrossThreadsOnlyWhenEnabled) {
+    const raytracer::HittableList world = MakeSpheres(17, 200);
+    const raytracer::Bvh8 bvh(world.Objects(), 0.0, 1.0);
+
+    const auto trace = [&bvh](std::uint32_t seed, int count) {
+        raytracer::Rng generator(seed);
+        for (int i = 0; i < count; ++i) {
+            const raytracer::Ray ray(Point3(0.0, 0.0, 0.0),
+                                     Vec3(raytracer::RandomDouble(generator, -0.5, 0.5),
+                                          raytracer::RandomDouble(generator, -0.5, 0.5), -1.0));
+            raytracer::HitRecord record;
+            bvh.Hit(ray, 0.001, std::numeric_limits<double>::infinity(), record, generator);
+        }
+    };
+
+    raytracer::ResetBvhCounters();
+    trace(1, 300);
+    std::thread worker(trace, 2, 200);
+    worker.join();
+    const raytracer::BvhTraversalCounters counters = raytracer::ReadBvhCounters();
+
+    if (!raytracer::kBvhCountersEnabled) {
+        EXPECT_EQ(counters.rays, 0u);
+        EXPECT_EQ(counters.nodes_visited, 0u);
+        EXPECT_EQ(counters.primitives_tested, 0u);
+        return;
+    }
+    // 끝난 스레드의 계수도 합에 남는다. 뿌리는 레이마다 방문한다.
+    EXPECT_EQ(counters.rays, 500u);
+    EXPECT_GE(counters.nodes_visited, 500u);
+    EXPECT_GT(counters.primitives_tested, 0u);
+
+    raytracer::ResetBvhCounters();
+    EXPECT_EQ(raytracer::ReadBvhCounters().rays, 0u);
+}
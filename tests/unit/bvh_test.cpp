@@ -1,27 +1,137 @@
 /*
- * 설명: BVH 트리가 RNG 전달 후에도 원본 HittableList와 동일한 hit 결과를 반환하는지 검증한다.
- * 버전: v0.9.0
- * 관련 문서: design/renderer/v0.6.0-bvh.md, design/renderer/v0.9.0-volume.md
+ * 설명: BVH 트리와 이를 평탄화한 선형 BVH가 빌더(중앙값/SAH, 잎 크기)와 무관하게, RNG 전달 후에도, 객체 이동 뒤
+ *       재맞춤(refit)한 뒤에도 원본 HittableList와 동일한 hit 결과를 반환하는지 검증한다. 공간 분할(SBVH)은 참조
+ *       복제 상한도 확인한다. 양자화 노드 BVH는 부모 상자 기준 격자에서 정밀도가 부족한 장면도 확인한다.
+ *       가림 판정(Occluded)이 유한 구간에서 hit 여부와 같고 첫 교차에서 멈추는지도 확인한다. 넓은 BVH의 레이 묶음
+ *       순회는 볼륨이 섞인 장면에서도 레이마다 단일 순회와 같은 기록과 난수 상태를 남겨야 한다. 타일 절두체로 잘라 낸
+ *       부분 트리도 절두체 안 화면 레이에게 같은 기록과 난수 상태를 남겨야 한다. 지연 빌드 트리는 레이가 들어온
+ *       부분만 나누면서 즉시 빌드 트리와 같은 결과를 내고, 여러 스레드가 동시에 들어와도 노드마다 한 번만 나눠야 한다.
+ *       모션 BVH는 셔터 안 어느 시각의 레이에도 구간 전체 경계 트리와 같은 교차를 내면서 도형을 덜 검사해야 한다.
+ * 버전: v1.25.0
+ * 관련 문서: design/renderer/v0.6.0-bvh.md, design/renderer/v0.9.0-volume.md, design/renderer/v1.9.0-animation.md,
+ *           design/renderer/v1.10.0-sah-build.md, design/renderer/v1.11.0-linear-bvh.md,
+ *           design/renderer/v1.15.0-sbvh.md, design/renderer/v1.17.0-quantized-bvh.md,
+ *           design/renderer/v1.20.0-occlusion.md, design/renderer/v1.21.0-ray-packets.md,
+ *           design/renderer/v1.23.0-tile-culling.md, design/renderer/v1.24.0-lazy-bvh.md,
+ *           design/renderer/v1.25.0-motion-bvh.md
  * 테스트: tests/unit/bvh_test.cpp
  */
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <memory>
-#include <random>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include "raytracer/bvh.hpp"
+#include "raytracer/bvh_stats.hpp"
+#include "raytracer/camera.hpp"
+#include "raytracer/constant_medium.hpp"
 #include "raytracer/hittable_list.hpp"
+#include "raytracer/linear_bvh.hpp"
 #include "raytracer/material.hpp"
+#include "raytracer/motion_bvh.hpp"
+#include "raytracer/quad.hpp"
+#include "raytracer/quantized_bvh.hpp"
+#include "raytracer/random.hpp"
 #include "raytracer/ray.hpp"
 #include "raytracer/sphere.hpp"
+#include "raytracer/thread_pool.hpp"
+#include "raytracer/transform.hpp"
 #include "raytracer/vec3.hpp"
+#include "raytracer/wide_bvh.hpp"
 
 namespace {
 
 double Inf() { return std::numeric_limits<double>::infinity(); }
 
+void ExpectSameHits(const raytracer::Hittable& expected, const raytracer::Hittable& actual,
+                    const std::vector<raytracer::Ray>& rays) {
+    for (const auto& ray : rays) {
+        raytracer::HitRecord expected_record;
+        raytracer::HitRecord actual_record;
+        raytracer::Rng expected_generator(99);
+        raytracer::Rng actual_generator(99);
+
+        const bool expected_hit = expected.Hit(ray, 0.001, Inf(), expected_record, expected_generator);
+        ASSERT_EQ(expected_hit, actual.Hit(ray, 0.001, Inf(), actual_record, actual_generator));
+        if (expected_hit) {
+            EXPECT_NEAR(expected_record.t, actual_record.t, 1e-12);
+            EXPECT_EQ(expected_record.material.get(), actual_record.material.get());
+        }
+    }
+}
+
+// z ∈ [-12, -2] 구역에 구를 흩뿌리고 열 개 중 하나는 hit마다 난수를 쓰는 볼륨으로 만든다.
+raytracer::HittableList MakeSpheresWithMedia(std::uint32_t seed, int count) {
+    raytracer::HittableList world;
+    const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    raytracer::Rng scene_generator(seed);
+    for (int i = 0; i < count; ++i) {
+        const raytracer::Point3 center(raytracer::RandomDouble(scene_generator, -5.0, 5.0),
+                                       raytracer::RandomDouble(scene_generator, -5.0, 5.0),
+                                       raytracer::RandomDouble(scene_generator, -12.0, -2.0));
+        if (i % 10 == 0) {
+            const auto boundary = std::make_shared<raytracer::Sphere>(center, 1.0, material);
+            world.Add(std::make_shared<raytracer::ConstantMedium>(boundary, 0.8, raytracer::Color(0.9, 0.9, 0.9)));
+        } else {
+            world.Add(std::make_shared<raytracer::Sphere>(center, 0.4, material));
+        }
+    }
+    return world;
+}
+
+// 감싼 객체의 hit가 호출된 순서를 기록해 두 트리의 잎 배치와 방문 순서가 같은지 비교한다.
+class VisitRecorder : public raytracer::Hittable {
+public:
+    VisitRecorder(std::shared_ptr<raytracer::Hittable> inner, int id, std::vector<int>& visits)
+        : inner_(std::move(inner)), id_(id), visits_(visits) {}
+
+    bool Hit(const raytracer::Ray& r, double t_min, double t_max, raytracer::HitRecord& record,
+             raytracer::Rng& generator) const override {
+        visits_.push_back(id_);
+        return inner_->Hit(r, t_min, t_max, record, generator);
+    }
+
+    bool BoundingBox(double time0, double time1, raytracer::Aabb& output_box) const override {
+        return inner_->BoundingBox(time0, time1, output_box);
+    }
+
+private:
+    std::shared_ptr<raytracer::Hittable> inner_;
+    int id_;
+    std::vector<int>& visits_;
+};
+
+// 기본 도형 Hit 호출 수를 센다. 모션 경계도 안쪽 객체의 것을 그대로 넘긴다.
+class CountingHittable : public raytracer::Hittable {
+public:
+    CountingHittable(std::shared_ptr<raytracer::Hittable> inner, std::size_t& calls)
+        : inner_(std::move(inner)), calls_(calls) {}
+
+    bool Hit(const raytracer::Ray& r, double t_min, double t_max, raytracer::HitRecord& record,
+             raytracer::Rng& generator) const override {
+        ++calls_;
+        return inner_->Hit(r, t_min, t_max, record, generator);
+    }
+
+    bool BoundingBox(double time0, double time1, raytracer::Aabb& output_box) const override {
+        return inner_->BoundingBox(time0, time1, output_box);
+    }
+
+    bool MotionBounds(double time0, double time1, raytracer::Aabb& box0, raytracer::Aabb& box1) const override {
+        return inner_->MotionBounds(time0, time1, box0, box1);
+    }
+
+private:
+    std::shared_ptr<raytracer::Hittable> inner_;
+    std::size_t& calls_;
+};
+
 }  // namespace
 
 TEST(BvhTest, MatchesHittableListHits) {
@@ -58,8 +168,8 @@ TEST(BvhTest, MatchesHittableListHits) {
         HitRecord list_record;
         HitRecord bvh_record;
 
-        std::mt19937 list_generator(1234);
-        std::mt19937 bvh_generator(1234);
+        raytracer::Rng list_generator(1234);
+        raytracer::Rng bvh_generator(1234);
 
         const bool list_hit = world.Hit(ray, 0.001, Inf(), list_record, list_generator);
         const bool bvh_hit = bvh.Hit(ray, 0.001, Inf(), bvh_record, bvh_generator);
@@ -78,3 +188,864 @@ TEST(BvhTest, MatchesHittableListHits) {
         }
     }
 }
+
+TEST(BvhTest, RefitTracksMovedObjectsAndRebuildsOnlyDegradedSubtrees) {
+    using raytracer::BvhNode;
+    using raytracer::HittableList;
+    using raytracer::Point3;
+    using raytracer::Ray;
+    using raytracer::Vec3;
+
+    HittableList world;
+    std::vector<std::shared_ptr<raytracer::Translate>> movers;
+    for (int i = 0; i < 8; ++i) {
+        const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.1 * i, 0.5, 0.5));
+        const auto sphere = std::make_shared<raytracer::Sphere>(Point3(0.0, 0.0, 0.0), 0.4, material);
+        movers.push_back(std::make_shared<raytracer::Translate>(sphere, Vec3(2.0 * i, 0.0, -5.0)));
+        world.Add(movers.back());
+    }
+    BvhNode bvh(world.Objects(), 0.0, 1.0);
+
+    std::vector<Ray> rays;
+    for (int i = 0; i < 64; ++i) {
+        rays.emplace_back(Point3(0.25 * i - 1.0, 0.1, 0.0), Vec3(0.0, 0.0, -1.0), 0.0);
+    }
+
+    // 작은 이동은 구조를 유지한 채 경계만 갱신한다.
+    for (std::size_t i = 0; i < movers.size(); ++i) {
+        movers[i]->SetOffset(movers[i]->Offset() + Vec3(0.3, 0.05 * static_cast<double>(i), 0.0));
+    }
+    const raytracer::BvhRefitStats small_move = bvh.Refit(0.0, 1.0, 1.5);
+    EXPECT_EQ(small_move.refitted_nodes, 7);
+    EXPECT_EQ(small_move.rebuilt_subtrees, 0);
+    ExpectSameHits(world, bvh, rays);
+
+    // 자리를 뒤섞으면 형제 상자가 서로 겹쳐 면적 비용이 커지므로 재구성한다.
+    const int shuffled_slots[] = {5, 2, 7, 0, 3, 6, 1, 4};
+    for (std::size_t i = 0; i < movers.size(); ++i) {
+        movers[i]->SetOffset(Vec3(2.0 * shuffled_slots[i], 0.0, -5.0));
+    }
+    const raytracer::BvhRefitStats shuffled = bvh.Refit(0.0, 1.0, 1.1);
+    EXPECT_GT(shuffled.rebuilt_subtrees, 0);
+    ExpectSameHits(world, bvh, rays);
+
+    EXPECT_THROW(bvh.Refit(0.0, 1.0, 0.5), std::invalid_argument);
+}
+
+TEST(BvhTest, EveryBuilderMatchesHittableListHitsBeforeAndAfterRefit) {
+    using raytracer::BvhBuildOptions;
+    using raytracer::BvhSplitMethod;
+    using raytracer::Point3;
+    using raytracer::Vec3;
+
+    // 한쪽에 몰린 구 무리와 흩어진 구를 섞어 SAH 분할이 중앙값과 다른 트리를 만들게 한다.
+    raytracer::Rng generator(7);
+    raytracer::HittableList world;
+    std::vector<std::shared_ptr<raytracer::Translate>> movers;
+    const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    for (int i = 0; i < 120; ++i) {
+        const double spread = i < 90 ? 1.0 : 8.0;
+        const Vec3 offset(raytracer::RandomDouble(generator, -spread, spread), raytracer::RandomDouble(generator, -spread, spread),
+                          raytracer::RandomDouble(generator, -12.0, -4.0));
+        const auto sphere = std::make_shared<raytracer::Sphere>(Point3(0.0, 0.0, 0.0), 0.15, material);
+        movers.push_back(std::make_shared<raytracer::Translate>(sphere, offset));
+        world.Add(movers.back());
+    }
+
+    std::vector<raytracer::Ray> rays;
+    for (int i = 0; i < 400; ++i) {
+        rays.emplace_back(Point3(0.0, 0.0, 0.0),
+                          Vec3(raytracer::RandomDouble(generator, -0.6, 0.6), raytracer::RandomDouble(generator, -0.6, 0.6), -1.0),
+                          0.0);
+    }
+
+    std::vector<BvhBuildOptions> builders(4);
+    builders[0].split = BvhSplitMethod::kMedian;
+    builders[2].max_leaf_size = 4;
+    builders[3].bin_count = 2;
+
+    for (const BvhBuildOptions& options : builders) {
+        raytracer::BvhNode bvh(world, 0.0, 1.0, options);
+        ExpectSameHits(world, bvh, rays);
+        ExpectSameHits(world, raytracer::LinearBvh(bvh, 0.0, 1.0), rays);
+        ExpectSameHits(world, raytracer::Bvh4(bvh, 0.0, 1.0), rays);
+        ExpectSameHits(world, raytracer::Bvh8(bvh, 0.0, 1.0), rays);
+        ExpectSameHits(world, raytracer::QuantizedBvh8(bvh, 0.0, 1.0), rays);
+        ExpectSameHits(world, raytracer::QuantizedBvh16(bvh, 0.0, 1.0), rays);
+
+        // 자리를 한 칸씩 돌려 트리를 크게 흐트러뜨린 뒤 재맞춤/재구성해도 결과가 같아야 한다.
+        const Vec3 first = movers.front()->Offset();
+        for (std::size_t i = 0; i + 1 < movers.size(); ++i) {
+            movers[i]->SetOffset(movers[i + 1]->Offset());
+        }
+        movers.back()->SetOffset(first);
+        bvh.Refit(0.0, 1.0, 1.0);
+        ExpectSameHits(world, bvh, rays);
+        ExpectSameHits(world, raytracer::LinearBvh(bvh, 0.0, 1.0), rays);
+        ExpectSameHits(world, raytracer::Bvh4(bvh, 0.0, 1.0), rays);
+        ExpectSameHits(world, raytracer::Bvh8(bvh, 0.0, 1.0), rays);
+        ExpectSameHits(world, raytracer::QuantizedBvh8(bvh, 0.0, 1.0), rays);
+        ExpectSameHits(world, raytracer::QuantizedBvh16(bvh, 0.0, 1.0), rays);
+    }
+
+    BvhBuildOptions invalid;
+    invalid.max_leaf_size = 0;
+    EXPECT_THROW(raytracer::BvhNode(world, 0.0, 1.0, invalid), std::invalid_argument);
+    invalid.max_leaf_size = 1;
+    invalid.bin_count = 1;
+    EXPECT_THROW(raytracer::BvhNode(world, 0.0, 1.0, invalid), std::invalid_argument);
+}
+
+TEST(BvhTest, LinearBvhStoresDepthFirstCompactNodes) {
+    using raytracer::Point3;
+
+    raytracer::HittableList world;
+    const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    for (int i = 0; i < 10; ++i) {
+        world.Add(std::make_shared<raytracer::Sphere>(Point3(static_cast<double>(i), 0.0, -3.0), 0.3, material));
+    }
+
+    raytracer::BvhBuildOptions options;
+    const raytracer::LinearBvh single_leaves(world.Objects(), 0.0, 1.0, options);
+    EXPECT_EQ(sizeof(raytracer::LinearBvhNode), 32u);
+    EXPECT_EQ(single_leaves.PrimitiveCount(), 10u);
+    EXPECT_EQ(single_leaves.NodeCount(), 19u);
+
+    options.max_leaf_size = 4;
+    const raytracer::LinearBvh grouped_leaves(world.Objects(), 0.0, 1.0, options);
+    EXPECT_EQ(grouped_leaves.PrimitiveCount(), 10u);
+    EXPECT_LT(grouped_leaves.NodeCount(), single_leaves.NodeCount());
+
+    const raytracer::LinearBvh lone(std::vector<std::shared_ptr<raytracer::Hittable>>{world.Objects().front()}, 0.0, 1.0);
+    EXPECT_EQ(lone.NodeCount(), 1u);
+    ExpectSameHits(raytracer::HittableList(world.Objects().front()), lone,
+                   {raytracer::Ray(Point3(0.0, 0.0, 0.0), raytracer::Vec3(0.0, 0.0, -1.0), 0.0),
+                    raytracer::Ray(Point3(0.0, 0.0, 0.0), raytracer::Vec3(0.0, 1.0, 0.0), 0.0)});
+}
+
+TEST(BvhTest, WideBvhCollapsesBinaryTreeIntoFullNodes) {
+    using raytracer::Point3;
+
+    raytracer::HittableList world;
+    const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    for (int i = 0; i < 10; ++i) {
+        world.Add(std::make_shared<raytracer::Sphere>(Point3(static_cast<double>(i), 0.0, -3.0), 0.3, material));
+    }
+
+    // 이진 트리의 내부 노드 9개가 4칸/8칸 노드로 접혀 노드 수와 깊이가 줄어야 한다.
+    const raytracer::BvhNode tree(world, 0.0, 1.0);
+    const raytracer::Bvh4 bvh4(tree, 0.0, 1.0);
+    const raytracer::Bvh8 bvh8(tree, 0.0, 1.0);
+    EXPECT_EQ(sizeof(raytracer::WideBvhNode<4>), 128u);
+    EXPECT_EQ(sizeof(raytracer::WideBvhNode<8>), 256u);
+    EXPECT_EQ(bvh4.PrimitiveCount(), 10u);
+    EXPECT_EQ(bvh8.PrimitiveCount(), 10u);
+    EXPECT_LT(bvh4.NodeCount(), 9u);
+    EXPECT_LT(bvh8.NodeCount(), bvh4.NodeCount());
+    EXPECT_LT(bvh4.Depth(), raytracer::LinearBvh(tree, 0.0, 1.0).Depth());
+
+    std::vector<raytracer::Ray> rays;
+    for (int i = 0; i <= 40; ++i) {
+        rays.emplace_back(Point3(-1.0 + 0.3 * i, 0.0, 0.0), raytracer::Vec3(0.1, 0.0, -1.0), 0.0);
+        rays.emplace_back(Point3(-2.0, 0.0, -3.0), raytracer::Vec3(1.0, 0.01 * (i - 20), 0.0), 0.0);
+    }
+    ExpectSameHits(world, bvh4, rays);
+    ExpectSameHits(world, bvh8, rays);
+
+    const raytracer::Bvh4 lone(std::vector<std::shared_ptr<raytracer::Hittable>>{world.Objects().front()}, 0.0, 1.0);
+    EXPECT_EQ(lone.NodeCount(), 1u);
+    ExpectSameHits(raytracer::HittableList(world.Objects().front()), lone, rays);
+}
+
+TEST(BvhTest, ParallelBuildMatchesSerialTree) {
+    using raytracer::BvhBuildOptions;
+    using raytracer::BvhSplitMethod;
+    using raytracer::Point3;
+    using raytracer::Vec3;
+
+    // 병렬 분기 기준(16384개)을 넘겨야 조각 집계와 자식 동시 빌드가 실제로 쓰인다.
+    raytracer::Rng generator(13);
+    std::vector<int> visits;
+    std::vector<std::shared_ptr<raytracer::Hittable>> objects;
+    const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    for (int i = 0; i < 20000; ++i) {
+        const double spread = i % 4 == 0 ? 30.0 : 5.0;
+        const Point3 center(raytracer::RandomDouble(generator, -spread, spread),
+                            raytracer::RandomDouble(generator, -spread, spread), raytracer::RandomDouble(generator, -40.0, -10.0));
+        objects.push_back(
+            std::make_shared<VisitRecorder>(std::make_shared<raytracer::Sphere>(center, 0.1, material), i, visits));
+    }
+
+    std::vector<raytracer::Ray> rays;
+    for (int i = 0; i < 64; ++i) {
+        rays.emplace_back(Point3(0.0, 0.0, 0.0),
+                          Vec3(raytracer::RandomDouble(generator, -0.5, 0.5), raytracer::RandomDouble(generator, -0.5, 0.5), -1.0),
+                          0.0);
+    }
+    const auto record_visits = [&](const raytracer::Hittable& bvh) {
+        visits.clear();
+        for (const auto& ray : rays) {
+            raytracer::HitRecord record;
+            raytracer::Rng ray_generator(5);
+            bvh.Hit(ray, 0.001, Inf(), record, ray_generator);
+        }
+        return visits;
+    };
+
+    std::vector<BvhBuildOptions> builders(2);
+    builders[0].split = BvhSplitMethod::kMedian;
+    raytracer::ThreadPool pool(4);
+    for (const BvhBuildOptions& options : builders) {
+        const raytracer::BvhNode serial(objects, 0.0, 1.0, options);
+        const raytracer::BvhNode parallel(objects, 0.0, 1.0, options, pool);
+        const std::vector<int> serial_visits = record_visits(serial);
+        ASSERT_FALSE(serial_visits.empty());
+        EXPECT_EQ(serial_visits, record_visits(parallel));
+
+        const raytracer::LinearBvh serial_linear(serial, 0.0, 1.0);
+        const raytracer::LinearBvh parallel_linear(parallel, 0.0, 1.0);
+        EXPECT_EQ(serial_linear.NodeCount(), parallel_linear.NodeCount());
+        EXPECT_EQ(serial_linear.Depth(), parallel_linear.Depth());
+        EXPECT_EQ(record_visits(serial_linear), record_visits(parallel_linear));
+    }
+}
+
+TEST(BvhTest, VisitsNearerChildFirstAndStopsAtClosestHit) {
+    using raytracer::Point3;
+    using raytracer::Vec3;
+
+    // x축 위에 늘어선 구를 양쪽 끝에서 쏘면 레이 쪽 끝 구부터 방문하고, 교차를 찾은 뒤에는 먼 상자를 건너뛰어야 한다.
+    // 객체 자식은 노드 상자 안에서 따로 상자 검사 없이 호출되므로, 가장 가까운 구의 형제 객체 둘까지는 방문될 수 있다.
+    std::vector<int> visits;
+    raytracer::HittableList world;
+    std::vector<std::shared_ptr<raytracer::Translate>> movers;
+    const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    for (int i = 0; i < 10; ++i) {
+        movers.push_back(std::make_shared<raytracer::Translate>(
+            std::make_shared<raytracer::Sphere>(Point3(0.0, 0.0, 0.0), 0.3, material), Vec3(static_cast<double>(i), 0.0, 0.0)));
+        world.Add(std::make_shared<VisitRecorder>(movers.back(), i, visits));
+    }
+
+    const raytracer::Ray forward(Point3(-5.0, 0.0, 0.0), Vec3(1.0, 0.0, 0.0), 0.0);
+    const raytracer::Ray backward(Point3(15.0, 0.0, 0.0), Vec3(-1.0, 0.0, 0.0), 0.0);
+    const auto first_visits = [&](const raytracer::Hittable& bvh, const raytracer::Ray& ray) {
+        visits.clear();
+        raytracer::HitRecord record;
+        raytracer::Rng generator(3);
+        EXPECT_TRUE(bvh.Hit(ray, 0.001, Inf(), record, generator));
+        return visits;
+    };
+
+    raytracer::BvhNode bvh(world, 0.0, 1.0);
+    std::vector<int> forward_visits = first_visits(bvh, forward);
+    ASSERT_FALSE(forward_visits.empty());
+    EXPECT_EQ(forward_visits.front(), 0);
+    EXPECT_LE(forward_visits.size(), 3u);
+    const std::vector<int> backward_visits = first_visits(bvh, backward);
+    ASSERT_FALSE(backward_visits.empty());
+    EXPECT_EQ(backward_visits.front(), 9);
+    EXPECT_LE(backward_visits.size(), 3u);
+
+    // 순서를 뒤집어 재맞춤하면 방문 순서도 새 위치를 따라야 한다.
+    for (int i = 0; i < 10; ++i) {
+        movers[static_cast<std::size_t>(i)]->SetOffset(Vec3(static_cast<double>(9 - i), 0.0, 0.0));
+    }
+    bvh.Refit(0.0, 1.0, 1.0e9);
+    forward_visits = first_visits(bvh, forward);
+    ASSERT_FALSE(forward_visits.empty());
+    EXPECT_EQ(forward_visits.front(), 9);
+    EXPECT_LE(forward_visits.size(), 3u);
+
+    std::vector<raytracer::Ray> rays;
+    raytracer::Rng generator(21);
+    for (int i = 0; i < 200; ++i) {
+        rays.emplace_back(Point3(RandomDouble(generator, -2.0, 11.0), RandomDouble(generator, -1.0, 1.0), 4.0),
+                          Vec3(RandomDouble(generator, -1.0, 1.0), RandomDouble(generator, -0.2, 0.2), -1.0), 0.0);
+    }
+    rays.push_back(forward);
+    rays.push_back(backward);
+    ExpectSameHits(world, bvh, rays);
+}
+
+TEST(BvhTest, SpatialSplitsMatchListHitsWithinReferenceBudget) {
+    using raytracer::Point3;
+    using raytracer::Vec3;
+
+    // 큰 벽 quad가 작은 구들 위로 겹쳐 객체 분할만으로는 자식 상자가 크게 겹치는 장면이다.
+    raytracer::HittableList world;
+    const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    world.Add(std::make_shared<raytracer::Quad>(Point3(-10.0, -10.0, 0.0), Vec3(20.0, 0.0, 0.0), Vec3(0.0, 20.0, 0.0),
+                                                material));
+    world.Add(std::make_shared<raytracer::Quad>(Point3(-10.0, -10.0, -10.0), Vec3(20.0, 0.0, 0.0),
+                                                Vec3(0.0, 0.0, 20.0), material));
+    world.Add(std::make_shared<raytracer::Quad>(Point3(-10.0, -10.0, -10.0), Vec3(0.0, 20.0, 0.0),
+                                                Vec3(0.0, 0.0, 20.0), material));
+    raytracer::Rng scene_generator(5);
+    for (int i = 0; i < 200; ++i) {
+        world.Add(std::make_shared<raytracer::Sphere>(Point3(raytracer::RandomDouble(scene_generator, -9.0, 9.0),
+                                                             raytracer::RandomDouble(scene_generator, -9.0, 9.0),
+                                                             raytracer::RandomDouble(scene_generator, -9.0, 9.0)),
+                                                      0.2, material));
+    }
+
+    std::vector<raytracer::Ray> rays;
+    raytracer::Rng ray_generator(8);
+    for (int i = 0; i < 500; ++i) {
+        rays.emplace_back(Point3(raytracer::RandomDouble(ray_generator, -12.0, 12.0), raytracer::RandomDouble(ray_generator, -12.0, 12.0),
+                                 raytracer::RandomDouble(ray_generator, -12.0, 12.0)),
+                          Vec3(raytracer::RandomDouble(ray_generator, -1.0, 1.0), raytracer::RandomDouble(ray_generator, -1.0, 1.0),
+                               raytracer::RandomDouble(ray_generator, -1.0, 1.0)),
+                          0.0);
+    }
+
+    raytracer::BvhBuildOptions options;
+    options.split = raytracer::BvhSplitMethod::kSpatialSah;
+    options.max_leaf_size = 2;
+    raytracer::BvhNode sbvh(world, 0.0, 1.0, options);
+    ExpectSameHits(world, sbvh, rays);
+    ExpectSameHits(world, raytracer::LinearBvh(sbvh, 0.0, 1.0), rays);
+    ExpectSameHits(world, raytracer::Bvh8(sbvh, 0.0, 1.0), rays);
+
+    const std::size_t object_count = world.Objects().size();
+    const std::size_t references = raytracer::LinearBvh(sbvh, 0.0, 1.0).PrimitiveCount();
+    EXPECT_GT(references, object_count);
+    EXPECT_LE(references, object_count + static_cast<std::size_t>(options.max_reference_growth * object_count));
+
+    options.max_reference_growth = 0.0;
+    raytracer::BvhNode unsplit(world, 0.0, 1.0, options);
+    EXPECT_EQ(raytracer::LinearBvh(unsplit, 0.0, 1.0).PrimitiveCount(), object_count);
+    ExpectSameHits(world, unsplit, rays);
+
+    // 재맞춤은 잘린 참조를 원래 객체로 되돌려 다시 빌드한다.
+    const raytracer::BvhRefitStats stats = sbvh.Refit(0.0, 1.0, 1.0e9);
+    EXPECT_EQ(stats.rebuilt_subtrees, 1u);
+    ExpectSameHits(world, sbvh, rays);
+    EXPECT_EQ(raytracer::LinearBvh(sbvh, 0.0, 1.0).PrimitiveCount(), references);
+
+    options.max_reference_growth = -0.5;
+    EXPECT_THROW(raytracer::BvhNode(world, 0.0, 1.0, options), std::invalid_argument);
+}
+
+TEST(BvhTest, QuantizedBvhKeepsConservativeBoundsFarFromOrigin) {
+    using raytracer::Point3;
+    using raytracer::Vec3;
+
+    // 원점에서 먼 곳에 아주 작은 구를 빽빽하게 두고 멀리 흩어진 구와 섞어, 뿌리 상자 격자 한 칸보다 작은 자식이
+    // 여러 단계 아래까지 이어지게 한다. 복원한 상자가 조금이라도 작으면 hit를 놓친다.
+    raytracer::Rng generator(17);
+    raytracer::HittableList world;
+    const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    for (int i = 0; i < 300; ++i) {
+        world.Add(std::make_shared<raytracer::Sphere>(
+            Point3(1000.0 + raytracer::RandomDouble(generator, -0.01, 0.01),
+                   1000.0 + raytracer::RandomDouble(generator, -0.01, 0.01), 1000.0),
+            0.0005, material));
+    }
+    for (int i = 0; i < 30; ++i) {
+        world.Add(std::make_shared<raytracer::Sphere>(
+            Point3(raytracer::RandomDouble(generator, -1000.0, 1000.0), raytracer::RandomDouble(generator, -1000.0, 1000.0),
+                   1000.0),
+            1.0, material));
+    }
+
+    // 작은 구의 중심을 정확히 겨눠 모두 맞아야 한다.
+    std::vector<raytracer::Ray> rays;
+    for (std::size_t i = 0; i < 300; ++i) {
+        const auto& sphere = world.Objects()[i];
+        raytracer::Aabb box;
+        ASSERT_TRUE(sphere->BoundingBox(0.0, 1.0, box));
+        const Point3 center = 0.5 * (box.minimum() + box.maximum());
+        rays.emplace_back(Point3(center.x(), center.y(), 990.0), Vec3(0.0, 0.0, 1.0), 0.0);
+        rays.emplace_back(Point3(center.x() + 0.00049, center.y(), 990.0), Vec3(0.0, 0.0, 1.0), 0.0);
+    }
+
+    raytracer::BvhBuildOptions options;
+    for (const int leaf_size : {1, 4, 40}) {
+        options.max_leaf_size = leaf_size;
+        const raytracer::BvhNode tree(world, 0.0, 1.0, options);
+        const raytracer::QuantizedBvh8 bvh8(tree, 0.0, 1.0);
+        const raytracer::QuantizedBvh16 bvh16(tree, 0.0, 1.0);
+        ExpectSameHits(world, bvh8, rays);
+        ExpectSameHits(world, bvh16, rays);
+        // 잎 노드를 따로 두지 않으므로 내부 노드만 남는다.
+        EXPECT_LT(bvh8.NodeCount(), raytracer::LinearBvh(tree, 0.0, 1.0).NodeCount());
+        EXPECT_EQ(bvh8.NodeCount(), bvh16.NodeCount());
+    }
+
+    // 33개 이상 잎 목록(작은 구 무리)은 목록 자체를 객체 하나로 담는다.
+    options.max_leaf_size = 400;
+    const raytracer::QuantizedBvh8 packed(world.Objects(), 0.0, 1.0, options);
+    EXPECT_LT(packed.PrimitiveCount(), world.Objects().size());
+    ExpectSameHits(world, packed, rays);
+
+    // 객체 하나짜리 뿌리는 빈 자식을 두어 두 번 검사하지 않는다.
+    const raytracer::QuantizedBvh8 lone(
+        std::vector<std::shared_ptr<raytracer::Hittable>>{world.Objects().front()}, 0.0, 1.0);
+    EXPECT_EQ(lone.NodeCount(), 1u);
+    EXPECT_EQ(lone.PrimitiveCount(), 1u);
+    raytracer::HitRecord record;
+    raytracer::Rng hit_generator(1);
+    EXPECT_TRUE(lone.Hit(rays.front(), 0.001, Inf(), record, hit_generator));
+}
+
+TEST(BvhTest, OccludedAgreesWithHitWithinFiniteSegment) {
+    using raytracer::Point3;
+    using raytracer::Vec3;
+
+    // 구, 움직이는 구, 회전·이동한 상자, 벽 quad를 섞어 모든 Occluded 구현을 거치게 한다.
+    raytracer::HittableList world;
+    const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    raytracer::Rng scene_generator(23);
+    for (int i = 0; i < 60; ++i) {
+        const Point3 center(raytracer::RandomDouble(scene_generator, -6.0, 6.0),
+                            raytracer::RandomDouble(scene_generator, -6.0, 6.0),
+                            raytracer::RandomDouble(scene_generator, -6.0, 6.0));
+        if (i % 3 == 0) {
+            world.Add(std::make_shared<raytracer::Sphere>(center, 0.4, material));
+        } else if (i % 3 == 1) {
+            world.Add(std::make_shared<raytracer::MovingSphere>(center, center + Vec3(0.0, 0.5, 0.0), 0.0, 1.0, 0.3,
+                                                                material));
+        } else {
+            const auto box = std::make_shared<raytracer::Box>(Point3(0.0, 0.0, 0.0), Point3(0.6, 0.9, 0.6), material);
+            const auto rotated = std::make_shared<raytracer::RotateY>(box, 20.0 * i);
+            world.Add(std::make_shared<raytracer::Translate>(rotated, center));
+        }
+    }
+    world.Add(std::make_shared<raytracer::Quad>(Point3(-8.0, -8.0, -8.0), Vec3(16.0, 0.0, 0.0), Vec3(0.0, 16.0, 0.0),
+                                                material));
+
+    raytracer::BvhBuildOptions spatial;
+    spatial.split = raytracer::BvhSplitMethod::kSpatialSah;
+    const raytracer::BvhNode bvh(world, 0.0, 1.0);
+    const raytracer::BvhNode sbvh(world, 0.0, 1.0, spatial);
+    const raytracer::Bvh4 bvh4(bvh, 0.0, 1.0);
+    const raytracer::Bvh8 bvh8(sbvh, 0.0, 1.0);
+    const raytracer::LinearBvh linear(bvh, 0.0, 1.0);
+    const std::vector<const raytracer::Hittable*> accelerators{&world, &bvh, &sbvh, &bvh4, &bvh8, &linear};
+
+    raytracer::Rng ray_generator(31);
+    int occluded = 0;
+    for (int i = 0; i < 600; ++i) {
+        const raytracer::Ray ray(Point3(raytracer::RandomDouble(ray_generator, -7.0, 7.0),
+                                        raytracer::RandomDouble(ray_generator, -7.0, 7.0),
+                                        raytracer::RandomDouble(ray_generator, -7.0, 7.0)),
+                                 Vec3(raytracer::RandomDouble(ray_generator, -1.0, 1.0),
+                                      raytracer::RandomDouble(ray_generator, -1.0, 1.0),
+                                      raytracer::RandomDouble(ray_generator, -1.0, 1.0)),
+                                 raytracer::RandomDouble(ray_generator, 0.0, 1.0));
+        // 짧은 구간부터 무한 구간까지 섞어 t_max 앞에서 멈추는지도 확인한다.
+        const double t_max = i % 4 == 0 ? Inf() : raytracer::RandomDouble(ray_generator, 0.1, 10.0);
+
+        raytracer::HitRecord record;
+        raytracer::Rng hit_generator(3);
+        const bool expected = world.Hit(ray, 0.001, t_max, record, hit_generator);
+        occluded += expected ? 1 : 0;
+        for (const raytracer::Hittable* accelerator : accelerators) {
+            raytracer::Rng generator(3);
+            EXPECT_EQ(expected, accelerator->Occluded(ray, 0.001, t_max, generator)) << "ray " << i;
+        }
+    }
+    // 가린 레이와 가리지 않은 레이가 모두 충분히 섞여야 비교가 의미 있다.
+    EXPECT_GT(occluded, 50);
+    EXPECT_LT(occluded, 550);
+}
+
+TEST(BvhTest, OccludedStopsAtFirstBlockingObject) {
+    using raytracer::Point3;
+    using raytracer::Vec3;
+
+    // 레이 위에 줄지은 구들: 가장 가까운 교차를 찾으려면 모두 검사해야 하지만 가림 판정은 첫 객체에서 끝난다.
+    std::vector<int> visits;
+    raytracer::HittableList world;
+    const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    for (int i = 0; i < 8; ++i) {
+        const auto sphere = std::make_shared<raytracer::Sphere>(Point3(0.0, 0.0, -2.0 - 2.0 * (7 - i)), 0.5, material);
+        world.Add(std::make_shared<VisitRecorder>(sphere, i, visits));
+    }
+    const raytracer::Ray ray(Point3(0.0, 0.0, 0.0), Vec3(0.0, 0.0, -1.0), 0.0);
+
+    raytracer::HitRecord record;
+    raytracer::Rng generator(1);
+    ASSERT_TRUE(world.Hit(ray, 0.001, Inf(), record, generator));
+    EXPECT_EQ(visits.size(), 8u);
+
+    visits.clear();
+    ASSERT_TRUE(world.Occluded(ray, 0.001, Inf(), generator));
+    EXPECT_EQ(visits, (std::vector<int>{0}));
+
+    // 구간이 첫 구 앞에서 끝나면 가리지 않는다.
+    EXPECT_FALSE(world.Occluded(ray, 0.001, 1.0, generator));
+
+    // 넓은 BVH도 첫 교차를 찾으면 나머지 잎을 검사하지 않는다.
+    const raytracer::Bvh8 bvh(world.Objects(), 0.0, 1.0);
+    visits.clear();
+    ASSERT_TRUE(bvh.Occluded(ray, 0.001, Inf(), generator));
+    EXPECT_EQ(visits.size(), 1u);
+}
+
+TEST(BvhTest, RayPacketsMatchSingleRayHitsAndRandomState) {
+    using raytracer::Point3;
+    using raytracer::Vec3;
+
+    // 볼륨은 hit마다 난수를 쓰므로 묶음이 레이마다 단일 순회와 같은 순서로 도형을 검사해야 기록과 난수 상태가 같다.
+    const raytracer::HittableList world = MakeSpheresWithMedia(41, 150);
+    const raytracer::Bvh8 bvh8(world.Objects(), 0.0, 1.0);
+    const raytracer::Bvh4 bvh4(world.Objects(), 0.0, 1.0);
+
+    // 화면 레이처럼 모인 묶음과 방향이 제각각인 묶음(대부분 단일 순회로 떨어져 나간다)을 섞는다.
+    raytracer::ResetBvhCounters();
+    raytracer::Rng ray_generator(43);
+    for (int packet = 0; packet < 200; ++packet) {
+        const bool coherent = packet % 2 == 0;
+        const int count = 1 + packet % raytracer::kMaxPacketSize;
+        const Vec3 base(raytracer::RandomDouble(ray_generator, -0.5, 0.5), raytracer::RandomDouble(ray_generator, -0.5, 0.5),
+                        -1.0);
+        raytracer::Ray rays[raytracer::kMaxPacketSize];
+        for (int i = 0; i < count; ++i) {
+            const double spread = coherent ? 0.02 : 1.0;
+            rays[i] = raytracer::Ray(Point3(0.0, 0.0, 0.0),
+                                     base + Vec3(raytracer::RandomDouble(ray_generator, -spread, spread),
+                                                 raytracer::RandomDouble(ray_generator, -spread, spread), 0.0),
+                                     0.0);
+        }
+
+        for (const raytracer::Hittable* accelerator : {static_cast<const raytracer::Hittable*>(&bvh8),
+                                                       static_cast<const raytracer::Hittable*>(&bvh4)}) {
+            raytracer::HitRecord records[raytracer::kMaxPacketSize];
+            raytracer::Rng generators[raytracer::kMaxPacketSize];
+            for (int i = 0; i < count; ++i) {
+                generators[i].Seed(1000 + static_cast<std::uint64_t>(i));
+            }
+            const std::uint32_t hits = accelerator->HitPacket(rays, count, 0.001, Inf(), records, generators);
+
+            for (int i = 0; i < count; ++i) {
+                raytracer::HitRecord expected;
+                raytracer::Rng expected_generator(1000 + static_cast<std::uint64_t>(i));
+                const bool expected_hit = accelerator->Hit(rays[i], 0.001, Inf(), expected, expected_generator);
+                ASSERT_EQ(expected_hit, (hits & (1u << i)) != 0) << "묶음 " << packet << ", 레이 " << i;
+                EXPECT_EQ(expected_generator(), generators[i]());
+                if (expected_hit) {
+                    EXPECT_EQ(expected.t, records[i].t);
+                    EXPECT_EQ(expected.material.get(), records[i].material.get());
+                }
+            }
+        }
+    }
+
+    if (raytracer::kBvhCountersEnabled) {
+        EXPECT_GT(raytracer::ReadBvhCounters().packet_detached_rays, 0u);
+    }
+
+    raytracer::Ray rays[1];
+    raytracer::HitRecord records[1];
+    raytracer::Rng generators[1];
+    EXPECT_THROW(bvh8.HitPacket(rays, 0, 0.001, Inf(), records, generators), std::invalid_argument);
+}
+
+TEST(BvhTest, FrustumCulledTreeMatchesFullTreeInsideTileFrustum) {
+    using raytracer::Point3;
+    using raytracer::Vec3;
+
+    const raytracer::HittableList world = MakeSpheresWithMedia(47, 600);
+    const raytracer::Bvh8 bvh(world.Objects(), 0.0, 1.0);
+    const raytracer::Camera camera(Point3(0.0, 0.0, 0.0), Point3(0.0, 0.0, -1.0), Vec3(0.0, 1.0, 0.0), 70.0, 1.0, 0.0,
+                                   1.0, 0.0, 1.0);
+
+    // 화면을 8x8 영역으로 나눠 영역마다 잘라 낸 트리와 원본 트리에 같은 화면 레이를 쏜다.
+    constexpr int kRegions = 8;
+    raytracer::Rng ray_generator(53);
+    std::size_t culled_nodes = 0;
+    for (int row = 0; row < kRegions; ++row) {
+        for (int column = 0; column < kRegions; ++column) {
+            const double s0 = static_cast<double>(column) / kRegions;
+            const double s1 = static_cast<double>(column + 1) / kRegions;
+            const double t0 = static_cast<double>(row) / kRegions;
+            const double t1 = static_cast<double>(row + 1) / kRegions;
+            raytracer::Frustum frustum;
+            ASSERT_TRUE(camera.RegionFrustum(s0, s1, t0, t1, frustum));
+            const raytracer::Bvh8 culled = bvh.CulledBy(frustum);
+            EXPECT_LT(culled.NodeCount(), bvh.NodeCount());
+            culled_nodes += culled.NodeCount();
+
+            raytracer::Ray rays[raytracer::kMaxPacketSize];
+            for (raytracer::Ray& ray : rays) {
+                // 영역 경계의 레이도 포함한다.
+                const bool on_edge = raytracer::RandomDouble(ray_generator) < 0.25;
+                const double s = on_edge ? s0 : raytracer::RandomDouble(ray_generator, s0, s1);
+                const double t = on_edge ? t1 : raytracer::RandomDouble(ray_generator, t0, t1);
+                ray = camera.GetRay(s, t, ray_generator);
+            }
+
+            raytracer::HitRecord records[raytracer::kMaxPacketSize];
+            raytracer::Rng generators[raytracer::kMaxPacketSize];
+            for (int i = 0; i < raytracer::kMaxPacketSize; ++i) {
+                generators[i].Seed(2000 + static_cast<std::uint64_t>(i));
+            }
+            const std::uint32_t hits =
+                culled.HitPacket(rays, raytracer::kMaxPacketSize, 0.001, Inf(), records, generators);
+            for (int i = 0; i < raytracer::kMaxPacketSize; ++i) {
+                raytracer::HitRecord expected;
+                raytracer::HitRecord actual;
+                raytracer::Rng expected_generator(2000 + static_cast<std::uint64_t>(i));
+                raytracer::Rng actual_generator(2000 + static_cast<std::uint64_t>(i));
+                const bool expected_hit = bvh.Hit(rays[i], 0.001, Inf(), expected, expected_generator);
+                ASSERT_EQ(expected_hit, culled.Hit(rays[i], 0.001, Inf(), actual, actual_generator));
+                ASSERT_EQ(expected_hit, (hits & (1u << i)) != 0);
+                const std::uint64_t expected_next = expected_generator();
+                EXPECT_EQ(expected_next, actual_generator());
+                EXPECT_EQ(expected_next, generators[i]());
+                if (expected_hit) {
+                    EXPECT_EQ(expected.t, actual.t);
+                    EXPECT_EQ(expected.material.get(), actual.material.get());
+                    EXPECT_EQ(expected.t, records[i].t);
+                }
+
+                raytracer::Rng expected_occlusion(7);
+                raytracer::Rng actual_occlusion(7);
+                EXPECT_EQ(bvh.Occluded(rays[i], 0.001, 8.0, expected_occlusion),
+                          culled.Occluded(rays[i], 0.001, 8.0, actual_occlusion));
+            }
+        }
+    }
+    // 영역마다 화면 밖 칸을 지우므로 64개 영역의 노드를 다 더해도 원본의 몇 배에 그친다.
+    EXPECT_LT(culled_nodes, bvh.NodeCount() * kRegions * kRegions / 4);
+
+    // 장면 반대쪽을 보는 절두체는 빈 뿌리만 남고, 렌즈가 있는 카메라는 절두체를 만들지 않는다.
+    const raytracer::Camera backward(Point3(0.0, 0.0, 0.0), Point3(0.0, 0.0, 1.0), Vec3(0.0, 1.0, 0.0), 40.0, 1.0, 0.0,
+                                     1.0, 0.0, 1.0);
+    raytracer::Frustum behind;
+    ASSERT_TRUE(backward.RegionFrustum(0.0, 1.0, 0.0, 1.0, behind));
+    const raytracer::Bvh8 empty = bvh.CulledBy(behind);
+    EXPECT_EQ(empty.NodeCount(), 1u);
+    EXPECT_EQ(empty.Nodes()[0].lane_count, 0);
+    raytracer::HitRecord record;
+    raytracer::Rng generator(1);
+    EXPECT_FALSE(empty.Hit(backward.GetRay(0.5, 0.5, generator), 0.001, Inf(), record, generator));
+
+    const raytracer::Camera lens(Point3(0.0, 0.0, 0.0), Point3(0.0, 0.0, -1.0), Vec3(0.0, 1.0, 0.0), 40.0, 1.0, 0.2, 5.0,
+                                 0.0, 1.0);
+    EXPECT_FALSE(lens.RegionFrustum(0.0, 1.0, 0.0, 1.0, behind));
+    EXPECT_EQ(world.CullFrustum(behind), nullptr);
+    EXPECT_NE(bvh.CullFrustum(behind), nullptr);
+}
+
+TEST(BvhTest, LazyBuildSplitsOnlyEnteredSubtreesAndMatchesEagerTree) {
+    using raytracer::Point3;
+    using raytracer::Vec3;
+
+    const raytracer::HittableList world = MakeSpheresWithMedia(59, 600);
+    for (const int max_leaf_size : {1, 4}) {
+        for (const auto split : {raytracer::BvhSplitMethod::kMedian, raytracer::BvhSplitMethod::kBinnedSah}) {
+            raytracer::BvhBuildOptions options;
+            options.split = split;
+            options.max_leaf_size = max_leaf_size;
+            const raytracer::BvhNode eager(world, 0.0, 1.0, options);
+            options.lazy = true;
+            const raytracer::BvhNode lazy(world, 0.0, 1.0, options);
+
+            const raytracer::BvhLazyBuildStats initial = lazy.LazyBuildStats();
+            EXPECT_EQ(initial.built_nodes, 0u);
+            EXPECT_EQ(initial.pending_nodes, 1u);
+            EXPECT_EQ(initial.pending_primitives, 600u);
+            EXPECT_EQ(initial.primitive_count, 600u);
+            EXPECT_EQ(eager.LazyBuildStats().primitive_count, 0u);
+
+            // 한쪽 구석만 보는 좁은 레이 다발은 트리 일부만 나누게 한다. 볼륨 난수 상태까지 즉시 빌드와 같아야 한다.
+            raytracer::Rng ray_generator(61);
+            for (int i = 0; i < 200; ++i) {
+                const Vec3 direction(raytracer::RandomDouble(ray_generator, 0.25, 0.35),
+                                     raytracer::RandomDouble(ray_generator, 0.25, 0.35), -1.0);
+                const raytracer::Ray ray(Point3(0.0, 0.0, 0.0), direction, 0.5);
+                raytracer::HitRecord expected;
+                raytracer::HitRecord actual;
+                raytracer::Rng expected_generator(static_cast<std::uint64_t>(i));
+                raytracer::Rng actual_generator(static_cast<std::uint64_t>(i));
+                const bool expected_hit = eager.Hit(ray, 0.001, Inf(), expected, expected_generator);
+                ASSERT_EQ(expected_hit, lazy.Hit(ray, 0.001, Inf(), actual, actual_generator));
+                EXPECT_EQ(expected_generator(), actual_generator());
+                if (expected_hit) {
+                    EXPECT_EQ(expected.t, actual.t);
+                    EXPECT_EQ(expected.material.get(), actual.material.get());
+                }
+                raytracer::Rng expected_occlusion(3);
+                raytracer::Rng actual_occlusion(3);
+                EXPECT_EQ(eager.Occluded(ray, 0.001, 6.0, expected_occlusion),
+                          lazy.Occluded(ray, 0.001, 6.0, actual_occlusion));
+            }
+
+            const raytracer::BvhStats eager_stats = raytracer::InspectBvh(eager, 0.0, 1.0);
+            const raytracer::BvhLazyBuildStats partial = lazy.LazyBuildStats();
+            EXPECT_GT(partial.built_nodes, 0u);
+            EXPECT_LT(partial.built_nodes, eager_stats.node_count / 2);
+            EXPECT_GT(partial.pending_primitives, 300u);
+
+            // 다 나누면 즉시 빌드와 같은 트리가 된다.
+            lazy.BuildAll();
+            const raytracer::BvhLazyBuildStats complete = lazy.LazyBuildStats();
+            EXPECT_EQ(complete.built_nodes, eager_stats.node_count);
+            EXPECT_EQ(complete.pending_nodes, 0u);
+            EXPECT_EQ(complete.pending_primitives, 0u);
+            const raytracer::BvhStats lazy_stats = raytracer::InspectBvh(lazy, 0.0, 1.0);
+            EXPECT_EQ(lazy_stats.leaf_sizes, eager_stats.leaf_sizes);
+            EXPECT_EQ(lazy_stats.leaves_per_depth, eager_stats.leaves_per_depth);
+            EXPECT_EQ(lazy_stats.sah_cost, eager_stats.sah_cost);
+        }
+    }
+}
+
+TEST(BvhTest, LazyBuildSplitsEachNodeOnceUnderConcurrentRays) {
+    const raytracer::HittableList world = MakeSpheresWithMedia(67, 2000);
+    const raytracer::BvhNode eager(world, 0.0, 1.0);
+    raytracer::BvhBuildOptions options;
+    options.lazy = true;
+    const raytracer::BvhNode lazy(world, 0.0, 1.0, options);
+
+    raytracer::Rng generator(71);
+    std::vector<raytracer::Ray> rays;
+    for (int i = 0; i < 4000; ++i) {
+        const raytracer::Point3 origin(raytracer::RandomDouble(generator, -6.0, 6.0),
+                                       raytracer::RandomDouble(generator, -6.0, 6.0), 2.0);
+        const raytracer::Point3 target(raytracer::RandomDouble(generator, -5.0, 5.0),
+                                       raytracer::RandomDouble(generator, -5.0, 5.0), -12.0);
+        rays.emplace_back(origin, target - origin, 0.5);
+    }
+    std::vector<double> expected_t(rays.size(), -1.0);
+    for (std::size_t i = 0; i < rays.size(); ++i) {
+        raytracer::HitRecord record;
+        raytracer::Rng ray_generator(i);
+        if (eager.Hit(rays[i], 0.001, Inf(), record, ray_generator)) {
+            expected_t[i] = record.t;
+        }
+    }
+
+    std::vector<double> actual_t(rays.size(), -1.0);
+    raytracer::ThreadPool pool(4);
+    pool.ParallelFor(rays.size(), [&](std::size_t i) {
+        raytracer::HitRecord record;
+        raytracer::Rng ray_generator(i);
+        if (lazy.Hit(rays[i], 0.001, Inf(), record, ray_generator)) {
+            actual_t[i] = record.t;
+        }
+    });
+    EXPECT_EQ(actual_t, expected_t);
+
+    // 같은 노드를 두 번 나눴다면 나눈 노드 수가 트리 노드 수를 넘는다.
+    lazy.BuildAll();
+    EXPECT_EQ(lazy.LazyBuildStats().built_nodes, raytracer::InspectBvh(eager, 0.0, 1.0).node_count);
+    EXPECT_EQ(lazy.LazyBuildStats().pending_nodes, 0u);
+
+    // 넓은 BVH로 접으면 남은 노드를 모두 나눈 뒤 접는다.
+    raytracer::BvhNode folded(world, 0.0, 1.0, options);
+    const raytracer::Bvh8 wide(folded, 0.0, 1.0);
+    EXPECT_EQ(folded.LazyBuildStats().pending_nodes, 0u);
+    EXPECT_EQ(wide.NodeCount(), raytracer::Bvh8(eager, 0.0, 1.0).NodeCount());
+
+    // 재맞춤은 뿌리부터 다시 지연 빌드한다.
+    const raytracer::BvhRefitStats refit = folded.Refit(0.0, 1.0, 2.0);
+    EXPECT_EQ(refit.rebuilt_subtrees, 1);
+    EXPECT_EQ(folded.LazyBuildStats().built_nodes, 0u);
+    EXPECT_EQ(folded.LazyBuildStats().pending_nodes, 1u);
+
+    options.split = raytracer::BvhSplitMethod::kSpatialSah;
+    EXPECT_THROW(raytracer::BvhNode(world, 0.0, 1.0, options), std::invalid_argument);
+}
+
+TEST(BvhTest, MotionBvhCullsWithRayTimeAndMatchesUnionBoundsTree) {
+    using raytracer::Point3;
+    using raytracer::Vec3;
+
+    // 셔터 동안 자기 지름의 몇 배씩 움직이는 구와 멈춘 구를 섞는다. 객체마다 재질을 따로 둬 교차한 객체를 구분한다.
+    std::size_t calls = 0;
+    raytracer::HittableList world;
+    raytracer::Rng scene_generator(73);
+    for (int i = 0; i < 500; ++i) {
+        const auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+        const Point3 center(raytracer::RandomDouble(scene_generator, -6.0, 6.0),
+                            raytracer::RandomDouble(scene_generator, -6.0, 6.0),
+                            raytracer::RandomDouble(scene_generator, -6.0, 6.0));
+        std::shared_ptr<raytracer::Hittable> object;
+        if (i % 5 == 0) {
+            object = std::make_shared<raytracer::Sphere>(center, 0.25, material);
+        } else {
+            const Vec3 motion(raytracer::RandomDouble(scene_generator, -3.0, 3.0),
+                              raytracer::RandomDouble(scene_generator, -3.0, 3.0),
+                              raytracer::RandomDouble(scene_generator, -3.0, 3.0));
+            object = std::make_shared<raytracer::MovingSphere>(center, center + motion, 0.0, 1.0, 0.2, material);
+        }
+        world.Add(std::make_shared<CountingHittable>(object, calls));
+    }
+
+    raytracer::Rng ray_generator(79);
+    std::vector<raytracer::Ray> rays;
+    for (int i = 0; i < 2000; ++i) {
+        // 셔터 양 끝 시각도 넣는다.
+        const double time = i % 50 == 0 ? 0.0 : i % 50 == 1 ? 1.0 : raytracer::RandomDouble(ray_generator, 0.0, 1.0);
+        rays.emplace_back(Point3(raytracer::RandomDouble(ray_generator, -7.0, 7.0),
+                                 raytracer::RandomDouble(ray_generator, -7.0, 7.0), 9.0),
+                          Vec3(raytracer::RandomDouble(ray_generator, -0.4, 0.4),
+                               raytracer::RandomDouble(ray_generator, -0.4, 0.4), -1.0),
+                          time);
+    }
+
+    const auto count_calls = [&](const raytracer::Hittable& bvh, std::vector<double>& hit_t,
+                                 std::vector<const raytracer::Material*>& hit_material, std::vector<bool>& occluded) {
+        calls = 0;
+        for (const raytracer::Ray& ray : rays) {
+            raytracer::HitRecord record;
+            raytracer::Rng generator(3);
+            const bool hit = bvh.Hit(ray, 0.001, Inf(), record, generator);
+            hit_t.push_back(hit ? record.t : -1.0);
+            hit_material.push_back(hit ? record.material.get() : nullptr);
+            occluded.push_back(bvh.Occluded(ray, 0.001, 8.0, generator));
+        }
+        return calls;
+    };
+
+    for (const int max_leaf_size : {1, 4}) {
+        for (const auto split : {raytracer::BvhSplitMethod::kMedian, raytracer::BvhSplitMethod::kBinnedSah}) {
+            raytracer::BvhBuildOptions options;
+            options.split = split;
+            options.max_leaf_size = max_leaf_size;
+            const raytracer::BvhNode reference(world, 0.0, 1.0, options);
+            std::vector<double> expected_t;
+            std::vector<const raytracer::Material*> expected_material;
+            std::vector<bool> expected_occluded;
+            const std::size_t reference_calls =
+                count_calls(reference, expected_t, expected_material, expected_occluded);
+            EXPECT_GT(std::count(expected_occluded.begin(), expected_occluded.end(), true), 200);
+
+            const raytracer::MotionBvh motion(world.Objects(), 0.0, 1.0, options);
+            EXPECT_EQ(motion.PrimitiveCount(), world.Objects().size());
+
+            std::vector<double> actual_t;
+            std::vector<const raytracer::Material*> actual_material;
+            std::vector<bool> actual_occluded;
+            const std::size_t motion_calls = count_calls(motion, actual_t, actual_material, actual_occluded);
+            EXPECT_EQ(actual_t, expected_t);
+            EXPECT_EQ(actual_material, expected_material);
+            EXPECT_EQ(actual_occluded, expected_occluded);
+            // 그 시각의 상자로 거르므로 셔터 전체를 감싼 상자보다 도형을 훨씬 덜 검사한다.
+            EXPECT_LT(motion_calls * 2, reference_calls) << "leaf " << max_leaf_size;
+        }
+    }
+
+    // 셔터 길이가 0이면 그 시각 하나의 경계만 쓴다.
+    const raytracer::MotionBvh instant(world.Objects(), 0.5, 0.5);
+    const raytracer::BvhNode instant_reference(world, 0.5, 0.5);
+    for (const raytracer::Ray& ray : rays) {
+        const raytracer::Ray at_middle(ray.origin(), ray.direction(), 0.5);
+        raytracer::HitRecord expected;
+        raytracer::HitRecord actual;
+        raytracer::Rng expected_generator(3);
+        raytracer::Rng actual_generator(3);
+        const bool expected_hit = instant_reference.Hit(at_middle, 0.001, Inf(), expected, expected_generator);
+        ASSERT_EQ(expected_hit, instant.Hit(at_middle, 0.001, Inf(), actual, actual_generator));
+        if (expected_hit) {
+            EXPECT_EQ(expected.t, actual.t);
+        }
+    }
+
+    raytracer::BvhBuildOptions spatial;
+    spatial.split = raytracer::BvhSplitMethod::kSpatialSah;
+    EXPECT_THROW(raytracer::MotionBvh(world.Objects(), 0.0, 1.0, spatial), std::invalid_argument);
+}
@@ -0,0 +1,48 @@
+/*
+ * 설명: PPM 스트림 기록기가 P3/P6 헤더와 행을 규약대로 서식화하는지 검증한다.
+ * 버전: v1.4.0
+ * 관련 문서: design/renderer/v1.4.0-streaming-output.md
+ * 테스트: tests/unit/image_sink_test.cpp
+ */
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "raytracer/image_sink.hpp"
+
+TEST(ImageSinkTest, AsciiWriterFormatsOnePixelPerLine) {
+    std::ostringstream output;
+    raytracer::PpmStreamWriter writer(output, raytracer::PpmFormat::kAscii);
+
+    writer.Begin(2, 2);
+    writer.WriteRow(0, {raytracer::Rgb8{0, 7, 255}, raytracer::Rgb8{10, 100, 200}});
+    EXPECT_EQ(output.str(), "P3\n2 2\n255\n0 7 255\n10 100 200\n");
+
+    writer.WriteRow(1, {raytracer::Rgb8{1, 2, 3}, raytracer::Rgb8{4, 5, 6}});
+    writer.End();
+    EXPECT_EQ(output.str(), "P3\n2 2\n255\n0 7 255\n10 100 200\n1 2 3\n4 5 6\n");
+}
+
+TEST(ImageSinkTest, BinaryWriterEmitsRawBytesAfterHeader) {
+    std::ostringstream output;
+    raytracer::PpmStreamWriter writer(output, raytracer::PpmFormat::kBinary);
+
+    writer.Begin(2, 1);
+    writer.WriteRow(0, {raytracer::Rgb8{0, 128, 255}, raytracer::Rgb8{10, 13, 32}});
+    writer.End();
+
+    const std::string header = "P6\n2 1\n255\n";
+    const std::string expected = header + std::string{'\x00', '\x80', '\xff', '\x0a', '\x0d', '\x20'};
+    EXPECT_EQ(output.str(), expected);
+}
+
+TEST(ImageSinkTest, RejectsRowWithWrongWidth) {
+    std::ostringstream output;
+    raytracer::PpmStreamWriter writer(output, raytracer::PpmFormat::kAscii);
+
+    writer.Begin(3, 1);
+    EXPECT_THROW(writer.WriteRow(0, {raytracer::Rgb8{}}), std::invalid_argument);
+}
@@ -0,0 +1,131 @@
+/*
+ * 설명: 아핀 인스턴스가 기존 변환 래퍼·직접 배치한 도형과 같은 교차를 내는지, 공유 BLAS 위의 TLAS가 기하를 복제한
+ *       리스트와 같은 hit를 반환하는지, 인스턴스를 거친 가림 판정도 같은 답을 내는지 검증한다.
+ * 버전: v1.20.0
+ * 관련 문서: design/renderer/v1.16.0-instancing.md, design/renderer/v1.20.0-occlusion.md
+ * 테스트: tests/unit/instance_test.cpp
+ */
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "raytracer/hittable_list.hpp"
+#include "raytracer/instance.hpp"
+#include "raytracer/material.hpp"
+#include "raytracer/quad.hpp"
+#include "raytracer/random.hpp"
+#include "raytracer/ray.hpp"
+#include "raytracer/sphere.hpp"
+#include "raytracer/transform.hpp"
+#include "raytracer/wide_bvh.hpp"
+
+namespace {
+
+using raytracer::AffineTransform;
+using raytracer::Point3;
+using raytracer::Vec3;
+
+double Inf() { return std::numeric_limits<double>::infinity(); }
+
+std::vector<raytracer::Ray> RandomRays(std::uint32_t seed, int count, double spread) {
+    std::vector<raytracer::Ray> rays;
+    raytracer::Rng generator(seed);
+    for (int i = 0; i < count; ++i) {
+        rays.emplace_back(Point3(raytracer::RandomDouble(generator, -spread, spread),
+                                 raytracer::RandomDouble(generator, -spread, spread), 3.0 * spread),
+                          Vec3(raytracer::RandomDouble(generator, -0.5, 0.5), raytracer::RandomDouble(generator, -0.5, 0.5),
+                               -1.0),
+                          0.0);
+    }
+    return rays;
+}
+
+void ExpectSameSurface(const raytracer::Hittable& expected, const raytracer::Hittable& actual,
+                       const std::vector<raytracer::Ray>& rays) {
+    int hits = 0;
+    for (const auto& ray : rays) {
+        raytracer::HitRecord expected_record;
+        raytracer::HitRecord actual_record;
+        raytracer::Rng expected_generator(7);
+        raytracer::Rng actual_generator(7);
+        const bool expected_hit = expected.Hit(ray, 0.001, Inf(), expected_record, expected_generator);
+        ASSERT_EQ(expected_hit, actual.Hit(ray, 0.001, Inf(), actual_record, actual_generator));
+        EXPECT_EQ(expected_hit, actual.Occluded(ray, 0.001, Inf(), actual_generator));
+        if (!expected_hit) {
+            continue;
+        }
+        ++hits;
+        EXPECT_NEAR(expected_record.t, actual_record.t, 1e-9);
+        EXPECT_NEAR((expected_record.p - actual_record.p).length(), 0.0, 1e-9);
+        EXPECT_NEAR((expected_record.normal - actual_record.normal).length(), 0.0, 1e-9);
+        EXPECT_EQ(expected_record.material.get(), actual_record.material.get());
+    }
+    EXPECT_GT(hits, 0);
+}
+
+}  // namespace
+
+TEST(InstanceTest, MatchesRotateThenTranslateWrappers) {
+    auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    auto quad = std::make_shared<raytracer::Quad>(Point3(-1.0, -1.0, 0.0), Vec3(2.0, 0.0, 0.0), Vec3(0.0, 2.0, 0.0),
+                                                  material);
+
+    const raytracer::Translate wrapped(std::make_shared<raytracer::RotateY>(quad, 30.0), Vec3(0.5, -0.25, 1.0));
+    const raytracer::Instance instance(
+        quad, AffineTransform::RotationY(30.0).Then(AffineTransform::Translation(Vec3(0.5, -0.25, 1.0))));
+    ExpectSameSurface(wrapped, instance, RandomRays(3, 300, 1.5));
+}
+
+TEST(InstanceTest, ScaledUnitSphereMatchesLargerSphere) {
+    auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    auto unit = std::make_shared<raytracer::Sphere>(Point3(0.0, 0.0, 0.0), 1.0, material);
+    const raytracer::Sphere expected(Point3(1.0, 2.0, -3.0), 2.0, material);
+    const raytracer::Instance instance(
+        unit, AffineTransform::Scaling(Vec3(2.0, 2.0, 2.0)).Then(AffineTransform::Translation(Vec3(1.0, 2.0, -3.0))));
+    ExpectSameSurface(expected, instance, RandomRays(5, 300, 3.0));
+
+    raytracer::Aabb box;
+    ASSERT_TRUE(instance.BoundingBox(0.0, 1.0, box));
+    EXPECT_NEAR(box.minimum().x(), -1.0, 1e-12);
+    EXPECT_NEAR(box.maximum().z(), -1.0, 1e-12);
+
+    EXPECT_THROW(raytracer::Instance(unit, AffineTransform::Scaling(Vec3(1.0, 0.0, 1.0))), std::invalid_argument);
+}
+
+TEST(InstanceTest, TlasOverSharedBlasMatchesCopiedGeometry) {
+    auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    raytracer::Rng scene_generator(11);
+    std::vector<std::shared_ptr<raytracer::Hittable>> cluster;
+    for (int i = 0; i < 50; ++i) {
+        cluster.push_back(std::make_shared<raytracer::Sphere>(
+            Point3(raytracer::RandomDouble(scene_generator, -0.4, 0.4), raytracer::RandomDouble(scene_generator, -0.4, 0.4),
+                   raytracer::RandomDouble(scene_generator, -0.4, 0.4)),
+            0.08, material));
+    }
+    auto blas = std::make_shared<raytracer::Bvh8>(cluster, 0.0, 1.0);
+
+    // 같은 배치를 기하 복제(변환 래퍼로 감싼 도형 리스트)와 인스턴스 TLAS로 각각 만든다.
+    raytracer::HittableList copies;
+    std::vector<std::shared_ptr<raytracer::Hittable>> instances;
+    for (int x = 0; x < 10; ++x) {
+        for (int y = 0; y < 10; ++y) {
+            const double angle = 9.0 * (x + y);
+            const Vec3 offset(x - 4.5, y - 4.5, 0.0);
+            for (const auto& sphere : cluster) {
+                copies.Add(std::make_shared<raytracer::Translate>(std::make_shared<raytracer::RotateY>(sphere, angle),
+                                                                  offset));
+            }
+            instances.push_back(std::make_shared<raytracer::Instance>(
+                blas, AffineTransform::RotationY(angle).Then(AffineTransform::Translation(offset))));
+        }
+    }
+    const raytracer::Bvh8 tlas(instances, 0.0, 1.0);
+    ExpectSameSurface(copies, tlas, RandomRays(13, 400, 5.0));
+
+    // 기하는 BLAS 한 벌을 인스턴스들이 공유한다.
+    EXPECT_EQ(blas.use_count(), 101);
+    EXPECT_EQ(tlas.PrimitiveCount(), 100u);
+}
@@ -1,9 +1,8 @@
 #include <gtest/gtest.h>
 
-#include <random>
-
 #include "raytracer/material.hpp"
 #include "raytracer/pdf.hpp"
+#include "raytracer/random.hpp"
 #include "raytracer/ray.hpp"
 #include "raytracer/vec3.hpp"
 
@@ -14,7 +13,7 @@ TEST(MaterialScatterTest, LambertianReturnsAlbedoAndUpwardDirection) {
     record.normal = raytracer::Vec3(0.0, 0.0, 1.0);
     record.front_face = true;
 
-    std::mt19937 generator(123);
+    raytracer::Rng generator(123);
     raytracer::Ray incoming(raytracer::Point3(0.0, 0.0, 1.0), raytracer::Vec3(0.0, 0.0, -1.0));
     raytracer::ScatterRecord scatter_record;
 
@@ -36,7 +35,7 @@ TEST(MaterialScatterTest, MetalReflectsWithoutFuzzWhenAligned) {
     record.normal = raytracer::Vec3(0.0, 0.0, 1.0);
     record.front_face = true;
 
-    std::mt19937 generator(1);
+    raytracer::Rng generator(1);
     raytracer::Ray incoming(raytracer::Point3(0.0, 0.0, 0.0), raytracer::Vec3(0.0, 0.0, -1.0));
     raytracer::ScatterRecord scatter_record;
 
@@ -59,7 +58,7 @@ TEST(MaterialScatterTest, DielectricUsesTotalInternalReflectionWhenNecessary) {
     record.normal = raytracer::Vec3(0.0, 0.0, 1.0);
     record.front_face = false;
 
-    std::mt19937 generator(7);
+    raytracer::Rng generator(7);
     raytracer::Ray incoming(raytracer::Point3(0.0, 0.0, 0.0), raytracer::Vec3(0.0, 1.0, 0.0));
     raytracer::ScatterRecord scatter_record;
 
@@ -1,11 +1,11 @@
 #include <gtest/gtest.h>
 
 #include <memory>
-#include <random>
 
 #include "raytracer/material.hpp"
 #include "raytracer/pdf.hpp"
 #include "raytracer/quad.hpp"
+#include "raytracer/random.hpp"
 #include "raytracer/vec3.hpp"
 
 TEST(PdfTest, CosinePdfValueMatchesNormalDirection) {
@@ -14,7 +14,7 @@ TEST(PdfTest, CosinePdfValueMatchesNormalDirection) {
 
     EXPECT_NEAR(pdf.Value(raytracer::Vec3(0.0, 0.0, 1.0)), expected, 1e-12);
 
-    std::mt19937 generator(42);
+    raytracer::Rng generator(42);
     const raytracer::Vec3 generated = pdf.Generate(generator);
     EXPECT_GT(generated.z(), 0.0);
 }
@@ -26,7 +26,7 @@ TEST(PdfTest, QuadPdfValueUsesGeometry) {
     const double pdf = quad.PdfValue(raytracer::Point3(0.5, 0.5, -1.0), raytracer::Vec3(0.0, 0.0, 1.0));
     EXPECT_NEAR(pdf, 1.0, 1e-12);
 
-    std::mt19937 generator(7);
+    raytracer::Rng generator(7);
     const raytracer::Vec3 random_direction = quad.Random(raytracer::Point3(0.5, 0.5, -1.0), generator);
     EXPECT_GT(raytracer::Dot(random_direction, raytracer::Vec3(0.0, 0.0, 1.0)), 0.0);
 }
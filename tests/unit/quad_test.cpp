@@ -1,10 +1,10 @@
 #include <gtest/gtest.h>
 
 #include <memory>
-#include <random>
 
 #include "raytracer/material.hpp"
 #include "raytracer/quad.hpp"
+#include "raytracer/random.hpp"
 #include "raytracer/ray.hpp"
 #include "raytracer/transform.hpp"
 
@@ -15,7 +15,7 @@ TEST(QuadTest, HitInsideQuadReturnsUvAndNormal) {
 
     raytracer::Ray ray(raytracer::Point3(1.0, 1.0, 1.0), raytracer::Vec3(0.0, 0.0, -1.0));
     raytracer::HitRecord record;
-    std::mt19937 generator(1);
+    raytracer::Rng generator(1);
 
     const bool hit = quad.Hit(ray, 0.001, 10.0, record, generator);
 
@@ -38,7 +38,7 @@ TEST(QuadTest, TranslateMovesIntersectionPoint) {
 
     raytracer::Ray ray(raytracer::Point3(0.5, 0.5, 3.0), raytracer::Vec3(0.0, 0.0, -1.0));
     raytracer::HitRecord record;
-    std::mt19937 generator(2);
+    raytracer::Rng generator(2);
 
     const bool hit = translated.Hit(ray, 0.001, 10.0, record, generator);
 
@@ -46,3 +46,31 @@ TEST(QuadTest, TranslateMovesIntersectionPoint) {
     EXPECT_NEAR(record.p.z(), 1.0, 1e-6);
     EXPECT_DOUBLE_EQ(record.material->Emitted(record.u, record.v, record.p).length(), 0.0);
 }
+
+TEST(QuadTest, ClipBoxBoundsOnlyThePartInsideRegion) {
+    auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(0.5, 0.5, 0.5));
+    // x+y 방향으로 기운 대각선 quad라 영역으로 잘라야 상자가 줄어든다.
+    raytracer::Quad quad(raytracer::Point3(0.0, 0.0, 0.0), raytracer::Vec3(4.0, 4.0, 0.0),
+                         raytracer::Vec3(0.0, 0.0, 2.0), material);
+
+    raytracer::Aabb clipped;
+    ASSERT_TRUE(quad.ClipBox(0.0, 1.0,
+                             raytracer::Aabb(raytracer::Point3(-1.0, -1.0, -1.0), raytracer::Point3(1.0, 5.0, 3.0)),
+                             clipped));
+    EXPECT_LE(clipped.maximum().x(), 1.0);
+    EXPECT_LE(clipped.maximum().y(), 1.0 + 1e-3);
+    EXPECT_LE(clipped.minimum().z(), 0.0);
+    EXPECT_GE(clipped.maximum().z(), 2.0);
+
+    raytracer::Aabb empty;
+    ASSERT_TRUE(quad.ClipBox(0.0, 1.0,
+                             raytracer::Aabb(raytracer::Point3(3.0, -1.0, -1.0), raytracer::Point3(5.0, 1.0, 3.0)),
+                             empty));
+    EXPECT_GT(empty.minimum().x(), empty.maximum().x());
+
+    raytracer::Quad skewed(raytracer::Point3(0.0, 0.0, 0.0), raytracer::Vec3(2.0, 0.0, 0.0),
+                           raytracer::Vec3(1.0, 2.0, 0.0), material);
+    raytracer::Aabb unused;
+    EXPECT_FALSE(skewed.ClipBox(
+        0.0, 1.0, raytracer::Aabb(raytracer::Point3(0.0, 0.0, -1.0), raytracer::Point3(1.0, 1.0, 1.0)), unused));
+}
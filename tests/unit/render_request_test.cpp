@@ -0,0 +1,83 @@
+/*
+ * 설명: 렌더 서버 요청 JSON 해석이 기본값 보충, crop 변환, 잘못된 입력 거부를 규약대로 하는지 검증한다.
+ * 버전: v1.8.0
+ * 관련 문서: design/renderer/v1.5.0-render-server.md
+ * 테스트: tests/unit/render_request_test.cpp
+ */
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "raytracer/render_request.hpp"
+
+TEST(RenderRequestTest, FillsMissingKeysFromDefaults) {
+    raytracer::RenderOptions defaults;
+    defaults.samples_per_pixel = 7;
+    defaults.max_depth = 5;
+
+    const raytracer::RenderRequest request =
+        raytracer::ParseRenderRequest(R"({"width": 32, "height":16, "seed": 4294967295})", defaults);
+
+    EXPECT_EQ(request.options.width, 32);
+    EXPECT_EQ(request.options.height, 16);
+    EXPECT_EQ(request.options.seed, 4294967295u);
+    EXPECT_EQ(request.options.samples_per_pixel, 7);
+    EXPECT_EQ(request.options.max_depth, 5);
+    EXPECT_EQ(request.format, raytracer::PpmFormat::kAscii);
+    EXPECT_EQ(request.crop.x0, 0);
+    EXPECT_EQ(request.crop.y0, 0);
+    EXPECT_EQ(request.crop.x1, 32);
+    EXPECT_EQ(request.crop.y1, 16);
+}
+
+TEST(RenderRequestTest, ConvertsCropToImageRegion) {
+    const raytracer::RenderRequest request = raytracer::ParseRenderRequest(
+        R"({"width":64,"height":48,"spp":2,"crop":[8, 4, 16, 20],"format":"p6"})", raytracer::RenderOptions{});
+
+    EXPECT_EQ(request.options.samples_per_pixel, 2);
+    EXPECT_EQ(request.format, raytracer::PpmFormat::kBinary);
+    EXPECT_EQ(request.crop.x0, 8);
+    EXPECT_EQ(request.crop.y0, 4);
+    EXPECT_EQ(request.crop.x1, 24);
+    EXPECT_EQ(request.crop.y1, 24);
+    EXPECT_EQ(request.output_path, "");
+}
+
+TEST(RenderRequestTest, ReadsOutputPathForBatchManifests) {
+    const raytracer::RenderRequest request =
+        raytracer::ParseRenderRequest(R"({"seed":2,"output":"out/seed2.ppm"})", raytracer::RenderOptions{});
+
+    EXPECT_EQ(request.output_path, "out/seed2.ppm");
+    EXPECT_THROW(raytracer::ParseRenderRequest(R"({"output":""})", raytracer::RenderOptions{}), std::invalid_argument);
+}
+
+TEST(RenderRequestTest, RejectsMalformedOrOutOfRangeRequests) {
+    const raytracer::RenderOptions defaults;
+    const char* invalid[] = {
+        "",
+        "{",
+        R"({"width":0})",
+        R"({"width":1.5})",
+        R"({"seed":-1})",
+        R"({"seed":4294967296})",
+        R"({"unknown":1})",
+        R"({"format":"png"})",
+        R"({"width":8,"height":8,"crop":[4,4,5,1]})",
+        R"({"width":8,"height":8,"crop":[0,0,8]})",
+        R"({"width":8} trailing)",
+        R"({"width":8193})",
+        R"({"width":100000,"height":100000})",
+        R"({"width":8192,"height":8192})",
+        R"({"spp":65537})",
+        R"({"max_depth":1025})",
+    };
+    for (const char* line : invalid) {
+        EXPECT_THROW(raytracer::ParseRenderRequest(line, defaults), std::invalid_argument) << line;
+    }
+
+    // 상한 자체는 받아들인다.
+    const raytracer::RenderRequest largest =
+        raytracer::ParseRenderRequest(R"({"width":8192,"height":2048,"spp":65536,"max_depth":1024})", defaults);
+    EXPECT_EQ(largest.options.width, 8192);
+    EXPECT_EQ(largest.options.samples_per_pixel, 65536);
+}
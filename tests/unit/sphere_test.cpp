@@ -1,9 +1,9 @@
 #include <gtest/gtest.h>
 
 #include <memory>
-#include <random>
 
 #include "raytracer/material.hpp"
+#include "raytracer/random.hpp"
 #include "raytracer/ray.hpp"
 #include "raytracer/sphere.hpp"
 #include "raytracer/vec3.hpp"
@@ -14,7 +14,7 @@ TEST(SphereTest, HitsCenteredSphereFromFront) {
     raytracer::Ray ray(raytracer::Point3(0.0, 0.0, 0.0), raytracer::Vec3(0.0, 0.0, -1.0));
 
     raytracer::HitRecord record;
-    std::mt19937 generator(1);
+    raytracer::Rng generator(1);
     const bool hit = sphere.Hit(ray, 0.001, 100.0, record, generator);
 
     EXPECT_TRUE(hit);
@@ -34,7 +34,7 @@ TEST(SphereTest, MissesWhenRaySkimsPast) {
     raytracer::Ray ray(raytracer::Point3(0.0, 1.0, 0.0), raytracer::Vec3(0.0, 0.0, -1.0));
 
     raytracer::HitRecord record;
-    std::mt19937 generator(1);
+    raytracer::Rng generator(1);
     const bool hit = sphere.Hit(ray, 0.001, 100.0, record, generator);
 
     EXPECT_FALSE(hit);
@@ -47,7 +47,7 @@ TEST(SphereTest, MovingSphereTracksRayTime) {
 
     raytracer::Ray ray_start(raytracer::Point3(0.0, 0.0, 0.0), raytracer::Vec3(0.0, 0.0, -1.0), 0.0);
     raytracer::HitRecord record_start;
-    std::mt19937 generator(2);
+    raytracer::Rng generator(2);
     ASSERT_TRUE(sphere.Hit(ray_start, 0.001, 100.0, record_start, generator));
     const raytracer::Point3 estimated_center_start = record_start.p - 0.5 * record_start.normal;
     EXPECT_NEAR(estimated_center_start.y(), 0.0, 1e-6);
@@ -58,3 +58,22 @@ TEST(SphereTest, MovingSphereTracksRayTime) {
     const raytracer::Point3 estimated_center_end = record_end.p - 0.5 * record_end.normal;
     EXPECT_NEAR(estimated_center_end.y(), -0.25, 1e-6);
 }
+
+TEST(SphereTest, ClipBoxShrinksToSlabInsideRegion) {
+    auto material = std::make_shared<raytracer::Lambertian>(raytracer::Color(1.0, 1.0, 1.0));
+    raytracer::Sphere sphere(raytracer::Point3(0.0, 0.0, 0.0), 1.0, material);
+
+    // x >= 0.8 조각은 y, z 반지름이 sqrt(1 - 0.64) = 0.6을 넘지 않는다.
+    raytracer::Aabb clipped;
+    ASSERT_TRUE(sphere.ClipBox(
+        0.0, 1.0, raytracer::Aabb(raytracer::Point3(0.8, -2.0, -2.0), raytracer::Point3(2.0, 2.0, 2.0)), clipped));
+    EXPECT_DOUBLE_EQ(clipped.minimum().x(), 0.8);
+    EXPECT_NEAR(clipped.maximum().x(), 1.0, 1e-9);
+    EXPECT_NEAR(clipped.maximum().y(), 0.6, 1e-9);
+    EXPECT_NEAR(clipped.minimum().z(), -0.6, 1e-9);
+
+    raytracer::Aabb empty;
+    ASSERT_TRUE(sphere.ClipBox(
+        0.0, 1.0, raytracer::Aabb(raytracer::Point3(0.8, 0.8, -2.0), raytracer::Point3(2.0, 2.0, 2.0)), empty));
+    EXPECT_GT(empty.minimum().x(), empty.maximum().x());
+}
@@ -0,0 +1,157 @@
+/*
+ * 설명: 힐베르트 타일 순서가 이미지를 정확히 한 번씩 덮는지와 스레드 풀 분배, 띠 스트리밍 순서, 샘플 시드 파생을 검증한다.
+ * 버전: v1.1.0
+ * 관련 문서: design/renderer/v1.1.0-tile-threads.md
+ * 테스트: tests/unit/tile_test.cpp
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "raytracer/random.hpp"
+#include "raytracer/strip_stream.hpp"
+#include "raytracer/thread_pool.hpp"
+#include "raytracer/tile.hpp"
+
+TEST(TileTest, HilbertTilesCoverEveryPixelExactlyOnce) {
+    const int sizes[][3] = {{1, 1, 16}, {37, 19, 8}, {19, 37, 8}, {64, 64, 16}, {100, 7, 4}};
+    for (const auto& size : sizes) {
+        const int width = size[0];
+        const int height = size[1];
+        const std::vector<raytracer::Tile> tiles = raytracer::BuildHilbertTiles(width, height, size[2]);
+
+        std::vector<int> coverage(static_cast<std::size_t>(width * height), 0);
+        for (const auto& tile : tiles) {
+            ASSERT_GT(tile.Width(), 0);
+            ASSERT_GT(tile.Height(), 0);
+            for (int y = tile.y0; y < tile.y1; ++y) {
+                for (int x = tile.x0; x < tile.x1; ++x) {
+                    ++coverage[static_cast<std::size_t>(y * width + x)];
+                }
+            }
+        }
+
+        for (const int count : coverage) {
+            EXPECT_EQ(count, 1);
+        }
+    }
+}
+
+TEST(TileTest, HilbertTilesVisitNeighborsConsecutively) {
+    const int tile_size = 4;
+    const std::vector<raytracer::Tile> tiles = raytracer::BuildHilbertTiles(40, 24, tile_size);
+
+    for (std::size_t i = 1; i < tiles.size(); ++i) {
+        const int dx = std::abs(tiles[i].x0 - tiles[i - 1].x0) / tile_size;
+        const int dy = std::abs(tiles[i].y0 - tiles[i - 1].y0) / tile_size;
+        EXPECT_LE(dx + dy, 2);
+    }
+}
+
+TEST(TileTest, ThreadPoolRunsEveryIndexOnce) {
+    raytracer::ThreadPool pool(4);
+    std::vector<std::atomic<int>> counts(257);
+    for (auto& count : counts) {
+        count = 0;
+    }
+
+    pool.ParallelFor(counts.size(), [&counts](std::size_t index) { ++counts[index]; });
+
+    for (const auto& count : counts) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST(TileTest, NarrowRegionStripsFillEveryWorkerAndFlushInOrder) {
+    // 타일 한 열짜리 영역이라 띠마다 타일이 하나뿐이다. 띠 사이에 장벽이 있으면 동시에 도는 타일이 1개를 넘지 못한다.
+    const int tile_size = 16;
+    const int strip_count = 40;
+    const raytracer::Tile region{3, 5, 3 + tile_size, 5 + tile_size * strip_count - 7};
+    raytracer::ThreadPool pool(4);
+    // 구간 높이는 ceil(2 * 4 / 1) = 8띠이고, 타일은 두 구간(16띠) 앞까지만 시작할 수 있다.
+    const int window = 16;
+
+    std::atomic<int> active{0};
+    std::atomic<int> max_active{0};
+    std::atomic<int> emitted{0};
+    std::atomic<bool> window_exceeded{false};
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    std::vector<int> order;
+
+    raytracer::RenderStripsInOrder(
+        pool, region, tile_size,
+        [&](const raytracer::Tile& tile) {
+            const int strip = (tile.y0 - region.y0) / tile_size;
+            if (strip >= emitted.load() + window) {
+                window_exceeded = true;
+            }
+            const int now = ++active;
+            int seen = max_active.load();
+            while (seen < now && !max_active.compare_exchange_weak(seen, now)) {
+            }
+            while (max_active.load() < 4 && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+            --active;
+
+            std::vector<raytracer::Color> sums;
+            for (int y = tile.y0; y < tile.y1; ++y) {
+                for (int x = tile.x0; x < tile.x1; ++x) {
+                    sums.emplace_back(x, y, 0.0);
+                }
+            }
+            return sums;
+        },
+        [&](const raytracer::StripResult& result) {
+            order.push_back((result.strip.y0 - region.y0) / tile_size);
+            ASSERT_EQ(result.tiles.size(), 1u);
+            const raytracer::Tile& tile = result.tiles[0];
+            EXPECT_EQ(tile.y0, result.strip.y0);
+            EXPECT_EQ(tile.y1, result.strip.y1);
+            const std::vector<raytracer::Color>& sums = result.sums[0];
+            ASSERT_EQ(sums.size(), static_cast<std::size_t>(tile.Width() * tile.Height()));
+            EXPECT_EQ(sums.back().x(), tile.x1 - 1);
+            EXPECT_EQ(sums.back().y(), tile.y1 - 1);
+            ++emitted;
+        });
+
+    EXPECT_EQ(max_active.load(), 4);
+    EXPECT_FALSE(window_exceeded.load());
+    ASSERT_EQ(order.size(), static_cast<std::size_t>(strip_count));
+    for (int i = 0; i < strip_count; ++i) {
+        EXPECT_EQ(order[static_cast<std::size_t>(i)], i);
+    }
+}
+
+TEST(TileTest, StripStreamRethrowsTileErrorsAndStopsFlushing) {
+    raytracer::ThreadPool pool(3);
+    const raytracer::Tile region{0, 0, 20, 60};
+    std::atomic<int> emitted{0};
+
+    EXPECT_THROW(raytracer::RenderStripsInOrder(
+                     pool, region, 4,
+                     [](const raytracer::Tile& tile) {
+                         if (tile.y0 == 20) {
+                             throw std::runtime_error("타일 실패");
+                         }
+                         return std::vector<raytracer::Color>(
+                             static_cast<std::size_t>(tile.Width() * tile.Height()));
+                     },
+                     [&](const raytracer::StripResult&) { ++emitted; }),
+                 std::runtime_error);
+    // 실패한 띠(6번째)부터는 내보내지 않는다.
+    EXPECT_LE(emitted.load(), 5);
+}
+
+TEST(TileTest, SampleSeedDependsOnPixelAndSample) {
+    EXPECT_EQ(raytracer::SampleSeed(1, 10, 3), raytracer::SampleSeed(1, 10, 3));
+    EXPECT_NE(raytracer::SampleSeed(1, 10, 3), raytracer::SampleSeed(1, 11, 3));
+    EXPECT_NE(raytracer::SampleSeed(1, 10, 3), raytracer::SampleSeed(1, 10, 4));
+    EXPECT_NE(raytracer::SampleSeed(1, 10, 3), raytracer::SampleSeed(2, 10, 3));
+}
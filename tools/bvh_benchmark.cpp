@@ -1,24 +1,59 @@
 /*
- * 설명: 동일한 레이 집합에 대해 BVH 사용 전후 hit 시간을 비교해 텍스트로 출력한다.
- * 버전: v0.9.0
- * 관련 문서: design/renderer/v0.6.0-bvh.md, design/renderer/v0.9.0-volume.md
+ * 설명: 동일한 레이 집합에 대해 BVH 사용 전후 hit 시간, 빌더(중앙값/SAH, 잎 크기)별 빌드·hit 시간, 포인터 트리와
+ *       평탄화한 선형 BVH·4칸/8칸 넓은 BVH의 hit 시간을 비교하고, 턴테이블 애니메이션에서 프레임마다 BVH를 다시 빌드할 때와
+ *       재맞춤(refit)할 때의 비용, 구 100만 개 장면의 스레드 수별 병렬 빌드 시간, 큰 벽이 많은 장면에서 SAH와 공간
+ *       분할(SBVH)의 참조 수·hit 시간·기본 도형 hit 호출 수, 공유 BLAS 인스턴싱(TLAS)과 기하 복제의 메모리·hit 시간을
+ *       비교하고, 포인터 트리·선형·넓은·양자화 노드 형식의 노드당 바이트와 hit 시간, 구 100만 개 BVH를 캐시 파일에서
+ *       mmap으로 읽을 때와 새로 빌드할 때의 시작 시간을 비교해 텍스트로 출력한다. 빌더 비교에는 트리 품질 지표(SAH 비용,
+ *       형제 겹침 비율, 최대 잎 깊이)와, 카운터를 켠 빌드에서는 레이당 방문 노드·검사 도형 수를 함께 적는다.
+ *       끝점이 정해진 선분에 대해 가장 가까운 교차(Hit)와 가림 판정(Occluded)의 시간도 비교한다. 핀홀 카메라 화면
+ *       레이를 하나씩 순회할 때와 4/8/16개 묶음으로 순회할 때의 hit 시간, 타일 절두체로 잘라 낸 부분 트리에서 순회할 때의
+ *       hit 시간도 비교한다. 구 100만 개 장면에서 즉시 빌드와 지연 빌드의 빌드·첫 레이·hit 시간과 지연 빌드가 나눈 노드
+ *       비율도 비교한다. 빠르게 움직이는 구가 많은 장면에서 셔터 전체 경계 트리와 레이 시각으로 보간한 경계의 모션
+ *       BVH의 빌드·hit 시간과 레이당 도형 hit 호출 수도 비교한다.
+ * 버전: v1.25.0
+ * 관련 문서: design/renderer/v0.6.0-bvh.md, design/renderer/v0.9.0-volume.md, design/renderer/v1.9.0-animation.md,
+ *           design/renderer/v1.10.0-sah-build.md, design/renderer/v1.11.0-linear-bvh.md,
+ *           design/renderer/v1.12.0-wide-bvh.md, design/renderer/v1.13.0-parallel-build.md,
+ *           design/renderer/v1.15.0-sbvh.md, design/renderer/v1.16.0-instancing.md,
+ *           design/renderer/v1.17.0-quantized-bvh.md, design/renderer/v1.18.0-bvh-cache.md,
+ *           design/renderer/v1.19.0-bvh-stats.md, design/renderer/v1.20.0-occlusion.md,
+ *           design/renderer/v1.21.0-ray-packets.md, design/renderer/v1.23.0-tile-culling.md,
+ *           design/renderer/v1.24.0-lazy-bvh.md, design/renderer/v1.25.0-motion-bvh.md
  * 테스트: (수동 실행)
  */
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
 #include <limits>
+#include <thread>
 #include <memory>
-#include <random>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "raytracer/bvh.hpp"
+#include "raytracer/bvh_cache.hpp"
+#include "raytracer/bvh_stats.hpp"
+#include "raytracer/camera.hpp"
 #include "raytracer/hittable_list.hpp"
+#include "raytracer/instance.hpp"
+#include "raytracer/linear_bvh.hpp"
 #include "raytracer/material.hpp"
+#include "raytracer/motion_bvh.hpp"
+#include "raytracer/quad.hpp"
+#include "raytracer/quantized_bvh.hpp"
 #include "raytracer/random.hpp"
 #include "raytracer/ray.hpp"
 #include "raytracer/sphere.hpp"
+#include "raytracer/thread_pool.hpp"
+#include "raytracer/transform.hpp"
 #include "raytracer/vec3.hpp"
+#include "raytracer/wide_bvh.hpp"
 
 using namespace raytracer;
 
@@ -27,7 +62,7 @@ struct Measurement {
     int hit_count = 0;
 };
 
-HittableList BuildBenchmarkWorld(std::mt19937& generator) {
+HittableList BuildBenchmarkWorld(Rng& generator) {
     HittableList world;
     const auto ground = std::make_shared<Lambertian>(Color(0.5, 0.5, 0.5));
     world.Add(std::make_shared<Sphere>(Point3(0.0, -1000.0, 0.0), 1000.0, ground));
@@ -54,7 +89,99 @@ HittableList BuildBenchmarkWorld(std::mt19937& generator) {
     return world;
 }
 
-std::vector<Ray> GenerateRays(std::mt19937& generator, size_t count) {
+// 작은 구 대부분을 한 덩어리로 몰고 나머지를 넓게 흩어, 개수 중앙값 분할이 불리한 불균일 장면을 만든다.
+HittableList BuildUnevenWorld(Rng& generator) {
+    HittableList world;
+    const auto ground = std::make_shared<Lambertian>(Color(0.5, 0.5, 0.5));
+    world.Add(std::make_shared<Sphere>(Point3(0.0, -1000.0, 0.0), 1000.0, ground));
+
+    const auto material = std::make_shared<Lambertian>(Color(0.4, 0.6, 0.3));
+    for (int i = 0; i < 20000; ++i) {
+        const bool clustered = i % 20 != 0;
+        const Point3 center = clustered ? Point3(RandomDouble(generator, 2.0, 3.0), RandomDouble(generator, 0.2, 1.2),
+                                                 RandomDouble(generator, -1.0, 0.0))
+                                        : Point3(RandomDouble(generator, -6.0, 6.0), RandomDouble(generator, 0.2, 3.0),
+                                                 RandomDouble(generator, -6.0, 6.0));
+        world.Add(std::make_shared<Sphere>(center, clustered ? 0.02 : 0.1, material));
+    }
+    return world;
+}
+
+// 병렬 빌드 측정용으로 작은 구를 넓은 상자 안에 고르게 흩는다.
+std::vector<std::shared_ptr<Hittable>> BuildMillionSpheres(Rng& generator, size_t count) {
+    std::vector<std::shared_ptr<Hittable>> objects;
+    objects.reserve(count);
+    const auto material = std::make_shared<Lambertian>(Color(0.5, 0.5, 0.5));
+    for (size_t i = 0; i < count; ++i) {
+        const Point3 center(RandomDouble(generator, -100.0, 100.0), RandomDouble(generator, 0.0, 50.0),
+                            RandomDouble(generator, -100.0, 100.0));
+        objects.push_back(std::make_shared<Sphere>(center, 0.05, material));
+    }
+    return objects;
+}
+
+// 스레드 1개는 직렬 빌드와 같은 경로다. 어느 스레드 수에서든 같은 트리가 나온다.
+void MeasureParallelBuild(const std::vector<std::shared_ptr<Hittable>>& objects) {
+    std::cout << "병렬 빌드(구 " << objects.size() << "개, SAH 잎 1, 하드웨어 스레드 "
+              << std::thread::hardware_concurrency() << "개)\n";
+    for (const int thread_count : {1, 2, 4, 8}) {
+        ThreadPool pool(thread_count);
+        const auto start = std::chrono::steady_clock::now();
+        const BvhNode bvh(objects, 0.0, 1.0, BvhBuildOptions{}, pool);
+        const std::chrono::duration<double, std::milli> build = std::chrono::steady_clock::now() - start;
+        std::cout << "  스레드 " << thread_count << "개 빌드 시간(ms): " << build.count() << "\n";
+    }
+}
+
+// 기본 도형 hit 호출 수를 세어 트리가 레이당 몇 개의 도형을 시험하는지 비교한다.
+class CountingHittable : public Hittable {
+public:
+    CountingHittable(std::shared_ptr<Hittable> inner, size_t& calls) : inner_(std::move(inner)), calls_(calls) {}
+
+    bool Hit(const Ray& r, double t_min, double t_max, HitRecord& record, Rng& generator) const override {
+        ++calls_;
+        return inner_->Hit(r, t_min, t_max, record, generator);
+    }
+
+    bool BoundingBox(double time0, double time1, Aabb& output_box) const override {
+        return inner_->BoundingBox(time0, time1, output_box);
+    }
+
+    bool ClipBox(double time0, double time1, const Aabb& region, Aabb& output_box) const override {
+        return inner_->ClipBox(time0, time1, region, output_box);
+    }
+
+    bool MotionBounds(double time0, double time1, Aabb& box0, Aabb& box1) const override {
+        return inner_->MotionBounds(time0, time1, box0, box1);
+    }
+
+private:
+    std::shared_ptr<Hittable> inner_;
+    size_t& calls_;
+};
+
+// 방 크기의 기운 벽과 바닥 quad가 작은 구 위로 겹쳐, 객체 분할만으로는 자식 상자가 크게 겹치는 장면이다.
+HittableList BuildWallWorld(Rng& generator, size_t& calls) {
+    HittableList world;
+    const auto material = std::make_shared<Lambertian>(Color(0.5, 0.5, 0.5));
+    const auto add = [&](std::shared_ptr<Hittable> object) {
+        world.Add(std::make_shared<CountingHittable>(std::move(object), calls));
+    };
+    for (int i = 0; i < 16; ++i) {
+        const double offset = -8.0 + static_cast<double>(i);
+        add(std::make_shared<Quad>(Point3(offset, 0.0, -12.0), Vec3(8.0, 0.0, 8.0), Vec3(0.0, 4.0, 0.0), material));
+        add(std::make_shared<Quad>(Point3(-8.0, 0.05 * i, offset - 4.0), Vec3(16.0, 0.0, 0.0), Vec3(0.0, 0.0, 0.5),
+                                   material));
+    }
+    for (int i = 0; i < 4000; ++i) {
+        const Point3 center(RandomDouble(generator, -8.0, 8.0), RandomDouble(generator, 0.0, 4.0),
+                            RandomDouble(generator, -12.0, 4.0));
+        add(std::make_shared<Sphere>(center, 0.08, material));
+    }
+    return world;
+}
+
+std::vector<Ray> GenerateRays(Rng& generator, size_t count) {
     std::vector<Ray> rays;
     rays.reserve(count);
     for (size_t i = 0; i < count; ++i) {
@@ -69,7 +196,7 @@ std::vector<Ray> GenerateRays(std::mt19937& generator, size_t count) {
 
 Measurement MeasureHits(const Hittable& world, const std::vector<Ray>& rays, std::uint32_t seed) {
     int hits = 0;
-    std::mt19937 generator(seed);
+    Rng generator(seed);
     const auto start = std::chrono::steady_clock::now();
     for (const auto& ray : rays) {
         HitRecord record;
@@ -81,8 +208,557 @@ Measurement MeasureHits(const Hittable& world, const std::vector<Ray>& rays, std
     return {end - start, hits};
 }
 
+void CompareBuilders(const char* label, const HittableList& world, const std::vector<Ray>& rays) {
+    struct BuilderCase {
+        const char* name;
+        BvhBuildOptions options;
+    };
+    std::vector<BuilderCase> cases(3);
+    cases[0].name = "중앙값";
+    cases[0].options.split = BvhSplitMethod::kMedian;
+    cases[1].name = "SAH(잎 1)";
+    cases[2].name = "SAH(잎 4)";
+    cases[2].options.max_leaf_size = 4;
+
+    std::cout << label << "(객체 " << world.Objects().size() << "개, 레이 " << rays.size() << "개)\n";
+    for (const BuilderCase& builder : cases) {
+        const auto start = std::chrono::steady_clock::now();
+        const BvhNode bvh(world, 0.0, 1.0, builder.options);
+        const std::chrono::duration<double, std::milli> build = std::chrono::steady_clock::now() - start;
+        ResetBvhCounters();
+        const Measurement measure = MeasureHits(bvh, rays, 2025);
+        const BvhTraversalCounters counters = ReadBvhCounters();
+        const BvhStats stats = InspectBvh(bvh, 0.0, 1.0);
+        std::cout << "  " << builder.name << " 빌드/hit 시간(ms): " << build.count() << " / " << measure.elapsed.count()
+                  << ", hit 수: " << measure.hit_count << ", SAH 비용: " << stats.sah_cost
+                  << ", 형제 겹침 비율: " << stats.sibling_overlap_ratio << ", 최대 잎 깊이: "
+                  << stats.leaves_per_depth.size() - 1 << "\n";
+        if (kBvhCountersEnabled) {
+            const double ray_count = static_cast<double>(rays.size());
+            std::cout << "    레이당 방문 노드/검사 도형: " << static_cast<double>(counters.nodes_visited) / ray_count
+                      << " / " << static_cast<double>(counters.primitives_tested) / ray_count << "\n";
+        }
+    }
+}
+
+// 같은 SAH 트리를 포인터 트리(BvhNode) 그대로, 그리고 32바이트 노드 배열로 평탄화해 순회한다.
+void CompareLayouts(const char* label, const HittableList& world, const std::vector<Ray>& rays) {
+    const BvhNode tree(world, 0.0, 1.0);
+    const auto start = std::chrono::steady_clock::now();
+    const LinearBvh linear(tree, 0.0, 1.0);
+    const std::chrono::duration<double, std::milli> flatten = std::chrono::steady_clock::now() - start;
+
+    const Measurement tree_measure = MeasureHits(tree, rays, 2025);
+    const Measurement linear_measure = MeasureHits(linear, rays, 2025);
+    std::cout << label << "(노드 " << linear.NodeCount() << "개, 깊이 " << linear.Depth() << ", 노드 배열 "
+              << linear.NodeCount() * sizeof(LinearBvhNode) << "바이트)\n";
+    std::cout << "  BvhNode hit 시간(ms): " << tree_measure.elapsed.count() << "\n";
+    std::cout << "  LinearBvh 평탄화/hit 시간(ms): " << flatten.count() << " / " << linear_measure.elapsed.count()
+              << ", hit 카운트 차이: " << (tree_measure.hit_count - linear_measure.hit_count) << "\n";
+
+    const Bvh4 bvh4(tree, 0.0, 1.0);
+    const Bvh8 bvh8(tree, 0.0, 1.0);
+    const Measurement bvh4_measure = MeasureHits(bvh4, rays, 2025);
+    const Measurement bvh8_measure = MeasureHits(bvh8, rays, 2025);
+    std::cout << "  Bvh4 hit 시간(ms): " << bvh4_measure.elapsed.count() << " (노드 " << bvh4.NodeCount() << "개, 깊이 "
+              << bvh4.Depth() << "), hit 카운트 차이: " << (tree_measure.hit_count - bvh4_measure.hit_count) << "\n";
+    std::cout << "  Bvh8 hit 시간(ms): " << bvh8_measure.elapsed.count() << " (노드 " << bvh8.NodeCount() << "개, 깊이 "
+              << bvh8.Depth() << "), hit 카운트 차이: " << (tree_measure.hit_count - bvh8_measure.hit_count) << "\n";
+}
+
+// SAH와 공간 분할(SBVH)로 같은 장면을 빌드해 참조 수, 포인터 트리·Bvh8의 hit 시간, 레이당 도형 hit 호출 수를 비교한다.
+void CompareSpatialSplits(Rng& generator, const std::vector<Ray>& rays) {
+    size_t calls = 0;
+    const HittableList world = BuildWallWorld(generator, calls);
+    std::cout << "공간 분할: 벽 장면(객체 " << world.Objects().size() << "개, 레이 " << rays.size() << "개)\n";
+
+    BvhBuildOptions spatial;
+    spatial.split = BvhSplitMethod::kSpatialSah;
+    for (const auto& [name, options] : {std::make_pair("SAH", BvhBuildOptions{}), std::make_pair("SBVH", spatial)}) {
+        const auto start = std::chrono::steady_clock::now();
+        const BvhNode tree(world, 0.0, 1.0, options);
+        const std::chrono::duration<double, std::milli> build = std::chrono::steady_clock::now() - start;
+        const Bvh8 bvh8(tree, 0.0, 1.0);
+        const LinearBvh linear(tree, 0.0, 1.0);
+
+        calls = 0;
+        const Measurement tree_measure = MeasureHits(tree, rays, 2025);
+        const size_t tree_calls = calls;
+        calls = 0;
+        const Measurement bvh8_measure = MeasureHits(bvh8, rays, 2025);
+        const size_t bvh8_calls = calls;
+        std::cout << "  " << name << " 빌드 시간(ms): " << build.count() << ", 참조 " << linear.PrimitiveCount() << "개\n";
+        std::cout << "    BvhNode hit 시간(ms): " << tree_measure.elapsed.count() << ", 레이당 도형 hit "
+                  << static_cast<double>(tree_calls) / static_cast<double>(rays.size()) << "회\n";
+        std::cout << "    Bvh8 hit 시간(ms): " << bvh8_measure.elapsed.count() << ", 레이당 도형 hit "
+                  << static_cast<double>(bvh8_calls) / static_cast<double>(rays.size())
+                  << "회, hit 수: " << bvh8_measure.hit_count << "\n";
+    }
+}
+
+// 구 1000개짜리 물체 하나를 BLAS로 두고 인스턴스 TLAS로 배치한다. 같은 배치를 도형마다 변환 래퍼로 복제한
+// 단일 BVH와 비교하고, 10만 개 배치의 메모리(노드 배열과 인스턴스, 도형 크기의 합)를 추정한다.
+void CompareInstancing(Rng& generator) {
+    const auto material = std::make_shared<Lambertian>(Color(0.5, 0.5, 0.5));
+    std::vector<std::shared_ptr<Hittable>> cluster;
+    for (int i = 0; i < 1000; ++i) {
+        cluster.push_back(std::make_shared<Sphere>(
+            Point3(RandomDouble(generator, -0.5, 0.5), RandomDouble(generator, 0.0, 1.0), RandomDouble(generator, -0.5, 0.5)),
+            0.03, material));
+    }
+    const auto blas = std::make_shared<Bvh8>(cluster, 0.0, 1.0);
+    const size_t blas_bytes = blas->NodeCount() * sizeof(WideBvhNode<8>) + cluster.size() * sizeof(Sphere);
+
+    const auto placement = [&generator](int index, int side) {
+        const double scale = RandomDouble(generator, 0.5, 1.0);
+        return AffineTransform::Scaling(Vec3(scale, scale, scale))
+            .Then(AffineTransform::RotationY(RandomDouble(generator, 0.0, 360.0)))
+            .Then(AffineTransform::Translation(Vec3(1.2 * (index % side - side / 2), 0.0, -1.2 * (index / side))));
+    };
+    const auto field_rays = [&generator](int side) {
+        std::vector<Ray> rays;
+        for (int i = 0; i < 20000; ++i) {
+            const Point3 origin(RandomDouble(generator, -0.6 * side, 0.6 * side), 5.0, RandomDouble(generator, -1.2 * side, 0.0));
+            rays.emplace_back(origin, Vec3(RandomDouble(generator, -0.3, 0.3), -1.0, RandomDouble(generator, -0.3, 0.3)), 0.0);
+        }
+        return rays;
+    };
+
+    // 작은 배치: 복제한 기하와 인스턴스가 같은 교차를 내는지와 hit 시간을 비교한다. 복제 쪽 변환은 균일 배율이 없는
+    // RotateY/Translate뿐이므로 배율 1로 둔다.
+    constexpr int kSmallSide = 10;
+    HittableList copies;
+    std::vector<std::shared_ptr<Hittable>> small_instances;
+    for (int index = 0; index < kSmallSide * kSmallSide; ++index) {
+        const double angle = RandomDouble(generator, 0.0, 360.0);
+        const Vec3 offset(1.2 * (index % kSmallSide - kSmallSide / 2), 0.0, -1.2 * (index / kSmallSide));
+        for (const auto& sphere : cluster) {
+            copies.Add(std::make_shared<Translate>(std::make_shared<RotateY>(sphere, angle), offset));
+        }
+        small_instances.push_back(std::make_shared<Instance>(
+            blas, AffineTransform::RotationY(angle).Then(AffineTransform::Translation(offset))));
+    }
+    const std::vector<Ray> small_rays = field_rays(kSmallSide);
+    auto start = std::chrono::steady_clock::now();
+    const Bvh8 flat(copies.Objects(), 0.0, 1.0);
+    const std::chrono::duration<double, std::milli> flat_build = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    const Bvh8 small_tlas(small_instances, 0.0, 1.0);
+    const std::chrono::duration<double, std::milli> small_build = std::chrono::steady_clock::now() - start;
+    const Measurement flat_measure = MeasureHits(flat, small_rays, 2025);
+    const Measurement small_measure = MeasureHits(small_tlas, small_rays, 2025);
+    std::cout << "인스턴싱: 구 " << cluster.size() << "개 물체 " << small_instances.size() << "번 배치(레이 "
+              << small_rays.size() << "개)\n";
+    std::cout << "  기하 복제 단일 Bvh8 빌드/hit 시간(ms): " << flat_build.count() << " / " << flat_measure.elapsed.count()
+              << ", 추정 메모리 "
+              << (flat.NodeCount() * sizeof(WideBvhNode<8>) +
+                  copies.Objects().size() * (sizeof(Sphere) + sizeof(RotateY) + sizeof(Translate))) /
+                     1024
+              << "KiB\n";
+    std::cout << "  TLAS+공유 BLAS 빌드/hit 시간(ms): " << small_build.count() << " / " << small_measure.elapsed.count()
+              << ", hit 카운트 차이: " << (flat_measure.hit_count - small_measure.hit_count) << "\n";
+
+    constexpr int kLargeSide = 317;
+    std::vector<std::shared_ptr<Hittable>> instances;
+    instances.reserve(100000);
+    for (int index = 0; index < 100000; ++index) {
+        instances.push_back(std::make_shared<Instance>(blas, placement(index, kLargeSide)));
+    }
+    start = std::chrono::steady_clock::now();
+    const Bvh8 tlas(instances, 0.0, 1.0);
+    const std::chrono::duration<double, std::milli> build = std::chrono::steady_clock::now() - start;
+    const std::vector<Ray> rays = field_rays(kLargeSide);
+    const Measurement measure = MeasureHits(tlas, rays, 2025);
+    const size_t instanced_bytes =
+        blas_bytes + tlas.NodeCount() * sizeof(WideBvhNode<8>) + instances.size() * sizeof(Instance);
+    std::cout << "  " << instances.size() << "번 배치 TLAS 빌드/hit 시간(ms): " << build.count() << " / "
+              << measure.elapsed.count() << ", hit 수: " << measure.hit_count << "\n";
+    std::cout << "  추정 메모리: 인스턴싱 " << instanced_bytes / 1024 << "KiB, 기하 복제 시 도형만 "
+              << instances.size() * cluster.size() * sizeof(Sphere) / (1024 * 1024) << "MiB\n";
+}
+
+// 같은 SAH 트리를 노드 형식별로 펼쳐 노드 배열 크기와 hit 시간을 비교한다. BvhNode는 make_shared 한 번에
+// 노드와 제어 블록(16바이트로 가정)을 함께 할당하므로 그 합을 노드 크기로 본다. 객체 포인터 배열은 제외한다.
+void CompareNodeFormats(const char* label, const std::vector<std::shared_ptr<Hittable>>& objects,
+                        const std::vector<Ray>& rays) {
+    constexpr size_t kControlBlockBytes = 16;
+    const BvhNode tree(objects, 0.0, 1.0);
+    const LinearBvh linear(tree, 0.0, 1.0);
+    const Bvh8 bvh8(tree, 0.0, 1.0);
+    const QuantizedBvh16 quantized16(tree, 0.0, 1.0);
+    const QuantizedBvh8 quantized8(tree, 0.0, 1.0);
+
+    std::cout << label << "(객체 " << objects.size() << "개, 레이 " << rays.size() << "개)\n";
+    const auto report = [&](const char* name, const Hittable& bvh, size_t node_count, size_t node_bytes) {
+        const Measurement measure = MeasureHits(bvh, rays, 2025);
+        std::cout << "  " << name << ": 노드 " << node_count << "개 x " << node_bytes << "바이트 = "
+                  << node_count * node_bytes / 1024 << "KiB(객체당 "
+                  << static_cast<double>(node_count * node_bytes) / static_cast<double>(objects.size())
+                  << "바이트), hit 시간(ms): " << measure.elapsed.count() << ", hit 수: " << measure.hit_count << "\n";
+    };
+    // BvhNode 개수는 잎을 따로 두지 않는 양자화 노드 수와 같다.
+    report("BvhNode", tree, quantized8.NodeCount(), sizeof(BvhNode) + kControlBlockBytes);
+    report("LinearBvh", linear, linear.NodeCount(), sizeof(LinearBvhNode));
+    report("Bvh8", bvh8, bvh8.NodeCount(), sizeof(WideBvhNode<8>));
+    report("QuantizedBvh16", quantized16, quantized16.NodeCount(), sizeof(QuantizedBvhNode<16>));
+    report("QuantizedBvh8", quantized8, quantized8.NodeCount(), sizeof(QuantizedBvhNode<8>));
+}
+
+// 그림자 레이처럼 끝점이 정해진 선분(t_max = 1)을 가장 가까운 교차(Hit)와 가림 판정(Occluded)으로 각각 답한다.
+Measurement MeasureSegments(const Hittable& world, const std::vector<Ray>& segments, bool any_hit) {
+    int hits = 0;
+    Rng generator(2025);
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& segment : segments) {
+        HitRecord record;
+        if (any_hit ? world.Occluded(segment, 0.001, 1.0, generator) : world.Hit(segment, 0.001, 1.0, record, generator)) {
+            ++hits;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return {end - start, hits};
+}
+
+void CompareOcclusion(const char* label, const HittableList& world, const std::vector<Ray>& rays) {
+    // 레이 방향으로 길이 12인 선분을 만든다. 장면 대부분을 가로지르므로 가린 선분이 많다.
+    std::vector<Ray> segments;
+    segments.reserve(rays.size());
+    for (const auto& ray : rays) {
+        segments.emplace_back(ray.origin(), 12.0 * ray.direction(), ray.time());
+    }
+    const BvhNode tree(world, 0.0, 1.0);
+    const Bvh8 bvh8(tree, 0.0, 1.0);
+
+    std::cout << label << "(객체 " << world.Objects().size() << "개, 선분 " << segments.size() << "개)\n";
+    const auto report = [&](const char* name, const Hittable& bvh) {
+        ResetBvhCounters();
+        const Measurement closest = MeasureSegments(bvh, segments, false);
+        const BvhTraversalCounters closest_counters = ReadBvhCounters();
+        ResetBvhCounters();
+        const Measurement any = MeasureSegments(bvh, segments, true);
+        const BvhTraversalCounters any_counters = ReadBvhCounters();
+        std::cout << "  " << name << " Hit/Occluded 시간(ms): " << closest.elapsed.count() << " / " << any.elapsed.count()
+                  << ", 가린 선분: " << any.hit_count << ", 개수 차이: " << (closest.hit_count - any.hit_count) << "\n";
+        if (kBvhCountersEnabled) {
+            const double segment_count = static_cast<double>(segments.size());
+            std::cout << "    선분당 검사 도형 Hit/Occluded: "
+                      << static_cast<double>(closest_counters.primitives_tested) / segment_count << " / "
+                      << static_cast<double>(any_counters.primitives_tested) / segment_count << "\n";
+        }
+    };
+    report("BvhNode", tree);
+    report("Bvh8", bvh8);
+}
+
+// 핀홀 카메라의 화면 레이(픽셀마다 한 개, 픽셀 안에서 흔듦)를 레이마다 따로, 그리고 2x2/4x2/4x4 픽셀 블록 묶음으로
+// 순회한다. 묶음은 레이마다 같은 순서로 도형을 검사하므로 레이마다 t가 비트 단위로 같아야 한다.
+void ComparePackets(const char* label, const HittableList& world, const Point3& look_from, const Point3& look_at) {
+    constexpr int kImageSize = 256;
+    const Camera camera(look_from, look_at, Vec3(0.0, 1.0, 0.0), 40.0, 1.0, 0.0, 1.0, 0.0, 1.0);
+    Rng generator(77);
+    std::vector<Ray> rays(static_cast<size_t>(kImageSize) * kImageSize);
+    for (int y = 0; y < kImageSize; ++y) {
+        for (int x = 0; x < kImageSize; ++x) {
+            rays[static_cast<size_t>(y) * kImageSize + static_cast<size_t>(x)] =
+                camera.GetRay((x + RandomDouble(generator)) / (kImageSize - 1.0),
+                              (kImageSize - 1 - y + RandomDouble(generator)) / (kImageSize - 1.0), generator);
+        }
+    }
+    const Bvh8 bvh8(world.Objects(), 0.0, 1.0);
+
+    std::cout << label << "(객체 " << world.Objects().size() << "개, 화면 레이 " << rays.size() << "개)\n";
+    std::vector<double> single_t(rays.size(), -1.0);
+    ResetBvhCounters();
+    const Measurement single = MeasureHits(bvh8, rays, 2025);
+    const BvhTraversalCounters single_counters = ReadBvhCounters();
+    std::cout << "  단일 레이 hit 시간(ms): " << single.elapsed.count() << ", hit 수: " << single.hit_count << "\n";
+    for (size_t i = 0; i < rays.size(); ++i) {
+        HitRecord record;
+        Rng ray_generator(2025);
+        if (bvh8.Hit(rays[i], 0.001, std::numeric_limits<double>::infinity(), record, ray_generator)) {
+            single_t[i] = record.t;
+        }
+    }
+
+    for (const auto& [block_width, block_height] : {std::pair{2, 2}, std::pair{4, 2}, std::pair{4, 4}}) {
+        const int packet_size = block_width * block_height;
+        Ray packet[kMaxPacketSize];
+        HitRecord records[kMaxPacketSize];
+        Rng generators[kMaxPacketSize];
+        int hits = 0;
+        std::vector<double> packet_t(rays.size(), -1.0);
+        ResetBvhCounters();
+        const auto start = std::chrono::steady_clock::now();
+        for (int by = 0; by < kImageSize; by += block_height) {
+            for (int bx = 0; bx < kImageSize; bx += block_width) {
+                int count = 0;
+                size_t indices[kMaxPacketSize];
+                for (int y = by; y < by + block_height; ++y) {
+                    for (int x = bx; x < bx + block_width; ++x) {
+                        indices[count] = static_cast<size_t>(y) * kImageSize + static_cast<size_t>(x);
+                        packet[count] = rays[indices[count]];
+                        ++count;
+                    }
+                }
+                const std::uint32_t mask = bvh8.HitPacket(packet, count, 0.001, std::numeric_limits<double>::infinity(),
+                                                          records, generators);
+                for (int i = 0; i < count; ++i) {
+                    if ((mask & (1u << i)) != 0) {
+                        ++hits;
+                        packet_t[indices[i]] = records[i].t;
+                    }
+                }
+            }
+        }
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        const BvhTraversalCounters counters = ReadBvhCounters();
+        size_t mismatches = 0;
+        for (size_t i = 0; i < rays.size(); ++i) {
+            mismatches += single_t[i] != packet_t[i] ? 1 : 0;
+        }
+        std::cout << "  묶음 " << packet_size << " hit 시간(ms): " << elapsed.count() << ", hit 수 차이: "
+                  << (single.hit_count - hits) << ", t가 다른 레이: " << mismatches << "\n";
+        if (kBvhCountersEnabled) {
+            std::cout << "    떨어진 레이 비율: "
+                      << static_cast<double>(counters.packet_detached_rays) / static_cast<double>(rays.size())
+                      << ", 레이당 방문 노드 단일/묶음: "
+                      << static_cast<double>(single_counters.nodes_visited) / static_cast<double>(rays.size()) << " / "
+                      << static_cast<double>(counters.nodes_visited) / static_cast<double>(rays.size()) << "\n";
+        }
+    }
+}
+
+// 핀홀 카메라 화면을 타일로 나눠, 타일 레이(픽셀 중앙 하나)를 전체 트리에서 순회할 때와 타일 절두체로 잘라 낸
+// 부분 트리에서 순회할 때의 시간을 해상도·타일 크기별로 비교한다. 잘라 낸 쪽 시간에는 타일마다 자르는 비용이 들어간다.
+void CompareTileCulling(const char* label, const HittableList& world, const Point3& look_from, const Point3& look_at) {
+    const Camera camera(look_from, look_at, Vec3(0.0, 1.0, 0.0), 40.0, 1.0, 0.0, 1.0, 0.0, 1.0);
+    const Bvh8 bvh8(world.Objects(), 0.0, 1.0);
+    std::cout << label << "(객체 " << world.Objects().size() << "개, 노드 " << bvh8.NodeCount() << "개)\n";
+
+    for (const int image_size : {512, 1024}) {
+        const auto trace_tiles = [&](int tile_size, bool cull, std::vector<double>& hit_t, size_t& culled_nodes) {
+            Rng generator(2025);
+            const double extent = image_size - 1.0;
+            for (int y0 = 0; y0 < image_size; y0 += tile_size) {
+                for (int x0 = 0; x0 < image_size; x0 += tile_size) {
+                    const int x1 = std::min(x0 + tile_size, image_size);
+                    const int y1 = std::min(y0 + tile_size, image_size);
+                    std::optional<Bvh8> culled;
+                    const Bvh8* tree = &bvh8;
+                    Frustum frustum;
+                    if (cull && camera.RegionFrustum(x0 / extent, x1 / extent, (image_size - y1) / extent,
+                                                     (image_size - y0) / extent, frustum)) {
+                        culled.emplace(bvh8.CulledBy(frustum));
+                        culled_nodes += culled->NodeCount();
+                        tree = &*culled;
+                    }
+                    for (int y = y0; y < y1; ++y) {
+                        for (int x = x0; x < x1; ++x) {
+                            const Ray ray =
+                                camera.GetRay((x + 0.5) / extent, (image_size - 1 - y + 0.5) / extent, generator);
+                            HitRecord record;
+                            if (tree->Hit(ray, 0.001, std::numeric_limits<double>::infinity(), record, generator)) {
+                                hit_t[static_cast<size_t>(y) * image_size + static_cast<size_t>(x)] = record.t;
+                            }
+                        }
+                    }
+                }
+            }
+        };
+
+        const size_t pixel_count = static_cast<size_t>(image_size) * image_size;
+        std::vector<double> full_t(pixel_count, -1.0);
+        size_t unused = 0;
+        ResetBvhCounters();
+        auto start = std::chrono::steady_clock::now();
+        trace_tiles(image_size, false, full_t, unused);
+        const std::chrono::duration<double, std::milli> full = std::chrono::steady_clock::now() - start;
+        const BvhTraversalCounters full_counters = ReadBvhCounters();
+        std::cout << "  " << image_size << "x" << image_size << " 전체 트리 hit 시간(ms): " << full.count() << "\n";
+
+        for (const int tile_size : {8, 16, 32, 64}) {
+            std::vector<double> culled_t(pixel_count, -1.0);
+            size_t culled_nodes = 0;
+            ResetBvhCounters();
+            start = std::chrono::steady_clock::now();
+            trace_tiles(tile_size, true, culled_t, culled_nodes);
+            const std::chrono::duration<double, std::milli> culled = std::chrono::steady_clock::now() - start;
+            const BvhTraversalCounters counters = ReadBvhCounters();
+            const size_t tiles = static_cast<size_t>((image_size + tile_size - 1) / tile_size) *
+                                 static_cast<size_t>((image_size + tile_size - 1) / tile_size);
+            size_t mismatches = 0;
+            for (size_t i = 0; i < pixel_count; ++i) {
+                mismatches += full_t[i] != culled_t[i] ? 1 : 0;
+            }
+            std::cout << "    타일 " << tile_size << " 절두체 컬링 hit 시간(ms): " << culled.count()
+                      << ", 타일당 노드: " << static_cast<double>(culled_nodes) / static_cast<double>(tiles)
+                      << ", t가 다른 레이: " << mismatches << "\n";
+            if (kBvhCountersEnabled) {
+                std::cout << "      레이당 방문 노드 전체/컬링: "
+                          << static_cast<double>(full_counters.nodes_visited) / static_cast<double>(pixel_count) << " / "
+                          << static_cast<double>(counters.nodes_visited) / static_cast<double>(pixel_count) << "\n";
+            }
+        }
+    }
+}
+
+// 즉시 빌드와 지연 빌드의 빌드 시간, 첫 레이까지 시간, 레이 전체 hit 시간과 지연 빌드가 실제로 나눈 노드 비율을 비교한다.
+void CompareLazyBuild(const char* label, const std::vector<std::shared_ptr<Hittable>>& objects,
+                      const std::vector<Ray>& rays) {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    auto start = Clock::now();
+    const BvhNode eager(objects, 0.0, 1.0);
+    const Milliseconds eager_build = Clock::now() - start;
+    const Measurement eager_hits = MeasureHits(eager, rays, 2025);
+    const std::size_t node_count = InspectBvh(eager, 0.0, 1.0).node_count;
+
+    BvhBuildOptions options;
+    options.lazy = true;
+    start = Clock::now();
+    const BvhNode lazy(objects, 0.0, 1.0, options);
+    const Milliseconds lazy_build = Clock::now() - start;
+    HitRecord record;
+    Rng generator(2025);
+    start = Clock::now();
+    lazy.Hit(rays.front(), 0.001, std::numeric_limits<double>::infinity(), record, generator);
+    const Milliseconds first_ray = Clock::now() - start;
+    const Measurement lazy_hits = MeasureHits(lazy, rays, 2025);
+    const BvhLazyBuildStats stats = lazy.LazyBuildStats();
+
+    std::cout << label << "(객체 " << objects.size() << "개, 레이 " << rays.size() << "개)\n";
+    std::cout << "  즉시 빌드/hit 시간(ms): " << eager_build.count() << " / " << eager_hits.elapsed.count() << "\n";
+    std::cout << "  지연 빌드 뿌리/첫 레이/hit 시간(ms): " << lazy_build.count() << " / " << first_ray.count() << " / "
+              << lazy_hits.elapsed.count() << ", hit 수 차이: " << (eager_hits.hit_count - lazy_hits.hit_count) << "\n";
+    std::cout << "  나눈 노드: " << stats.built_nodes << " / " << node_count << "("
+              << 100.0 * static_cast<double>(stats.built_nodes) / static_cast<double>(node_count)
+              << "%), 나누지 않은 구간의 객체: " << stats.pending_primitives << "\n";
+}
+
+// 반지름 0.05인 구 10000개가 셔터 동안 임의 방향으로 distance만큼 움직인다. 셔터 전체 경계로 빌드한 트리(BvhNode,
+// Bvh8)와 레이 시각으로 보간한 경계를 쓰는 MotionBvh를 같은 레이(시각은 셔터 안에 고르게)로 비교한다.
+void CompareMotionBlur(Rng& generator, const std::vector<Ray>& rays) {
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    std::cout << "모션 블러(구 10000개, 레이 " << rays.size() << "개)\n";
+    const auto material = std::make_shared<Lambertian>(Color(0.5, 0.5, 0.5));
+    for (const double distance : {0.0, 0.5, 3.0}) {
+        size_t calls = 0;
+        std::vector<std::shared_ptr<Hittable>> objects;
+        for (int i = 0; i < 10000; ++i) {
+            const Point3 center(RandomDouble(generator, -6.0, 6.0), RandomDouble(generator, 0.0, 3.0),
+                                RandomDouble(generator, -6.0, 6.0));
+            const Vec3 motion = distance * RandomUnitVector(generator);
+            objects.push_back(std::make_shared<CountingHittable>(
+                std::make_shared<MovingSphere>(center, center + motion, 0.0, 1.0, 0.05, material), calls));
+        }
+
+        auto start = Clock::now();
+        const BvhNode tree(objects, 0.0, 1.0);
+        const Milliseconds tree_build = Clock::now() - start;
+        start = Clock::now();
+        const Bvh8 bvh8(tree, 0.0, 1.0);
+        const Milliseconds wide_build = tree_build + (Clock::now() - start);
+        start = Clock::now();
+        const MotionBvh motion(objects, 0.0, 1.0);
+        const Milliseconds motion_build = Clock::now() - start;
+
+        std::cout << "  이동 거리 " << distance << "\n";
+        int reference_hits = 0;
+        const auto report = [&](const char* name, const Hittable& bvh, const Milliseconds& build) {
+            calls = 0;
+            const Measurement measure = MeasureHits(bvh, rays, 2025);
+            if (reference_hits == 0) {
+                reference_hits = measure.hit_count;
+            }
+            std::cout << "    " << name << " 빌드/hit 시간(ms): " << build.count() << " / " << measure.elapsed.count()
+                      << ", 레이당 도형 hit 호출: " << static_cast<double>(calls) / static_cast<double>(rays.size())
+                      << ", hit 수 차이: " << (reference_hits - measure.hit_count) << "\n";
+        };
+        report("BvhNode", tree, tree_build);
+        report("Bvh8", bvh8, wide_build);
+        report("MotionBvh", motion, motion_build);
+    }
+}
+
+// 첫 실행은 캐시가 없어 빌드 후 기록하고, 두 번째 실행은 키 계산 뒤 캐시 파일을 mmap해 검증만 한다.
+void MeasureBvhCache(const std::vector<std::shared_ptr<Hittable>>& objects, const std::vector<Ray>& rays) {
+    const std::string path = (std::filesystem::temp_directory_path() / "bvh_benchmark_cache.bin").string();
+    std::remove(path.c_str());
+
+    auto start = std::chrono::steady_clock::now();
+    const BvhCacheResult cold = LoadOrBuildBvh(path, objects, 0.0, 1.0);
+    const std::chrono::duration<double, std::milli> cold_time = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    const std::uint64_t key = BvhCacheKey(objects, 0.0, 1.0);
+    const std::chrono::duration<double, std::milli> key_time = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    const BvhCacheResult warm = LoadOrBuildBvh(path, objects, 0.0, 1.0);
+    const std::chrono::duration<double, std::milli> warm_time = std::chrono::steady_clock::now() - start;
+
+    const Measurement cold_measure = MeasureHits(*cold.bvh, rays, 2025);
+    const Measurement warm_measure = MeasureHits(*warm.bvh, rays, 2025);
+    std::cout << "BVH 캐시(구 " << objects.size() << "개, 파일 " << std::filesystem::file_size(path) / (1024 * 1024)
+              << "MiB, 키 " << std::hex << key << std::dec << ")\n";
+    std::cout << "  캐시 없음(빌드+기록) 시간(ms): " << cold_time.count() << ", 읽음: " << cold.loaded << "\n";
+    std::cout << "  캐시 있음(키 계산+mmap+검증) 시간(ms): " << warm_time.count() << " (키 계산만 " << key_time.count()
+              << "), 읽음: " << warm.loaded << "\n";
+    std::cout << "  hit 시간(ms) 빌드/캐시: " << cold_measure.elapsed.count() << " / " << warm_measure.elapsed.count()
+              << ", hit 카운트 차이: " << (cold_measure.hit_count - warm_measure.hit_count) << "\n";
+    std::remove(path.c_str());
+}
+
+struct AnimationMeasurement {
+    std::chrono::duration<double, std::milli> update;
+    std::chrono::duration<double, std::milli> hits;
+    BvhRefitStats refit;
+};
+
+// 작은 구들을 Translate로 감싸 턴테이블처럼 y축 둘레로 돌리며 프레임마다 BVH를 갱신하고 같은 레이 집합을 쏜다.
+// refit이 false면 프레임마다 BVH를 새로 빌드한다.
+AnimationMeasurement MeasureTurntable(const std::vector<Ray>& rays, int frame_count, bool refit) {
+    Rng generator(7);
+    HittableList world;
+    std::vector<std::shared_ptr<Translate>> movers;
+    std::vector<Point3> rest;
+    const auto material = std::make_shared<Lambertian>(Color(0.5, 0.5, 0.5));
+    for (int i = 0; i < 2000; ++i) {
+        const Point3 center(RandomDouble(generator, -6.0, 6.0), RandomDouble(generator, 0.0, 3.0), RandomDouble(generator, -6.0, 6.0));
+        const auto sphere = std::make_shared<Sphere>(Point3(0.0, 0.0, 0.0), 0.1, material);
+        movers.push_back(std::make_shared<Translate>(sphere, center));
+        rest.push_back(center);
+        world.Add(movers.back());
+    }
+
+    AnimationMeasurement measurement{};
+    auto bvh = std::make_shared<BvhNode>(world, 0.0, 1.0);
+    for (int frame = 0; frame < frame_count; ++frame) {
+        const double radians = 2.0 * 3.1415926535897932385 * frame / frame_count;
+        const double sin_theta = std::sin(radians);
+        const double cos_theta = std::cos(radians);
+        for (std::size_t i = 0; i < movers.size(); ++i) {
+            const Point3& p = rest[i];
+            movers[i]->SetOffset(Point3(cos_theta * p.x() + sin_theta * p.z(), p.y(), -sin_theta * p.x() + cos_theta * p.z()));
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        if (refit) {
+            const BvhRefitStats stats = bvh->Refit(0.0, 1.0, 1.5);
+            measurement.refit.refitted_nodes += stats.refitted_nodes;
+            measurement.refit.rebuilt_subtrees += stats.rebuilt_subtrees;
+        } else {
+            bvh = std::make_shared<BvhNode>(world, 0.0, 1.0);
+        }
+        measurement.update += std::chrono::steady_clock::now() - start;
+        measurement.hits += MeasureHits(*bvh, rays, 2025).elapsed;
+    }
+    return measurement;
+}
+
 int main() {
-    std::mt19937 generator(2024);
+    Rng generator(2024);
     HittableList world = BuildBenchmarkWorld(generator);
     std::vector<std::shared_ptr<Hittable>> objects = world.Objects();
     BvhNode bvh(objects, 0.0, 1.0);
@@ -97,5 +773,58 @@ int main() {
     std::cout << "BVH hit 시간(ms): " << bvh_measure.elapsed.count() << "\n";
     std::cout << "hit 카운트 차이: " << (list_measure.hit_count - bvh_measure.hit_count) << "\n";
 
+    CompareBuilders("빌더 비교: 격자 장면", world, rays);
+    const HittableList uneven = BuildUnevenWorld(generator);
+    const std::vector<Ray> uneven_rays = GenerateRays(generator, 20000);
+    CompareBuilders("빌더 비교: 불균일 장면", uneven, uneven_rays);
+
+    CompareLayouts("선형 BVH: 격자 장면", world, rays);
+    CompareLayouts("선형 BVH: 불균일 장면", uneven, uneven_rays);
+    CompareOcclusion("가림 판정: 격자 장면", world, rays);
+    CompareOcclusion("가림 판정: 불균일 장면", uneven, uneven_rays);
+    ComparePackets("레이 묶음: 격자 장면", world, Point3(0.0, 3.0, 9.0), Point3(0.0, 0.3, 0.0));
+    ComparePackets("레이 묶음: 불균일 장면", uneven, Point3(2.5, 1.2, 3.0), Point3(2.5, 0.7, -0.5));
+    CompareTileCulling("타일 절두체 컬링: 격자 장면", world, Point3(0.0, 3.0, 9.0), Point3(0.0, 0.3, 0.0));
+    CompareTileCulling("타일 절두체 컬링: 불균일 장면", uneven, Point3(2.5, 1.2, 3.0), Point3(2.5, 0.7, -0.5));
+
+    constexpr int kFrames = 240;
+    const std::vector<Ray> frame_rays(rays.begin(), rays.begin() + 2000);
+    const AnimationMeasurement rebuild = MeasureTurntable(frame_rays, kFrames, false);
+    const AnimationMeasurement refit = MeasureTurntable(frame_rays, kFrames, true);
+    std::cout << "턴테이블 " << kFrames << "프레임(구 2000개, 프레임당 레이 " << frame_rays.size() << "개)\n";
+    std::cout << "  재빌드 갱신/hit 시간(ms): " << rebuild.update.count() << " / " << rebuild.hits.count() << "\n";
+    std::cout << "  재맞춤 갱신/hit 시간(ms): " << refit.update.count() << " / " << refit.hits.count() << "\n";
+    std::cout << "  재맞춤 노드/재구성 서브트리: " << refit.refit.refitted_nodes << " / " << refit.refit.rebuilt_subtrees << "\n";
+
+    CompareSpatialSplits(generator, rays);
+    CompareInstancing(generator);
+
+    CompareNodeFormats("노드 형식: 불균일 장면", uneven.Objects(), uneven_rays);
+    const std::vector<std::shared_ptr<Hittable>> million = BuildMillionSpheres(generator, 1000000);
+    std::vector<Ray> million_rays;
+    for (int i = 0; i < 20000; ++i) {
+        const Point3 origin(RandomDouble(generator, -100.0, 100.0), 80.0, RandomDouble(generator, -100.0, 100.0));
+        million_rays.emplace_back(origin, Vec3(RandomDouble(generator, -0.2, 0.2), -1.0, RandomDouble(generator, -0.2, 0.2)),
+                                  0.0);
+    }
+    CompareNodeFormats("노드 형식: 구 100만 개", million, million_rays);
+    MeasureBvhCache(million, million_rays);
+
+    // 장면 한구석을 좁은 화각으로 가까이 보는 128x128 화면 레이와, 장면 전체를 내려다보는 레이를 비교한다.
+    const Camera close_up(Point3(-60.0, 12.0, -60.0), Point3(-70.0, 5.0, -70.0), Vec3(0.0, 1.0, 0.0), 20.0, 1.0, 0.0, 1.0,
+                          0.0, 1.0);
+    std::vector<Ray> close_up_rays;
+    for (int y = 0; y < 128; ++y) {
+        for (int x = 0; x < 128; ++x) {
+            close_up_rays.push_back(close_up.GetRay((x + 0.5) / 127.0, (127 - y + 0.5) / 127.0, generator));
+        }
+    }
+    CompareLazyBuild("지연 빌드: 구 100만 개 근접 화면", million, close_up_rays);
+    CompareLazyBuild("지연 빌드: 구 100만 개 전체 내려다보기", million, million_rays);
+
+    CompareMotionBlur(generator, rays);
+
+    MeasureParallelBuild(million);
+
     return 0;
 }
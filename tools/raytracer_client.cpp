@@ -0,0 +1,71 @@
+/*
+ * 설명: raytracer --serve 렌더 서버에 한 줄 JSON 요청을 보내 받은 PPM을 파일이나 표준 출력으로 기록한다.
+ * 버전: v1.5.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.5.0-render-server.md
+ * 테스트: tests/integration/render_server_test.cpp
+ */
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "raytracer/render_client.hpp"
+
+int main(int argc, char* argv[]) {
+    std::string output_path = "-";
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--output") {
+            if (i + 1 >= argc) {
+                std::cerr << "오류: --output 옵션에 경로가 필요하다." << std::endl;
+                return 1;
+            }
+            output_path = argv[++i];
+        } else if (arg.size() > 1 && arg[0] == '-' && arg[1] == '-') {
+            std::cerr << "오류: 지원하지 않는 옵션." << std::endl;
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.empty() || positional.size() > 2) {
+        std::cerr << "오류: 사용법: raytracer_client [--output <경로>] <소켓> [요청 JSON]" << std::endl;
+        return 1;
+    }
+
+    std::ofstream file;
+    std::ostream* output = &std::cout;
+    if (output_path != "-") {
+        file.open(output_path, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "오류: 파일을 열 수 없다." << std::endl;
+            return 2;
+        }
+        output = &file;
+    }
+
+    try {
+        raytracer::RenderClient client(positional[0]);
+        if (positional.size() == 2) {
+            client.Render(positional[1], *output);
+        } else {
+            // 요청 JSON이 없으면 표준 입력의 각 줄을 같은 연결로 차례로 보낸다.
+            std::string line;
+            while (std::getline(std::cin, line)) {
+                if (!line.empty()) {
+                    client.Render(line, *output);
+                }
+            }
+        }
+        output->flush();
+    } catch (const std::runtime_error& error) {
+        std::cerr << "오류: " << error.what() << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * 설명: raytracer --shard/--tile-range로 만든 샤드 파일들을 읽어 전체 PPM(P3/P6)으로 병합한다.
+ * 버전: v1.4.0
+ * 관련 문서: design/protocol/contract.md, design/renderer/v1.3.0-shards.md, design/renderer/v1.4.0-streaming-output.md
+ * 테스트: tests/integration/ppm_integration_test.cpp
+ */
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "raytracer/image_sink.hpp"
+#include "raytracer/shard.hpp"
+
+int main(int argc, char* argv[]) {
+    std::string output_path = "-";
+    raytracer::PpmFormat format = raytracer::PpmFormat::kAscii;
+    std::vector<std::string> shard_paths;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--output") {
+            if (i + 1 >= argc) {
+                std::cerr << "오류: --output 옵션에 경로가 필요하다." << std::endl;
+                return 1;
+            }
+            output_path = argv[++i];
+        } else if (arg == "--format") {
+            const std::string value = (i + 1 < argc) ? argv[++i] : "";
+            if (value == "p3") {
+                format = raytracer::PpmFormat::kAscii;
+            } else if (value == "p6") {
+                format = raytracer::PpmFormat::kBinary;
+            } else {
+                std::cerr << "오류: --format 값은 p3 또는 p6이어야 한다." << std::endl;
+                return 1;
+            }
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "오류: 지원하지 않는 옵션." << std::endl;
+            return 1;
+        } else {
+            shard_paths.push_back(arg);
+        }
+    }
+
+    if (shard_paths.empty()) {
+        std::cerr << "오류: 병합할 샤드 파일 경로가 필요하다." << std::endl;
+        return 1;
+    }
+
+    std::vector<raytracer::ShardImage> shards;
+    try {
+        for (const std::string& path : shard_paths) {
+            std::ifstream file(path);
+            if (!file.is_open()) {
+                throw std::runtime_error("샤드 파일을 열 수 없다: " + path);
+            }
+            shards.push_back(raytracer::DecodeShard(file));
+        }
+    } catch (const std::runtime_error& error) {
+        std::cerr << "오류: " << error.what() << std::endl;
+        return 2;
+    }
+
+    std::ofstream file;
+    std::ostream* output = &std::cout;
+    if (output_path != "-") {
+        file.open(output_path, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "오류: 파일을 열 수 없다." << std::endl;
+            return 2;
+        }
+        output = &file;
+    }
+
+    try {
+        raytracer::PpmStreamWriter writer(*output, format);
+        raytracer::MergeShards(shards, writer);
+    } catch (const std::runtime_error& error) {
+        std::cerr << "오류: " << error.what() << std::endl;
+        return 2;
+    }
+
+    return 0;
+}